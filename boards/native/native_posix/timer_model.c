@@ -68,6 +68,7 @@ uint64_t hw_timer_timer;
 
 uint64_t hw_timer_tick_timer;
 uint64_t hw_timer_awake_timer;
+static uint64_t hw_timer_alarm_timer;
 
 static uint64_t tick_p; /* Period of the ticker */
 static int64_t silent_ticks;
@@ -126,7 +127,8 @@ void hwtimer_set_real_time_mode(bool new_rt)
 
 static void hwtimer_update_timer(void)
 {
-	hw_timer_timer = MIN(hw_timer_tick_timer, hw_timer_awake_timer);
+	hw_timer_timer = MIN(MIN(hw_timer_tick_timer, hw_timer_awake_timer),
+			     hw_timer_alarm_timer);
 }
 
 static inline void host_clock_gettime(struct timespec *tv)
@@ -151,6 +153,7 @@ void hwtimer_init(void)
 	silent_ticks = 0;
 	hw_timer_tick_timer = NEVER;
 	hw_timer_awake_timer = NEVER;
+	hw_timer_alarm_timer = NEVER;
 	hwtimer_update_timer();
 	if (real_time_mode) {
 		boot_time = get_host_us_time();
@@ -227,6 +230,13 @@ static void hwtimer_tick_timer_reached(void)
 	}
 }
 
+static void hwtimer_alarm_timer_reached(void)
+{
+	hw_timer_alarm_timer = NEVER;
+	hwtimer_update_timer();
+	hw_irq_ctrl_set_irq(TIMER_TICK_IRQ);
+}
+
 static void hwtimer_awake_timer_reached(void)
 {
 	hw_timer_awake_timer = NEVER;
@@ -242,6 +252,10 @@ void hwtimer_timer_reached(void)
 		hwtimer_awake_timer_reached();
 	}
 
+	if (hw_timer_alarm_timer == Now) {
+		hwtimer_alarm_timer_reached();
+	}
+
 	if (hw_timer_tick_timer == Now) {
 		hwtimer_tick_timer_reached();
 	}
@@ -264,6 +278,19 @@ void hwtimer_wake_in_time(uint64_t time)
 	}
 }
 
+/**
+ * Raise the timer tick interrupt when <time> comes, independently of the
+ * periodic ticks and without consuming a silent tick.
+ *
+ * A new call replaces the previous alarm, <time> = NEVER cancels it.
+ */
+void hwtimer_set_alarm(uint64_t time)
+{
+	hw_timer_alarm_timer = time;
+	hwtimer_update_timer();
+	hwm_find_next_timer();
+}
+
 /**
  * The kernel wants to skip the next sys_ticks tick interrupts
  * If sys_ticks == 0, the next interrupt will be raised.
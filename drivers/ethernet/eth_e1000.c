@@ -47,6 +47,7 @@ static const char *e1000_reg_to_string(enum e1000_reg_t r)
 	_(ICR);
 	_(ICS);
 	_(IMS);
+	_(IMC);
 	_(RCTL);
 	_(TCTL);
 	_(RDBAL);
@@ -166,8 +167,13 @@ static struct net_pkt *e1000_rx(struct e1000_dev *dev)
 
 	hexdump(buf, len, "%zd byte(s)", len);
 
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+	pkt = net_pkt_rx_alloc_from_cache(dev->iface, &dev->rx_cache, len,
+					  K_NO_WAIT);
+#else
 	pkt = net_pkt_rx_alloc_with_buffer(dev->iface, len, AF_UNSPEC, 0,
 					   K_NO_WAIT);
+#endif
 	if (!pkt) {
 		LOG_ERR("Out of buffers");
 		goto out;
@@ -310,8 +316,33 @@ static void e1000_iface_init(struct net_if *iface)
 	LOG_DBG("done");
 }
 
+static int e1000_start(const struct device *ddev)
+{
+	struct e1000_dev *dev = ddev->data;
+
+	iow32(dev, IMS, IMS_RXO);
+
+	return 0;
+}
+
+static int e1000_stop(const struct device *ddev)
+{
+	struct e1000_dev *dev = ddev->data;
+
+	iow32(dev, IMC, IMS_RXO);
+
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+	/* Nothing is received anymore, give the cached buffers back */
+	net_pkt_buf_cache_flush(&dev->rx_cache);
+#endif
+
+	return 0;
+}
+
 static const struct ethernet_api e1000_api = {
 	.iface_api.init		= e1000_iface_init,
+	.start			= e1000_start,
+	.stop			= e1000_stop,
 #if defined(CONFIG_ETH_E1000_PTP_CLOCK)
 	.get_ptp_clock		= e1000_get_ptp_clock,
 #endif
@@ -37,6 +37,7 @@ enum e1000_reg_t {
 	ICR	= 0x00C0,	/* Interrupt Cause Read */
 	ICS	= 0x00C8,	/* Interrupt Cause Set */
 	IMS	= 0x00D0,	/* Interrupt Mask Set */
+	IMC	= 0x00D8,	/* Interrupt Mask Clear */
 	RCTL	= 0x0100,	/* Receive Control */
 	TCTL	= 0x0400,	/* Transmit Control */
 	RDBAL	= 0x2800,	/* Rx Descriptor Base Address Low */
@@ -90,6 +91,10 @@ struct e1000_dev {
 	uint8_t mac[ETH_ALEN];
 	uint8_t txb[NET_ETH_MTU];
 	uint8_t rxb[NET_ETH_MTU];
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+	/* RX buffers, refilled from the pool in bulk */
+	struct net_pkt_buf_cache rx_cache;
+#endif
 #if defined(CONFIG_ETH_E1000_PTP_CLOCK)
 	const struct device *ptp_clock;
 	float clk_ratio;
@@ -61,6 +61,9 @@ struct eth_context {
 	bool status;
 	bool promisc_mode;
 
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+	struct net_pkt_buf_cache rx_cache;
+#endif
 #if defined(CONFIG_NET_STATISTICS_ETHERNET)
 	struct net_stats_eth stats;
 #endif
@@ -229,6 +232,18 @@ static inline struct net_if *get_iface(struct eth_context *ctx,
 #endif
 }
 
+/* The RX thread is the only user of the buffer cache of the context */
+static struct net_pkt *rx_alloc(struct eth_context *ctx, int count)
+{
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+	return net_pkt_rx_alloc_from_cache(ctx->iface, &ctx->rx_cache, count,
+					   NET_BUF_TIMEOUT);
+#else
+	return net_pkt_rx_alloc_with_buffer(ctx->iface, count,
+					    AF_UNSPEC, 0, NET_BUF_TIMEOUT);
+#endif
+}
+
 #if defined(CONFIG_NET_VLAN)
 static struct net_pkt *prepare_vlan_pkt(struct eth_context *ctx,
 					int count, uint16_t *vlan_tag, int *status)
@@ -241,8 +256,7 @@ static struct net_pkt *prepare_vlan_pkt(struct eth_context *ctx,
 		count -= NET_ETH_VLAN_HDR_SIZE;
 	}
 
-	pkt = net_pkt_rx_alloc_with_buffer(ctx->iface, count,
-					   AF_UNSPEC, 0, NET_BUF_TIMEOUT);
+	pkt = rx_alloc(ctx, count);
 	if (!pkt) {
 		*status = -ENOMEM;
 		return NULL;
@@ -294,8 +308,7 @@ static struct net_pkt *prepare_non_vlan_pkt(struct eth_context *ctx,
 {
 	struct net_pkt *pkt;
 
-	pkt = net_pkt_rx_alloc_with_buffer(ctx->iface, count,
-					   AF_UNSPEC, 0, NET_BUF_TIMEOUT);
+	pkt = rx_alloc(ctx, count);
 	if (!pkt) {
 		*status = -ENOMEM;
 		return NULL;
@@ -381,6 +394,13 @@ static void eth_rx(void *p1, void *p2, void *p3)
 			}
 		}
 
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+		/* Do not keep buffers while the interface is down */
+		if (!net_if_is_up(ctx->iface)) {
+			net_pkt_buf_cache_flush(&ctx->rx_cache);
+		}
+#endif
+
 		k_sleep(K_MSEC(CONFIG_ETH_NATIVE_POSIX_RX_TIMEOUT));
 	}
 }
@@ -230,6 +230,15 @@ static __pinned_bss uint64_t last_count;
 static __pinned_bss uint64_t last_tick;
 static __pinned_bss uint32_t last_elapsed;
 
+#ifdef CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE
+/* Comparator value wanted by sys_clock_set_timeout(), and the cycle
+ * deadline from sys_clock_set_cycle_deadline().  The comparator holds
+ * the earlier of the two.
+ */
+static __pinned_bss uint64_t tick_cyc;
+static __pinned_data uint64_t deadline_cyc = UINT64_MAX;
+#endif
+
 #ifdef CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME
 static __pinned_bss unsigned int cyc_per_tick;
 #else
@@ -272,6 +281,27 @@ static inline void hpet_timer_comparator_set_safe(uint64_t next)
 	}
 }
 
+/* Program the comparator for a tick expiry, or for the cycle deadline
+ * if that comes first.  Must be called with the lock held.
+ */
+static inline void hpet_timeout_set(uint64_t cyc)
+{
+#ifdef CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE
+	tick_cyc = cyc;
+	cyc = MIN(cyc, deadline_cyc);
+#endif
+	hpet_timer_comparator_set_safe(cyc);
+}
+
+static inline bool hpet_deadline_pending(void)
+{
+#ifdef CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE
+	return deadline_cyc != UINT64_MAX;
+#else
+	return false;
+#endif
+}
+
 __isr
 static void hpet_isr(const void *arg)
 {
@@ -303,6 +333,12 @@ static void hpet_isr(const void *arg)
 			now = last_count;
 		}
 	}
+#ifdef CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE
+	if (deadline_cyc <= now) {
+		deadline_cyc = UINT64_MAX;
+	}
+#endif
+
 	uint32_t dticks = (uint32_t)((now - last_count) / cyc_per_tick);
 
 	last_count += (uint64_t)dticks * cyc_per_tick;
@@ -356,7 +392,7 @@ void sys_clock_set_timeout(int32_t ticks, bool idle)
 #if defined(CONFIG_TICKLESS_KERNEL)
 	uint32_t reg;
 
-	if (ticks == K_TICKS_FOREVER && idle) {
+	if (ticks == K_TICKS_FOREVER && idle && !hpet_deadline_pending()) {
 		reg = hpet_gconf_get();
 		reg &= ~GCONF_ENABLE;
 		hpet_gconf_set(reg);
@@ -369,11 +405,23 @@ void sys_clock_set_timeout(int32_t ticks, bool idle)
 	k_spinlock_key_t key = k_spin_lock(&lock);
 	uint64_t cyc = (last_tick + last_elapsed + ticks) * cyc_per_tick;
 
-	hpet_timer_comparator_set_safe(cyc);
+	hpet_timeout_set(cyc);
 	k_spin_unlock(&lock, key);
 #endif
 }
 
+#ifdef CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE
+__pinned_func
+void sys_clock_set_cycle_deadline(uint64_t cycles)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	deadline_cyc = cycles;
+	hpet_timer_comparator_set_safe(MIN(tick_cyc, deadline_cyc));
+	k_spin_unlock(&lock, key);
+}
+#endif
+
 __pinned_func
 uint32_t sys_clock_elapsed(void)
 {
@@ -458,7 +506,7 @@ static int sys_clock_driver_init(void)
 
 	last_tick = hpet_counter_get() / cyc_per_tick;
 	last_count = last_tick * cyc_per_tick;
-	hpet_timer_comparator_set_safe(last_count + cyc_per_tick);
+	hpet_timeout_set(last_count + cyc_per_tick);
 
 	return 0;
 }
@@ -94,6 +94,26 @@ void sys_clock_set_timeout(int32_t ticks, bool idle)
 #endif
 }
 
+#if defined(CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE)
+/**
+ * @brief Request an interrupt at an absolute cycle count
+ *
+ * The timer model raises the tick interrupt at that time, so the ISR
+ * announces whatever whole ticks have elapsed (possibly none).
+ *
+ * See system_timer.h for more information
+ *
+ * @param cycles Absolute cycle count (microseconds since boot)
+ */
+void sys_clock_set_cycle_deadline(uint64_t cycles)
+{
+	if (cycles != UINT64_MAX) {
+		cycles = MAX(cycles, hwm_get_time());
+	}
+	hwtimer_set_alarm(cycles);
+}
+#endif
+
 /**
  * @brief Ticks elapsed since last sys_clock_announce() call
  *
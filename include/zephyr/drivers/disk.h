@@ -65,6 +65,33 @@ extern "C" {
 
 struct disk_operations;
 
+/**
+ * @brief Disk block cache statistics, counted in sectors
+ */
+struct disk_cache_stats {
+	/** Sectors read from the cache */
+	uint32_t hits;
+	/** Sectors read from the disk for a read request */
+	uint32_t misses;
+	/** Sectors read from the disk ahead of the read requests */
+	uint32_t read_ahead;
+	/** Sectors written to the disk */
+	uint32_t written;
+	/** Write commands sent to the disk */
+	uint32_t write_cmds;
+};
+
+/** @cond INTERNAL_HIDDEN */
+struct disk_cache_info {
+	/* Sector size, 0 when the disk is not cached */
+	uint32_t sector_size;
+	uint32_t sector_count;
+	/* Sector following the last read, to detect sequential reads */
+	uint32_t next_sector;
+	struct disk_cache_stats stats;
+};
+/** @endcond */
+
 /**
  * @brief Disk info
  */
@@ -77,6 +104,10 @@ struct disk_info {
 	const struct disk_operations *ops;
 	/** Device associated to this disk */
 	const struct device *dev;
+#if defined(CONFIG_DISK_CACHE) || defined(__DOXYGEN__)
+	/** Internally used by the block cache */
+	struct disk_cache_info cache;
+#endif
 };
 
 /**
@@ -118,6 +118,27 @@ extern uint32_t sys_clock_elapsed(void);
  */
 extern void sys_clock_disable(void);
 
+/**
+ * @brief Request an interrupt at an absolute cycle count
+ *
+ * In addition to the expiry set with sys_clock_set_timeout(), the
+ * driver must call sys_clock_announce(), with however many whole ticks
+ * have elapsed (possibly zero), as soon as the hardware cycle counter
+ * reaches @p cycles.  The deadline is one-shot: the driver drops it
+ * once reached.  A new call replaces the previous deadline.  A
+ * deadline that has already passed must cause an interrupt as soon as
+ * possible.
+ *
+ * Used by high-resolution timers to expire between ticks.
+ *
+ * @note Only drivers selecting
+ * @kconfig{CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE} implement this.
+ *
+ * @param cycles Absolute value of the 64-bit cycle counter, as returned
+ *               by sys_clock_cycle_get_64(), or UINT64_MAX for none.
+ */
+extern void sys_clock_set_cycle_deadline(uint64_t cycles);
+
 /**
  * @brief Hardware cycle counter
  *
@@ -33,6 +33,22 @@ extern "C" {
  * @{
  */
 
+#if CONFIG_NVS_ATE_INDEX
+/** @cond INTERNAL_HIDDEN */
+/** Non-volatile Storage RAM index entry, the most recent allocation table entry of an id */
+struct nvs_ate_index_entry {
+	/** Address of the allocation table entry */
+	uint32_t ate_addr;
+	/** Id of the entry */
+	uint16_t id;
+	/** Data offset within the sector */
+	uint16_t offset;
+	/** Data length, 0 for a deletion */
+	uint16_t len;
+};
+/** @endcond */
+#endif
+
 /**
  * @brief Non-volatile Storage File system structure
  */
@@ -62,6 +78,28 @@ struct nvs_fs {
 #if CONFIG_NVS_LOOKUP_CACHE
 	uint32_t lookup_cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
 #endif
+#if CONFIG_NVS_ATE_INDEX
+	/** Most recent allocation table entry of each id */
+	struct nvs_ate_index_entry ate_index[CONFIG_NVS_ATE_INDEX_SIZE];
+	/** Bytes of data and allocation table entries in use in each sector */
+	uint16_t sector_live[CONFIG_NVS_ATE_INDEX_MAX_SECTORS];
+	/** Flag indicating if the index holds every id of the file system */
+	bool ate_index_complete;
+#endif
+};
+
+/**
+ * @brief Non-volatile Storage entry, as found by nvs_walk()
+ */
+struct nvs_entry {
+	/** Id of the entry */
+	uint16_t id;
+	/** Length of the entry data, 0 for a deletion */
+	uint16_t len;
+	/** Address of the entry data, for nvs_entry_read() */
+	uint32_t data_addr;
+	/** Allocation table write address when the entry was found */
+	uint32_t ate_wra;
 };
 
 /**
@@ -164,6 +202,55 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len, ui
  */
 ssize_t nvs_calc_free_space(struct nvs_fs *fs);
 
+/**
+ * @brief Callback for nvs_walk().
+ *
+ * @param fs Pointer to file system
+ * @param entry Entry found
+ * @param arg Argument given to nvs_walk()
+ *
+ * @return 0 to continue the walk, any other value stops it and is returned by nvs_walk().
+ */
+typedef int (*nvs_walk_cb_t)(struct nvs_fs *fs, const struct nvs_entry *entry, void *arg);
+
+/**
+ * @brief Walk through all the entries of the file system in a single pass.
+ *
+ * Entries are visited from the most recent to the oldest one. Older versions of an id and
+ * deletions, which are entries of length @p 0, are visited too: callers only interested in the
+ * current data of each id skip the ids they have already seen. The file system is not locked
+ * while the callback runs, so it may write to the file system. After a write, by the callback
+ * or by another thread, the walk starts over from the most recent entry, so entries can be
+ * visited more than once.
+ *
+ * @param fs Pointer to file system
+ * @param cb Callback called for each entry
+ * @param arg Argument passed to @p cb
+ *
+ * @retval 0 Success
+ * @retval -ERRNO errno code if error
+ * @return Any other value returned by @p cb, which stopped the walk
+ */
+int nvs_walk(struct nvs_fs *fs, nvs_walk_cb_t cb, void *arg);
+
+/**
+ * @brief Read the data of an entry found by nvs_walk().
+ *
+ * Only valid from the nvs_walk() callback that got @p entry, until the file system is written.
+ *
+ * @param fs Pointer to file system
+ * @param entry Entry to be read
+ * @param offset Offset in the entry data to read from
+ * @param data Pointer to data buffer
+ * @param len Number of bytes to be read
+ *
+ * @return Number of bytes read, which is less than @p len when the entry data ends first. On
+ * error, returns negative value of errno.h defined error codes, -EAGAIN when the file system
+ * was written since @p entry was found.
+ */
+ssize_t nvs_entry_read(struct nvs_fs *fs, const struct nvs_entry *entry, size_t offset,
+		       void *data, size_t len);
+
 /**
  * @}
  */
@@ -1834,10 +1834,119 @@ static inline uint64_t k_cycle_get_64(void)
  * @}
  */
 
+#if defined(CONFIG_HRTIMER) || defined(__DOXYGEN__)
+
+struct k_hrtimer;
+
+/**
+ * @defgroup hrtimer_apis High-Resolution Timer APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @typedef k_hrtimer_expiry_t
+ * @brief High-resolution timer expiry function type.
+ *
+ * The expiry function is executed by the system clock interrupt handler
+ * each time the timer expires.
+ *
+ * @param timer     Address of the timer.
+ */
+typedef void (*k_hrtimer_expiry_t)(struct k_hrtimer *timer);
+
+/**
+ * @brief High-resolution timer.
+ *
+ * Unlike @ref k_timer, which expires on system tick boundaries, a
+ * high-resolution timer expires at a 64-bit hardware cycle count.  On
+ * system timer drivers that support cycle deadlines
+ * (@kconfig{CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE}) it fires as close
+ * to that count as the hardware allows, otherwise on the first tick
+ * after it.
+ */
+struct k_hrtimer {
+	/** @cond INTERNAL_HIDDEN */
+	sys_dnode_t node;
+	uint64_t expiry;
+	uint64_t period;
+	k_hrtimer_expiry_t expiry_fn;
+	/** @endcond */
+
+	/** User data, free for use by the owner of the timer */
+	void *user_data;
+};
+
+/**
+ * @brief Initialize a high-resolution timer.
+ *
+ * @param timer     Address of the timer.
+ * @param expiry_fn Function to invoke each time the timer expires.
+ */
+void k_hrtimer_init(struct k_hrtimer *timer, k_hrtimer_expiry_t expiry_fn);
+
+/**
+ * @brief Start a high-resolution timer.
+ *
+ * Starts the timer, or restarts it with the new parameters if it is
+ * already running.  An expiry in the past makes the timer expire right
+ * away.  A periodic timer keeps its phase: its expiries are @p expiry
+ * plus whole multiples of @p period, and expiries missed because the
+ * system was late are skipped rather than run back to back.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param timer     Address of the timer.
+ * @param expiry    Absolute cycle count, as returned by k_cycle_get_64(),
+ *                  at which the timer first expires.
+ * @param period    Period in cycles, or 0 for a one-shot timer.
+ */
+void k_hrtimer_start(struct k_hrtimer *timer, uint64_t expiry,
+		     uint64_t period);
+
+/**
+ * @brief Stop a high-resolution timer.
+ *
+ * The expiry function of a stopped timer may still be running on
+ * another CPU when this returns, but it will not be invoked again
+ * until the timer is restarted.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param timer     Address of the timer.
+ *
+ * @retval true if the timer was running.
+ * @retval false if the timer was already stopped.
+ */
+bool k_hrtimer_stop(struct k_hrtimer *timer);
+
+/**
+ * @brief Get the next expiry of a high-resolution timer.
+ *
+ * @param timer     Address of the timer.
+ *
+ * @return Absolute cycle count of the next expiry, or 0 if the timer is
+ * not running.
+ */
+uint64_t k_hrtimer_expires_get(struct k_hrtimer *timer);
+
+/** @} */
+
+#endif /* CONFIG_HRTIMER */
+
 struct k_queue {
 	sys_sflist_t data_q;
 	struct k_spinlock lock;
 	_wait_q_t wait_q;
+#ifdef CONFIG_QUEUE_LOCKFREE
+	/* Items put without the lock, newest first */
+	atomic_ptr_t append_inbox;
+	atomic_ptr_t prepend_inbox;
+	/* Threads about to block or blocked in k_queue_get() */
+	atomic_t waiters;
+	/* Set once the queue has been passed to k_poll() */
+	atomic_t polled;
+#endif
 
 	Z_DECL_POLL_EVENT
 
@@ -1989,6 +2098,26 @@ void k_queue_insert(struct k_queue *queue, void *prev, void *data);
  */
 int k_queue_append_list(struct k_queue *queue, void *head, void *tail);
 
+/**
+ * @brief Atomically prepend a list of elements to a queue.
+ *
+ * This routine adds a list of data items to the front of @a queue in one
+ * operation, keeping their order. The data items must be in a
+ * singly-linked list, with the first word in each data item pointing to
+ * the next data item; the list must be NULL-terminated.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param queue Address of the queue.
+ * @param head Pointer to first node in singly-linked list.
+ * @param tail Pointer to last node in singly-linked list.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL on invalid supplied data
+ *
+ */
+int k_queue_prepend_list(struct k_queue *queue, void *head, void *tail);
+
 /**
  * @brief Atomically add a list of elements to a queue.
  *
@@ -2077,6 +2206,12 @@ __syscall int k_queue_is_empty(struct k_queue *queue);
 
 static inline int z_impl_k_queue_is_empty(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKFREE
+	if ((atomic_ptr_get(&queue->append_inbox) != NULL) ||
+	    (atomic_ptr_get(&queue->prepend_inbox) != NULL)) {
+		return 0;
+	}
+#endif
 	return (int)sys_sflist_is_empty(&queue->data_q);
 }
 
@@ -2673,6 +2808,31 @@ struct k_lifo {
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_lifo, put, lifo, data); \
 	})
 
+/**
+ * @brief Atomically add a list of elements to a LIFO queue.
+ *
+ * This routine adds a list of data items to @a lifo in one operation.
+ * The data items must be in a singly-linked list implemented using a
+ * sys_slist_t object, and are taken out in the order of the list, before
+ * the items already in @a lifo. Upon completion, the sys_slist_t object
+ * is empty.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param lifo Address of the LIFO queue.
+ * @param list Pointer to sys_slist_t object.
+ */
+#define k_lifo_put_slist(lifo, list) \
+	({ \
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_lifo, put_slist, lifo, list); \
+	if (!sys_slist_is_empty(list)) { \
+		k_queue_prepend_list(&(lifo)->_queue, sys_slist_peek_head(list), \
+				     sys_slist_peek_tail(list)); \
+		sys_slist_init(list); \
+	} \
+	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_lifo, put_slist, lifo, list); \
+	})
+
 /**
  * @brief Add an element to a LIFO queue.
  *
@@ -3781,6 +3941,116 @@ int k_work_cancel_delayable(struct k_work_delayable *dwork);
 bool k_work_cancel_delayable_sync(struct k_work_delayable *dwork,
 				  struct k_work_sync *sync);
 
+#if defined(CONFIG_WORK_POOL) || defined(__DOXYGEN__)
+
+struct k_work_pool;
+
+/** @brief Start the worker threads of a work queue pool.
+ *
+ * A work queue pool is a set of work queues, each animated by its own
+ * thread, that share their work: a worker that runs out of work takes
+ * the oldest item off a busy sibling.  With
+ * @kconfig{CONFIG_SCHED_CPU_MASK} worker @c n is pinned to CPU @c n.
+ *
+ * Work items keep their usual semantics: an item is never run by two
+ * workers at the same time, and k_work_flush(), k_work_cancel() and
+ * their variants work on items submitted to a pool.
+ *
+ * The pool must be defined with K_WORK_POOL_DEFINE().
+ *
+ * @param pool pointer to the pool.
+ *
+ * @param prio initial priority of the worker threads.
+ *
+ * @param cfg optional additional configuration parameters, applied to
+ * every worker.  Pass @c NULL if not required.
+ */
+void k_work_pool_start(struct k_work_pool *pool, int prio,
+		       const struct k_work_queue_config *cfg);
+
+/** @brief Submit a work item to a work queue pool.
+ *
+ * The item is queued to the next worker in turn, or to the worker
+ * already running it, from which idle workers may steal it.  A worker
+ * submitting an item to its own pool queues it to itself.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param pool pointer to the pool.
+ *
+ * @param work pointer to the work item.
+ *
+ * @return as for k_work_submit_to_queue().
+ */
+int k_work_submit_to_pool(struct k_work_pool *pool, struct k_work *work);
+
+/** @brief Schedule delayable work on a work queue pool.
+ *
+ * Same as k_work_schedule_for_queue(), with the worker picked as in
+ * k_work_submit_to_pool().
+ *
+ * @funcprops \isr_ok
+ *
+ * @param pool pointer to the pool.
+ *
+ * @param dwork pointer to the delayable work item.
+ *
+ * @param delay the time to wait before submitting the work item.
+ *
+ * @return as for k_work_schedule_for_queue().
+ */
+int k_work_schedule_for_pool(struct k_work_pool *pool,
+			     struct k_work_delayable *dwork,
+			     k_timeout_t delay);
+
+/** @brief Reschedule delayable work on a work queue pool.
+ *
+ * Same as k_work_reschedule_for_queue(), with the worker picked as in
+ * k_work_submit_to_pool().
+ *
+ * @funcprops \isr_ok
+ *
+ * @param pool pointer to the pool.
+ *
+ * @param dwork pointer to the delayable work item.
+ *
+ * @param delay the time to wait before submitting the work item.
+ *
+ * @return as for k_work_reschedule_for_queue().
+ */
+int k_work_reschedule_for_pool(struct k_work_pool *pool,
+			       struct k_work_delayable *dwork,
+			       k_timeout_t delay);
+
+/** @brief Wait until all workers of a pool have drained.
+ *
+ * Same as k_work_queue_drain(), applied to every worker of the pool at
+ * once.  No work is stolen from a worker while it drains.
+ *
+ * @param pool pointer to the pool.
+ *
+ * @param plug if true the workers will continue to block new submissions
+ * after all items have drained, until k_work_pool_unplug() is invoked.
+ *
+ * @retval 1 if call had to wait for the drain to complete
+ * @retval 0 if call did not have to wait
+ * @retval negative if wait was interrupted or failed
+ */
+int k_work_pool_drain(struct k_work_pool *pool, bool plug);
+
+/** @brief Release a work queue pool to accept new submissions.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param pool pointer to the pool.
+ *
+ * @retval 0 if successfully unplugged
+ * @retval -EALREADY if the pool was not plugged.
+ */
+int k_work_pool_unplug(struct k_work_pool *pool);
+
+#endif /* CONFIG_WORK_POOL */
+
 enum {
 /**
  * @cond INTERNAL_HIDDEN
@@ -4026,8 +4296,53 @@ struct k_work_q {
 
 	/* Flags describing queue state. */
 	uint32_t flags;
+
+#ifdef CONFIG_WORK_POOL
+	/* Pool this queue is a worker of, if any. */
+	struct k_work_pool *pool;
+#endif
+};
+
+#if defined(CONFIG_WORK_POOL) || defined(__DOXYGEN__)
+/** @brief A pool of work queues sharing their work. */
+struct k_work_pool {
+	/* One work queue per worker thread. */
+	struct k_work_q *workers;
+
+	/* Worker thread stacks, stack_len bytes apart. */
+	k_thread_stack_t *stacks;
+	size_t stack_len;
+	size_t stack_size;
+
+	/* Number of workers. */
+	uint32_t num_workers;
+
+	/* Worker the next item submitted from outside the pool goes to. */
+	atomic_t next_worker;
 };
 
+/**
+ * @brief Statically define a work queue pool.
+ *
+ * The pool must be started with k_work_pool_start() before use.
+ *
+ * @param name Name of the pool.
+ * @param n_workers Number of worker threads.
+ * @param stack_sz Stack size of each worker thread, in bytes.
+ */
+#define K_WORK_POOL_DEFINE(name, n_workers, stack_sz)			\
+	static K_KERNEL_STACK_ARRAY_DEFINE(_wpstacks_##name,		\
+					   n_workers, stack_sz);	\
+	static struct k_work_q _wpworkers_##name[n_workers];		\
+	static struct k_work_pool name = {				\
+		.workers = _wpworkers_##name,				\
+		.stacks = &(_wpstacks_##name[0][0]),			\
+		.stack_len = Z_KERNEL_STACK_LEN(stack_sz),		\
+		.stack_size = stack_sz,					\
+		.num_workers = n_workers,				\
+	}
+#endif /* CONFIG_WORK_POOL */
+
 /* Provide the implementation for inline functions declared above */
 
 static inline bool k_work_is_pending(const struct k_work *work)
@@ -5062,6 +5377,15 @@ struct k_mem_slab_info {
 #endif
 };
 
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+/* Per-CPU cache of free blocks in front of a memory slab */
+struct z_mem_slab_cache {
+	struct k_spinlock lock;
+	char *free_list;
+	uint32_t count;
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
 	struct k_spinlock lock;
@@ -5074,6 +5398,15 @@ struct k_mem_slab {
 #ifdef CONFIG_OBJ_CORE_MEM_SLAB
 	struct k_obj_core  obj_core;
 #endif
+
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+	/* info.num_used also counts the blocks held in the caches.
+	 * cache_waiters is the number of threads blocked on the slab,
+	 * while non-zero frees bypass the caches.
+	 */
+	uint32_t cache_waiters;
+	struct z_mem_slab_cache cache[CONFIG_MP_MAX_NUM_CPUS];
+#endif
 };
 
 #define Z_MEM_SLAB_INITIALIZER(_slab, _slab_buffer, _slab_block_size, \
@@ -5210,6 +5543,11 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem,
  */
 void k_mem_slab_free(struct k_mem_slab *slab, void *mem);
 
+/* private, used by k_mem_slab_num_used_get() */
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+uint32_t z_mem_slab_num_used(struct k_mem_slab *slab);
+#endif
+
 /**
  * @brief Get the number of used blocks in a memory slab.
  *
@@ -5222,7 +5560,11 @@ void k_mem_slab_free(struct k_mem_slab *slab, void *mem);
  */
 static inline uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+	return z_mem_slab_num_used(slab);
+#else
 	return slab->info.num_used;
+#endif
 }
 
 /**
@@ -5257,7 +5599,7 @@ static inline uint32_t k_mem_slab_max_used_get(struct k_mem_slab *slab)
  */
 static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->info.num_blocks - slab->info.num_used;
+	return slab->info.num_blocks - k_mem_slab_num_used_get(slab);
 }
 
 /**
@@ -5804,8 +6146,8 @@ __syscall void k_poll_signal_check(struct k_poll_signal *sig,
  * @brief Signal a poll signal object.
  *
  * This routine makes ready a poll signal, which is basically a poll event of
- * type K_POLL_TYPE_SIGNAL. If a thread was polling on that event, it will be
- * made ready to run. A @a result value can be specified.
+ * type K_POLL_TYPE_SIGNAL. Every thread polling on that event is made ready
+ * to run. A @a result value can be specified.
  *
  * The poll signal contains a 'signaled' field that, when set by
  * k_poll_signal_raise(), stays set until the user sets it back to 0 with
@@ -117,6 +117,11 @@ struct _thread_base {
 	/* Recursive count of irq_lock() calls */
 	uint8_t global_lock_count;
 
+#ifdef CONFIG_SCHED_WORK_STEALING
+	/* CPU whose ready queue holds this thread while it is queued */
+	uint8_t runq_cpu;
+#endif
+
 #endif
 
 #ifdef CONFIG_SCHED_CPU_MASK
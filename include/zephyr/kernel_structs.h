@@ -121,9 +121,8 @@ struct _priq_rb {
 /* Traditional/textbook "multi-queue" structure.  Separate lists for a
  * small number (max 32 here) of fixed priorities.  This corresponds
  * to the original Zephyr scheduler.  RAM requirements are
- * comparatively high, but performance is very fast.  Won't work with
- * features like deadline scheduling which need large priority spaces
- * to represent their requirements.
+ * comparatively high, but performance is very fast.  With deadline
+ * scheduling each list is kept sorted by deadline.
  */
 struct _priq_mq {
 	sys_dlist_t queues[K_NUM_THREAD_PRIO];
@@ -164,7 +163,7 @@ struct _cpu {
 	/* one assigned idle thread per CPU */
 	struct k_thread *idle_thread;
 
-#ifdef CONFIG_SCHED_CPU_MASK_PIN_ONLY
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
 	struct _ready_q ready_q;
 #endif
 
@@ -220,7 +219,7 @@ struct z_kernel {
 	 * ready queue: can be big, keep after small fields, since some
 	 * assembly (e.g. ARC) are limited in the encoding of the offset
 	 */
-#ifndef CONFIG_SCHED_CPU_MASK_PIN_ONLY
+#ifndef CONFIG_SCHED_PER_CPU_RUNQ
 	struct _ready_q ready_q;
 #endif
 
@@ -307,7 +306,10 @@ struct _timeout {
 	sys_dnode_t node;
 	_timeout_func_t fn;
 #ifdef CONFIG_TIMEOUT_64BIT
-	/* Can't use k_ticks_t for header dependency reasons */
+	/* Can't use k_ticks_t for header dependency reasons.  Holds the
+	 * absolute expiry tick instead of a delta with
+	 * CONFIG_TIMEOUT_QUEUE_WHEEL.
+	 */
 	int64_t dticks;
 #else
 	int32_t dticks;
@@ -1315,6 +1315,31 @@ struct net_buf * __must_check net_buf_alloc_with_data(struct net_buf_pool *pool,
 						      k_timeout_t timeout);
 #endif
 
+/**
+ * @brief Allocate several buffers from a pool in one call.
+ *
+ * Takes up to @a count buffers off the pool in one pass, each with
+ * @a size bytes of data like net_buf_alloc_len(). This is meant for
+ * receivers that keep a set of buffers ready, and refill it in bulk.
+ *
+ * Only waits if no buffer at all is free, in which case at most one
+ * buffer is allocated.
+ *
+ * @param pool Which pool to allocate the buffers from.
+ * @param size Amount of data each buffer must be able to fit.
+ * @param bufs Array receiving the allocated buffers.
+ * @param count Number of entries in @a bufs.
+ * @param timeout Affects the action taken should the pool be empty.
+ *        If K_NO_WAIT, then return immediately. If K_FOREVER, then
+ *        wait as long as necessary. Otherwise, wait until the specified
+ *        timeout.
+ *
+ * @return Number of buffers allocated, 0 if out of buffers.
+ */
+int __must_check net_buf_alloc_batch(struct net_buf_pool *pool, size_t size,
+				     struct net_buf **bufs, int count,
+				     k_timeout_t timeout);
+
 /**
  * @brief Get a buffer from a FIFO.
  *
@@ -182,6 +182,11 @@ enum ethernet_hw_caps {
 
 	/** TX-Injection supported */
 	ETHERNET_TXINJECTION_MODE	= BIT(20),
+
+	/** TCP segmentation offload, the driver splits TCP packets larger
+	 * than the MTU into segments of net_pkt_gso_size() bytes of payload
+	 */
+	ETHERNET_HW_TX_TSO		= BIT(21),
 };
 
 /** @cond INTERNAL_HIDDEN */
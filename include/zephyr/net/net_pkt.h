@@ -261,6 +261,13 @@ struct net_pkt {
 	/** IPv4/IPv6 Explicit Congestion Notification value. */
 	uint8_t ip_ecn : 2;
 #endif /* CONFIG_NET_IP_DSCP_ECN */
+
+#if defined(CONFIG_NET_TCP_GSO)
+	/* Payload size of the segments a TCP super-packet is split into
+	 * before being given to L2, 0 if it is a regular packet.
+	 */
+	uint16_t gso_size;
+#endif /* CONFIG_NET_TCP_GSO */
 #endif /* CONFIG_NET_IP */
 
 #if defined(CONFIG_NET_VLAN)
@@ -437,6 +444,27 @@ static inline void net_pkt_set_ip_hdr_len(struct net_pkt *pkt, uint8_t len)
 #endif
 }
 
+static inline uint16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_TCP_GSO)
+	return pkt->gso_size;
+#else
+	ARG_UNUSED(pkt);
+
+	return 0;
+#endif
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, uint16_t size)
+{
+#if defined(CONFIG_NET_TCP_GSO)
+	pkt->gso_size = size;
+#else
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(size);
+#endif
+}
+
 static inline uint8_t net_pkt_ip_dscp(struct net_pkt *pkt)
 {
 #if defined(CONFIG_NET_IP_DSCP_ECN)
@@ -1879,6 +1907,50 @@ struct net_pkt *net_pkt_rx_alloc_with_buffer(struct net_if *iface,
 					     k_timeout_t timeout);
 #endif
 
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE) || defined(__DOXYGEN__)
+/**
+ * @brief Cache of RX data buffers.
+ *
+ * Owned by a single receiver, typically the RX path of a network driver,
+ * and not locked. It is refilled from the RX buffer pool several buffers
+ * at a time.
+ */
+struct net_pkt_buf_cache {
+	/** Cached buffers */
+	struct net_buf *bufs[CONFIG_NET_PKT_BUF_RX_CACHE_SIZE];
+	/** Number of cached buffers */
+	uint8_t count;
+};
+
+/**
+ * @brief Allocate a RX network packet with buffers from a cache
+ *
+ * @details Same as net_pkt_rx_alloc_with_buffer() for a frame of @a size
+ *          bytes, without any header space estimation, but the buffers
+ *          are taken from @a cache. When the cache runs short, it is
+ *          refilled with net_buf_alloc_batch(), and if the RX buffer
+ *          pool cannot provide enough buffers right away, the packet is
+ *          allocated as with net_pkt_rx_alloc_with_buffer().
+ *
+ * @param iface   The network interface the packet is received on.
+ * @param cache   Buffer cache of the receiver.
+ * @param size    The size of buffer.
+ * @param timeout Maximum time to wait for an allocation.
+ *
+ * @return a pointer to a newly allocated net_pkt on success, NULL otherwise.
+ */
+struct net_pkt *net_pkt_rx_alloc_from_cache(struct net_if *iface,
+					    struct net_pkt_buf_cache *cache,
+					    size_t size, k_timeout_t timeout);
+
+/**
+ * @brief Give the buffers of a RX buffer cache back to the pool
+ *
+ * @param cache Buffer cache to empty.
+ */
+void net_pkt_buf_cache_flush(struct net_pkt_buf_cache *cache);
+#endif /* CONFIG_NET_PKT_BUF_RX_CACHE */
+
 /**
  * @brief Append a buffer in packet
  *
@@ -274,6 +274,18 @@ struct net_stats_tc {
 	} recv[NET_TC_RX_STATS_COUNT];
 };
 
+/**
+ * @brief RX steering queue statistics
+ */
+struct net_stats_rx_queue {
+	/** Number of packets put in the queue */
+	net_stats_t pkts;
+
+	/** Number of bytes put in the queue */
+	net_stats_t bytes;
+};
+
+
 
 /**
  * @brief Power management statistics
@@ -347,6 +359,11 @@ struct net_stats {
 	struct net_stats_tc tc;
 #endif
 
+#if defined(CONFIG_NET_TC_RX_STEERING)
+	/** RX steering queue statistics */
+	struct net_stats_rx_queue rx_queue[CONFIG_NET_TC_RX_STEERING_QUEUES];
+#endif
+
 #if defined(CONFIG_NET_PKT_TXTIME_STATS)
 	/** Network packet TX time statistics */
 	struct net_stats_tx_time tx_time;
@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <errno.h>
 #include <sys/types.h>
 #include <zephyr/types.h>
 #include <zephyr/net/net_ip.h>
@@ -65,6 +66,48 @@ struct zsock_pollfd {
 #define ZSOCK_POLLNVAL 0x20
 /** @} */
 
+/**
+ * @name Options for epoll
+ * @{
+ */
+/** zsock_epoll_ctl: Register a socket */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: Remove a registration */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: Change the events and data of a registration */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/* ZSOCK_EPOLL* event values are compatible with Linux */
+/** zsock_epoll_wait: Socket is readable */
+#define ZSOCK_EPOLLIN ZSOCK_POLLIN
+/** zsock_epoll_wait: Exceptional condition */
+#define ZSOCK_EPOLLPRI ZSOCK_POLLPRI
+/** zsock_epoll_wait: Socket is writable */
+#define ZSOCK_EPOLLOUT ZSOCK_POLLOUT
+/** zsock_epoll_wait: Error condition (always reported) */
+#define ZSOCK_EPOLLERR ZSOCK_POLLERR
+/** zsock_epoll_wait: Connection closed (always reported) */
+#define ZSOCK_EPOLLHUP ZSOCK_POLLHUP
+/** zsock_epoll_ctl: Disable the registration once it was reported */
+#define ZSOCK_EPOLLONESHOT BIT(30)
+/** zsock_epoll_ctl: Report state changes only (edge-triggered) */
+#define ZSOCK_EPOLLET BIT(31)
+/** @} */
+
+/** User data of an epoll registration, returned with its events */
+union zsock_epoll_data {
+	void *ptr;     /**< Pointer */
+	int fd;        /**< File descriptor */
+	uint32_t u32;  /**< 32-bit value */
+	uint64_t u64;  /**< 64-bit value */
+};
+
+/** Events and user data of an epoll registration */
+struct zsock_epoll_event {
+	uint32_t events;             /**< ZSOCK_EPOLL* event mask */
+	union zsock_epoll_data data; /**< User data */
+};
+
 /**
  * @name Options for sending and receiving data
  * @{
@@ -82,6 +125,8 @@ struct zsock_pollfd {
 #define ZSOCK_MSG_DONTWAIT 0x40
 /** zsock_recv: block until the full amount of data can be returned */
 #define ZSOCK_MSG_WAITALL 0x100
+/** zsock_recvmmsg: block for the first message only */
+#define ZSOCK_MSG_WAITFORONE 0x10000
 /** @} */
 
 /**
@@ -529,6 +574,103 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
  */
 __syscall ssize_t zsock_recvmsg(int sock, struct msghdr *msg, int flags);
 
+/**
+ * @brief Send multiple messages on a socket
+ *
+ * @details
+ * Sends up to @p vlen messages with a single call, as if
+ * @ref zsock_sendmsg was called for each of them, but the socket is
+ * looked up and locked only once.  The number of bytes sent for each
+ * message is stored in its @c msg_len field.  Sending stops at the first
+ * message that fails; the error is reported only if no message was sent.
+ *
+ * @rst
+ * This function is also exposed as ``sendmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages sent, or -1 with errno set on error.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive multiple messages from a socket
+ *
+ * @details
+ * Receives up to @p vlen messages with a single call, as if
+ * @ref zsock_recvmsg was called for each of them, but the socket is
+ * looked up and locked only once.  The length of each message is stored
+ * in its @c msg_len field.  With @ref ZSOCK_MSG_WAITFORONE, only the
+ * first message is waited for and the call returns as soon as no more
+ * data is queued.  Receiving stops at the first message that fails; the
+ * error is reported only if no message was received.
+ *
+ * @rst
+ * This function is also exposed as ``recvmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages received, or -1 with errno set on error.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/** Network buffers lent out by @ref zsock_recvmsg_zc */
+struct zsock_zc_ref {
+	/** @cond INTERNAL_HIDDEN */
+	struct net_pkt *pkt;
+	size_t len;
+	/** @endcond */
+};
+
+/**
+ * @brief Receive data without copying it
+ *
+ * @details
+ * Like @ref zsock_recvmsg, but instead of copying the data into the
+ * buffers of @p msg, the @c iov_base and @c iov_len of its @c msg_iov
+ * entries are set to point to the network buffers holding it, and
+ * @c msg_iovlen to the number of entries used.  The buffers are lent to
+ * the caller until released with @ref zsock_recv_zc_release, which must
+ * be called once for every successful call.
+ *
+ * For a datagram socket, one datagram is returned.  If it spans more
+ * buffers than @c msg_iovlen, the rest is discarded and
+ * @ref ZSOCK_MSG_TRUNC is set in @c msg_flags.  For a stream socket,
+ * the data of at most @c msg_iovlen buffers is returned and the rest
+ * stays queued; the TCP receive window is only reopened once the data
+ * is released.  Ancillary data and @ref ZSOCK_MSG_PEEK are not
+ * supported.
+ *
+ * Only available for native TCP and UDP sockets, from kernel mode, with
+ * :kconfig:option:`CONFIG_NET_SOCKETS_RECV_ZEROCOPY`.
+ *
+ * @param sock Socket
+ * @param msg Message header, the @c msg_iov entries are overwritten
+ * @param ref Reference to pass to @ref zsock_recv_zc_release
+ * @param flags Receive flags
+ *
+ * @return Number of bytes received, 0 at end of stream, or -1 with
+ *         errno set on error.
+ */
+ssize_t zsock_recvmsg_zc(int sock, struct msghdr *msg,
+			 struct zsock_zc_ref *ref, int flags);
+
+/**
+ * @brief Release data received with @ref zsock_recvmsg_zc
+ *
+ * @details
+ * The buffers are freed even if the socket was closed meanwhile, in
+ * which case -1 is returned with errno set to EBADF.
+ *
+ * @param sock Socket the data was received from
+ * @param ref Reference filled by @ref zsock_recvmsg_zc
+ *
+ * @return 0 on success, or -1 with errno set on error.
+ */
+int zsock_recv_zc_release(int sock, struct zsock_zc_ref *ref);
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -595,6 +737,71 @@ __syscall int zsock_ioctl(int sock, unsigned long request, va_list ap);
  */
 __syscall int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout);
 
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * An epoll instance keeps a set of sockets registered with
+ * @ref zsock_epoll_ctl and returns the ones that are ready from
+ * @ref zsock_epoll_wait.  Unlike @ref zsock_poll, the registrations
+ * persist between waits and native sockets signal the instance when
+ * their state changes, so a wait only looks at the sockets that
+ * signalled it instead of at all of them.  Other descriptors, such as
+ * TLS sockets or an eventfd, are polled on every wait.
+ *
+ * The instance is a file descriptor, which can itself be polled for
+ * @ref ZSOCK_POLLIN and is closed with @ref zsock_close.
+ *
+ * Only available from kernel mode, with
+ * :kconfig:option:`CONFIG_NET_SOCKETS_EPOLL`.
+ *
+ * @param size Ignored, but must be greater than zero
+ *
+ * @return File descriptor of the instance, or -1 with errno set on error.
+ */
+int zsock_epoll_create(int size);
+
+/**
+ * @brief Add, modify or remove a socket of an epoll instance
+ *
+ * @details
+ * @ref ZSOCK_EPOLLERR and @ref ZSOCK_EPOLLHUP are always reported.  By
+ * default a registration is level-triggered: it is returned by every
+ * wait while the socket is ready.  With @ref ZSOCK_EPOLLET it is only
+ * returned once after the socket signalled new data, a new connection,
+ * more send window or a state change; this is only supported for native
+ * sockets, others are always level-triggered.  With
+ * @ref ZSOCK_EPOLLONESHOT the registration is disabled once returned
+ * until re-armed with @ref ZSOCK_EPOLL_CTL_MOD.
+ *
+ * A native socket is removed from all instances when it is closed.
+ * Other descriptors must be removed before they are closed.
+ *
+ * @param epfd Epoll instance
+ * @param op @ref ZSOCK_EPOLL_CTL_ADD, @ref ZSOCK_EPOLL_CTL_MOD or
+ *        @ref ZSOCK_EPOLL_CTL_DEL
+ * @param fd Socket or file descriptor
+ * @param event Events to wait for and user data, ignored for
+ *        @ref ZSOCK_EPOLL_CTL_DEL
+ *
+ * @return 0 on success, or -1 with errno set on error.
+ */
+int zsock_epoll_ctl(int epfd, int op, int fd, struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for sockets of an epoll instance to become ready
+ *
+ * @param epfd Epoll instance
+ * @param events Returned events and the user data of their registration
+ * @param maxevents Maximum number of entries to return in @p events
+ * @param timeout Timeout in milliseconds, -1 to wait forever
+ *
+ * @return Number of entries returned in @p events, 0 on timeout, or -1
+ *         with errno set on error.
+ */
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout);
+
 /**
  * @brief Get various socket options
  *
@@ -937,6 +1144,13 @@ static inline ssize_t sendmsg(int sock, const struct msghdr *message,
 	return zsock_sendmsg(sock, message, flags);
 }
 
+/** POSIX wrapper for @ref zsock_sendmmsg */
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
 /** POSIX wrapper for @ref zsock_recvfrom */
 static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 			       struct sockaddr *src_addr, socklen_t *addrlen)
@@ -950,6 +1164,20 @@ static inline ssize_t recvmsg(int sock, struct msghdr *msg, int flags)
 	return zsock_recvmsg(sock, msg, flags);
 }
 
+struct timespec;
+
+/** POSIX wrapper for @ref zsock_recvmmsg, the timeout is not supported */
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec, unsigned int vlen,
+			   int flags, struct timespec *timeout)
+{
+	if (timeout != NULL) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 /** POSIX wrapper for @ref zsock_poll */
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
@@ -1056,6 +1284,8 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 /** POSIX wrapper for @ref ZSOCK_MSG_WAITALL */
 #define MSG_WAITALL ZSOCK_MSG_WAITALL
+/** POSIX wrapper for @ref ZSOCK_MSG_WAITFORONE */
+#define MSG_WAITFORONE ZSOCK_MSG_WAITFORONE
 
 /** POSIX wrapper for @ref ZSOCK_SHUT_RD */
 #define SHUT_RD ZSOCK_SHUT_RD
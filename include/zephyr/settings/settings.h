@@ -232,6 +232,15 @@ int settings_subsys_init(void);
  */
 int settings_register(struct settings_handler *cf);
 
+/**
+ * Deregister a handler registered with @ref settings_register.
+ *
+ * @param cf Structure containing registration info.
+ *
+ * @return true if the handler was registered, false otherwise.
+ */
+bool settings_deregister(struct settings_handler *cf);
+
 /**
  * Load serialized items from registered persistence sources. Handlers for
  * serialized item subtrees registered earlier will be called for encountered
@@ -107,6 +107,31 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
  */
 int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buff);
 
+/**
+ * @brief Get the block cache statistics of a disk
+ *
+ * Available with @kconfig{CONFIG_DISK_CACHE}. The hit rate of the cache is
+ * hits / (hits + misses).
+ *
+ * @param[in] pdrv          Disk name
+ * @param[out] stats        Statistics since the disk was registered or the
+ *                          last disk_access_cache_stats_reset()
+ *
+ * @return 0 on success, negative errno code on fail
+ */
+int disk_access_cache_stats_get(const char *pdrv, struct disk_cache_stats *stats);
+
+/**
+ * @brief Reset the block cache statistics of a disk
+ *
+ * Available with @kconfig{CONFIG_DISK_CACHE}.
+ *
+ * @param[in] pdrv          Disk name
+ *
+ * @return 0 on success, negative errno code on fail
+ */
+int disk_access_cache_stats_reset(const char *pdrv);
+
 #ifdef __cplusplus
 }
 #endif
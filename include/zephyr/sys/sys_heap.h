@@ -10,6 +10,9 @@
 #include <stdbool.h>
 #include <zephyr/types.h>
 #include <zephyr/sys/mem_stats.h>
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+#include <zephyr/spinlock.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,10 +56,45 @@ extern "C" {
  * put the two values somewhere else, though it would make
  * SYS_HEAP_DEFINE a little hairy to write.
  */
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+/* One size class per 8 byte chunk size up to
+ * CONFIG_SYS_HEAP_SIZE_CLASS_MAX, see lib/heap/heap.h.  These live
+ * outside the heap memory so they don't change its minimum size.
+ */
+#define Z_HEAP_SIZE_CLASSES ((CONFIG_SYS_HEAP_SIZE_CLASS_MAX + 7) / 8 + 1)
+
+struct z_heap_classes {
+	uint32_t next[Z_HEAP_SIZE_CLASSES];
+	uint8_t count[Z_HEAP_SIZE_CLASSES];
+};
+#endif
+
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+struct z_heap_cpu_cache {
+	struct k_spinlock lock;
+	struct z_heap_classes classes;
+};
+#endif
+
 struct sys_heap {
 	struct z_heap *heap;
 	void *init_mem;
 	size_t init_bytes;
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+	struct z_heap_classes classes;
+#endif
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+	uint32_t cpu_cache_suspended;
+	struct z_heap_cpu_cache cpu_cache[CONFIG_MP_MAX_NUM_CPUS];
+#endif
+};
+
+/* Operation latency distribution, in cycles */
+struct z_heap_stress_latency {
+	uint32_t p50;
+	uint32_t p90;
+	uint32_t p99;
+	uint32_t max;
 };
 
 struct z_heap_stress_result {
@@ -64,6 +102,8 @@ struct z_heap_stress_result {
 	uint32_t successful_allocs;
 	uint32_t total_frees;
 	uint64_t accumulated_in_use_bytes;
+	struct z_heap_stress_latency alloc_latency;
+	struct z_heap_stress_latency free_latency;
 };
 
 #ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
@@ -195,6 +235,56 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
  */
 size_t sys_heap_usable_size(struct sys_heap *heap, void *mem);
 
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+
+/** @brief Allocate a small block from the current CPU's cache
+ *
+ * Pops a chunk of the size class matching @a bytes from the calling
+ * CPU's cache, without touching the rest of the heap.  Unlike the
+ * other sys_heap functions, this one and sys_heap_cpu_cache_free()
+ * may run concurrently with each other and with any other sys_heap
+ * call made under the user's lock.
+ *
+ * @param heap Heap from which to allocate
+ * @param align Alignment, as for sys_heap_aligned_alloc()
+ * @param bytes Number of bytes requested
+ * @return Pointer to memory the caller can now use, or NULL if the
+ *         request is too big, needs more alignment than chunks
+ *         naturally have, or the cache has no such block
+ */
+void *sys_heap_cpu_cache_alloc(struct sys_heap *heap, size_t align, size_t bytes);
+
+/** @brief Free a small block into the current CPU's cache
+ *
+ * Same synchronization rules as sys_heap_cpu_cache_alloc().
+ *
+ * @param heap Heap to which to return the memory
+ * @param mem A pointer previously returned from this heap
+ * @return true if the block was cached, false if it must be freed
+ *         with sys_heap_free() instead
+ */
+bool sys_heap_cpu_cache_free(struct sys_heap *heap, void *mem);
+
+/** @brief Stop caching freed blocks on all CPUs
+ *
+ * Drains all the per-CPU caches back into the heap, and makes
+ * sys_heap_cpu_cache_free() refuse every block until the matching
+ * sys_heap_cpu_cache_resume().  Used by callers about to wait for
+ * memory to be freed.  Calls nest, and must be made under the user's
+ * lock like the rest of the sys_heap API.
+ *
+ * @param heap Heap to operate on
+ */
+void sys_heap_cpu_cache_suspend(struct sys_heap *heap);
+
+/** @brief Undo one sys_heap_cpu_cache_suspend()
+ *
+ * @param heap Heap to operate on
+ */
+void sys_heap_cpu_cache_resume(struct sys_heap *heap);
+
+#endif /* CONFIG_SYS_HEAP_PERCPU_CACHE */
+
 /** @brief Validate heap integrity
  *
  * Validates the internal integrity of a sys_heap.  Intended for unit
@@ -237,7 +327,10 @@ bool sys_heap_validate(struct sys_heap *heap);
  *                       random allocation choices will seek.  High
  *                       values will result in significant allocation
  *                       failures and a very fragmented heap.
- * @param result Struct into which to store test results.
+ * @param result Struct into which to store test results.  The
+ *               latency percentiles are measured around the callbacks
+ *               with k_cycle_get_32() and are accurate to within
+ *               about 12%.
  */
 void sys_heap_stress(void *(*alloc_fn)(void *arg, size_t bytes),
 		     void (*free_fn)(void *arg, void *p),
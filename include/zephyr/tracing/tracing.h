@@ -1001,6 +1001,19 @@
  */
 #define sys_port_trace_k_queue_merge_slist_exit(queue, ret)
 
+/**
+ * @brief Trace Queue prepend list enter
+ * @param queue Queue object
+ */
+#define sys_port_trace_k_queue_prepend_list_enter(queue)
+
+/**
+ * @brief Trace Queue prepend list exit
+ * @param queue Queue object
+ * @param ret Return value
+ */
+#define sys_port_trace_k_queue_prepend_list_exit(queue, ret)
+
 /**
  * @brief Trace Queue get attempt enter
  * @param queue Queue object
@@ -1230,6 +1243,20 @@
  */
 #define sys_port_trace_k_lifo_put_exit(lifo, data)
 
+/**
+ * @brief Trace LIFO Queue put slist entry
+ * @param lifo LIFO object
+ * @param list Syslist object
+ */
+#define sys_port_trace_k_lifo_put_slist_enter(lifo, list)
+
+/**
+ * @brief Trace LIFO Queue put slist exit
+ * @param lifo LIFO object
+ * @param list Syslist object
+ */
+#define sys_port_trace_k_lifo_put_slist_exit(lifo, list)
+
 /**
  * @brief Trace LIFO Queue alloc put entry
  * @param lifo LIFO object
@@ -155,20 +155,26 @@ static uint32_t k_event_post_internal(struct k_event *event, uint32_t events,
 	 * 1. Walk the waitq and create a linked list of threads to unpend.
 	 * 2. Unpend each of the threads in the linked list
 	 * 3. Ready each of the threads in the linked list
+	 *
+	 * Steps 2 and 3 are done in batches of Z_SCHED_WAKE_BATCH threads,
+	 * each under one hold of the scheduler lock.
 	 */
 
 	z_sched_waitq_walk(&event->wait_q, event_walk_op, &data);
 
-	if (data.head != NULL) {
-		thread = data.head;
-		struct k_thread *next;
+	thread = data.head;
+	while (thread != NULL) {
+		struct k_thread *batch[Z_SCHED_WAKE_BATCH];
+		size_t count = 0;
+
 		do {
 			arch_thread_return_value_set(thread, 0);
 			thread->events = events;
-			next = thread->next_event_link;
-			z_sched_wake_thread(thread, false);
-			thread = next;
-		} while (thread != NULL);
+			batch[count++] = thread;
+			thread = thread->next_event_link;
+		} while ((thread != NULL) && (count < ARRAY_SIZE(batch)));
+
+		z_sched_wake_threads(batch, count);
 	}
 
 	z_reschedule(&event->lock, key);
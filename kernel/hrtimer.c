@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * High-resolution timers.  Timers are kept on a list sorted by their
+ * absolute expiry in hardware cycles.  Only the earliest one is known
+ * to the system timer: drivers with cycle deadline support are asked to
+ * interrupt at exactly that cycle count, with the others a kernel
+ * timeout is set for the first tick at or after it.  Either way the
+ * expired timers are run from the system clock interrupt.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/drivers/timer/system_timer.h>
+#include <timeout_q.h>
+
+static sys_dlist_t hrtimer_list = SYS_DLIST_STATIC_INIT(&hrtimer_list);
+
+static struct k_spinlock hrtimer_lock;
+
+#ifndef CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE
+static struct _timeout hrtimer_timeout;
+#endif
+
+static struct k_hrtimer *first(void)
+{
+	sys_dnode_t *n = sys_dlist_peek_head(&hrtimer_list);
+
+	return n == NULL ? NULL : CONTAINER_OF(n, struct k_hrtimer, node);
+}
+
+/* Timers expiring on the same cycle run in the order they were started */
+static void insert_locked(struct k_hrtimer *timer)
+{
+	struct k_hrtimer *t;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&hrtimer_list, t, node) {
+		if (t->expiry > timer->expiry) {
+			sys_dlist_insert(&t->node, &timer->node);
+			return;
+		}
+	}
+
+	sys_dlist_append(&hrtimer_list, &timer->node);
+}
+
+#ifndef CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE
+static void hrtimer_timeout_fn(struct _timeout *to)
+{
+	ARG_UNUSED(to);
+
+	z_hrtimer_announce();
+}
+#endif
+
+/* Tell the system timer about the earliest expiry */
+static void program_locked(void)
+{
+	struct k_hrtimer *t = first();
+
+#ifdef CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE
+	sys_clock_set_cycle_deadline(t == NULL ? UINT64_MAX : t->expiry);
+#else
+	(void)z_abort_timeout(&hrtimer_timeout);
+
+	if (t != NULL) {
+		uint64_t now = k_cycle_get_64();
+		uint64_t dt = (t->expiry > now) ? (t->expiry - now) : 0U;
+		uint64_t ticks = MIN(k_cyc_to_ticks_ceil64(dt), INT32_MAX);
+
+		/* Expiries beyond the range of a timeout are reached in
+		 * several steps, z_hrtimer_announce() reprograms.
+		 */
+		z_add_timeout(&hrtimer_timeout, hrtimer_timeout_fn,
+			      K_TICKS(ticks));
+	}
+#endif
+}
+
+void z_hrtimer_announce(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&hrtimer_lock);
+	uint64_t now = k_cycle_get_64();
+	struct k_hrtimer *t;
+
+	for (t = first(); (t != NULL) && (t->expiry <= now); t = first()) {
+		sys_dlist_remove(&t->node);
+
+		/* Periodic timers are requeued before their expiry function
+		 * runs, so it can stop or restart them.
+		 */
+		if (t->period != 0U) {
+			t->expiry += t->period;
+			if (t->expiry <= now) {
+				t->expiry += ((now - t->expiry) / t->period + 1U)
+					     * t->period;
+			}
+			insert_locked(t);
+		}
+
+		k_spin_unlock(&hrtimer_lock, key);
+		t->expiry_fn(t);
+		key = k_spin_lock(&hrtimer_lock);
+
+		now = k_cycle_get_64();
+	}
+
+	program_locked();
+
+	k_spin_unlock(&hrtimer_lock, key);
+}
+
+void k_hrtimer_init(struct k_hrtimer *timer, k_hrtimer_expiry_t expiry_fn)
+{
+	__ASSERT_NO_MSG(expiry_fn != NULL);
+
+	sys_dnode_init(&timer->node);
+	timer->expiry = 0U;
+	timer->period = 0U;
+	timer->expiry_fn = expiry_fn;
+	timer->user_data = NULL;
+}
+
+void k_hrtimer_start(struct k_hrtimer *timer, uint64_t expiry,
+		     uint64_t period)
+{
+	K_SPINLOCK(&hrtimer_lock) {
+		struct k_hrtimer *head = first();
+
+		if (sys_dnode_is_linked(&timer->node)) {
+			sys_dlist_remove(&timer->node);
+		}
+
+		timer->expiry = expiry;
+		timer->period = period;
+		insert_locked(timer);
+
+		if ((head != first()) || (head == timer)) {
+			program_locked();
+		}
+	}
+}
+
+bool k_hrtimer_stop(struct k_hrtimer *timer)
+{
+	bool ret = false;
+
+	K_SPINLOCK(&hrtimer_lock) {
+		if (sys_dnode_is_linked(&timer->node)) {
+			bool was_first = (timer == first());
+
+			sys_dlist_remove(&timer->node);
+			ret = true;
+
+			if (was_first) {
+				program_locked();
+			}
+		}
+	}
+
+	return ret;
+}
+
+uint64_t k_hrtimer_expires_get(struct k_hrtimer *timer)
+{
+	uint64_t ret = 0U;
+
+	K_SPINLOCK(&hrtimer_lock) {
+		if (sys_dnode_is_linked(&timer->node)) {
+			ret = timer->expiry;
+		}
+	}
+
+	return ret;
+}
@@ -310,31 +310,78 @@ bool z_sched_wake(_wait_q_t *wait_q, int swap_retval, void *swap_data);
  */
 void z_sched_wake_thread(struct k_thread *thread, bool is_timeout);
 
+/* Batch size callers use for z_sched_wake_threads(), big enough to
+ * amortize the scheduler lock, small enough to keep on the stack.
+ */
+#define Z_SCHED_WAKE_BATCH 8
+
 /**
- * Wake up all threads pending on the provided wait queue
+ * Wakes a batch of threads
  *
- * Convenience function to invoke z_sched_wake() on all threads in the queue
- * until there are no more to wake up.
+ * Equivalent to calling z_sched_wake_thread(thread, false) on each of the
+ * given threads, but all of them are readied under a single hold of the
+ * scheduler lock, and the ready queue cache update and the IPI to other
+ * CPUs happen once for the whole batch instead of once per thread.
  *
- * @param wait_q Wait queue to wake up the highest prio thread
- * @param swap_retval Swap return value for woken thread
- * @param swap_data Data return value to supplement swap_retval. May be NULL.
- * @retval true If any threads were woken up
- * @retval false If the wait_q was empty
+ * @param threads Threads to wake up
+ * @param count Number of entries in @a threads
+ */
+void z_sched_wake_threads(struct k_thread **threads, size_t count);
+
+#ifdef CONFIG_ADAPTIVE_SPIN
+/**
+ * Checks whether a thread is running on another CPU
+ *
+ * Used by blocking primitives to decide whether spinning for a resource
+ * is worthwhile.  The answer is a snapshot taken without the scheduler
+ * lock and may be stale by the time the caller looks at it.
+ *
+ * @param thread Thread to look for, or NULL for any thread other than
+ *        an idle thread
+ * @return true if @a thread is the current thread of another CPU
+ */
+bool z_thread_running_elsewhere(struct k_thread *thread);
+
+/* Cycles a contended waiter may spin before it pends, so that spinning
+ * never eats past the deadline of the caller's timeout.
  */
-static inline bool z_sched_wake_all(_wait_q_t *wait_q, int swap_retval,
-				    void *swap_data)
+static inline uint32_t z_spin_budget(k_timepoint_t end)
 {
-	bool woken = false;
+	k_timeout_t left = sys_timepoint_timeout(end);
+	uint32_t max = k_us_to_cyc_ceil32(CONFIG_ADAPTIVE_SPIN_MAX_US);
 
-	while (z_sched_wake(wait_q, swap_retval, swap_data)) {
-		woken = true;
+	if (!K_TIMEOUT_EQ(left, K_FOREVER)) {
+		max = (uint32_t)MIN(max, k_ticks_to_cyc_floor64(left.ticks));
 	}
 
-	/* True if we woke at least one thread up */
-	return woken;
+	return max;
 }
 
+/* Timeout left to pend with after spinning.  The budget stops short of
+ * the deadline, so this only rounds to K_NO_WAIT within the last tick,
+ * which must still report a timeout and not a failure to wait.
+ */
+static inline k_timeout_t z_spin_timeout_left(k_timepoint_t end)
+{
+	k_timeout_t left = sys_timepoint_timeout(end);
+
+	return K_TIMEOUT_EQ(left, K_NO_WAIT) ? K_TICKS(1) : left;
+}
+#endif
+
+/**
+ * Wake up all threads pending on the provided wait queue
+ *
+ * Same as invoking z_sched_wake() until the queue is empty, but all the
+ * threads are woken as one batch, see z_sched_wake_threads().
+ *
+ * @param wait_q Wait queue to wake up all threads from
+ * @param swap_retval Swap return value for woken threads
+ * @param swap_data Data return value to supplement swap_retval. May be NULL.
+ * @return Number of threads woken up, zero if the wait_q was empty
+ */
+int z_sched_wake_all(_wait_q_t *wait_q, int swap_retval, void *swap_data);
+
 /**
  * Atomically put the current thread to sleep on a wait queue, with timeout
  *
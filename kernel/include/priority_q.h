@@ -90,7 +90,37 @@ static ALWAYS_INLINE void z_priq_mq_add(struct _priq_mq *pq,
 {
 	struct prio_info pos = get_prio_info(thread->base.prio);
 
+#ifdef CONFIG_SCHED_DEADLINE
+	/* Keep each per-priority list sorted by deadline, FIFO among
+	 * equal deadlines.  A newly set deadline is usually the latest
+	 * one around, so search from the tail: that is O(1) in the
+	 * common case, O(n) in the threads of the same priority in the
+	 * worst one, and never walks threads of other priorities.
+	 * Threads of one list share their priority, so only the
+	 * deadlines are compared, as z_sched_prio_cmp() does (which is
+	 * not declared yet where this header is included).
+	 */
+	sys_dlist_t *list = &pq->queues[pos.offset_prio];
+	sys_dnode_t *succ = NULL;
+
+	for (sys_dnode_t *n = sys_dlist_peek_tail(list); n != NULL;
+	     n = sys_dlist_peek_prev(list, n)) {
+		struct k_thread *t = CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
+
+		if ((int32_t)(t->base.prio_deadline - thread->base.prio_deadline) <= 0) {
+			break;
+		}
+		succ = n;
+	}
+
+	if (succ != NULL) {
+		sys_dlist_insert(succ, &thread->base.qnode_dlist);
+	} else {
+		sys_dlist_append(list, &thread->base.qnode_dlist);
+	}
+#else
 	sys_dlist_append(&pq->queues[pos.offset_prio], &thread->base.qnode_dlist);
+#endif
 	pq->bitmask[pos.idx] |= BIT(pos.bit);
 }
 
@@ -58,6 +58,11 @@ int32_t z_get_next_timeout_expiry(void);
 
 k_ticks_t z_timeout_remaining(const struct _timeout *timeout);
 
+#ifdef CONFIG_HRTIMER
+/* Run expired high-resolution timers and program the next expiry */
+void z_hrtimer_announce(void);
+#endif
+
 #else
 
 /* Stubs when !CONFIG_SYS_CLOCK_EXISTS */
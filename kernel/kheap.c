@@ -68,6 +68,15 @@ void *k_heap_aligned_alloc(struct k_heap *heap, size_t align, size_t bytes,
 	k_timepoint_t end = sys_timepoint_calc(timeout);
 	void *ret = NULL;
 
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+	ret = sys_heap_cpu_cache_alloc(&heap->heap, align, bytes);
+	if (ret != NULL) {
+		SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc, heap, timeout);
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, heap, timeout, ret);
+		return ret;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&heap->lock);
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc, heap, timeout);
@@ -87,6 +96,15 @@ void *k_heap_aligned_alloc(struct k_heap *heap, size_t align, size_t bytes,
 		if (!blocked_alloc) {
 			blocked_alloc = true;
 
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+			/* Make sure frees reach the heap and wake us up */
+			sys_heap_cpu_cache_suspend(&heap->heap);
+			ret = sys_heap_aligned_alloc(&heap->heap, align, bytes);
+			if (ret != NULL) {
+				break;
+			}
+#endif
+
 			SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_heap, aligned_alloc, heap, timeout);
 		} else {
 			/**
@@ -99,6 +117,12 @@ void *k_heap_aligned_alloc(struct k_heap *heap, size_t align, size_t bytes,
 		key = k_spin_lock(&heap->lock);
 	}
 
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+	if (blocked_alloc) {
+		sys_heap_cpu_cache_resume(&heap->heap);
+	}
+#endif
+
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, heap, timeout, ret);
 
 	k_spin_unlock(&heap->lock, key);
@@ -118,6 +142,13 @@ void *k_heap_alloc(struct k_heap *heap, size_t bytes, k_timeout_t timeout)
 
 void k_heap_free(struct k_heap *heap, void *mem)
 {
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+	if (sys_heap_cpu_cache_free(&heap->heap, mem)) {
+		SYS_PORT_TRACING_OBJ_FUNC(k_heap, free, heap);
+		return;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&heap->lock);
 
 	sys_heap_free(&heap->heap, mem);
@@ -18,6 +18,173 @@
 #include <ksched.h>
 #include <wait_q.h>
 
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+#define CACHE_BATCH (CONFIG_MEM_SLAB_PERCPU_CACHE_SIZE / 2)
+
+/* Lock ordering: the per-CPU cache locks, in CPU index order, always
+ * come before the slab lock.
+ */
+
+/* Move up to n blocks between two free lists, returns how many moved */
+static uint32_t move_blocks(char **from, char **to, uint32_t n)
+{
+	uint32_t moved = 0U;
+
+	while ((moved < n) && (*from != NULL)) {
+		char *block = *from;
+
+		*from = *(char **)block;
+		*(char **)block = *to;
+		*to = block;
+		moved++;
+	}
+
+	return moved;
+}
+
+static void release_caches(struct k_mem_slab *slab)
+{
+	for (unsigned int i = arch_num_cpus() - 1; i > 0; i--) {
+		k_spin_release(&slab->cache[i].lock);
+	}
+}
+
+/* Locks every cache and then the slab, freezing the accounting */
+static k_spinlock_key_t lock_all(struct k_mem_slab *slab)
+{
+	k_spinlock_key_t key = k_spin_lock(&slab->cache[0].lock);
+	unsigned int num_cpus = arch_num_cpus();
+
+	for (unsigned int i = 1; i < num_cpus; i++) {
+		(void)k_spin_lock(&slab->cache[i].lock);
+	}
+	(void)k_spin_lock(&slab->lock);
+
+	return key;
+}
+
+static void unlock_all(struct k_mem_slab *slab, k_spinlock_key_t key)
+{
+	k_spin_release(&slab->lock);
+	release_caches(slab);
+	k_spin_unlock(&slab->cache[0].lock, key);
+}
+
+/* Blocks held in the caches count as free.  Must hold lock_all() */
+static uint32_t num_used_locked(struct k_mem_slab *slab)
+{
+	uint32_t used = slab->info.num_used;
+	unsigned int num_cpus = arch_num_cpus();
+
+	for (unsigned int i = 0; i < num_cpus; i++) {
+		used -= slab->cache[i].count;
+	}
+
+	return used;
+}
+
+/* Must hold lock_all() */
+static void drain_caches(struct k_mem_slab *slab)
+{
+	unsigned int num_cpus = arch_num_cpus();
+
+	for (unsigned int i = 0; i < num_cpus; i++) {
+		struct z_mem_slab_cache *cache = &slab->cache[i];
+
+		slab->info.num_used -= move_blocks(&cache->free_list,
+						   &slab->free_list,
+						   cache->count);
+		cache->count = 0U;
+	}
+}
+
+static bool cache_alloc(struct k_mem_slab *slab, void **mem)
+{
+	unsigned int irq = arch_irq_lock();
+	struct z_mem_slab_cache *cache = &slab->cache[arch_curr_cpu()->id];
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+	bool hit;
+
+	if (cache->count == 0U) {
+		K_SPINLOCK(&slab->lock) {
+			cache->count = move_blocks(&slab->free_list,
+						   &cache->free_list,
+						   CACHE_BATCH);
+			slab->info.num_used += cache->count;
+		}
+	}
+
+	hit = (cache->count != 0U);
+	if (hit) {
+		*mem = cache->free_list;
+		cache->free_list = *(char **)(cache->free_list);
+		cache->count--;
+	}
+
+	k_spin_unlock(&cache->lock, key);
+	arch_irq_unlock(irq);
+
+	return hit;
+}
+
+static bool cache_free(struct k_mem_slab *slab, void *mem)
+{
+	unsigned int irq = arch_irq_lock();
+	struct z_mem_slab_cache *cache = &slab->cache[arch_curr_cpu()->id];
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+
+	/* Blocked threads must be handed blocks through the slab, and
+	 * cache_waiters can only go up while all the caches are locked.
+	 */
+	bool cached = (slab->cache_waiters == 0U);
+
+	if (cached) {
+		if (cache->count == CONFIG_MEM_SLAB_PERCPU_CACHE_SIZE) {
+			K_SPINLOCK(&slab->lock) {
+				slab->info.num_used -= move_blocks(&cache->free_list,
+								   &slab->free_list,
+								   CACHE_BATCH);
+			}
+			cache->count -= CACHE_BATCH;
+		}
+
+		*(char **)mem = cache->free_list;
+		cache->free_list = (char *)mem;
+		cache->count++;
+	}
+
+	k_spin_unlock(&cache->lock, key);
+	arch_irq_unlock(irq);
+
+	return cached;
+}
+
+uint32_t z_mem_slab_num_used(struct k_mem_slab *slab)
+{
+	k_spinlock_key_t key = lock_all(slab);
+	uint32_t used = num_used_locked(slab);
+
+	unlock_all(slab, key);
+
+	return used;
+}
+#else
+static inline k_spinlock_key_t lock_all(struct k_mem_slab *slab)
+{
+	return k_spin_lock(&slab->lock);
+}
+
+static inline void unlock_all(struct k_mem_slab *slab, k_spinlock_key_t key)
+{
+	k_spin_unlock(&slab->lock, key);
+}
+
+static inline uint32_t num_used_locked(struct k_mem_slab *slab)
+{
+	return slab->info.num_used;
+}
+#endif /* CONFIG_MEM_SLAB_PERCPU_CACHE */
+
 #ifdef CONFIG_OBJ_CORE_MEM_SLAB
 static struct k_obj_type obj_type_mem_slab;
 
@@ -31,9 +198,10 @@ static int k_mem_slab_stats_raw(struct k_obj_core *obj_core, void *stats)
 	k_spinlock_key_t   key;
 
 	slab = CONTAINER_OF(obj_core, struct k_mem_slab, obj_core);
-	key = k_spin_lock(&slab->lock);
+	key = lock_all(slab);
 	memcpy(stats, &slab->info, sizeof(slab->info));
-	k_spin_unlock(&slab->lock, key);
+	((struct k_mem_slab_info *)stats)->num_used = num_used_locked(slab);
+	unlock_all(slab, key);
 
 	return 0;
 }
@@ -47,16 +215,16 @@ static int k_mem_slab_stats_query(struct k_obj_core *obj_core, void *stats)
 	struct sys_memory_stats *ptr = stats;
 
 	slab = CONTAINER_OF(obj_core, struct k_mem_slab, obj_core);
-	key = k_spin_lock(&slab->lock);
-	ptr->free_bytes = (slab->info.num_blocks - slab->info.num_used) *
+	key = lock_all(slab);
+	ptr->free_bytes = (slab->info.num_blocks - num_used_locked(slab)) *
 			  slab->info.block_size;
-	ptr->allocated_bytes = slab->info.num_used * slab->info.block_size;
+	ptr->allocated_bytes = num_used_locked(slab) * slab->info.block_size;
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	ptr->max_allocated_bytes = slab->info.max_used * slab->info.block_size;
 #else
 	ptr->max_allocated_bytes = 0;
 #endif
-	k_spin_unlock(&slab->lock, key);
+	unlock_all(slab, key);
 
 	return 0;
 }
@@ -184,6 +352,11 @@ int k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->info.max_used = 0U;
 #endif
 
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+	slab->cache_waiters = 0U;
+	(void)memset(slab->cache, 0, sizeof(slab->cache));
+#endif
+
 	rc = create_free_list(slab);
 	if (rc < 0) {
 		goto out;
@@ -207,11 +380,26 @@ out:
 
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 {
-	k_spinlock_key_t key = k_spin_lock(&slab->lock);
 	int result;
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mem_slab, alloc, slab, timeout);
 
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+	if (cache_alloc(slab, mem)) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, 0);
+		return 0;
+	}
+
+	/* Neither this CPU's cache nor the slab has a block left, pull
+	 * back whatever the other CPUs are holding on to.
+	 */
+	k_spinlock_key_t key = lock_all(slab);
+
+	drain_caches(slab);
+#else
+	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+#endif
+
 	if (slab->free_list != NULL) {
 		/* take a free block */
 		*mem = slab->free_list;
@@ -232,11 +420,27 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 	} else {
 		SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_mem_slab, alloc, slab, timeout);
 
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+		/* Route frees through the slab until we are served.  The
+		 * thread handing us a block drops the count again.
+		 */
+		slab->cache_waiters++;
+		release_caches(slab);
+		k_spin_release(&slab->cache[0].lock);
+#endif
+
 		/* wait for a free block or timeout */
 		result = z_pend_curr(&slab->lock, key, &slab->wait_q, timeout);
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+		else {
+			K_SPINLOCK(&slab->lock) {
+				slab->cache_waiters--;
+			}
+		}
+#endif
 
 		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, result);
 
@@ -245,15 +449,17 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, result);
 
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+	unlock_all(slab, key);
+#else
 	k_spin_unlock(&slab->lock, key);
+#endif
 
 	return result;
 }
 
 void k_mem_slab_free(struct k_mem_slab *slab, void *mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&slab->lock);
-
 	__ASSERT(((char *)mem >= slab->buffer) &&
 		 ((((char *)mem - slab->buffer) % slab->info.block_size) == 0) &&
 		 ((char *)mem <= (slab->buffer + (slab->info.block_size *
@@ -261,12 +467,26 @@ void k_mem_slab_free(struct k_mem_slab *slab, void *mem)
 		 "Invalid memory pointer provided");
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mem_slab, free, slab);
+
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+	if (cache_free(slab, mem)) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
+		return;
+	}
+#endif
+
+	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+
 	if (slab->free_list == NULL && IS_ENABLED(CONFIG_MULTITHREADING)) {
 		struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
 
 		if (pending_thread != NULL) {
 			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
 
+#ifdef CONFIG_MEM_SLAB_PERCPU_CACHE
+			slab->cache_waiters--;
+#endif
+
 			z_thread_return_value_set_with_data(pending_thread, 0, mem);
 			z_ready_thread(pending_thread);
 			z_reschedule(&slab->lock, key);
@@ -288,10 +508,11 @@ int k_mem_slab_runtime_stats_get(struct k_mem_slab *slab, struct sys_memory_stat
 		return -EINVAL;
 	}
 
-	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+	k_spinlock_key_t key = lock_all(slab);
+	uint32_t num_used = num_used_locked(slab);
 
-	stats->allocated_bytes = slab->info.num_used * slab->info.block_size;
-	stats->free_bytes = (slab->info.num_blocks - slab->info.num_used) *
+	stats->allocated_bytes = num_used * slab->info.block_size;
+	stats->free_bytes = (slab->info.num_blocks - num_used) *
 			    slab->info.block_size;
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	stats->max_allocated_bytes = slab->info.max_used *
@@ -300,7 +521,7 @@ int k_mem_slab_runtime_stats_get(struct k_mem_slab *slab, struct sys_memory_stat
 	stats->max_allocated_bytes = 0;
 #endif
 
-	k_spin_unlock(&slab->lock, key);
+	unlock_all(slab, key);
 
 	return 0;
 }
@@ -101,6 +101,36 @@ static bool adjust_owner_prio(struct k_mutex *mutex, int32_t new_prio)
 	return false;
 }
 
+#ifdef CONFIG_ADAPTIVE_SPIN
+/* A mutex whose owner is running on another CPU is likely to be
+ * released soon, so rather than pay for a context switch the caller
+ * spins until the owner lets go of it or gets switched out, or the
+ * budget runs out.  No priority is inherited while spinning: the owner
+ * is running anyway, and is boosted as usual if the caller ends up
+ * pending.  Entered and left with the lock held.
+ */
+static k_spinlock_key_t spin_on_owner(struct k_mutex *mutex,
+				      k_spinlock_key_t key, uint32_t budget)
+{
+	struct k_thread *owner = mutex->owner;
+	uint32_t start = k_cycle_get_32();
+
+	if ((budget == 0U) || !z_thread_running_elsewhere(owner)) {
+		return key;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	do {
+		arch_spin_relax();
+		owner = *(struct k_thread *volatile *)&mutex->owner;
+	} while ((owner != NULL) && z_thread_running_elsewhere(owner) &&
+		 ((k_cycle_get_32() - start) < budget));
+
+	return k_spin_lock(&lock);
+}
+#endif
+
 int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 {
 	int new_prio;
@@ -113,6 +143,16 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 
 	key = k_spin_lock(&lock);
 
+#ifdef CONFIG_ADAPTIVE_SPIN
+	if ((mutex->lock_count != 0U) && (mutex->owner != _current) &&
+	    !K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_timepoint_t end = sys_timepoint_calc(timeout);
+
+		key = spin_on_owner(mutex, key, z_spin_budget(end));
+		timeout = z_spin_timeout_left(end);
+	}
+#endif
+
 	if (likely((mutex->lock_count == 0U) || (mutex->owner == _current))) {
 
 		mutex->owner_orig_prio = (mutex->lock_count == 0U) ?
@@ -37,7 +37,16 @@ static struct k_spinlock lock;
 
 enum POLL_MODE { MODE_NONE, MODE_POLL, MODE_TRIGGERED };
 
-static int signal_poller(struct k_poll_event *event, uint32_t state);
+/* Pollers released by one call, readied together under a single hold
+ * of the scheduler lock, see z_sched_wake_threads()
+ */
+struct wake_batch {
+	struct k_thread *threads[Z_SCHED_WAKE_BATCH];
+	size_t count;
+};
+
+static int signal_poller(struct k_poll_event *event, uint32_t state,
+			 struct wake_batch *batch);
 static int signal_triggered_work(struct k_poll_event *event, uint32_t status);
 
 void k_poll_event_init(struct k_poll_event *event, uint32_t type,
@@ -70,6 +79,12 @@ static inline bool is_condition_met(struct k_poll_event *event, uint32_t *state)
 		}
 		break;
 	case K_POLL_TYPE_DATA_AVAILABLE:
+#ifdef CONFIG_QUEUE_LOCKFREE
+		/* Make lock-free puts notify us from now on, before
+		 * looking at the queue, see kernel/queue.c
+		 */
+		atomic_set(&event->queue->polled, 1);
+#endif
 		if (!k_queue_is_empty(event->queue)) {
 			*state = K_POLL_STATE_FIFO_DATA_AVAILABLE;
 			return true;
@@ -262,7 +277,19 @@ static inline int register_events(struct k_poll_event *events,
 	return events_registered;
 }
 
-static int signal_poller(struct k_poll_event *event, uint32_t state)
+static void wake_batch_flush(struct wake_batch *batch)
+{
+	if (batch->count > 0) {
+		z_sched_wake_threads(batch->threads, batch->count);
+		batch->count = 0;
+	}
+}
+
+/* The poller is unpended and readied in one go by the scheduler, right
+ * away if batch is NULL, otherwise when the batch gets flushed.
+ */
+static int signal_poller(struct k_poll_event *event, uint32_t state,
+			 struct wake_batch *batch)
 {
 	struct k_thread *thread = poller_thread(event->poller);
 
@@ -272,15 +299,19 @@ static int signal_poller(struct k_poll_event *event, uint32_t state)
 		return 0;
 	}
 
-	z_unpend_thread(thread);
+	(void)z_abort_thread_timeout(thread);
 	arch_thread_return_value_set(thread,
 		state == K_POLL_STATE_CANCELLED ? -EINTR : 0);
 
-	if (!z_is_thread_ready(thread)) {
+	if (batch == NULL) {
+		z_sched_wake_threads(&thread, 1);
 		return 0;
 	}
 
-	z_ready_thread(thread);
+	batch->threads[batch->count++] = thread;
+	if (batch->count == ARRAY_SIZE(batch->threads)) {
+		wake_batch_flush(batch);
+	}
 
 	return 0;
 }
@@ -438,14 +469,15 @@ oops_free:
 #endif
 
 /* must be called with interrupts locked */
-static int signal_poll_event(struct k_poll_event *event, uint32_t state)
+static int signal_poll_event(struct k_poll_event *event, uint32_t state,
+			     struct wake_batch *batch)
 {
 	struct z_poller *poller = event->poller;
 	int retcode = 0;
 
 	if (poller != NULL) {
 		if (poller->mode == MODE_POLL) {
-			retcode = signal_poller(event, state);
+			retcode = signal_poller(event, state, batch);
 		} else if (poller->mode == MODE_TRIGGERED) {
 			retcode = signal_triggered_work(event, state);
 		} else {
@@ -471,7 +503,7 @@ void z_handle_obj_poll_events(sys_dlist_t *events, uint32_t state)
 
 	poll_event = (struct k_poll_event *)sys_dlist_get(events);
 	if (poll_event != NULL) {
-		(void) signal_poll_event(poll_event, state);
+		(void) signal_poll_event(poll_event, state, NULL);
 	}
 
 	k_spin_unlock(&lock, key);
@@ -528,6 +560,8 @@ int z_impl_k_poll_signal_raise(struct k_poll_signal *sig, int result)
 {
 	k_spinlock_key_t key = k_spin_lock(&lock);
 	struct k_poll_event *poll_event;
+	struct wake_batch batch = { .count = 0 };
+	int rc = 0;
 
 	sig->result = result;
 	sig->signaled = 1U;
@@ -541,7 +575,22 @@ int z_impl_k_poll_signal_raise(struct k_poll_signal *sig, int result)
 		return 0;
 	}
 
-	int rc = signal_poll_event(poll_event, K_POLL_STATE_SIGNALED);
+	/* The signal stays raised until reset, so it satisfies every
+	 * event registered on it, release them all as one batch.
+	 */
+	do {
+		int ret = signal_poll_event(poll_event, K_POLL_STATE_SIGNALED,
+					    &batch);
+
+		if (rc == 0) {
+			rc = ret;
+		}
+
+		poll_event = (struct k_poll_event *)
+			sys_dlist_get(&sig->poll_events);
+	} while (poll_event != NULL);
+
+	wake_batch_flush(&batch);
 
 	SYS_PORT_TRACING_FUNC(k_poll_api, signal_raise, sig, rc);
 
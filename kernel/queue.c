@@ -60,6 +60,12 @@ void z_impl_k_queue_init(struct k_queue *queue)
 	sys_sflist_init(&queue->data_q);
 	queue->lock = (struct k_spinlock) {};
 	z_waitq_init(&queue->wait_q);
+#ifdef CONFIG_QUEUE_LOCKFREE
+	(void)atomic_ptr_clear(&queue->append_inbox);
+	(void)atomic_ptr_clear(&queue->prepend_inbox);
+	(void)atomic_clear(&queue->waiters);
+	(void)atomic_clear(&queue->polled);
+#endif
 #if defined(CONFIG_POLL)
 	sys_dlist_init(&queue->poll_events);
 #endif
@@ -94,6 +100,127 @@ static inline void handle_poll_events(struct k_queue *queue, uint32_t state)
 #endif
 }
 
+#ifdef CONFIG_QUEUE_LOCKFREE
+/*
+ * Lock-free put path
+ *
+ * k_queue_append() and k_queue_prepend() push their node onto one of
+ * two atomic lists, newest first, instead of taking the queue lock.
+ * Whoever takes the lock next moves them into data_q, appended nodes
+ * oldest first at the tail and prepended nodes newest first at the
+ * head, so FIFO and LIFO order are kept.  Getting items still takes
+ * the lock: a lock-free pop of caller-owned nodes is exposed to ABA.
+ *
+ * A consumer about to block increments waiters and then looks at the
+ * inboxes one last time, a producer looks at waiters after its push.
+ * One of them sees the other, and in the producer's case it takes the
+ * lock to hand the node over (see queue_kick()).  k_poll() sets polled
+ * before looking at the queue for the same reason.
+ */
+static void inbox_push(atomic_ptr_t *inbox, sys_sfnode_t *node)
+{
+	atomic_ptr_val_t head;
+
+	do {
+		head = atomic_ptr_get(inbox);
+		z_sfnode_next_set(node, head);
+	} while (!atomic_ptr_cas(inbox, head, node));
+}
+
+/* Must be called with the queue lock held.  Returns true if a pended
+ * thread was handed an item and needs a reschedule.
+ */
+static bool queue_sync_locked(struct k_queue *queue)
+{
+	sys_sfnode_t *node, *next, *prev = NULL;
+	struct k_thread *thread;
+	bool woken = false;
+
+	if (atomic_ptr_get(&queue->prepend_inbox) != NULL) {
+		node = atomic_ptr_clear(&queue->prepend_inbox);
+		for (; node != NULL; node = next) {
+			next = z_sfnode_next_peek(node);
+			sys_sflist_insert(&queue->data_q, prev, node);
+			prev = node;
+		}
+	}
+
+	if (atomic_ptr_get(&queue->append_inbox) != NULL) {
+		sys_sfnode_t *oldest = NULL;
+
+		node = atomic_ptr_clear(&queue->append_inbox);
+		for (; node != NULL; node = next) {
+			next = z_sfnode_next_peek(node);
+			z_sfnode_next_set(node, oldest);
+			oldest = node;
+		}
+		for (node = oldest; node != NULL; node = next) {
+			next = z_sfnode_next_peek(node);
+			sys_sflist_append(&queue->data_q, node);
+		}
+	}
+
+	/* Keep "no thread pends while data_q has items" true for the
+	 * locked paths
+	 */
+	while (!sys_sflist_is_empty(&queue->data_q) &&
+	       ((thread = z_unpend_first_thread(&queue->wait_q)) != NULL)) {
+		node = sys_sflist_get_not_empty(&queue->data_q);
+		prepare_thread_to_run(thread, z_queue_node_peek(node, true));
+		woken = true;
+	}
+
+	return woken;
+}
+
+/* Called by a producer that raced with a consumer going to sleep or
+ * with k_poll()
+ */
+static void queue_kick(struct k_queue *queue)
+{
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	(void)queue_sync_locked(queue);
+	if (!sys_sflist_is_empty(&queue->data_q)) {
+		handle_poll_events(queue, K_POLL_STATE_DATA_AVAILABLE);
+	}
+	z_reschedule(&queue->lock, key);
+}
+
+/* For the operations which look at data_q without the lock */
+static void queue_sync(struct k_queue *queue)
+{
+	if ((atomic_ptr_get(&queue->append_inbox) != NULL) ||
+	    (atomic_ptr_get(&queue->prepend_inbox) != NULL)) {
+		k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+		if (queue_sync_locked(queue)) {
+			z_reschedule(&queue->lock, key);
+		} else {
+			k_spin_unlock(&queue->lock, key);
+		}
+	}
+}
+
+static inline bool queue_contended(struct k_queue *queue)
+{
+	return (atomic_get(&queue->waiters) != 0) ||
+	       (atomic_get(&queue->polled) != 0);
+}
+#else
+static inline bool queue_sync_locked(struct k_queue *queue)
+{
+	ARG_UNUSED(queue);
+
+	return false;
+}
+
+static inline void queue_sync(struct k_queue *queue)
+{
+	ARG_UNUSED(queue);
+}
+#endif /* CONFIG_QUEUE_LOCKFREE */
+
 void z_impl_k_queue_cancel_wait(struct k_queue *queue)
 {
 	SYS_PORT_TRACING_OBJ_FUNC(k_queue, cancel_wait, queue);
@@ -120,14 +247,71 @@ static inline void z_vrfy_k_queue_cancel_wait(struct k_queue *queue)
 #include <syscalls/k_queue_cancel_wait_mrsh.c>
 #endif
 
+static void *alloc_node(void *data, bool alloc)
+{
+	if (alloc) {
+		struct alloc_node *anode;
+
+		anode = z_thread_malloc(sizeof(*anode));
+		if (anode == NULL) {
+			return NULL;
+		}
+		anode->data = data;
+		sys_sfnode_init(&anode->node, 0x1);
+		data = anode;
+	} else {
+		sys_sfnode_init(data, 0x0);
+	}
+
+	return data;
+}
+
+#ifdef CONFIG_QUEUE_LOCKFREE
+static int32_t queue_insert_lockfree(struct k_queue *queue, void *data,
+				     bool alloc, bool is_append)
+{
+	sys_sfnode_t *node;
+
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_queue, queue_insert, queue, alloc);
+
+	node = alloc_node(data, alloc);
+	if (node == NULL) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, queue_insert, queue, alloc,
+			-ENOMEM);
+
+		return -ENOMEM;
+	}
+
+	inbox_push(is_append ? &queue->append_inbox : &queue->prepend_inbox,
+		   node);
+
+	if (queue_contended(queue)) {
+		queue_kick(queue);
+	}
+
+	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, queue_insert, queue, alloc, 0);
+
+	return 0;
+}
+#endif /* CONFIG_QUEUE_LOCKFREE */
+
 static int32_t queue_insert(struct k_queue *queue, void *prev, void *data,
 			    bool alloc, bool is_append)
 {
 	struct k_thread *first_pending_thread;
+
+#ifdef CONFIG_QUEUE_LOCKFREE
+	if (((prev == NULL) || is_append) && !queue_contended(queue)) {
+		return queue_insert_lockfree(queue, data, alloc, is_append);
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_queue, queue_insert, queue, alloc);
 
+	(void)queue_sync_locked(queue);
+
 	if (is_append) {
 		prev = sys_sflist_peek_tail(&queue->data_q);
 	}
@@ -145,23 +329,14 @@ static int32_t queue_insert(struct k_queue *queue, void *prev, void *data,
 	}
 
 	/* Only need to actually allocate if no threads are pending */
-	if (alloc) {
-		struct alloc_node *anode;
-
-		anode = z_thread_malloc(sizeof(*anode));
-		if (anode == NULL) {
-			k_spin_unlock(&queue->lock, key);
+	data = alloc_node(data, alloc);
+	if (data == NULL) {
+		k_spin_unlock(&queue->lock, key);
 
-			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, queue_insert, queue, alloc,
-				-ENOMEM);
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, queue_insert, queue, alloc,
+			-ENOMEM);
 
-			return -ENOMEM;
-		}
-		anode->data = data;
-		sys_sfnode_init(&anode->node, 0x1);
-		data = anode;
-	} else {
-		sys_sfnode_init(data, 0x0);
+		return -ENOMEM;
 	}
 
 	SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_queue, queue_insert, queue, alloc, K_FOREVER);
@@ -244,20 +419,17 @@ static inline int32_t z_vrfy_k_queue_alloc_prepend(struct k_queue *queue,
 #include <syscalls/k_queue_alloc_prepend_mrsh.c>
 #endif
 
-int k_queue_append_list(struct k_queue *queue, void *head, void *tail)
+/* Hand the items of a list to the waiting threads, and put the rest of
+ * the list in the queue, in front of the items already there if prepend
+ * is set.
+ */
+static void queue_insert_list_locked(struct k_queue *queue, void *head,
+				     void *tail, bool prepend)
 {
-	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_queue, append_list, queue);
-
-	/* invalid head or tail of list */
-	CHECKIF(head == NULL || tail == NULL) {
-		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, append_list, queue, -EINVAL);
-
-		return -EINVAL;
-	}
-
-	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 	struct k_thread *thread = NULL;
 
+	(void)queue_sync_locked(queue);
+
 	if (head != NULL) {
 		thread = z_unpend_first_thread(&queue->wait_q);
 	}
@@ -268,9 +440,36 @@ int k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 		thread = z_unpend_first_thread(&queue->wait_q);
 	}
 
-	if (head != NULL) {
+	if (head == NULL) {
+		return;
+	}
+
+	if (prepend) {
+		sys_sflist_t list;
+
+		sys_sflist_init(&list);
+		sys_sflist_append_list(&list, head, tail);
+		sys_sflist_merge_sflist(&list, &queue->data_q);
+		queue->data_q = list;
+	} else {
 		sys_sflist_append_list(&queue->data_q, head, tail);
 	}
+}
+
+int k_queue_append_list(struct k_queue *queue, void *head, void *tail)
+{
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_queue, append_list, queue);
+
+	/* invalid head or tail of list */
+	CHECKIF(head == NULL || tail == NULL) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, append_list, queue, -EINVAL);
+
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	queue_insert_list_locked(queue, head, tail, false);
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, append_list, queue, 0);
 
@@ -279,6 +478,28 @@ int k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 	return 0;
 }
 
+int k_queue_prepend_list(struct k_queue *queue, void *head, void *tail)
+{
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_queue, prepend_list, queue);
+
+	/* invalid head or tail of list */
+	CHECKIF(head == NULL || tail == NULL) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, prepend_list, queue, -EINVAL);
+
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	queue_insert_list_locked(queue, head, tail, true);
+
+	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, prepend_list, queue, 0);
+
+	handle_poll_events(queue, K_POLL_STATE_DATA_AVAILABLE);
+	z_reschedule(&queue->lock, key);
+	return 0;
+}
+
 int k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list)
 {
 	int ret;
@@ -314,19 +535,36 @@ int k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list)
 	return 0;
 }
 
+static void *queue_get_locked(struct k_queue *queue, k_spinlock_key_t key,
+			      bool woken)
+{
+	sys_sfnode_t *node;
+	void *data;
+
+	node = sys_sflist_get_not_empty(&queue->data_q);
+	data = z_queue_node_peek(node, true);
+
+	if (woken) {
+		z_reschedule(&queue->lock, key);
+	} else {
+		k_spin_unlock(&queue->lock, key);
+	}
+
+	return data;
+}
+
 void *z_impl_k_queue_get(struct k_queue *queue, k_timeout_t timeout)
 {
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 	void *data;
+	bool woken;
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_queue, get, queue, timeout);
 
-	if (likely(!sys_sflist_is_empty(&queue->data_q))) {
-		sys_sfnode_t *node;
+	woken = queue_sync_locked(queue);
 
-		node = sys_sflist_get_not_empty(&queue->data_q);
-		data = z_queue_node_peek(node, true);
-		k_spin_unlock(&queue->lock, key);
+	if (likely(!sys_sflist_is_empty(&queue->data_q))) {
+		data = queue_get_locked(queue, key, woken);
 
 		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, get, queue, timeout, data);
 
@@ -336,15 +574,40 @@ void *z_impl_k_queue_get(struct k_queue *queue, k_timeout_t timeout)
 	SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_queue, get, queue, timeout);
 
 	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
-		k_spin_unlock(&queue->lock, key);
+		if (woken) {
+			z_reschedule(&queue->lock, key);
+		} else {
+			k_spin_unlock(&queue->lock, key);
+		}
 
 		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, get, queue, timeout, NULL);
 
 		return NULL;
 	}
 
+#ifdef CONFIG_QUEUE_LOCKFREE
+	/* Producers check waiters after pushing, so anything pushed
+	 * before this increment is visible below.
+	 */
+	atomic_inc(&queue->waiters);
+	woken = queue_sync_locked(queue) || woken;
+
+	if (!sys_sflist_is_empty(&queue->data_q)) {
+		atomic_dec(&queue->waiters);
+		data = queue_get_locked(queue, key, woken);
+
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, get, queue, timeout, data);
+
+		return data;
+	}
+#endif
+
 	int ret = z_pend_curr(&queue->lock, key, &queue->wait_q, timeout);
 
+#ifdef CONFIG_QUEUE_LOCKFREE
+	atomic_dec(&queue->waiters);
+#endif
+
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, get, queue, timeout,
 		(ret != 0) ? NULL : _current->base.swap_data);
 
@@ -355,6 +618,8 @@ bool k_queue_remove(struct k_queue *queue, void *data)
 {
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_queue, remove, queue);
 
+	queue_sync(queue);
+
 	bool ret = sys_sflist_find_and_remove(&queue->data_q, (sys_sfnode_t *)data);
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, remove, queue, ret);
@@ -368,6 +633,8 @@ bool k_queue_unique_append(struct k_queue *queue, void *data)
 
 	sys_sfnode_t *test;
 
+	queue_sync(queue);
+
 	SYS_SFLIST_FOR_EACH_NODE(&queue->data_q, test) {
 		if (test == (sys_sfnode_t *) data) {
 			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_queue, unique_append, queue, false);
@@ -385,6 +652,8 @@ bool k_queue_unique_append(struct k_queue *queue, void *data)
 
 void *z_impl_k_queue_peek_head(struct k_queue *queue)
 {
+	queue_sync(queue);
+
 	void *ret = z_queue_node_peek(sys_sflist_peek_head(&queue->data_q), false);
 
 	SYS_PORT_TRACING_OBJ_FUNC(k_queue, peek_head, queue, ret);
@@ -394,6 +663,8 @@ void *z_impl_k_queue_peek_head(struct k_queue *queue)
 
 void *z_impl_k_queue_peek_tail(struct k_queue *queue)
 {
+	queue_sync(queue);
+
 	void *ret = z_queue_node_peek(sys_sflist_peek_tail(&queue->data_q), false);
 
 	SYS_PORT_TRACING_OBJ_FUNC(k_queue, peek_tail, queue, ret);
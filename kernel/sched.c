@@ -190,6 +190,8 @@ static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
 	cpu = m == 0 ? 0 : u32_count_trailing_zeros(m);
 
 	return &_kernel.cpus[cpu].ready_q.runq;
+#elif defined(CONFIG_SCHED_WORK_STEALING)
+	return &_kernel.cpus[thread->base.runq_cpu].ready_q.runq;
 #else
 	ARG_UNUSED(thread);
 	return &_kernel.ready_q.runq;
@@ -198,15 +200,73 @@ static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
 
 static ALWAYS_INLINE void *curr_cpu_runq(void)
 {
-#ifdef CONFIG_SCHED_CPU_MASK_PIN_ONLY
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
 	return &arch_curr_cpu()->ready_q.runq;
 #else
 	return &_kernel.ready_q.runq;
 #endif
 }
 
+#ifdef CONFIG_SCHED_WORK_STEALING
+/* Choose the CPU whose queue a newly runnable thread goes to.  This
+ * is the CPU it last ran on, so it comes back to warm caches, unless
+ * its affinity mask no longer allows that CPU.
+ */
+static ALWAYS_INLINE uint8_t runq_home_cpu(struct k_thread *thread)
+{
+	unsigned int cpu = thread->base.cpu;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	uint32_t m = thread->base.cpu_mask;
+
+	if ((m != 0) && ((m & BIT(cpu)) == 0)) {
+		cpu = u32_count_trailing_zeros(m);
+	}
+#endif
+	if (cpu >= arch_num_cpus()) {
+		cpu = 0;
+	}
+
+	return cpu;
+}
+
+/* Best thread the current CPU may run.  The local queue wins ties so
+ * threads stay where they last ran; the head of another CPU's queue
+ * is only stolen when it is strictly more important (or the local
+ * queue is empty), which keeps the highest priority runnable threads
+ * running across the system just like a single global queue would.
+ * With CONFIG_SCHED_CPU_MASK, _priq_run_best() only returns threads
+ * allowed on the current CPU, so pinning is honored while stealing.
+ */
+static ALWAYS_INLINE struct k_thread *runq_best_or_steal(void)
+{
+	struct _cpu *cpu = arch_curr_cpu();
+	struct k_thread *best = _priq_run_best(&cpu->ready_q.runq);
+	unsigned int num_cpus = arch_num_cpus();
+
+	for (unsigned int i = 0; i < num_cpus; i++) {
+		struct k_thread *thread;
+
+		if (i == cpu->id) {
+			continue;
+		}
+
+		thread = _priq_run_best(&_kernel.cpus[i].ready_q.runq);
+		if ((thread != NULL) &&
+		    ((best == NULL) || (z_sched_prio_cmp(thread, best) > 0))) {
+			best = thread;
+		}
+	}
+
+	return best;
+}
+#endif
+
 static ALWAYS_INLINE void runq_add(struct k_thread *thread)
 {
+#ifdef CONFIG_SCHED_WORK_STEALING
+	thread->base.runq_cpu = runq_home_cpu(thread);
+#endif
 	_priq_run_add(thread_runq(thread), thread);
 }
 
@@ -217,7 +277,11 @@ static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
 
 static ALWAYS_INLINE struct k_thread *runq_best(void)
 {
+#ifdef CONFIG_SCHED_WORK_STEALING
+	return runq_best_or_steal();
+#else
 	return _priq_run_best(curr_cpu_runq());
+#endif
 }
 
 /* _current is never in the run queue until context switch on
@@ -603,7 +667,39 @@ static bool thread_active_elsewhere(struct k_thread *thread)
 	return false;
 }
 
-static void ready_thread(struct k_thread *thread)
+#ifdef CONFIG_ADAPTIVE_SPIN
+bool z_thread_running_elsewhere(struct k_thread *thread)
+{
+	unsigned int key = arch_irq_lock();
+	int currcpu = _current_cpu->id;
+	unsigned int num_cpus = arch_num_cpus();
+	bool ret = false;
+
+	for (int i = 0; i < num_cpus; i++) {
+		struct k_thread *curr = _kernel.cpus[i].current;
+
+		if ((i == currcpu) || (curr == NULL)) {
+			continue;
+		}
+
+		if ((thread != NULL) ? (curr == thread)
+				     : !z_is_idle_thread_object(curr)) {
+			ret = true;
+			break;
+		}
+	}
+
+	arch_irq_unlock(key);
+	return ret;
+}
+#endif
+
+/* Adds a runnable thread to the run queue but leaves the cache update
+ * and IPI to the caller, so that a batch of threads woken under one
+ * hold of the scheduler lock costs a single scheduling decision.
+ * Returns true if the thread was queued.
+ */
+static bool queue_ready_thread(struct k_thread *thread)
 {
 #ifdef CONFIG_KERNEL_COHERENCE
 	__ASSERT_NO_MSG(arch_mem_coherent(thread));
@@ -616,6 +712,15 @@ static void ready_thread(struct k_thread *thread)
 		SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_ready, thread);
 
 		queue_thread(thread);
+		return true;
+	}
+
+	return false;
+}
+
+static void ready_thread(struct k_thread *thread)
+{
+	if (queue_ready_thread(thread)) {
 		update_cache(0);
 		flag_ipi();
 	}
@@ -859,35 +964,67 @@ ALWAYS_INLINE void z_unpend_thread_no_timeout(struct k_thread *thread)
 	}
 }
 
-void z_sched_wake_thread(struct k_thread *thread, bool is_timeout)
+/* Must be called with _sched_spinlock held.  Returns true if the thread
+ * was queued, in which case the caller owes an update_cache() and
+ * flag_ipi(), see queue_ready_thread().
+ */
+static bool wake_thread_locked(struct k_thread *thread, bool is_timeout)
 {
-	K_SPINLOCK(&_sched_spinlock) {
-		bool killed = (thread->base.thread_state &
-				(_THREAD_DEAD | _THREAD_ABORTING));
+	bool killed = (thread->base.thread_state &
+			(_THREAD_DEAD | _THREAD_ABORTING));
 
 #ifdef CONFIG_EVENTS
-		bool do_nothing = thread->no_wake_on_timeout && is_timeout;
+	bool do_nothing = thread->no_wake_on_timeout && is_timeout;
 
-		thread->no_wake_on_timeout = false;
+	thread->no_wake_on_timeout = false;
 
-		if (do_nothing) {
-			continue;
-		}
+	if (do_nothing) {
+		return false;
+	}
 #endif
 
-		if (!killed) {
-			/* The thread is not being killed */
-			if (thread->base.pended_on != NULL) {
-				unpend_thread_no_timeout(thread);
-			}
-			z_mark_thread_as_started(thread);
-			if (is_timeout) {
-				z_mark_thread_as_not_suspended(thread);
-			}
-			ready_thread(thread);
+	if (killed) {
+		return false;
+	}
+
+	/* The thread is not being killed */
+	if (thread->base.pended_on != NULL) {
+		unpend_thread_no_timeout(thread);
+	}
+	z_mark_thread_as_started(thread);
+	if (is_timeout) {
+		z_mark_thread_as_not_suspended(thread);
+	}
+
+	return queue_ready_thread(thread);
+}
+
+void z_sched_wake_thread(struct k_thread *thread, bool is_timeout)
+{
+	K_SPINLOCK(&_sched_spinlock) {
+		if (wake_thread_locked(thread, is_timeout)) {
+			update_cache(0);
+			flag_ipi();
 		}
 	}
+}
+
+void z_sched_wake_threads(struct k_thread **threads, size_t count)
+{
+	K_SPINLOCK(&_sched_spinlock) {
+		bool queued = false;
+
+		for (size_t i = 0; i < count; i++) {
+			if (wake_thread_locked(threads[i], false)) {
+				queued = true;
+			}
+		}
 
+		if (queued) {
+			update_cache(0);
+			flag_ipi();
+		}
+	}
 }
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
@@ -1187,18 +1324,47 @@ void *z_get_next_switch_handle(void *interrupted)
 }
 #endif
 
-int z_unpend_all(_wait_q_t *wait_q)
+/* Wakes every thread pended on wait_q as one batch, must be called with
+ * _sched_spinlock held.  Returns the number of threads woken.
+ */
+static int wake_all_locked(_wait_q_t *wait_q, bool set_retval,
+			   int swap_retval, void *swap_data)
 {
-	int need_sched = 0;
 	struct k_thread *thread;
+	bool queued = false;
+	int woken = 0;
 
 	while ((thread = z_waitq_head(wait_q)) != NULL) {
-		z_unpend_thread(thread);
-		z_ready_thread(thread);
-		need_sched = 1;
+		if (set_retval) {
+			z_thread_return_value_set_with_data(thread,
+							    swap_retval,
+							    swap_data);
+		}
+		unpend_thread_no_timeout(thread);
+		(void)z_abort_thread_timeout(thread);
+		if (queue_ready_thread(thread)) {
+			queued = true;
+		}
+		woken++;
 	}
 
-	return need_sched;
+	if (queued) {
+		update_cache(0);
+		flag_ipi();
+	}
+
+	return woken;
+}
+
+int z_unpend_all(_wait_q_t *wait_q)
+{
+	int woken = 0;
+
+	K_SPINLOCK(&_sched_spinlock) {
+		woken = wake_all_locked(wait_q, false, 0, NULL);
+	}
+
+	return woken;
 }
 
 void init_ready_q(struct _ready_q *ready_q)
@@ -1210,7 +1376,7 @@ void init_ready_q(struct _ready_q *ready_q)
 		}
 	};
 #elif defined(CONFIG_SCHED_MULTIQ)
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
+	for (int i = 0; i < ARRAY_SIZE(ready_q->runq.queues); i++) {
 		sys_dlist_init(&ready_q->runq.queues[i]);
 	}
 #else
@@ -1220,7 +1386,7 @@ void init_ready_q(struct _ready_q *ready_q)
 
 void z_sched_init(void)
 {
-#ifdef CONFIG_SCHED_CPU_MASK_PIN_ONLY
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
 	for (int i = 0; i < CONFIG_MP_MAX_NUM_CPUS; i++) {
 		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
@@ -1561,14 +1727,7 @@ static inline int z_vrfy_k_is_preempt_thread(void)
 
 static inline void unpend_all(_wait_q_t *wait_q)
 {
-	struct k_thread *thread;
-
-	while ((thread = z_waitq_head(wait_q)) != NULL) {
-		unpend_thread_no_timeout(thread);
-		(void)z_abort_thread_timeout(thread);
-		arch_thread_return_value_set(thread, 0);
-		ready_thread(thread);
-	}
+	(void)wake_all_locked(wait_q, true, 0, NULL);
 }
 
 #ifdef CONFIG_THREAD_ABORT_HOOK
@@ -1779,6 +1938,17 @@ bool z_sched_wake(_wait_q_t *wait_q, int swap_retval, void *swap_data)
 	return ret;
 }
 
+int z_sched_wake_all(_wait_q_t *wait_q, int swap_retval, void *swap_data)
+{
+	int woken = 0;
+
+	K_SPINLOCK(&_sched_spinlock) {
+		woken = wake_all_locked(wait_q, true, swap_retval, swap_data);
+	}
+
+	return woken;
+}
+
 int z_sched_wait(struct k_spinlock *lock, k_spinlock_key_t key,
 		 _wait_q_t *wait_q, k_timeout_t timeout, void **data)
 {
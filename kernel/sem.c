@@ -129,6 +129,34 @@ static inline void z_vrfy_k_sem_give(struct k_sem *sem)
 #include <syscalls/k_sem_give_mrsh.c>
 #endif
 
+#ifdef CONFIG_ADAPTIVE_SPIN
+/* Semaphores have no owner to watch, so spin while any other CPU is
+ * running something that might give it.  Not while there are threads
+ * pending: a give would wake them rather than bump the count.  Entered
+ * and left with the lock held.
+ */
+static k_spinlock_key_t spin_on_count(struct k_sem *sem,
+				      k_spinlock_key_t key, uint32_t budget)
+{
+	uint32_t start = k_cycle_get_32();
+
+	if ((budget == 0U) || (z_waitq_head(&sem->wait_q) != NULL) ||
+	    !z_thread_running_elsewhere(NULL)) {
+		return key;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	do {
+		arch_spin_relax();
+	} while ((*(volatile unsigned int *)&sem->count == 0U) &&
+		 z_thread_running_elsewhere(NULL) &&
+		 ((k_cycle_get_32() - start) < budget));
+
+	return k_spin_lock(&lock);
+}
+#endif
+
 int z_impl_k_sem_take(struct k_sem *sem, k_timeout_t timeout)
 {
 	int ret = 0;
@@ -140,6 +168,15 @@ int z_impl_k_sem_take(struct k_sem *sem, k_timeout_t timeout)
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_sem, take, sem, timeout);
 
+#ifdef CONFIG_ADAPTIVE_SPIN
+	if ((sem->count == 0U) && !K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_timepoint_t end = sys_timepoint_calc(timeout);
+
+		key = spin_on_count(sem, key, z_spin_budget(end));
+		timeout = z_spin_timeout_left(end);
+	}
+#endif
+
 	if (likely(sem->count > 0U)) {
 		sem->count--;
 		k_spin_unlock(&lock, key);
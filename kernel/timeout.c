@@ -11,10 +11,13 @@
 #include <zephyr/internal/syscall_handler.h>
 #include <zephyr/drivers/timer/system_timer.h>
 #include <zephyr/sys_clock.h>
+#include <zephyr/sys/math_extras.h>
 
 static uint64_t curr_tick;
 
+#ifndef CONFIG_TIMEOUT_QUEUE_WHEEL
 static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+#endif
 
 static struct k_spinlock timeout_lock;
 
@@ -36,6 +39,138 @@ static inline int z_vrfy_sys_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+/* Hierarchical timing wheel.  Level N has WHEEL_SLOTS slots that each
+ * span WHEEL_SLOTS^N ticks.  A timeout sits at the level of the most
+ * significant WHEEL_BITS wide digit in which its expiry differs from
+ * wheel_now, in the slot given by that digit of its expiry.  It
+ * follows that every timeout at level N expires before any timeout
+ * at level N+1, that slots within a level expire in index order, and
+ * that a level 0 slot only holds timeouts expiring on the same tick,
+ * in the order they were added.
+ *
+ * When wheel_now reaches the start of an occupied slot above level 0
+ * the timeouts in it are "cascaded" down to the lower levels, so each
+ * timeout moves at most once per level.  Expiries beyond the range of
+ * the top level wait on an overflow list which is redistributed each
+ * time wheel_now crosses a multiple of that range.
+ *
+ * In this mode dticks holds the absolute expiry in wheel ticks.
+ * wheel_now advances in lockstep with curr_tick, but is kept separate
+ * so sys_clock_tick_set() doesn't break the wheel invariants.
+ */
+#define WHEEL_BITS   6
+#define WHEEL_SLOTS  BIT(WHEEL_BITS)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_QUEUE_WHEEL_LEVELS
+
+static uint64_t wheel_now;
+
+/* Slot lists are only valid while their bit in wheel_pending is set,
+ * they get initialized when a timeout is added to an empty slot.
+ */
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t wheel_pending[WHEEL_LEVELS];
+static sys_dlist_t wheel_overflow = SYS_DLIST_STATIC_INIT(&wheel_overflow);
+
+static sys_dlist_t *wheel_slot(uint64_t expiry, int *level, int *slot)
+{
+	uint64_t diff = expiry ^ wheel_now;
+	int lvl = 0;
+
+	if (diff != 0U) {
+		lvl = (63 - u64_count_leading_zeros(diff)) / WHEEL_BITS;
+	}
+
+	*level = lvl;
+	if (lvl >= WHEEL_LEVELS) {
+		*level = WHEEL_LEVELS;
+		return &wheel_overflow;
+	}
+
+	*slot = (expiry >> (lvl * WHEEL_BITS)) & (WHEEL_SLOTS - 1U);
+	return &wheel[lvl][*slot];
+}
+
+static void wheel_add(struct _timeout *to)
+{
+	int lvl, slot = 0;
+	sys_dlist_t *list = wheel_slot(to->dticks, &lvl, &slot);
+
+	if ((lvl < WHEEL_LEVELS) && ((wheel_pending[lvl] & BIT64(slot)) == 0U)) {
+		sys_dlist_init(list);
+		wheel_pending[lvl] |= BIT64(slot);
+	}
+
+	sys_dlist_append(list, &to->node);
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	int lvl, slot = 0;
+	sys_dlist_t *list = wheel_slot(t->dticks, &lvl, &slot);
+
+	sys_dlist_remove(&t->node);
+
+	if ((lvl < WHEEL_LEVELS) && sys_dlist_is_empty(list)) {
+		wheel_pending[lvl] &= ~BIT64(slot);
+	}
+}
+
+/* Find the next tick at which the wheel needs service: the expiry of
+ * the first occupied level 0 slot, or else the start of the first
+ * occupied slot of a higher level.  Returns the level of that slot,
+ * WHEEL_LEVELS when the overflow list is due, or -1 if no timeouts
+ * are pending.
+ */
+static int wheel_next_event(uint64_t *tick)
+{
+	for (int lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		if (wheel_pending[lvl] != 0U) {
+			int shift = lvl * WHEEL_BITS;
+			uint64_t slot = u64_count_trailing_zeros(wheel_pending[lvl]);
+
+			*tick = (wheel_now & ~(BIT64(shift + WHEEL_BITS) - 1U)) |
+				(slot << shift);
+			return lvl;
+		}
+	}
+
+	if (!sys_dlist_is_empty(&wheel_overflow)) {
+		*tick = (wheel_now | (BIT64(WHEEL_LEVELS * WHEEL_BITS) - 1U)) + 1U;
+		return WHEEL_LEVELS;
+	}
+
+	return -1;
+}
+
+/* Must be called with wheel_now at the start of the slot */
+static void wheel_cascade(int lvl)
+{
+	sys_dlist_t *list = &wheel_overflow;
+	sys_dlist_t moving;
+	sys_dnode_t *node;
+
+	if (lvl < WHEEL_LEVELS) {
+		int slot = (wheel_now >> (lvl * WHEEL_BITS)) & (WHEEL_SLOTS - 1U);
+
+		list = &wheel[lvl][slot];
+		wheel_pending[lvl] &= ~BIT64(slot);
+	}
+
+	/* Detach first: overflow entries may go right back to the
+	 * overflow list.  Order is preserved, so timeouts with equal
+	 * expiries still fire in the order they were added.
+	 */
+	sys_dlist_init(&moving);
+	while ((node = sys_dlist_get(list)) != NULL) {
+		sys_dlist_append(&moving, node);
+	}
+
+	while ((node = sys_dlist_get(&moving)) != NULL) {
+		wheel_add(CONTAINER_OF(node, struct _timeout, node));
+	}
+}
+#else
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -58,6 +193,7 @@ static void remove_timeout(struct _timeout *t)
 
 	sys_dlist_remove(&t->node);
 }
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
 
 static int32_t elapsed(void)
 {
@@ -82,9 +218,19 @@ static int32_t elapsed(void)
 
 static int32_t next_timeout(void)
 {
-	struct _timeout *to = first();
 	int32_t ticks_elapsed = elapsed();
 	int32_t ret;
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	uint64_t tick;
+
+	if ((wheel_next_event(&tick) < 0) ||
+	    ((int64_t)(tick - wheel_now - ticks_elapsed) > (int64_t)INT_MAX)) {
+		ret = MAX_WAIT;
+	} else {
+		ret = MAX(0, (int64_t)(tick - wheel_now) - ticks_elapsed);
+	}
+#else
+	struct _timeout *to = first();
 
 	if ((to == NULL) ||
 	    ((int64_t)(to->dticks - ticks_elapsed) > (int64_t)INT_MAX)) {
@@ -92,6 +238,7 @@ static int32_t next_timeout(void)
 	} else {
 		ret = MAX(0, to->dticks - ticks_elapsed);
 	}
+#endif
 
 	return ret;
 }
@@ -111,8 +258,6 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 	to->fn = fn;
 
 	K_SPINLOCK(&timeout_lock) {
-		struct _timeout *t;
-
 		if (IS_ENABLED(CONFIG_TIMEOUT_64BIT) &&
 		    Z_TICK_ABS(timeout.ticks) >= 0) {
 			k_ticks_t ticks = Z_TICK_ABS(timeout.ticks) - curr_tick;
@@ -122,6 +267,20 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 			to->dticks = timeout.ticks + 1 + elapsed();
 		}
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+		uint64_t prev_event, next_event;
+		int prev_lvl = wheel_next_event(&prev_event);
+
+		to->dticks += wheel_now;
+		wheel_add(to);
+
+		(void)wheel_next_event(&next_event);
+		if ((prev_lvl < 0) || (next_event != prev_event)) {
+			sys_clock_set_timeout(next_timeout(), false);
+		}
+#else
+		struct _timeout *t;
+
 		for (t = first(); t != NULL; t = next(t)) {
 			if (t->dticks > to->dticks) {
 				t->dticks -= to->dticks;
@@ -138,6 +297,7 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 		if (to == first()) {
 			sys_clock_set_timeout(next_timeout(), false);
 		}
+#endif
 	}
 }
 
@@ -158,6 +318,9 @@ int z_abort_timeout(struct _timeout *to)
 /* must be locked */
 static k_ticks_t timeout_rem(const struct _timeout *timeout)
 {
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	return timeout->dticks - (k_ticks_t)wheel_now;
+#else
 	k_ticks_t ticks = 0;
 
 	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
@@ -168,6 +331,7 @@ static k_ticks_t timeout_rem(const struct _timeout *timeout)
 	}
 
 	return ticks;
+#endif
 }
 
 k_ticks_t z_timeout_remaining(const struct _timeout *timeout)
@@ -225,6 +389,36 @@ void sys_clock_announce(int32_t ticks)
 
 	announce_remaining = ticks;
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	uint64_t tick;
+	int lvl;
+
+	for (lvl = wheel_next_event(&tick);
+	     (lvl >= 0) && ((int64_t)(tick - wheel_now) <= announce_remaining);
+	     lvl = wheel_next_event(&tick)) {
+		int dt = tick - wheel_now;
+
+		curr_tick += dt;
+		wheel_now = tick;
+
+		if (lvl == 0) {
+			int slot = tick & (WHEEL_SLOTS - 1U);
+			struct _timeout *t = CONTAINER_OF(sys_dlist_peek_head(&wheel[0][slot]),
+							  struct _timeout, node);
+
+			remove_timeout(t);
+
+			k_spin_unlock(&timeout_lock, key);
+			t->fn(t);
+			key = k_spin_lock(&timeout_lock);
+		} else {
+			wheel_cascade(lvl);
+		}
+		announce_remaining -= dt;
+	}
+
+	wheel_now += announce_remaining;
+#else
 	struct _timeout *t;
 
 	for (t = first();
@@ -245,6 +439,7 @@ void sys_clock_announce(int32_t ticks)
 	if (t != NULL) {
 		t->dticks -= announce_remaining;
 	}
+#endif
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
@@ -253,6 +448,13 @@ void sys_clock_announce(int32_t ticks)
 
 	k_spin_unlock(&timeout_lock, key);
 
+#if defined(CONFIG_HRTIMER) && defined(CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE)
+	/* The driver may have interrupted for a cycle deadline rather
+	 * than for a tick, see hrtimer.c
+	 */
+	z_hrtimer_announce();
+#endif
+
 #ifdef CONFIG_TIMESLICING
 	z_time_slice();
 #endif
@@ -245,6 +245,109 @@ static inline bool notify_queue_locked(struct k_work_q *queue)
 	return rv;
 }
 
+#ifdef CONFIG_WORK_POOL
+
+/* Wake an idle worker of the pool @p queue belongs to, so it can steal
+ * work from @p queue while that is busy.
+ *
+ * Invoked with work lock held.
+ *
+ * @param queue the queue to which work has been submitted.
+ */
+static void pool_notify_idle_locked(struct k_work_q *queue)
+{
+	struct k_work_pool *pool = queue->pool;
+
+	if (pool == NULL) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < pool->num_workers; i++) {
+		struct k_work_q *worker = &pool->workers[i];
+
+		if ((worker == queue)
+		    || ((flags_get(&worker->flags)
+			 & (K_WORK_QUEUE_DRAIN | K_WORK_QUEUE_PLUGGED)) != 0U)) {
+			continue;
+		}
+
+		if (notify_queue_locked(worker)) {
+			break;
+		}
+	}
+}
+
+/* Take the oldest pending item off a sibling of @p thief.
+ *
+ * Items are only taken from the head of a sibling's list, so each
+ * worker still runs its items in submission order.  An item that is
+ * also running (it was resubmitted from its handler) stays with the
+ * worker running it, and flushers queued right behind a stolen item
+ * move along with it so they still complete after it.  Draining
+ * workers neither give nor take work.
+ *
+ * Invoked with work lock held.
+ *
+ * @param thief a pool worker with no pending work.
+ *
+ * @return the node of the stolen work item, or null if there was
+ * nothing to steal.
+ */
+static sys_snode_t *pool_steal_locked(struct k_work_q *thief)
+{
+	struct k_work_pool *pool = thief->pool;
+	uint32_t self = (uint32_t)(thief - pool->workers);
+
+	if ((flags_get(&thief->flags)
+	     & (K_WORK_QUEUE_DRAIN | K_WORK_QUEUE_PLUGGED)) != 0U) {
+		return NULL;
+	}
+
+	for (uint32_t i = 1; i < pool->num_workers; i++) {
+		struct k_work_q *victim
+			= &pool->workers[(self + i) % pool->num_workers];
+		sys_snode_t *node = sys_slist_peek_head(&victim->pending);
+		sys_snode_t *next;
+		struct k_work *work;
+
+		if ((node == NULL)
+		    || flag_test(&victim->flags, K_WORK_QUEUE_DRAIN_BIT)) {
+			continue;
+		}
+
+		work = CONTAINER_OF(node, struct k_work, node);
+		if ((flags_get(&work->flags)
+		     & (K_WORK_RUNNING | K_WORK_FLUSHING)) != 0U) {
+			continue;
+		}
+
+		(void)sys_slist_get(&victim->pending);
+		work->queue = thief;
+
+		next = sys_slist_peek_head(&victim->pending);
+		while ((next != NULL)
+		       && flag_test(&CONTAINER_OF(next, struct k_work, node)->flags,
+				    K_WORK_FLUSHING_BIT)) {
+			(void)sys_slist_get(&victim->pending);
+			sys_slist_append(&thief->pending, next);
+			next = sys_slist_peek_head(&victim->pending);
+		}
+
+		return node;
+	}
+
+	return NULL;
+}
+
+#else
+
+static inline void pool_notify_idle_locked(struct k_work_q *queue)
+{
+	ARG_UNUSED(queue);
+}
+
+#endif /* CONFIG_WORK_POOL */
+
 /* Submit an work item to a queue if queue state allows new work.
  *
  * Submission is rejected if no queue is provided, or if the queue is
@@ -292,7 +395,9 @@ static inline int queue_submit_locked(struct k_work_q *queue,
 	} else {
 		sys_slist_append(&queue->pending, &work->node);
 		ret = 1;
-		(void)notify_queue_locked(queue);
+		if (!notify_queue_locked(queue)) {
+			pool_notify_idle_locked(queue);
+		}
 	}
 
 	return ret;
@@ -629,6 +734,11 @@ static void work_queue_main(void *workq_ptr, void *p2, void *p3)
 
 		/* Check for and prepare any new work. */
 		node = sys_slist_get(&queue->pending);
+#ifdef CONFIG_WORK_POOL
+		if ((node == NULL) && (queue->pool != NULL)) {
+			node = pool_steal_locked(queue);
+		}
+#endif
 		if (node != NULL) {
 			/* Mark that there's some work active that's
 			 * not on the pending list.
@@ -726,19 +836,21 @@ void k_work_queue_init(struct k_work_q *queue)
 	SYS_PORT_TRACING_OBJ_INIT(k_work_queue, queue);
 }
 
-void k_work_queue_start(struct k_work_q *queue,
-			k_thread_stack_t *stack,
-			size_t stack_size,
-			int prio,
-			const struct k_work_queue_config *cfg)
+/* Set up a work queue and create its thread without starting it.
+ *
+ * See k_work_queue_start() for the parameters.
+ */
+static void work_queue_setup(struct k_work_q *queue,
+			     k_thread_stack_t *stack,
+			     size_t stack_size,
+			     int prio,
+			     const struct k_work_queue_config *cfg)
 {
 	__ASSERT_NO_MSG(queue);
 	__ASSERT_NO_MSG(stack);
 	__ASSERT_NO_MSG(!flag_test(&queue->flags, K_WORK_QUEUE_STARTED_BIT));
 	uint32_t flags = K_WORK_QUEUE_STARTED;
 
-	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_work_queue, start, queue);
-
 	sys_slist_init(&queue->pending);
 	z_waitq_init(&queue->notifyq);
 	z_waitq_init(&queue->drainq);
@@ -760,7 +872,17 @@ void k_work_queue_start(struct k_work_q *queue,
 	if ((cfg != NULL) && (cfg->name != NULL)) {
 		k_thread_name_set(&queue->thread, cfg->name);
 	}
+}
+
+void k_work_queue_start(struct k_work_q *queue,
+			k_thread_stack_t *stack,
+			size_t stack_size,
+			int prio,
+			const struct k_work_queue_config *cfg)
+{
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_work_queue, start, queue);
 
+	work_queue_setup(queue, stack, stack_size, prio, cfg);
 	k_thread_start(&queue->thread);
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_work_queue, start, queue);
@@ -818,6 +940,117 @@ int k_work_queue_unplug(struct k_work_q *queue)
 	return ret;
 }
 
+#ifdef CONFIG_WORK_POOL
+
+void k_work_pool_start(struct k_work_pool *pool, int prio,
+		       const struct k_work_queue_config *cfg)
+{
+	__ASSERT_NO_MSG(pool);
+	__ASSERT_NO_MSG(pool->num_workers > 0U);
+
+	for (uint32_t i = 0; i < pool->num_workers; i++) {
+		struct k_work_q *worker = &pool->workers[i];
+		k_thread_stack_t *stack = (k_thread_stack_t *)
+			((uint8_t *)pool->stacks + (i * pool->stack_len));
+
+		k_work_queue_init(worker);
+		worker->pool = pool;
+		work_queue_setup(worker, stack, pool->stack_size, prio, cfg);
+#ifdef CONFIG_SCHED_CPU_MASK
+		if (i < arch_num_cpus()) {
+			(void)k_thread_cpu_pin(&worker->thread, i);
+		}
+#endif
+	}
+
+	for (uint32_t i = 0; i < pool->num_workers; i++) {
+		k_thread_start(&pool->workers[i].thread);
+	}
+}
+
+/* Pick the worker of a pool a new item goes to: the calling worker for
+ * chained submissions, otherwise the worker of the current CPU.
+ */
+static struct k_work_q *pool_worker_get(struct k_work_pool *pool)
+{
+	uint32_t next;
+
+	/* A worker keeps what it queues itself, other items are spread
+	 * round robin and idle workers steal the ones that pile up.
+	 */
+	if (!k_is_in_isr()) {
+		for (uint32_t i = 0; i < pool->num_workers; i++) {
+			if (_current == &pool->workers[i].thread) {
+				return &pool->workers[i];
+			}
+		}
+	}
+
+	next = (uint32_t)atomic_inc(&pool->next_worker);
+
+	return &pool->workers[next % pool->num_workers];
+}
+
+int k_work_submit_to_pool(struct k_work_pool *pool, struct k_work *work)
+{
+	__ASSERT_NO_MSG(pool != NULL);
+
+	return k_work_submit_to_queue(pool_worker_get(pool), work);
+}
+
+int k_work_pool_drain(struct k_work_pool *pool, bool plug)
+{
+	__ASSERT_NO_MSG(pool);
+	__ASSERT_NO_MSG(!k_is_in_isr());
+
+	int ret = 0;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	/* Stop submissions to and stealing between all workers before
+	 * waiting for any of them, so work can't move to a worker that
+	 * has already drained.
+	 */
+	for (uint32_t i = 0; i < pool->num_workers; i++) {
+		struct k_work_q *worker = &pool->workers[i];
+
+		flag_set(&worker->flags, K_WORK_QUEUE_DRAIN_BIT);
+		if (plug) {
+			flag_set(&worker->flags, K_WORK_QUEUE_PLUGGED_BIT);
+		}
+		notify_queue_locked(worker);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	for (uint32_t i = 0; i < pool->num_workers; i++) {
+		int rc = k_work_queue_drain(&pool->workers[i], plug);
+
+		if (rc < 0) {
+			return rc;
+		}
+		ret = MAX(ret, rc);
+	}
+
+	return ret;
+}
+
+int k_work_pool_unplug(struct k_work_pool *pool)
+{
+	__ASSERT_NO_MSG(pool);
+
+	int ret = -EALREADY;
+
+	for (uint32_t i = 0; i < pool->num_workers; i++) {
+		if (k_work_queue_unplug(&pool->workers[i]) == 0) {
+			ret = 0;
+		}
+	}
+
+	return ret;
+}
+
+#endif /* CONFIG_WORK_POOL */
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 
 /* Timeout handler for delayable work.
@@ -1139,4 +1372,26 @@ bool k_work_flush_delayable(struct k_work_delayable *dwork,
 	return need_flush;
 }
 
+#ifdef CONFIG_WORK_POOL
+
+int k_work_schedule_for_pool(struct k_work_pool *pool,
+			     struct k_work_delayable *dwork,
+			     k_timeout_t delay)
+{
+	__ASSERT_NO_MSG(pool != NULL);
+
+	return k_work_schedule_for_queue(pool_worker_get(pool), dwork, delay);
+}
+
+int k_work_reschedule_for_pool(struct k_work_pool *pool,
+			       struct k_work_delayable *dwork,
+			       k_timeout_t delay)
+{
+	__ASSERT_NO_MSG(pool != NULL);
+
+	return k_work_reschedule_for_queue(pool_worker_get(pool), dwork, delay);
+}
+
+#endif /* CONFIG_WORK_POOL */
+
 #endif /* CONFIG_SYS_CLOCK_EXISTS */
@@ -148,6 +148,248 @@ static void free_chunk(struct z_heap *h, chunkid_t c)
 	free_list_add(h, c);
 }
 
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz);
+
+static void class_push(struct z_heap *h, struct z_heap_classes *classes,
+		       int cls, chunkid_t c)
+{
+	set_next_free_chunk(h, c, classes->next[cls]);
+	classes->next[cls] = c;
+	classes->count[cls]++;
+}
+
+static chunkid_t class_pop(struct z_heap *h, struct z_heap_classes *classes,
+			   int cls)
+{
+	chunkid_t c = classes->next[cls];
+
+	if (c != 0U) {
+		classes->next[cls] = next_free_chunk(h, c);
+		classes->count[cls]--;
+	}
+
+	return c;
+}
+
+/* Takes a chunk of exactly sz units from its size class, carving a
+ * new slab of them out of the heap if the class is empty.  Returns
+ * the chunk marked used, or 0.
+ */
+static chunkid_t class_alloc(struct sys_heap *heap, chunksz_t sz)
+{
+	struct z_heap *h = heap->heap;
+	int cls = size_class(h, sz);
+	chunkid_t c = class_pop(h, &heap->classes, cls);
+
+	if (c != 0U) {
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+		h->free_bytes -= chunksz_to_bytes(h, sz);
+#endif
+		return c;
+	}
+
+	chunksz_t n = MIN(CONFIG_SYS_HEAP_SIZE_CLASS_SLAB,
+			  CONFIG_SYS_HEAP_SIZE_CLASS_DEPTH + 1);
+
+	if ((n * sz) >= h->end_chunk) {
+		return 0;
+	}
+
+	c = alloc_chunk(h, n * sz);
+	if (c == 0U) {
+		return 0;
+	}
+
+	if (chunk_size(h, c) > n * sz) {
+		split_chunks(h, c, c + n * sz);
+		free_list_add(h, c + n * sz);
+	}
+
+	/* Hand out the lowest chunk, park the others so that the next
+	 * allocations keep walking up in memory.
+	 */
+	for (chunksz_t i = n - 1; i > 0; i--) {
+		chunkid_t rc = c + i * sz;
+
+		split_chunks(h, c, rc);
+		set_chunk_used(h, rc, true);
+		class_push(h, &heap->classes, cls, rc);
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+		h->free_bytes += chunksz_to_bytes(h, sz);
+#endif
+	}
+
+	set_chunk_used(h, c, true);
+	return c;
+}
+
+/* True if the memory of every chunk meets the alignment, with the
+ * rewind encoding of sys_heap_aligned_alloc().
+ */
+static bool naturally_aligned(struct z_heap *h, size_t align)
+{
+	size_t rew = align & -align;
+
+	if (align == rew) {
+		return align <= chunk_header_bytes(h);
+	}
+
+	align -= rew;
+
+	return (align <= CHUNK_UNIT) &&
+	       (((chunk_header_bytes(h) + rew) & (align - 1)) == 0U);
+}
+
+/* Parks a chunk freed by the user in its size class, if it has one
+ * and the class isn't full.  The chunk stays marked used.
+ */
+static bool class_free(struct sys_heap *heap, chunkid_t c)
+{
+	struct z_heap *h = heap->heap;
+	int cls = size_class(h, chunk_size(h, c));
+
+	if ((cls < 0) ||
+	    (heap->classes.count[cls] >= CONFIG_SYS_HEAP_SIZE_CLASS_DEPTH)) {
+		return false;
+	}
+
+	class_push(h, &heap->classes, cls, c);
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	size_t bytes = chunksz_to_bytes(h, chunk_size(h, c));
+
+	h->allocated_bytes -= bytes;
+	h->free_bytes += bytes;
+#endif
+	return true;
+}
+
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+static bool cpu_caches_drain(struct sys_heap *heap)
+{
+	struct z_heap *h = heap->heap;
+	bool drained = false;
+
+	for (int i = 0; i < CONFIG_MP_MAX_NUM_CPUS; i++) {
+		struct z_heap_cpu_cache *cache = &heap->cpu_cache[i];
+
+		K_SPINLOCK(&cache->lock) {
+			for (int cls = 0; cls < SIZE_CLASSES; cls++) {
+				chunkid_t c;
+
+				while ((c = class_pop(h, &cache->classes, cls)) != 0U) {
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+					h->allocated_bytes -=
+						chunksz_to_bytes(h, chunk_size(h, c));
+#endif
+					set_chunk_used(h, c, false);
+					free_chunk(h, c);
+					drained = true;
+				}
+			}
+		}
+	}
+
+	return drained;
+}
+#endif
+
+/* Gives every cached chunk back to the heap, returns false if there
+ * was none.
+ */
+static bool classes_flush(struct sys_heap *heap)
+{
+	struct z_heap *h = heap->heap;
+	bool flushed = false;
+
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+	flushed = cpu_caches_drain(heap);
+#endif
+
+	for (int cls = 0; cls < SIZE_CLASSES; cls++) {
+		chunkid_t c;
+
+		while ((c = class_pop(h, &heap->classes, cls)) != 0U) {
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+			/* Added back by free_chunk() */
+			h->free_bytes -= chunksz_to_bytes(h, chunk_size(h, c));
+#endif
+			set_chunk_used(h, c, false);
+			free_chunk(h, c);
+			flushed = true;
+		}
+	}
+
+	return flushed;
+}
+
+/* Takes c out of its size class and gives it back to the heap,
+ * returns false if c isn't parked in the heap's classes.  Walks the
+ * class list, so O(CONFIG_SYS_HEAP_SIZE_CLASS_DEPTH).
+ */
+static bool class_unpark(struct sys_heap *heap, chunkid_t c)
+{
+	struct z_heap *h = heap->heap;
+	struct z_heap_classes *classes = &heap->classes;
+	int cls = size_class(h, chunk_size(h, c));
+	chunkid_t prev = 0U;
+
+	if (cls < 0) {
+		return false;
+	}
+
+	for (chunkid_t n = classes->next[cls]; n != 0U;
+	     prev = n, n = next_free_chunk(h, n)) {
+		if (n != c) {
+			continue;
+		}
+
+		if (prev == 0U) {
+			classes->next[cls] = next_free_chunk(h, c);
+		} else {
+			set_next_free_chunk(h, prev, next_free_chunk(h, c));
+		}
+		classes->count[cls]--;
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+		/* Added back by free_chunk() */
+		h->free_bytes -= chunksz_to_bytes(h, chunk_size(h, c));
+#endif
+		set_chunk_used(h, c, false);
+		free_chunk(h, c);
+		return true;
+	}
+
+	return false;
+}
+
+/* The chunks of a class slab sit next to each other, so a block from
+ * a size class has parked chunks, not free space, on its right.  Give
+ * them back to the heap until c and the free chunk on its right add
+ * up to sz units, or a chunk in use by someone else is in the way.
+ */
+static void class_make_room(struct sys_heap *heap, chunkid_t c, chunksz_t sz)
+{
+	struct z_heap *h = heap->heap;
+
+	while (true) {
+		chunkid_t rc = right_chunk(h, c);
+		chunksz_t room = chunk_size(h, c);
+
+		if (!chunk_used(h, rc)) {
+			room += chunk_size(h, rc);
+			rc = right_chunk(h, rc);
+		}
+
+		if ((room >= sz) || (rc == h->end_chunk) ||
+		    !class_unpark(heap, rc)) {
+			return;
+		}
+	}
+}
+#endif /* CONFIG_SYS_HEAP_SIZE_CLASSES */
+
 /*
  * Return the closest chunk ID corresponding to given memory pointer.
  * Here "closest" is only meaningful in the context of sys_heap_aligned_alloc()
@@ -184,16 +426,22 @@ void sys_heap_free(struct sys_heap *heap, void *mem)
 		 "corrupted heap bounds (buffer overflow?) for memory at %p",
 		 mem);
 
-	set_chunk_used(h, c, false);
-#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
-	h->allocated_bytes -= chunksz_to_bytes(h, chunk_size(h, c));
-#endif
-
 #ifdef CONFIG_SYS_HEAP_LISTENER
 	heap_listener_notify_free(HEAP_ID_FROM_POINTER(heap), mem,
 				  chunksz_to_bytes(h, chunk_size(h, c)));
 #endif
 
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+	if (class_free(heap, c)) {
+		return;
+	}
+#endif
+
+	set_chunk_used(h, c, false);
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	h->allocated_bytes -= chunksz_to_bytes(h, chunk_size(h, c));
+#endif
+
 	free_chunk(h, c);
 }
 
@@ -210,6 +458,14 @@ size_t sys_heap_usable_size(struct sys_heap *heap, void *mem)
 
 static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 {
+	/* size_too_big() doesn't account for the chunk header, so a
+	 * request it lets through may still not fit in the heap.  Don't
+	 * look it up past the last bucket.
+	 */
+	if (sz >= h->end_chunk) {
+		return 0;
+	}
+
 	int bi = bucket_idx(h, sz);
 	struct z_heap_bucket *b = &h->buckets[bi];
 
@@ -260,6 +516,23 @@ static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 	return 0;
 }
 
+/* Like alloc_chunk(), but returns any chunks cached in the size
+ * classes to the heap and retries before failing.
+ */
+static chunkid_t alloc_chunk_or_flush(struct sys_heap *heap, chunksz_t sz)
+{
+	struct z_heap *h = heap->heap;
+	chunkid_t c = alloc_chunk(h, sz);
+
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+	if ((c == 0U) && classes_flush(heap)) {
+		c = alloc_chunk(h, sz);
+	}
+#endif
+
+	return c;
+}
+
 void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 {
 	struct z_heap *h = heap->heap;
@@ -270,7 +543,16 @@ void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 	}
 
 	chunksz_t chunk_sz = bytes_to_chunksz(h, bytes);
-	chunkid_t c = alloc_chunk(h, chunk_sz);
+	chunkid_t c = 0U;
+
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+	if (bytes <= CONFIG_SYS_HEAP_SIZE_CLASS_MAX) {
+		c = class_alloc(heap, chunk_sz);
+	}
+#endif
+	if (c == 0U) {
+		c = alloc_chunk_or_flush(heap, chunk_sz);
+	}
 	if (c == 0U) {
 		return NULL;
 	}
@@ -323,6 +605,16 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 	}
 	__ASSERT((align & (align - 1)) == 0, "align must be a power of 2");
 
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+	/* e.g. k_malloc() on 32 bit targets: let small requests use the
+	 * size classes when any chunk will do.
+	 */
+	if ((bytes <= CONFIG_SYS_HEAP_SIZE_CLASS_MAX) &&
+	    naturally_aligned(h, align | rew)) {
+		return sys_heap_alloc(heap, bytes);
+	}
+#endif
+
 	if (bytes == 0 || size_too_big(h, bytes)) {
 		return NULL;
 	}
@@ -333,7 +625,7 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 	 * the extra allocations afterwards.
 	 */
 	chunksz_t padded_sz = bytes_to_chunksz(h, bytes + align - gap);
-	chunkid_t c0 = alloc_chunk(h, padded_sz);
+	chunkid_t c0 = alloc_chunk_or_flush(heap, padded_sz);
 
 	if (c0 == 0) {
 		return NULL;
@@ -400,8 +692,15 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 	chunkid_t rc = right_chunk(h, c);
 	size_t align_gap = (uint8_t *)ptr - (uint8_t *)chunk_mem(h, c);
 	chunksz_t chunks_need = bytes_to_chunksz(h, bytes + align_gap);
+	bool misaligned = align && ((uintptr_t)ptr & (align - 1));
 
-	if (align && ((uintptr_t)ptr & (align - 1))) {
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+	if (!misaligned && (chunk_size(h, c) < chunks_need)) {
+		class_make_room(heap, c, chunks_need);
+	}
+#endif
+
+	if (misaligned) {
 		/* ptr is not sufficiently aligned */
 	} else if (chunk_size(h, c) == chunks_need) {
 		/* We're good already */
@@ -527,6 +826,14 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 		h->buckets[i].next = 0;
 	}
 
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+	(void)memset(&heap->classes, 0, sizeof(heap->classes));
+#endif
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+	heap->cpu_cache_suspended = 0U;
+	(void)memset(heap->cpu_cache, 0, sizeof(heap->cpu_cache));
+#endif
+
 	/* chunk containing our struct z_heap */
 	set_chunk_size(h, 0, chunk0_size);
 	set_left_chunk_size(h, 0, 0);
@@ -543,3 +850,100 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 
 	free_list_add(h, chunk0_size);
 }
+
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+void *sys_heap_cpu_cache_alloc(struct sys_heap *heap, size_t align, size_t bytes)
+{
+	struct z_heap *h = heap->heap;
+
+	if ((bytes == 0U) || (bytes > CONFIG_SYS_HEAP_SIZE_CLASS_MAX) ||
+	    !naturally_aligned(h, align)) {
+		return NULL;
+	}
+
+	int cls = size_class(h, bytes_to_chunksz(h, bytes));
+	unsigned int irq = arch_irq_lock();
+	struct z_heap_cpu_cache *cache = &heap->cpu_cache[arch_curr_cpu()->id];
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+	chunkid_t c = class_pop(h, &cache->classes, cls);
+
+	k_spin_unlock(&cache->lock, key);
+	arch_irq_unlock(irq);
+
+	if (c == 0U) {
+		return NULL;
+	}
+
+	void *mem = chunk_mem(h, c);
+
+#ifdef CONFIG_SYS_HEAP_LISTENER
+	heap_listener_notify_alloc(HEAP_ID_FROM_POINTER(heap), mem,
+				   chunksz_to_bytes(h, chunk_size(h, c)));
+#endif
+
+	IF_ENABLED(CONFIG_MSAN, (__msan_allocated_memory(mem, bytes)));
+	return mem;
+}
+
+bool sys_heap_cpu_cache_free(struct sys_heap *heap, void *mem)
+{
+	if (mem == NULL) {
+		return false;
+	}
+
+	struct z_heap *h = heap->heap;
+	chunkid_t c = mem_to_chunkid(h, mem);
+
+	/* Our own header can't change under us while we own the block,
+	 * so these are safe without the heap lock.
+	 */
+	__ASSERT(chunk_used(h, c),
+		 "unexpected heap state (double-free?) for memory at %p", mem);
+	__ASSERT(left_chunk(h, right_chunk(h, c)) == c,
+		 "corrupted heap bounds (buffer overflow?) for memory at %p",
+		 mem);
+
+	int cls = size_class(h, chunk_size(h, c));
+	bool cached = false;
+
+	if (cls < 0) {
+		return false;
+	}
+
+	unsigned int irq = arch_irq_lock();
+	struct z_heap_cpu_cache *cache = &heap->cpu_cache[arch_curr_cpu()->id];
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+
+	if ((heap->cpu_cache_suspended == 0U) &&
+	    (cache->classes.count[cls] < CONFIG_SYS_HEAP_PERCPU_CACHE_DEPTH)) {
+		class_push(h, &cache->classes, cls, c);
+		cached = true;
+	}
+
+	k_spin_unlock(&cache->lock, key);
+	arch_irq_unlock(irq);
+
+#ifdef CONFIG_SYS_HEAP_LISTENER
+	if (cached) {
+		heap_listener_notify_free(HEAP_ID_FROM_POINTER(heap), mem,
+					  chunksz_to_bytes(h, chunk_size(h, c)));
+	}
+#endif
+
+	return cached;
+}
+
+void sys_heap_cpu_cache_suspend(struct sys_heap *heap)
+{
+	/* Frees check the count under their cache lock, so once a cache
+	 * has been drained below it stays empty.
+	 */
+	heap->cpu_cache_suspended++;
+	(void)cpu_caches_drain(heap);
+}
+
+void sys_heap_cpu_cache_resume(struct sys_heap *heap)
+{
+	heap->cpu_cache_suspended--;
+}
+#endif /* CONFIG_SYS_HEAP_PERCPU_CACHE */
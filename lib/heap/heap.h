@@ -253,6 +253,58 @@ static inline int bucket_idx(struct z_heap *h, chunksz_t sz)
 	return 31 - __builtin_clz(usable_sz);
 }
 
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+/* Size classes are exact chunk sizes, starting at min_chunk_size().
+ * Chunks sitting in a class list (struct z_heap_classes, kept in the
+ * struct sys_heap) stay marked used as far as the rest of the heap is
+ * concerned, and are linked through their FREE_NEXT field into a
+ * NULL-terminated list.
+ */
+#define SIZE_CLASSES Z_HEAP_SIZE_CLASSES
+
+/* Returns the size class for a chunk size, or -1 if there is none */
+static inline int size_class(struct z_heap *h, chunksz_t sz)
+{
+	unsigned int cls = sz - min_chunk_size(h);
+
+	return (cls < SIZE_CLASSES) ? (int)cls : -1;
+}
+
+static inline size_t classes_bytes(struct z_heap *h,
+				   struct z_heap_classes *classes)
+{
+	size_t bytes = 0;
+
+	for (int cls = 0; cls < SIZE_CLASSES; cls++) {
+		bytes += classes->count[cls] *
+			 chunksz_to_bytes(h, min_chunk_size(h) + cls);
+	}
+
+	return bytes;
+}
+#endif
+
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+/* Bytes parked in the per-CPU caches, which are still counted in
+ * allocated_bytes as they come and go without the heap lock.
+ */
+static inline size_t cpu_cache_bytes(struct sys_heap *heap)
+{
+	struct z_heap *h = heap->heap;
+	size_t bytes = 0;
+
+	for (int i = 0; i < CONFIG_MP_MAX_NUM_CPUS; i++) {
+		struct z_heap_cpu_cache *cache = &heap->cpu_cache[i];
+		k_spinlock_key_t key = k_spin_lock(&cache->lock);
+
+		bytes += classes_bytes(h, &cache->classes);
+		k_spin_unlock(&cache->lock, key);
+	}
+
+	return bytes;
+}
+#endif
+
 static inline bool size_too_big(struct z_heap *h, size_t bytes)
 {
 	/*
@@ -262,9 +314,10 @@ static inline bool size_too_big(struct z_heap *h, size_t bytes)
 	return (bytes / CHUNK_UNIT) >= h->end_chunk;
 }
 
-static inline void get_alloc_info(struct z_heap *h, size_t *alloc_bytes,
+static inline void get_alloc_info(struct sys_heap *heap, size_t *alloc_bytes,
 			   size_t *free_bytes)
 {
+	struct z_heap *h = heap->heap;
 	chunkid_t c;
 
 	*alloc_bytes = 0;
@@ -277,6 +330,17 @@ static inline void get_alloc_info(struct z_heap *h, size_t *alloc_bytes,
 			*free_bytes += chunksz_to_bytes(h, chunk_size(h, c));
 		}
 	}
+
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+	/* Chunks waiting in the class lists are marked used */
+	size_t cached = classes_bytes(h, &heap->classes);
+
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+	cached += cpu_cache_bytes(heap);
+#endif
+	*alloc_bytes -= cached;
+	*free_bytes += cached;
+#endif
 }
 
 #endif /* ZEPHYR_INCLUDE_LIB_OS_HEAP_H_ */
@@ -11,8 +11,9 @@
 /*
  * Print heap info for debugging / analysis purpose
  */
-static void heap_print_info(struct z_heap *h, bool dump_chunks)
+static void heap_print_info(struct sys_heap *heap, bool dump_chunks)
 {
+	struct z_heap *h = heap->heap;
 	int i, nb_buckets = bucket_idx(h, h->end_chunk) + 1;
 	size_t free_bytes, allocated_bytes, total, overhead;
 
@@ -60,7 +61,7 @@ static void heap_print_info(struct z_heap *h, bool dump_chunks)
 		}
 	}
 
-	get_alloc_info(h, &allocated_bytes, &free_bytes);
+	get_alloc_info(heap, &allocated_bytes, &free_bytes);
 	/* The end marker chunk has a header. It is part of the overhead. */
 	total = h->end_chunk * CHUNK_UNIT + chunk_header_bytes(h);
 	overhead = total - free_bytes - allocated_bytes;
@@ -72,5 +73,5 @@ static void heap_print_info(struct z_heap *h, bool dump_chunks)
 
 void sys_heap_print_info(struct sys_heap *heap, bool dump_chunks)
 {
-	heap_print_info(heap->heap, dump_chunks);
+	heap_print_info(heap, dump_chunks);
 }
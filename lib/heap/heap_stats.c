@@ -19,6 +19,16 @@ int sys_heap_runtime_stats_get(struct sys_heap *heap,
 	stats->allocated_bytes = heap->heap->allocated_bytes;
 	stats->max_allocated_bytes = heap->heap->max_allocated_bytes;
 
+#ifdef CONFIG_SYS_HEAP_PERCPU_CACHE
+	/* max_allocated_bytes can't be corrected after the fact, it
+	 * counts cached blocks as allocated.
+	 */
+	size_t cached = cpu_cache_bytes(heap);
+
+	stats->free_bytes += cached;
+	stats->allocated_bytes -= cached;
+#endif
+
 	return 0;
 }
 
@@ -6,6 +6,7 @@
 #include <zephyr/sys/sys_heap.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/kernel.h>
+#include <string.h>
 #include "heap.h"
 
 struct z_heap_stress_rec {
@@ -25,6 +26,64 @@ struct z_heap_stress_block {
 	size_t sz;
 };
 
+/* Log-linear latency histogram: exact below 8 cycles, then 8
+ * sub-buckets per power of two, so every bucket is within 12.5% of
+ * the values it holds.  Static as the rig isn't reentrant anyway and
+ * these are too big for a test thread stack.
+ */
+#define LAT_SUB_BITS 3
+#define LAT_SUB      BIT(LAT_SUB_BITS)
+#define LAT_BUCKETS  ((32 - LAT_SUB_BITS + 1) * LAT_SUB)
+
+static uint32_t alloc_hist[LAT_BUCKETS];
+static uint32_t free_hist[LAT_BUCKETS];
+
+static int lat_bucket(uint32_t cycles)
+{
+	if (cycles < LAT_SUB) {
+		return cycles;
+	}
+
+	int msb = 31 - __builtin_clz(cycles);
+	int sub = (cycles >> (msb - LAT_SUB_BITS)) & (LAT_SUB - 1);
+
+	return (msb - LAT_SUB_BITS + 1) * LAT_SUB + sub;
+}
+
+static uint32_t lat_bucket_floor(int bucket)
+{
+	if (bucket < LAT_SUB) {
+		return bucket;
+	}
+
+	int shift = bucket / LAT_SUB - 1;
+
+	return (LAT_SUB + bucket % LAT_SUB) << shift;
+}
+
+static void lat_summarize(uint32_t *hist, uint32_t max,
+			  struct z_heap_stress_latency *lat)
+{
+	static const uint32_t pcts[] = { 50, 90, 99 };
+	uint32_t *outs[] = { &lat->p50, &lat->p90, &lat->p99 };
+	uint64_t total = 0, seen = 0;
+	int p = 0;
+
+	for (int i = 0; i < LAT_BUCKETS; i++) {
+		total += hist[i];
+	}
+
+	*lat = (struct z_heap_stress_latency) { .max = max };
+
+	for (int i = 0; i < LAT_BUCKETS && p < ARRAY_SIZE(pcts); i++) {
+		seen += hist[i];
+		while (p < ARRAY_SIZE(pcts) && total != 0 &&
+		       seen * 100 >= total * pcts[p]) {
+			*outs[p++] = lat_bucket_floor(i);
+		}
+	}
+}
+
 /* Very simple LCRNG (from https://nuclear.llnl.gov/CNP/rng/rngman/node4.html)
  *
  * Here to guarantee cross-platform test repeatability.
@@ -122,13 +181,21 @@ void sys_heap_stress(void *(*alloc_fn)(void *arg, size_t bytes),
 	       .target_percent = target_percent,
 	};
 
+	uint32_t alloc_max = 0, free_max = 0;
+
 	*result = (struct z_heap_stress_result) {0};
+	memset(alloc_hist, 0, sizeof(alloc_hist));
+	memset(free_hist, 0, sizeof(free_hist));
 
 	for (uint32_t i = 0; i < op_count; i++) {
 		if (rand_alloc_choice(&sr)) {
 			size_t sz = rand_alloc_size(&sr);
+			uint32_t t0 = k_cycle_get_32();
 			void *p = sr.alloc_fn(sr.arg, sz);
+			uint32_t dt = k_cycle_get_32() - t0;
 
+			alloc_hist[lat_bucket(dt)]++;
+			alloc_max = MAX(alloc_max, dt);
 			result->total_allocs++;
 			if (p != NULL) {
 				result->successful_allocs++;
@@ -146,8 +213,19 @@ void sys_heap_stress(void *(*alloc_fn)(void *arg, size_t bytes),
 			sr.blocks[b] = sr.blocks[sr.blocks_alloced - 1];
 			sr.blocks_alloced--;
 			sr.bytes_alloced -= sz;
+
+			uint32_t t0 = k_cycle_get_32();
+
 			sr.free_fn(sr.arg, p);
+
+			uint32_t dt = k_cycle_get_32() - t0;
+
+			free_hist[lat_bucket(dt)]++;
+			free_max = MAX(free_max, dt);
 		}
 		result->accumulated_in_use_bytes += sr.bytes_alloced;
 	}
+
+	lat_summarize(alloc_hist, alloc_max, &result->alloc_latency);
+	lat_summarize(free_hist, free_max, &result->free_latency);
 }
@@ -95,7 +95,7 @@ bool sys_heap_validate(struct sys_heap *heap)
 	size_t allocated_bytes, free_bytes;
 	struct sys_memory_stats stat;
 
-	get_alloc_info(h, &allocated_bytes, &free_bytes);
+	get_alloc_info(heap, &allocated_bytes, &free_bytes);
 	sys_heap_runtime_stats_get(heap, &stat);
 	if ((stat.allocated_bytes != allocated_bytes) ||
 	    (stat.free_bytes != free_bytes)) {
@@ -103,6 +103,28 @@ bool sys_heap_validate(struct sys_heap *heap)
 	}
 #endif
 
+#ifdef CONFIG_SYS_HEAP_SIZE_CLASSES
+	/* Chunks parked in the size classes stay marked used and must
+	 * all be of their class size.
+	 */
+	for (int cls = 0; cls < SIZE_CLASSES; cls++) {
+		uint32_t n = 0;
+
+		for (c = heap->classes.next[cls]; c != 0;
+		     n++, c = next_free_chunk(h, c)) {
+			if ((n >= heap->classes.count[cls]) ||
+			    !valid_chunk(h, c) || !chunk_used(h, c) ||
+			    (size_class(h, chunk_size(h, c)) != cls)) {
+				return false;
+			}
+		}
+
+		if (n != heap->classes.count[cls]) {
+			return false;
+		}
+	}
+#endif
+
 	/* Check the free lists: entry count should match, empty bit
 	 * should be correct, and all chunk entries should point into
 	 * valid unused chunks.  Mark those chunks USED, temporarily.
@@ -0,0 +1,482 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+#include <zephyr/sys/slist.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/drivers/disk.h>
+
+#include "disk_cache.h"
+
+#define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(disk);
+
+#define CACHE_SS CONFIG_DISK_CACHE_SECTOR_SIZE
+
+/* Requests larger than this go straight to the disk, rather than evicting
+ * most of the cache.
+ */
+#define CACHE_MAX_REQUEST (CONFIG_DISK_CACHE_BLOCKS / 2)
+
+struct disk_cache_block {
+	uint8_t data[CACHE_SS] __aligned(4);
+	/* LRU list node, most recently used first */
+	sys_dnode_t node;
+	/* Hash bucket node, when the block holds a sector */
+	sys_snode_t hash_node;
+	/* Disk the sector belongs to, NULL when the block is unused */
+	struct disk_info *disk;
+	uint32_t sector;
+	bool dirty;
+};
+
+static struct disk_cache_block blocks[CONFIG_DISK_CACHE_BLOCKS];
+static sys_dlist_t lru = SYS_DLIST_STATIC_INIT(&lru);
+static bool lru_ready;
+
+/* Blocks holding a sector, hashed by disk and sector */
+static sys_slist_t cache_hash[CONFIG_DISK_CACHE_BLOCKS];
+
+/* Sectors read ahead, or consecutive sectors written back at once */
+static uint8_t burst_buf[CONFIG_DISK_CACHE_BURST * CACHE_SS] __aligned(4);
+
+/* Protects the blocks, and serializes the requests to the cached disks */
+static K_MUTEX_DEFINE(cache_lock);
+
+static void cache_lru_init(void)
+{
+	if (lru_ready) {
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		sys_dlist_append(&lru, &blocks[i].node);
+	}
+
+	lru_ready = true;
+}
+
+static inline sys_slist_t *cache_bucket(struct disk_info *disk, uint32_t sector)
+{
+	/* consecutive sectors of a disk land in different buckets */
+	return &cache_hash[((uintptr_t)disk / sizeof(void *) + sector) %
+			   ARRAY_SIZE(cache_hash)];
+}
+
+static struct disk_cache_block *cache_find(struct disk_info *disk, uint32_t sector)
+{
+	struct disk_cache_block *blk;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(cache_bucket(disk, sector), blk, hash_node) {
+		if ((blk->disk == disk) && (blk->sector == sector)) {
+			return blk;
+		}
+	}
+
+	return NULL;
+}
+
+/* The block does not hold a sector anymore, its changes are lost */
+static void cache_forget(struct disk_cache_block *blk)
+{
+	sys_slist_find_and_remove(cache_bucket(blk->disk, blk->sector), &blk->hash_node);
+	blk->disk = NULL;
+	blk->dirty = false;
+}
+
+static void cache_touch(struct disk_cache_block *blk)
+{
+	sys_dlist_remove(&blk->node);
+	sys_dlist_prepend(&lru, &blk->node);
+}
+
+static inline struct disk_cache_block *cache_lru_tail(void)
+{
+	return CONTAINER_OF(sys_dlist_peek_tail(&lru), struct disk_cache_block, node);
+}
+
+/* Write back the run of consecutive dirty sectors blk is part of, in a
+ * single command of up to CONFIG_DISK_CACHE_BURST sectors.
+ */
+static int cache_write_back(struct disk_info *disk, struct disk_cache_block *blk)
+{
+	struct disk_cache_block *run[CONFIG_DISK_CACHE_BURST];
+	struct disk_cache_block *prev;
+	uint32_t ss = disk->cache.sector_size;
+	uint32_t start = blk->sector;
+	uint32_t n;
+	int rc;
+
+	for (n = 1; (n < CONFIG_DISK_CACHE_BURST) && (start > 0); n++) {
+		prev = cache_find(disk, start - 1);
+		if ((prev == NULL) || !prev->dirty) {
+			break;
+		}
+		start--;
+	}
+
+	for (n = 0; n < CONFIG_DISK_CACHE_BURST; n++) {
+		run[n] = cache_find(disk, start + n);
+		if ((run[n] == NULL) || !run[n]->dirty) {
+			break;
+		}
+		memcpy(&burst_buf[n * ss], run[n]->data, ss);
+	}
+
+	rc = disk->ops->write(disk, burst_buf, start, n);
+	if (rc) {
+		LOG_ERR("write back of %u sectors at %u failed (%d)", n, start, rc);
+		return rc;
+	}
+
+	for (uint32_t i = 0; i < n; i++) {
+		run[i]->dirty = false;
+	}
+
+	disk->cache.stats.written += n;
+	disk->cache.stats.write_cmds++;
+
+	return 0;
+}
+
+/* Make the least recently used block hold a sector of a disk */
+static int cache_alloc(struct disk_info *disk, uint32_t sector,
+		       struct disk_cache_block **out)
+{
+	struct disk_cache_block *blk = cache_lru_tail();
+	int rc;
+
+	if (blk->dirty) {
+		rc = cache_write_back(blk->disk, blk);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	if (blk->disk != NULL) {
+		cache_forget(blk);
+	}
+
+	blk->disk = disk;
+	blk->sector = sector;
+	sys_slist_prepend(cache_bucket(disk, sector), &blk->hash_node);
+	cache_touch(blk);
+
+	*out = blk;
+	return 0;
+}
+
+/* Write back the dirty blocks among the n least recently used ones, so
+ * that the next n allocations do not need burst_buf.
+ */
+static int cache_reserve(uint32_t n)
+{
+	struct disk_cache_block *blk = cache_lru_tail();
+	int rc;
+
+	while (n--) {
+		if (blk->dirty) {
+			rc = cache_write_back(blk->disk, blk);
+			if (rc) {
+				return rc;
+			}
+		}
+		blk = CONTAINER_OF(sys_dlist_peek_prev_no_check(&lru, &blk->node),
+				   struct disk_cache_block, node);
+	}
+
+	return 0;
+}
+
+/* Read a run of sectors missing from the cache, and the sectors after them
+ * when the read is sequential, then keep them in the cache.
+ */
+static int cache_fill(struct disk_info *disk, uint8_t *data_buf,
+		      uint32_t sector, uint32_t run, bool sequential)
+{
+	struct disk_cache_block *blk;
+	uint32_t ss = disk->cache.sector_size;
+	uint32_t cnt = run;
+	uint8_t *src = data_buf;
+	int rc;
+
+	if (IS_ENABLED(CONFIG_DISK_CACHE_READ_AHEAD) && sequential &&
+	    (run < CONFIG_DISK_CACHE_BURST)) {
+		cnt = MIN(CONFIG_DISK_CACHE_BURST, disk->cache.sector_count - sector);
+		src = burst_buf;
+	}
+
+	rc = cache_reserve(cnt);
+	if (rc) {
+		return rc;
+	}
+
+	rc = disk->ops->read(disk, src, sector, cnt);
+	if (rc) {
+		return rc;
+	}
+
+	if (src != data_buf) {
+		memcpy(data_buf, src, run * ss);
+	}
+
+	disk->cache.stats.misses += run;
+	disk->cache.stats.read_ahead += cnt - run;
+
+	for (uint32_t i = 0; i < cnt; i++) {
+		/* sectors read ahead may be cached already, and dirty */
+		if ((i >= run) && (cache_find(disk, sector + i) != NULL)) {
+			continue;
+		}
+
+		rc = cache_alloc(disk, sector + i, &blk);
+		if (rc) {
+			return rc;
+		}
+
+		memcpy(blk->data, &src[i * ss], ss);
+		blk->dirty = false;
+	}
+
+	return 0;
+}
+
+static bool cache_usable(struct disk_info *disk, uint32_t start_sector,
+			 uint32_t num_sector)
+{
+	uint32_t end = start_sector + num_sector;
+
+	/* Leave requests out of the disk for the driver to fail */
+	return (disk->cache.sector_size != 0U) && (end >= start_sector) &&
+	       (end <= disk->cache.sector_count);
+}
+
+/* Forget the sectors of a disk, returns the number of them not written back */
+static uint32_t cache_forget_disk(struct disk_info *disk)
+{
+	struct disk_cache_block *blk;
+	uint32_t lost = 0U;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&lru, blk, node) {
+		if (blk->disk == disk) {
+			lost += blk->dirty ? 1U : 0U;
+			cache_forget(blk);
+		}
+	}
+
+	return lost;
+}
+
+void disk_cache_init(struct disk_info *disk)
+{
+	uint32_t sector_size = 0U, sector_count = 0U;
+	uint32_t lost;
+
+	if ((disk->ops->ioctl == NULL) ||
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE, &sector_size) ||
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_COUNT, &sector_count)) {
+		LOG_WRN("disk %s: unknown geometry, not cached", disk->name);
+		sector_size = 0U;
+	} else if (sector_size > CACHE_SS) {
+		LOG_WRN("disk %s: sectors of %u bytes, not cached", disk->name,
+			sector_size);
+		sector_size = 0U;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	cache_lru_init();
+
+	/* Another medium, the cached sectors are not its own */
+	if ((disk->cache.sector_size != sector_size) ||
+	    (disk->cache.sector_count != sector_count)) {
+		lost = cache_forget_disk(disk);
+		if (lost > 0U) {
+			LOG_WRN("disk %s: geometry changed, %u cached sectors lost",
+				disk->name, lost);
+		}
+	}
+
+	disk->cache.sector_size = sector_size;
+	disk->cache.sector_count = sector_count;
+	disk->cache.next_sector = UINT32_MAX;
+	k_mutex_unlock(&cache_lock);
+}
+
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_block *blk;
+	uint32_t ss = disk->cache.sector_size;
+	uint32_t i = 0, run;
+	bool sequential;
+	int rc = 0;
+
+	if (!cache_usable(disk, start_sector, num_sector)) {
+		return disk->ops->read(disk, data_buf, start_sector, num_sector);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	sequential = (start_sector == disk->cache.next_sector);
+	disk->cache.next_sector = start_sector + num_sector;
+
+	if (num_sector > CACHE_MAX_REQUEST) {
+		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+		if (rc) {
+			goto out;
+		}
+
+		disk->cache.stats.misses += num_sector;
+
+		/* the cache holds the latest data of the sectors not written back */
+		SYS_DLIST_FOR_EACH_CONTAINER(&lru, blk, node) {
+			if ((blk->disk == disk) && blk->dirty &&
+			    (blk->sector - start_sector < num_sector)) {
+				memcpy(&data_buf[(blk->sector - start_sector) * ss],
+				       blk->data, ss);
+			}
+		}
+
+		goto out;
+	}
+
+	while (i < num_sector) {
+		blk = cache_find(disk, start_sector + i);
+		if (blk != NULL) {
+			memcpy(&data_buf[i * ss], blk->data, ss);
+			cache_touch(blk);
+			disk->cache.stats.hits++;
+			i++;
+			continue;
+		}
+
+		for (run = 1; i + run < num_sector; run++) {
+			if (cache_find(disk, start_sector + i + run) != NULL) {
+				break;
+			}
+		}
+
+		rc = cache_fill(disk, &data_buf[i * ss], start_sector + i, run,
+				sequential);
+		if (rc) {
+			break;
+		}
+
+		i += run;
+	}
+
+out:
+	k_mutex_unlock(&cache_lock);
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_block *blk;
+	uint32_t ss = disk->cache.sector_size;
+	int rc = 0;
+
+	if (!cache_usable(disk, start_sector, num_sector)) {
+		return disk->ops->write(disk, data_buf, start_sector, num_sector);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (!IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK) ||
+	    (num_sector > CACHE_MAX_REQUEST)) {
+		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+		if (rc) {
+			goto out;
+		}
+
+		disk->cache.stats.written += num_sector;
+		disk->cache.stats.write_cmds++;
+
+		/* cached sectors now hold the same data as the disk */
+		SYS_DLIST_FOR_EACH_CONTAINER(&lru, blk, node) {
+			if ((blk->disk == disk) &&
+			    (blk->sector - start_sector < num_sector)) {
+				memcpy(blk->data,
+				       &data_buf[(blk->sector - start_sector) * ss], ss);
+				blk->dirty = false;
+			}
+		}
+
+		goto out;
+	}
+
+	for (uint32_t i = 0; i < num_sector; i++) {
+		blk = cache_find(disk, start_sector + i);
+		if (blk != NULL) {
+			cache_touch(blk);
+		} else {
+			rc = cache_alloc(disk, start_sector + i, &blk);
+			if (rc) {
+				break;
+			}
+		}
+
+		memcpy(blk->data, &data_buf[i * ss], ss);
+		blk->dirty = true;
+	}
+
+out:
+	k_mutex_unlock(&cache_lock);
+	return rc;
+}
+
+int disk_cache_sync(struct disk_info *disk)
+{
+	struct disk_cache_block *blk;
+	int rc = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&lru, blk, node) {
+		if ((blk->disk == disk) && blk->dirty) {
+			rc = cache_write_back(disk, blk);
+			if (rc) {
+				break;
+			}
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+	return rc;
+}
+
+void disk_cache_drop(struct disk_info *disk)
+{
+	if (disk_cache_sync(disk)) {
+		LOG_WRN("disk %s: cached data lost", disk->name);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	(void)cache_forget_disk(disk);
+	disk->cache.sector_size = 0U;
+
+	k_mutex_unlock(&cache_lock);
+}
+
+void disk_cache_stats_get(struct disk_info *disk, struct disk_cache_stats *stats)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	*stats = disk->cache.stats;
+	k_mutex_unlock(&cache_lock);
+}
+
+void disk_cache_stats_reset(struct disk_info *disk)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	memset(&disk->cache.stats, 0, sizeof(disk->cache.stats));
+	k_mutex_unlock(&cache_lock);
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+#define ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+
+#include <zephyr/drivers/disk.h>
+
+/* Set up the cache of a disk its driver has just initialized */
+void disk_cache_init(struct disk_info *disk);
+
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector);
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector);
+
+/* Write back the sectors of the disk changed in the cache */
+int disk_cache_sync(struct disk_info *disk);
+
+/* Write back then forget the sectors of a disk going away */
+void disk_cache_drop(struct disk_info *disk);
+
+void disk_cache_stats_get(struct disk_info *disk, struct disk_cache_stats *stats);
+
+void disk_cache_stats_reset(struct disk_info *disk);
+
+#endif /* ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_ */
@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include "ext2.h"
+#include "ext2_impl.h"
+#include "ext2_struct.h"
+#include "ext2_diskops.h"
+
+LOG_MODULE_DECLARE(ext2);
+
+/* Blocks which may be in use at the same time and blocks kept only in the cache. */
+#define CACHE_BLOCKS (CONFIG_EXT2_MAX_BLOCK_COUNT + CONFIG_EXT2_BLOCK_CACHE_COUNT)
+
+/* Number of dirty blocks waking up the write back thread. */
+#define DIRTY_THRESHOLD MAX(CACHE_BLOCKS / 2, 1)
+
+static struct ext2_block cache_blocks[CACHE_BLOCKS];
+static uint8_t __aligned(sizeof(void *)) cache_memory[CACHE_BLOCKS * CONFIG_EXT2_MAX_BLOCK_SIZE];
+
+/* Blocks with a number, hashed by that number */
+static sys_slist_t cache_hash[CACHE_BLOCKS];
+
+/* Unused blocks with a number, the least recently used first */
+static sys_dlist_t cache_lru;
+
+/* Unused blocks without a number */
+static sys_dlist_t cache_free;
+
+static uint32_t cache_dirty;
+
+static K_MUTEX_DEFINE(cache_lock);
+
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+static K_THREAD_STACK_DEFINE(flush_stack, CONFIG_EXT2_BLOCK_CACHE_FLUSH_STACK_SIZE);
+static K_SEM_DEFINE(flush_sem, 0, 1);
+static bool flush_running;
+static bool flush_stop;
+
+/* First error of the write back thread, returned by the next flush */
+static int flush_error;
+#endif
+
+static inline sys_slist_t *cache_bucket(uint32_t num)
+{
+	return &cache_hash[num % CACHE_BLOCKS];
+}
+
+static struct ext2_block *cache_find(uint32_t num)
+{
+	struct ext2_block *b;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(cache_bucket(num), b, hash_node) {
+		if (b->num == num) {
+			return b;
+		}
+	}
+	return NULL;
+}
+
+static void cache_insert(struct ext2_block *b)
+{
+	sys_slist_prepend(cache_bucket(b->num), &b->hash_node);
+	b->flags |= EXT2_BLOCK_HASHED;
+}
+
+/* The block is not found by its number anymore and its changes are lost. */
+static void cache_remove(struct ext2_block *b)
+{
+	sys_slist_find_and_remove(cache_bucket(b->num), &b->hash_node);
+	if (b->flags & EXT2_BLOCK_DIRTY) {
+		cache_dirty--;
+	}
+	b->flags &= ~(EXT2_BLOCK_HASHED | EXT2_BLOCK_DIRTY);
+}
+
+static void cache_reset(void)
+{
+	sys_dlist_init(&cache_lru);
+	sys_dlist_init(&cache_free);
+
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		sys_slist_init(&cache_hash[i]);
+		cache_blocks[i].ref = 0;
+		cache_blocks[i].flags = 0;
+		sys_dlist_append(&cache_free, &cache_blocks[i].lru_node);
+	}
+	cache_dirty = 0;
+}
+
+static int cache_write_back(struct ext2_data *fs, struct ext2_block *b)
+{
+	int ret;
+
+	ret = fs->backend_ops->write_block(fs, b->data, b->num);
+	if (ret < 0) {
+		LOG_ERR("write back: block %d write error %d", b->num, ret);
+		return ret;
+	}
+
+	b->flags &= ~EXT2_BLOCK_DIRTY;
+	cache_dirty--;
+	return 0;
+}
+
+static int cache_flush(struct ext2_data *fs)
+{
+	int rc, ret = 0;
+
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		if (cache_blocks[i].flags & EXT2_BLOCK_DIRTY) {
+			rc = cache_write_back(fs, &cache_blocks[i]);
+			if (rc < 0) {
+				ret = rc;
+			}
+		}
+	}
+	return ret;
+}
+
+/* Take an unused block, evicting the least recently used one when no block is free. */
+static struct ext2_block *cache_alloc(struct ext2_data *fs)
+{
+	struct ext2_block *b;
+	sys_dnode_t *node;
+
+	node = sys_dlist_peek_head(&cache_free);
+	if (node == NULL) {
+		node = sys_dlist_peek_head(&cache_lru);
+	}
+	if (node == NULL) {
+		LOG_ERR("get block: all %d blocks in use", CACHE_BLOCKS);
+		return NULL;
+	}
+
+	b = CONTAINER_OF(node, struct ext2_block, lru_node);
+	if ((b->flags & EXT2_BLOCK_DIRTY) && cache_write_back(fs, b) < 0) {
+		return NULL;
+	}
+
+	sys_dlist_remove(node);
+	if (b->flags & EXT2_BLOCK_HASHED) {
+		cache_remove(b);
+	}
+	b->ref = 1;
+	return b;
+}
+
+struct ext2_block *ext2_get_block(struct ext2_data *fs, uint32_t block)
+{
+	int ret;
+	struct ext2_block *b;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	b = cache_find(block);
+	if (b != NULL) {
+		if (b->ref++ == 0) {
+			sys_dlist_remove(&b->lru_node);
+		}
+		goto out;
+	}
+
+	b = cache_alloc(fs);
+	if (b == NULL) {
+		goto out;
+	}
+
+	ret = fs->backend_ops->read_block(fs, b->data, block);
+	if (ret < 0) {
+		LOG_ERR("get block: read block error %d", ret);
+		b->ref = 0;
+		b->flags = 0;
+		sys_dlist_append(&cache_free, &b->lru_node);
+		b = NULL;
+		goto out;
+	}
+
+	b->num = block;
+	b->flags = EXT2_BLOCK_ASSIGNED;
+	cache_insert(b);
+out:
+	k_mutex_unlock(&cache_lock);
+	return b;
+}
+
+struct ext2_block *ext2_get_empty_block(struct ext2_data *fs)
+{
+	struct ext2_block *b;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	b = cache_alloc(fs);
+	if (b != NULL) {
+		b->num = 0;
+		b->flags = 0;
+		memset(b->data, 0, fs->block_size);
+	}
+
+	k_mutex_unlock(&cache_lock);
+	return b;
+}
+
+int ext2_write_block(struct ext2_data *fs, struct ext2_block *b)
+{
+	bool wake;
+
+	ARG_UNUSED(fs);
+
+	if (!(b->flags & EXT2_BLOCK_ASSIGNED)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (!(b->flags & EXT2_BLOCK_HASHED)) {
+		/* Its number was given to another block after it was freed. */
+		LOG_WRN("write of stale block %d dropped", b->num);
+	} else if (!(b->flags & EXT2_BLOCK_DIRTY)) {
+		b->flags |= EXT2_BLOCK_DIRTY;
+		cache_dirty++;
+	}
+	wake = cache_dirty >= DIRTY_THRESHOLD;
+
+	k_mutex_unlock(&cache_lock);
+
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+	if (wake) {
+		k_sem_give(&flush_sem);
+	}
+#else
+	ARG_UNUSED(wake);
+#endif
+	return 0;
+}
+
+void ext2_drop_block(struct ext2_block *b)
+{
+	if (b == NULL) {
+		return;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	__ASSERT(b->ref > 0, "Block %d dropped more times than taken", b->num);
+
+	if (--b->ref == 0) {
+		if (b->flags & EXT2_BLOCK_HASHED) {
+			sys_dlist_append(&cache_lru, &b->lru_node);
+		} else {
+			b->flags = 0;
+			sys_dlist_append(&cache_free, &b->lru_node);
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+void ext2_init_blocks_slab(struct ext2_data *fs)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	memset(cache_memory, 0, sizeof(cache_memory));
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		cache_blocks[i].data = &cache_memory[i * fs->block_size];
+	}
+	cache_reset();
+
+	k_mutex_unlock(&cache_lock);
+}
+
+int ext2_assign_block_num(struct ext2_data *fs, struct ext2_block *b)
+{
+	int64_t new_block;
+	struct ext2_block *old;
+
+	if (b->flags & EXT2_BLOCK_ASSIGNED) {
+		return -EINVAL;
+	}
+
+	/* Allocate block in the file system. */
+	new_block = ext2_alloc_block(fs);
+	if (new_block < 0) {
+		return new_block;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	/* The cache may still hold the contents the block had before it was freed. */
+	old = cache_find(new_block);
+	if (old != NULL) {
+		cache_remove(old);
+		if (old->ref == 0) {
+			sys_dlist_remove(&old->lru_node);
+			old->flags = 0;
+			sys_dlist_append(&cache_free, &old->lru_node);
+		}
+	}
+
+	b->num = new_block;
+	b->flags |= EXT2_BLOCK_ASSIGNED;
+	cache_insert(b);
+
+	k_mutex_unlock(&cache_lock);
+	return 0;
+}
+
+int ext2_block_cache_flush(struct ext2_data *fs)
+{
+	int ret;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	ret = cache_flush(fs);
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+	if (flush_error < 0) {
+		ret = flush_error;
+		flush_error = 0;
+	}
+#endif
+	k_mutex_unlock(&cache_lock);
+
+	return ret;
+}
+
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+static void flush_thread(void *p1, void *p2, void *p3)
+{
+	struct ext2_data *fs = p1;
+	int ret;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!flush_stop) {
+		(void)k_sem_take(&flush_sem, K_MSEC(CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL));
+
+		k_mutex_lock(&cache_lock, K_FOREVER);
+		ret = cache_flush(fs);
+		if ((ret < 0) && (flush_error == 0)) {
+			flush_error = ret;
+		}
+		k_mutex_unlock(&cache_lock);
+	}
+}
+#endif
+
+void ext2_block_cache_start(struct ext2_data *fs)
+{
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+	if (flush_running || (fs->flags & EXT2_DATA_FLAGS_RO)) {
+		return;
+	}
+
+	flush_stop = false;
+	flush_error = 0;
+	k_sem_reset(&flush_sem);
+
+	k_thread_create(&fs->sync_thr, flush_stack, K_THREAD_STACK_SIZEOF(flush_stack),
+			flush_thread, fs, NULL, NULL,
+			CONFIG_EXT2_BLOCK_CACHE_FLUSH_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&fs->sync_thr, "ext2_flush");
+	flush_running = true;
+#else
+	ARG_UNUSED(fs);
+#endif
+}
+
+void ext2_block_cache_stop(struct ext2_data *fs)
+{
+#if CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+	if (flush_running) {
+		flush_stop = true;
+		k_sem_give(&flush_sem);
+		(void)k_thread_join(&fs->sync_thr, K_FOREVER);
+		flush_running = false;
+	}
+#endif
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (cache_dirty > 0) {
+		(void)cache_flush(fs);
+	}
+	cache_reset();
+
+	k_mutex_unlock(&cache_lock);
+}
@@ -1152,7 +1152,7 @@ int ext2_free_inode(struct ext2_data *fs, uint32_t ino, bool directory)
 		LOG_DBG("block bitmap write returned: %d", rc);
 		return -EIO;
 	}
-	rc = fs->backend_ops->sync(fs);
+	rc = ext2_sync_fs(fs);
 	if (rc < 0) {
 		return -EIO;
 	}
@@ -22,6 +22,7 @@ LOG_MODULE_REGISTER(ext2, CONFIG_EXT2_LOG_LEVEL);
 static struct ext2_data __fs;
 static bool initialized;
 
+#ifndef CONFIG_EXT2_BLOCK_CACHE
 #define BLOCK_MEMORY_BUFFER_SIZE (CONFIG_EXT2_MAX_BLOCK_COUNT * CONFIG_EXT2_MAX_BLOCK_SIZE)
 #define BLOCK_STRUCT_BUFFER_SIZE (CONFIG_EXT2_MAX_BLOCK_COUNT * sizeof(struct ext2_block))
 
@@ -29,6 +30,7 @@ static bool initialized;
 struct k_mem_slab ext2_block_memory_slab, ext2_block_struct_slab;
 char __aligned(sizeof(void *)) __ext2_block_memory_buffer[BLOCK_MEMORY_BUFFER_SIZE];
 char __aligned(sizeof(void *)) __ext2_block_struct_buffer[BLOCK_STRUCT_BUFFER_SIZE];
+#endif
 
 /* Initialize heap memory allocator */
 K_HEAP_DEFINE(direntry_heap, MAX_DIRENTRY_SIZE);
@@ -66,6 +68,9 @@ void error_behavior(struct ext2_data *fs, const char *msg)
 
 /* Block operations --------------------------------------------------------- */
 
+/* With CONFIG_EXT2_BLOCK_CACHE the block operations are implemented by the block cache. */
+#ifndef CONFIG_EXT2_BLOCK_CACHE
+
 static struct ext2_block *get_block_struct(void)
 {
 	int ret;
@@ -178,6 +183,19 @@ int ext2_assign_block_num(struct ext2_data *fs, struct ext2_block *b)
 	return 0;
 }
 
+#endif /* CONFIG_EXT2_BLOCK_CACHE */
+
+int ext2_sync_fs(struct ext2_data *fs)
+{
+#ifdef CONFIG_EXT2_BLOCK_CACHE
+	int ret = ext2_block_cache_flush(fs);
+
+	if (ret < 0) {
+		return ret;
+	}
+#endif
+	return fs->backend_ops->sync(fs);
+}
 
 /* FS operations ------------------------------------------------------------ */
 
@@ -384,7 +402,7 @@ int ext2_close_fs(struct ext2_data *fs)
 	ext2_drop_block(fs->bgroup.inode_bitmap);
 	ext2_drop_block(fs->bgroup.block_bitmap);
 
-	if (fs->backend_ops->sync(fs) < 0) {
+	if (ext2_sync_fs(fs) < 0) {
 		return -EIO;
 	}
 	return 0;
@@ -392,6 +410,9 @@ int ext2_close_fs(struct ext2_data *fs)
 
 int ext2_close_struct(struct ext2_data *fs)
 {
+#ifdef CONFIG_EXT2_BLOCK_CACHE
+	ext2_block_cache_stop(fs);
+#endif
 	memset(fs, 0, sizeof(struct ext2_data));
 	initialized = false;
 	return 0;
@@ -788,7 +809,7 @@ int ext2_inode_sync(struct ext2_inode *inode)
 		if (ret < 0) {
 			return ret;
 		}
-		ret = fs->backend_ops->sync(fs);
+		ret = ext2_sync_fs(fs);
 		if (ret < 0) {
 			return ret;
 		}
@@ -55,6 +55,30 @@ int ext2_write_block(struct ext2_data *fs, struct ext2_block *b);
 
 int ext2_assign_block_num(struct ext2_data *fs, struct ext2_block *b);
 
+/**
+ * @brief Write blocks waiting in the block cache and sync the disk.
+ */
+int ext2_sync_fs(struct ext2_data *fs);
+
+#ifdef CONFIG_EXT2_BLOCK_CACHE
+/**
+ * @brief Write back all dirty blocks of the block cache.
+ *
+ * Also reports the first error of the background write back since the last flush.
+ */
+int ext2_block_cache_flush(struct ext2_data *fs);
+
+/**
+ * @brief Start the thread writing back dirty blocks in the background.
+ */
+void ext2_block_cache_start(struct ext2_data *fs);
+
+/**
+ * @brief Stop the write back thread, write back dirty blocks and empty the cache.
+ */
+void ext2_block_cache_stop(struct ext2_data *fs);
+#endif
+
 /* FS operations */
 
 /**
@@ -435,6 +435,10 @@ static int ext2_mount(struct fs_mount_t *mountp)
 		goto err;
 	}
 
+#ifdef CONFIG_EXT2_BLOCK_CACHE
+	ext2_block_cache_start(fs);
+#endif
+
 	mountp->fs_data = fs;
 	return 0;
 
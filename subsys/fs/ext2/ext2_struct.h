@@ -131,11 +131,18 @@ struct ext2_superblock {
 	((struct ext2_disk_direntry *)(((uint8_t *)(addr)) + (offset)))
 
 #define EXT2_BLOCK_ASSIGNED BIT(0)
+#define EXT2_BLOCK_DIRTY    BIT(1) /* modified in the cache, not written yet */
+#define EXT2_BLOCK_HASHED   BIT(2) /* found in the cache by its number */
 
 struct ext2_block {
 	uint32_t num;
 	uint8_t flags;
 	uint8_t *data;
+#ifdef CONFIG_EXT2_BLOCK_CACHE
+	uint16_t ref;          /* number of users of the block */
+	sys_snode_t hash_node; /* node in the hash bucket of the block number */
+	sys_dnode_t lru_node;  /* node in the list of unused or free blocks */
+#endif
 } __aligned(sizeof(void *));
 
 #define BGROUP_INODE_TABLE(bg) ((struct ext2_disk_inode *)(bg)->inode_table->data)
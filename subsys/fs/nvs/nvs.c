@@ -19,9 +19,7 @@ LOG_MODULE_REGISTER(fs_nvs, CONFIG_NVS_LOG_LEVEL);
 static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate);
 static int nvs_ate_valid(struct nvs_fs *fs, const struct nvs_ate *entry);
 
-#ifdef CONFIG_NVS_LOOKUP_CACHE
-
-static inline size_t nvs_lookup_cache_pos(uint16_t id)
+static inline uint16_t nvs_id_hash(uint16_t id)
 {
 	uint16_t hash;
 
@@ -33,7 +31,14 @@ static inline size_t nvs_lookup_cache_pos(uint16_t id)
 	hash *= 0xdb2dU;
 	hash ^= hash >> 9;
 
-	return hash % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+	return hash;
+}
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+
+static inline size_t nvs_lookup_cache_pos(uint16_t id)
+{
+	return nvs_id_hash(id) % CONFIG_NVS_LOOKUP_CACHE_SIZE;
 }
 
 static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
@@ -97,6 +102,190 @@ static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
 }
 /* end basic routines */
 
+#ifdef CONFIG_NVS_ATE_INDEX
+
+/* The index is an open addressing hash table with linear probing, free
+ * slots have ate_addr set to NVS_LOOKUP_CACHE_NO_ADDR. It is only used and
+ * maintained while it is complete, that is from the end of nvs_startup()
+ * until an id does not fit in it anymore.
+ */
+static inline size_t nvs_ate_index_pos(uint16_t id)
+{
+	return nvs_id_hash(id) % CONFIG_NVS_ATE_INDEX_SIZE;
+}
+
+/* Slot holding id, or the free slot where it goes, NULL if the index is full */
+static struct nvs_ate_index_entry *nvs_ate_index_slot(struct nvs_fs *fs,
+						      uint16_t id)
+{
+	struct nvs_ate_index_entry *entry;
+	size_t pos = nvs_ate_index_pos(id);
+
+	for (size_t i = 0; i < CONFIG_NVS_ATE_INDEX_SIZE; i++) {
+		entry = &fs->ate_index[pos];
+		if ((entry->ate_addr == NVS_LOOKUP_CACHE_NO_ADDR) ||
+		    (entry->id == id)) {
+			return entry;
+		}
+		pos = (pos + 1) % CONFIG_NVS_ATE_INDEX_SIZE;
+	}
+
+	return NULL;
+}
+
+static const struct nvs_ate_index_entry *nvs_ate_index_find(struct nvs_fs *fs,
+							    uint16_t id)
+{
+	const struct nvs_ate_index_entry *entry = nvs_ate_index_slot(fs, id);
+
+	if ((entry == NULL) || (entry->ate_addr == NVS_LOOKUP_CACHE_NO_ADDR)) {
+		return NULL;
+	}
+
+	return entry;
+}
+
+/* Bytes of the sector in use by the entry, deletions are not moved by gc */
+static inline uint16_t nvs_ate_index_live(struct nvs_fs *fs,
+					  const struct nvs_ate_index_entry *entry)
+{
+	if (entry->len == 0U) {
+		return 0U;
+	}
+
+	return nvs_al_size(fs, entry->len) +
+	       nvs_al_size(fs, sizeof(struct nvs_ate));
+}
+
+static void nvs_ate_index_set(struct nvs_fs *fs, uint32_t ate_addr,
+			      const struct nvs_ate *ate)
+{
+	struct nvs_ate_index_entry *entry;
+
+	entry = nvs_ate_index_slot(fs, ate->id);
+	if (entry == NULL) {
+		LOG_WRN("ATE index full, falling back to ATE walks");
+		fs->ate_index_complete = false;
+		return;
+	}
+
+	if (entry->ate_addr != NVS_LOOKUP_CACHE_NO_ADDR) {
+		fs->sector_live[entry->ate_addr >> ADDR_SECT_SHIFT] -=
+			nvs_ate_index_live(fs, entry);
+	}
+
+	entry->ate_addr = ate_addr;
+	entry->id = ate->id;
+	entry->offset = ate->offset;
+	entry->len = ate->len;
+
+	fs->sector_live[ate_addr >> ADDR_SECT_SHIFT] += nvs_ate_index_live(fs, entry);
+}
+
+/* Free a slot, moving back the entries after it which would otherwise not
+ * be found anymore.
+ */
+static void nvs_ate_index_remove(struct nvs_fs *fs, size_t pos)
+{
+	size_t next = pos, home;
+	bool reachable;
+
+	fs->ate_index[pos].ate_addr = NVS_LOOKUP_CACHE_NO_ADDR;
+
+	while (true) {
+		next = (next + 1) % CONFIG_NVS_ATE_INDEX_SIZE;
+		if (fs->ate_index[next].ate_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+			return;
+		}
+
+		/* the entry is still found if its home slot is after pos */
+		home = nvs_ate_index_pos(fs->ate_index[next].id);
+		if (pos < next) {
+			reachable = (home > pos) && (home <= next);
+		} else {
+			reachable = (home > pos) || (home <= next);
+		}
+
+		if (!reachable) {
+			fs->ate_index[pos] = fs->ate_index[next];
+			fs->ate_index[next].ate_addr = NVS_LOOKUP_CACHE_NO_ADDR;
+			pos = next;
+		}
+	}
+}
+
+static void nvs_ate_index_invalidate(struct nvs_fs *fs, uint32_t sector)
+{
+	size_t pos = 0;
+
+	if (!fs->ate_index_complete) {
+		return;
+	}
+
+	/* removing an entry can move another one in its slot, so only move
+	 * on when the slot is kept.
+	 */
+	while (pos < CONFIG_NVS_ATE_INDEX_SIZE) {
+		if ((fs->ate_index[pos].ate_addr != NVS_LOOKUP_CACHE_NO_ADDR) &&
+		    ((fs->ate_index[pos].ate_addr >> ADDR_SECT_SHIFT) == sector)) {
+			nvs_ate_index_remove(fs, pos);
+		} else {
+			pos++;
+		}
+	}
+
+	fs->sector_live[sector] = 0U;
+}
+
+static int nvs_ate_index_rebuild(struct nvs_fs *fs)
+{
+	int rc;
+	uint32_t addr, ate_addr;
+	struct nvs_ate ate;
+
+	memset(fs->ate_index, 0xff, sizeof(fs->ate_index));
+	memset(fs->sector_live, 0, sizeof(fs->sector_live));
+	fs->ate_index_complete = false;
+
+	if (fs->sector_count > ARRAY_SIZE(fs->sector_live)) {
+		LOG_WRN("Too many sectors for the ATE index");
+		return 0;
+	}
+
+	fs->ate_index_complete = true;
+	addr = fs->ate_wra;
+
+	while (true) {
+		/* Make a copy of 'addr' as it will be advanced by nvs_prev_ate() */
+		ate_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, &ate);
+
+		if (rc) {
+			fs->ate_index_complete = false;
+			return rc;
+		}
+
+		/* The walk goes from the most recent ate to the oldest one,
+		 * only the first valid ate of an id is kept.
+		 */
+		if (ate.id != 0xFFFF && nvs_ate_valid(fs, &ate) &&
+		    !nvs_ate_index_find(fs, ate.id)) {
+			nvs_ate_index_set(fs, ate_addr, &ate);
+			if (!fs->ate_index_complete) {
+				return 0;
+			}
+		}
+
+		if (addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_NVS_ATE_INDEX */
+
 /* flash routines */
 /* basic aligned flash write to nvs address */
 static int nvs_flash_al_wrt(struct nvs_fs *fs, uint32_t addr, const void *data,
@@ -168,6 +357,16 @@ static int nvs_flash_ate_wrt(struct nvs_fs *fs, const struct nvs_ate *entry)
 	if (entry->id != 0xFFFF) {
 		fs->lookup_cache[nvs_lookup_cache_pos(entry->id)] = fs->ate_wra;
 	}
+#endif
+#ifdef CONFIG_NVS_ATE_INDEX
+	if ((entry->id != 0xFFFF) && fs->ate_index_complete) {
+		if (rc) {
+			/* the ate might not be valid, leave it to the walks */
+			fs->ate_index_complete = false;
+		} else {
+			nvs_ate_index_set(fs, fs->ate_wra, entry);
+		}
+	}
 #endif
 	fs->ate_wra -= nvs_al_size(fs, sizeof(struct nvs_ate));
 
@@ -307,6 +506,9 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, uint32_t addr)
 
 #ifdef CONFIG_NVS_LOOKUP_CACHE
 	nvs_lookup_cache_invalidate(fs, addr >> ADDR_SECT_SHIFT);
+#endif
+#ifdef CONFIG_NVS_ATE_INDEX
+	nvs_ate_index_invalidate(fs, addr >> ADDR_SECT_SHIFT);
 #endif
 	rc = flash_erase(fs->flash_device, offset, fs->sector_size);
 
@@ -590,6 +792,9 @@ static int nvs_gc(struct nvs_fs *fs)
 	uint32_t sec_addr, gc_addr, gc_prev_addr, wlk_addr, wlk_prev_addr,
 	      data_addr, stop_addr;
 	size_t ate_size;
+#ifdef CONFIG_NVS_ATE_INDEX
+	const struct nvs_ate_index_entry *index_entry;
+#endif
 
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
@@ -609,6 +814,14 @@ static int nvs_gc(struct nvs_fs *fs)
 		goto gc_done;
 	}
 
+#ifdef CONFIG_NVS_ATE_INDEX
+	if (fs->ate_index_complete &&
+	    (fs->sector_live[sec_addr >> ADDR_SECT_SHIFT] == 0U)) {
+		/* nothing in the sector is in use anymore */
+		goto gc_done;
+	}
+#endif
+
 	stop_addr = gc_addr - ate_size;
 
 	if (nvs_close_ate_valid(fs, &close_ate)) {
@@ -632,6 +845,15 @@ static int nvs_gc(struct nvs_fs *fs)
 			continue;
 		}
 
+#ifdef CONFIG_NVS_ATE_INDEX
+		if (fs->ate_index_complete) {
+			index_entry = nvs_ate_index_find(fs, gc_ate.id);
+			wlk_prev_addr = index_entry ? index_entry->ate_addr :
+						      NVS_LOOKUP_CACHE_NO_ADDR;
+			goto index_found;
+		}
+#endif
+
 #ifdef CONFIG_NVS_LOOKUP_CACHE
 		wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(gc_ate.id)];
 
@@ -658,6 +880,9 @@ static int nvs_gc(struct nvs_fs *fs)
 			}
 		} while (wlk_addr != fs->ate_wra);
 
+#ifdef CONFIG_NVS_ATE_INDEX
+index_found:
+#endif
 		/* if walk has reached the same address as gc_addr copy is
 		 * needed unless it is a deleted item.
 		 */
@@ -721,6 +946,13 @@ static int nvs_startup(struct nvs_fs *fs)
 
 	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
 
+#ifdef CONFIG_NVS_ATE_INDEX
+	/* The index is built once the ate and data write addresses are known,
+	 * until then gc and erase must not use it.
+	 */
+	fs->ate_index_complete = false;
+#endif
+
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 	/* step through the sectors to find a open sector following
 	 * a closed sector, this is where NVS can write.
@@ -914,6 +1146,11 @@ end:
 	if (!rc) {
 		rc = nvs_lookup_cache_rebuild(fs);
 	}
+#endif
+#ifdef CONFIG_NVS_ATE_INDEX
+	if (!rc) {
+		rc = nvs_ate_index_rebuild(fs);
+	}
 #endif
 	/* If the sector is empty add a gc done ate to avoid having insufficient
 	 * space when doing gc.
@@ -1018,6 +1255,9 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	uint32_t wlk_addr, rd_addr;
 	uint16_t required_space = 0U; /* no space, appropriate for delete ate */
 	bool prev_found = false;
+#ifdef CONFIG_NVS_ATE_INDEX
+	const struct nvs_ate_index_entry *index_entry;
+#endif
 
 	if (!fs->ready) {
 		LOG_ERR("NVS not initialized");
@@ -1036,7 +1276,25 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		return -EINVAL;
 	}
 
+	/* The previous entry must not be moved by a concurrent gc between
+	 * finding it and comparing its data.
+	 */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
 	/* find latest entry with same id */
+#ifdef CONFIG_NVS_ATE_INDEX
+	if (fs->ate_index_complete) {
+		index_entry = nvs_ate_index_find(fs, id);
+		if (index_entry) {
+			prev_found = true;
+			rd_addr = index_entry->ate_addr;
+			wlk_ate.offset = index_entry->offset;
+			wlk_ate.len = index_entry->len;
+		}
+		goto no_cached_entry;
+	}
+#endif
+
 #ifdef CONFIG_NVS_LOOKUP_CACHE
 	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
 
@@ -1052,7 +1310,7 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		rd_addr = wlk_addr;
 		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 		if (rc) {
-			return rc;
+			goto end;
 		}
 		if ((wlk_ate.id == id) && (nvs_ate_valid(fs, &wlk_ate))) {
 			prev_found = true;
@@ -1063,7 +1321,7 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		}
 	}
 
-#ifdef CONFIG_NVS_LOOKUP_CACHE
+#if defined(CONFIG_NVS_LOOKUP_CACHE) || defined(CONFIG_NVS_ATE_INDEX)
 no_cached_entry:
 #endif
 
@@ -1078,20 +1336,22 @@ no_cached_entry:
 				/* skip delete entry as it is already the
 				 * last one
 				 */
-				return 0;
+				rc = 0;
+				goto end;
 			}
 		} else if (len == wlk_ate.len) {
 			/* do not try to compare if lengths are not equal */
 			/* compare the data and if equal return 0 */
 			rc = nvs_flash_block_cmp(fs, rd_addr, data, len);
 			if (rc <= 0) {
-				return rc;
+				goto end;
 			}
 		}
 	} else {
 		/* skip delete entry for non-existing entry */
 		if (len == 0) {
-			return 0;
+			rc = 0;
+			goto end;
 		}
 	}
 
@@ -1101,8 +1361,6 @@ no_cached_entry:
 		required_space = data_size + ate_size;
 	}
 
-	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
-
 	gc_count = 0;
 	while (1) {
 		if (gc_count == fs->sector_count) {
@@ -1153,6 +1411,9 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 	uint16_t cnt_his;
 	struct nvs_ate wlk_ate;
 	size_t ate_size;
+#ifdef CONFIG_NVS_ATE_INDEX
+	const struct nvs_ate_index_entry *index_entry;
+#endif
 
 	if (!fs->ready) {
 		LOG_ERR("NVS not initialized");
@@ -1167,6 +1428,45 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
+#ifdef CONFIG_NVS_ATE_INDEX
+	/* A write or gc may update the entry and move the data under us */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	if (fs->ate_index_complete) {
+		index_entry = nvs_ate_index_find(fs, id);
+		if (!index_entry) {
+			k_mutex_unlock(&fs->nvs_lock);
+			rc = -ENOENT;
+			goto err;
+		}
+
+		if (cnt == 0U) {
+			/* the index has all it takes to read the data */
+			if (index_entry->len == 0U) {
+				rc = -ENOENT;
+			} else {
+				rd_addr = (index_entry->ate_addr & ADDR_SECT_MASK);
+				rd_addr += index_entry->offset;
+				rc = nvs_flash_rd(fs, rd_addr, data,
+						  MIN(len, index_entry->len));
+				if (rc == 0) {
+					rc = index_entry->len;
+				}
+			}
+
+			k_mutex_unlock(&fs->nvs_lock);
+			return rc;
+		}
+
+		/* older ates of the id come after the most recent one */
+		wlk_addr = index_entry->ate_addr;
+		k_mutex_unlock(&fs->nvs_lock);
+		goto index_found;
+	}
+
+	k_mutex_unlock(&fs->nvs_lock);
+#endif
+
 #ifdef CONFIG_NVS_LOOKUP_CACHE
 	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
 
@@ -1176,6 +1476,10 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 	}
 #else
 	wlk_addr = fs->ate_wra;
+#endif
+
+#ifdef CONFIG_NVS_ATE_INDEX
+index_found:
 #endif
 	rd_addr = wlk_addr;
 
@@ -1273,3 +1577,95 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 	}
 	return free_space;
 }
+
+int nvs_walk(struct nvs_fs *fs, nvs_walk_cb_t cb, void *arg)
+{
+	int rc;
+	uint32_t wlk_addr, rd_addr;
+	struct nvs_ate wlk_ate;
+	struct nvs_entry entry;
+
+	if (!fs->ready) {
+		LOG_ERR("NVS not initialized");
+		return -EACCES;
+	}
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	wlk_addr = fs->ate_wra;
+
+	while (1) {
+		rd_addr = wlk_addr;
+		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+		if (rc) {
+			break;
+		}
+
+		/* skip the gc done ate and invalid ones */
+		if ((wlk_ate.id != 0xFFFF) && (nvs_ate_valid(fs, &wlk_ate))) {
+			entry.id = wlk_ate.id;
+			entry.len = wlk_ate.len;
+			entry.data_addr = (rd_addr & ADDR_SECT_MASK) + wlk_ate.offset;
+			entry.ate_wra = fs->ate_wra;
+
+			/* The callback may take its time or write */
+			k_mutex_unlock(&fs->nvs_lock);
+			rc = cb(fs, &entry, arg);
+			k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+			if (rc) {
+				break;
+			}
+
+			if (!fs->ready) {
+				rc = -EACCES;
+				break;
+			}
+
+			/* A write may have moved the entries left to walk with
+			 * garbage collection, start over.
+			 */
+			if (fs->ate_wra != entry.ate_wra) {
+				wlk_addr = fs->ate_wra;
+				continue;
+			}
+		}
+
+		if (wlk_addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	k_mutex_unlock(&fs->nvs_lock);
+
+	return rc;
+}
+
+ssize_t nvs_entry_read(struct nvs_fs *fs, const struct nvs_entry *entry, size_t offset,
+		       void *data, size_t len)
+{
+	int rc;
+
+	if (offset > entry->len) {
+		return -EINVAL;
+	}
+
+	len = MIN(len, entry->len - offset);
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	/* The data may have been moved by garbage collection since */
+	if (!fs->ready || (fs->ate_wra != entry->ate_wra)) {
+		rc = -EAGAIN;
+	} else {
+		rc = nvs_flash_rd(fs, entry->data_addr + offset, data, len);
+	}
+
+	k_mutex_unlock(&fs->nvs_lock);
+
+	if (rc) {
+		return rc;
+	}
+
+	return len;
+}
@@ -222,6 +222,40 @@ static uint8_t *data_ref(struct net_buf *buf, uint8_t *data)
 	return pool->alloc->cb->ref(buf, data);
 }
 
+/* Sets up a buffer just taken off its pool, allocating its data */
+static int buf_setup(struct net_buf *buf, size_t size, k_timeout_t timeout)
+{
+	if (size) {
+#if __ASSERT_ON
+		size_t req_size = size;
+#endif
+		buf->__buf = data_alloc(buf, &size, timeout);
+		if (!buf->__buf) {
+			return -ENOMEM;
+		}
+
+#if __ASSERT_ON
+		NET_BUF_ASSERT(req_size <= size);
+#endif
+	} else {
+		buf->__buf = NULL;
+	}
+
+	buf->ref   = 1U;
+	buf->flags = 0U;
+	buf->frags = NULL;
+	buf->size  = size;
+	net_buf_reset(buf);
+
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
+
+	atomic_dec(&pool->avail_count);
+	__ASSERT_NO_MSG(atomic_get(&pool->avail_count) >= 0);
+#endif
+	return 0;
+}
+
 #if defined(CONFIG_NET_BUF_LOG)
 struct net_buf *net_buf_alloc_len_debug(struct net_buf_pool *pool, size_t size,
 					k_timeout_t timeout, const char *func,
@@ -308,37 +342,78 @@ struct net_buf *net_buf_alloc_len(struct net_buf_pool *pool, size_t size,
 success:
 	NET_BUF_DBG("allocated buf %p", buf);
 
-	if (size) {
-#if __ASSERT_ON
-		size_t req_size = size;
-#endif
-		timeout = sys_timepoint_timeout(end);
-		buf->__buf = data_alloc(buf, &size, timeout);
-		if (!buf->__buf) {
-			NET_BUF_ERR("%s():%d: Failed to allocate data",
-				    func, line);
-			net_buf_destroy(buf);
-			return NULL;
+	if (buf_setup(buf, size, sys_timepoint_timeout(end)) < 0) {
+		NET_BUF_ERR("%s():%d: Failed to allocate data", func, line);
+		net_buf_destroy(buf);
+		return NULL;
+	}
+
+	return buf;
+}
+
+int net_buf_alloc_batch(struct net_buf_pool *pool, size_t size,
+			struct net_buf **bufs, int count, k_timeout_t timeout)
+{
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	k_spinlock_key_t key;
+	int n = 0;
+	int i;
+
+	__ASSERT_NO_MSG(pool);
+	__ASSERT_NO_MSG(bufs != NULL || count <= 0);
+
+	key = k_spin_lock(&pool->lock);
+
+	/* Previously used buffers first, then the uninitialized ones */
+	while (n < count) {
+		if (pool->uninit_count < pool->buf_count) {
+			bufs[n] = k_lifo_get(&pool->free, K_NO_WAIT);
+			if (bufs[n]) {
+				n++;
+				continue;
+			}
 		}
 
-#if __ASSERT_ON
-		NET_BUF_ASSERT(req_size <= size);
-#endif
-	} else {
-		buf->__buf = NULL;
+		if (!pool->uninit_count) {
+			break;
+		}
+
+		bufs[n++] = pool_get_uninit(pool, pool->uninit_count--);
 	}
 
-	buf->ref   = 1U;
-	buf->flags = 0U;
-	buf->frags = NULL;
-	buf->size  = size;
-	net_buf_reset(buf);
+	k_spin_unlock(&pool->lock, key);
 
-#if defined(CONFIG_NET_BUF_POOL_USAGE)
-	atomic_dec(&pool->avail_count);
-	__ASSERT_NO_MSG(atomic_get(&pool->avail_count) >= 0);
-#endif
-	return buf;
+	if (n == 0) {
+		if (count <= 0) {
+			return 0;
+		}
+
+		/* Nothing is free, wait for a buffer like a single
+		 * allocation does.
+		 */
+		bufs[0] = net_buf_alloc_len(pool, size, timeout);
+
+		return bufs[0] ? 1 : 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (buf_setup(bufs[i], size, sys_timepoint_timeout(end)) < 0) {
+			NET_BUF_ERR("Failed to allocate data");
+			break;
+		}
+	}
+
+	/* Give back the buffers we could not allocate data for, the ones
+	 * never set up may hold a stale data pointer.
+	 */
+	for (int j = i; j < n; j++) {
+		bufs[j]->__buf = NULL;
+		net_buf_destroy(bufs[j]);
+	}
+
+	NET_BUF_DBG("allocated %d of %d bufs", i, count);
+
+	return i;
 }
 
 #if defined(CONFIG_NET_BUF_LOG)
@@ -444,14 +519,26 @@ void net_buf_put(struct k_fifo *fifo, struct net_buf *buf)
 	k_fifo_put(fifo, buf);
 }
 
+static void buf_free_list(struct net_buf_pool *pool, sys_slist_t *list)
+{
+	if (pool) {
+		k_lifo_put_slist(&pool->free, list);
+	}
+}
+
 #if defined(CONFIG_NET_BUF_LOG)
 void net_buf_unref_debug(struct net_buf *buf, const char *func, int line)
 #else
 void net_buf_unref(struct net_buf *buf)
 #endif
 {
+	struct net_buf_pool *freed_pool = NULL;
+	sys_slist_t freed;
+
 	__ASSERT_NO_MSG(buf);
 
+	sys_slist_init(&freed);
+
 	while (buf) {
 		struct net_buf *frags = buf->frags;
 		struct net_buf_pool *pool;
@@ -460,14 +547,14 @@ void net_buf_unref(struct net_buf *buf)
 		if (!buf->ref) {
 			NET_BUF_ERR("%s():%d: buf %p double free", func, line,
 				    buf);
-			return;
+			break;
 		}
 #endif
 		NET_BUF_DBG("buf %p ref %u pool_id %u frags %p", buf, buf->ref,
 			    buf->pool_id, buf->frags);
 
 		if (--buf->ref > 0) {
-			return;
+			break;
 		}
 
 		buf->data = NULL;
@@ -483,11 +570,28 @@ void net_buf_unref(struct net_buf *buf)
 		if (pool->destroy) {
 			pool->destroy(buf);
 		} else {
-			net_buf_destroy(buf);
+			/* The fragments going back to the same pool are
+			 * put on its free list in one go.
+			 */
+			if (pool != freed_pool) {
+				buf_free_list(freed_pool, &freed);
+				freed_pool = pool;
+			}
+
+			if (buf->__buf) {
+				if (!(buf->flags & NET_BUF_EXTERNAL_DATA)) {
+					pool->alloc->cb->unref(buf, buf->__buf);
+				}
+				buf->__buf = NULL;
+			}
+
+			sys_slist_append(&freed, &buf->node);
 		}
 
 		buf = frags;
 	}
+
+	buf_free_list(freed_pool, &freed);
 }
 
 struct net_buf *net_buf_ref(struct net_buf *buf)
@@ -116,6 +116,108 @@ void conn_register_debug(struct net_conn *conn,
 
 static K_MUTEX_DEFINE(conn_lock);
 
+#if defined(CONFIG_NET_CONN_HASH)
+/* UDP and TCP connections are also indexed, so that a received unicast
+ * packet is only matched against the handlers that can take it:
+ * connections with local port, remote port and remote address all
+ * specified are hashed by protocol and the full remote end point, the
+ * ones with only a local port by protocol and local port, and the rest
+ * are kept on a wildcard list.  The index sits next to conn_used, which
+ * still holds every connection.
+ */
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_NET_CONN_HASH_BUCKETS),
+	     "CONFIG_NET_CONN_HASH_BUCKETS must be a power of two");
+
+#define CONN_HASH_MASK (CONFIG_NET_CONN_HASH_BUCKETS - 1)
+
+static sys_slist_t conn_exact[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_port[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_wild;
+static uint32_t conn_seq;
+
+static inline uint32_t conn_hash_mix(uint32_t h)
+{
+	h ^= h >> 16;
+	h *= 0x7feb352dU;
+	h ^= h >> 15;
+
+	return h;
+}
+
+/* Ports are in network byte order */
+static inline uint32_t conn_hash_port(uint16_t proto, uint16_t local_port)
+{
+	return conn_hash_mix(((uint32_t)proto << 16) | local_port) & CONN_HASH_MASK;
+}
+
+static uint32_t conn_hash_exact(uint16_t proto, uint16_t local_port,
+				uint16_t remote_port, const uint8_t *remote_addr,
+				size_t len)
+{
+	uint32_t h = ((uint32_t)proto << 16) | local_port;
+
+	h ^= (uint32_t)remote_port << 8;
+
+	for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+		h = conn_hash_mix(h ^ UNALIGNED_GET((const uint32_t *)&remote_addr[i]));
+	}
+
+	return h & CONN_HASH_MASK;
+}
+
+static bool conn_is_indexed(struct net_conn *conn)
+{
+	return (conn->proto == IPPROTO_UDP || conn->proto == IPPROTO_TCP) &&
+	       (conn->family == AF_INET || conn->family == AF_INET6 ||
+		conn->family == AF_UNSPEC);
+}
+
+static sys_slist_t *conn_index_bucket(struct net_conn *conn)
+{
+	uint16_t local_port = net_sin(&conn->local_addr)->sin_port;
+	uint16_t remote_port = net_sin(&conn->remote_addr)->sin_port;
+
+	if (local_port == 0U) {
+		return &conn_wild;
+	}
+
+	if (remote_port == 0U || !(conn->flags & NET_CONN_REMOTE_ADDR_SPEC)) {
+		return &conn_port[conn_hash_port(conn->proto, local_port)];
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && conn->remote_addr.sa_family == AF_INET6) {
+		return &conn_exact[conn_hash_exact(
+				conn->proto, local_port, remote_port,
+				net_sin6(&conn->remote_addr)->sin6_addr.s6_addr,
+				sizeof(struct in6_addr))];
+	}
+
+	return &conn_exact[conn_hash_exact(
+			conn->proto, local_port, remote_port,
+			(const uint8_t *)&net_sin(&conn->remote_addr)->sin_addr,
+			sizeof(struct in_addr))];
+}
+
+/* Must be called with conn_lock held */
+static void conn_index_add(struct net_conn *conn)
+{
+	if (conn_is_indexed(conn)) {
+		sys_slist_prepend(conn_index_bucket(conn), &conn->index_node);
+	}
+}
+
+/* Must be called with conn_lock held */
+static void conn_index_remove(struct net_conn *conn)
+{
+	if (conn_is_indexed(conn)) {
+		sys_slist_find_and_remove(conn_index_bucket(conn), &conn->index_node);
+	}
+}
+#else
+#define conn_index_add(...)
+#define conn_index_remove(...)
+#endif /* CONFIG_NET_CONN_HASH */
+
 static struct net_conn *conn_get_unused(void)
 {
 	sys_snode_t *node;
@@ -141,6 +243,10 @@ static void conn_set_used(struct net_conn *conn)
 
 	k_mutex_lock(&conn_lock, K_FOREVER);
 	sys_slist_prepend(&conn_used, &conn->node);
+#if defined(CONFIG_NET_CONN_HASH)
+	conn->seq = conn_seq++;
+	conn_index_add(conn);
+#endif
 	k_mutex_unlock(&conn_lock);
 }
 
@@ -450,6 +556,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 
 	k_mutex_lock(&conn_lock, K_FOREVER);
 	sys_slist_find_and_remove(&conn_used, &conn->node);
+	conn_index_remove(conn);
 	k_mutex_unlock(&conn_lock);
 
 	conn_set_unused(conn);
@@ -476,7 +583,12 @@ int net_conn_update(struct net_conn_handle *handle,
 
 	net_conn_change_callback(conn, cb, user_data);
 
+	/* The remote end point decides where the connection is indexed */
+	k_mutex_lock(&conn_lock, K_FOREVER);
+	conn_index_remove(conn);
 	ret = net_conn_change_remote(conn, remote_addr, remote_port);
+	conn_index_add(conn);
+	k_mutex_unlock(&conn_lock);
 
 	return ret;
 }
@@ -532,6 +644,51 @@ static bool conn_addr_cmp(struct net_pkt *pkt,
 	return true;
 }
 
+/* Is the TCP/UDP connection matching the packet's addresses and ports? */
+static bool conn_ip_endpoints_match(struct net_conn *conn, struct net_pkt *pkt,
+				    union net_ip_header *ip_hdr, uint8_t pkt_family,
+				    uint16_t src_port, uint16_t dst_port)
+{
+	if (net_sin(&conn->remote_addr)->sin_port &&
+	    net_sin(&conn->remote_addr)->sin_port != src_port) {
+		return false; /* wrong remote port */
+	}
+
+	if (net_sin(&conn->local_addr)->sin_port &&
+	    net_sin(&conn->local_addr)->sin_port != dst_port) {
+		return false; /* wrong local port */
+	}
+
+	if ((conn->flags & NET_CONN_REMOTE_ADDR_SET) &&
+	    !conn_addr_cmp(pkt, ip_hdr, &conn->remote_addr, true)) {
+		return false; /* wrong remote address */
+	}
+
+	if ((conn->flags & NET_CONN_LOCAL_ADDR_SET) &&
+	    !conn_addr_cmp(pkt, ip_hdr, &conn->local_addr, false)) {
+
+		/* Check if we could do a v4-mapping-to-v6 and the IPv6 socket
+		 * has no IPV6_V6ONLY option set and if the local IPV6 address
+		 * is unspecified, then we could accept a connection from IPv4
+		 * address by mapping it to IPv6 address.
+		 */
+		if (IS_ENABLED(CONFIG_NET_IPV4_MAPPING_TO_IPV6)) {
+			if (!(conn->family == AF_INET6 && pkt_family == AF_INET &&
+			      !conn->v6only &&
+			      net_ipv6_is_addr_unspecified(
+				      &net_sin6(&conn->local_addr)->sin6_addr))) {
+				return false; /* wrong local address */
+			}
+		} else {
+			return false; /* wrong local address */
+		}
+
+		/* We might have a match for v4-to-v6 mapping */
+	}
+
+	return true;
+}
+
 static inline void conn_send_icmp_error(struct net_pkt *pkt)
 {
 	if (IS_ENABLED(CONFIG_NET_DISABLE_ICMP_DESTINATION_UNREACHABLE)) {
@@ -622,6 +779,95 @@ static enum net_verdict conn_raw_socket(struct net_pkt *pkt,
 	return NET_OK;
 }
 
+#if defined(CONFIG_NET_CONN_HASH)
+/* Same checks as the net_conn_input() loop does for a TCP/UDP packet */
+static bool conn_index_match(struct net_conn *conn, struct net_pkt *pkt,
+			     union net_ip_header *ip_hdr, uint8_t proto,
+			     uint16_t src_port, uint16_t dst_port)
+{
+	uint8_t pkt_family = net_pkt_family(pkt);
+
+	if (conn->proto != proto) {
+		return false;
+	}
+
+	if (conn->context != NULL &&
+	    net_context_is_bound_to_iface(conn->context) &&
+	    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
+		return false;
+	}
+
+	if (conn->family != AF_UNSPEC && conn->family != pkt_family &&
+	    !(IS_ENABLED(CONFIG_NET_IPV4_MAPPING_TO_IPV6) &&
+	      conn->family == AF_INET6 && pkt_family == AF_INET && !conn->v6only)) {
+		return false;
+	}
+
+	return conn_ip_endpoints_match(conn, pkt, ip_hdr, pkt_family,
+				       src_port, dst_port);
+}
+
+/* The best match is the one with the highest rank, and among those the
+ * most recently registered one, as with the walk of conn_used.
+ */
+static void conn_index_rank(sys_slist_t *bucket, struct net_conn **best,
+			    struct net_pkt *pkt, union net_ip_header *ip_hdr,
+			    uint8_t proto, uint16_t src_port, uint16_t dst_port)
+{
+	struct net_conn *conn;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(bucket, conn, index_node) {
+		if (*best != NULL) {
+			int rank = NET_CONN_RANK(conn->flags);
+			int best_rank = NET_CONN_RANK((*best)->flags);
+
+			if (rank < best_rank ||
+			    (rank == best_rank && (int32_t)(conn->seq - (*best)->seq) < 0)) {
+				continue;
+			}
+		}
+
+		if (conn_index_match(conn, pkt, ip_hdr, proto, src_port, dst_port)) {
+			*best = conn;
+		}
+	}
+}
+
+/* Unicast TCP/UDP lookup.  An exact match with every rank bit set can't
+ * be beaten by a wildcard one, otherwise the wildcard buckets are
+ * checked as well.  Must be called with conn_lock held.
+ */
+static struct net_conn *conn_index_lookup(struct net_pkt *pkt,
+					  union net_ip_header *ip_hdr,
+					  uint8_t proto, uint16_t src_port,
+					  uint16_t dst_port)
+{
+	struct net_conn *best = NULL;
+	const uint8_t *src;
+	size_t len;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		src = ip_hdr->ipv6->src;
+		len = sizeof(struct in6_addr);
+	} else {
+		src = ip_hdr->ipv4->src;
+		len = sizeof(struct in_addr);
+	}
+
+	conn_index_rank(&conn_exact[conn_hash_exact(proto, dst_port, src_port, src, len)],
+			&best, pkt, ip_hdr, proto, src_port, dst_port);
+	if (best != NULL && NET_CONN_RANK(best->flags) == NET_CONN_RANK(0xff)) {
+		return best;
+	}
+
+	conn_index_rank(&conn_port[conn_hash_port(proto, dst_port)],
+			&best, pkt, ip_hdr, proto, src_port, dst_port);
+	conn_index_rank(&conn_wild, &best, pkt, ip_hdr, proto, src_port, dst_port);
+
+	return best;
+}
+#endif /* CONFIG_NET_CONN_HASH */
+
 enum net_verdict net_conn_input(struct net_pkt *pkt,
 				union net_ip_header *ip_hdr,
 				uint8_t proto,
@@ -698,6 +944,17 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 
 	k_mutex_lock(&conn_lock, K_FOREVER);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	/* Multicast packets go to every matching handler, so only unicast
+	 * ones can use the index.
+	 */
+	if ((pkt_family == AF_INET || pkt_family == AF_INET6) &&
+	    (proto == IPPROTO_UDP || proto == IPPROTO_TCP) && !is_mcast_pkt) {
+		best_match = conn_index_lookup(pkt, ip_hdr, proto, src_port, dst_port);
+		goto lookup_done;
+	}
+#endif
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
 		/* Is the candidate connection matching the packet's interface? */
 		if (conn->context != NULL &&
@@ -786,43 +1043,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 			/* Is the candidate connection matching the packet's TCP/UDP
 			 * address and port?
 			 */
-			if (net_sin(&conn->remote_addr)->sin_port &&
-			    net_sin(&conn->remote_addr)->sin_port != src_port) {
-				continue; /* wrong remote port */
-			}
-
-			if (net_sin(&conn->local_addr)->sin_port &&
-			    net_sin(&conn->local_addr)->sin_port != dst_port) {
-				continue; /* wrong local port */
-			}
-
-			if ((conn->flags & NET_CONN_REMOTE_ADDR_SET) &&
-			    !conn_addr_cmp(pkt, ip_hdr, &conn->remote_addr, true)) {
-				continue; /* wrong remote address */
-			}
-
-			if ((conn->flags & NET_CONN_LOCAL_ADDR_SET) &&
-			    !conn_addr_cmp(pkt, ip_hdr, &conn->local_addr, false)) {
-
-				/* Check if we could do a v4-mapping-to-v6 and the IPv6 socket
-				 * has no IPV6_V6ONLY option set and if the local IPV6 address
-				 * is unspecified, then we could accept a connection from IPv4
-				 * address by mapping it to IPv6 address.
-				 */
-				if (IS_ENABLED(CONFIG_NET_IPV4_MAPPING_TO_IPV6)) {
-					if (!(conn->family == AF_INET6 && pkt_family == AF_INET &&
-					      !conn->v6only &&
-					      net_ipv6_is_addr_unspecified(
-						      &net_sin6(&conn->local_addr)->sin6_addr))) {
-						continue; /* wrong local address */
-					}
-				} else {
-					continue; /* wrong local address */
-				}
-
-				/* We might have a match for v4-to-v6 mapping,
-				 * continue with rank checking.
-				 */
+			if (!conn_ip_endpoints_match(conn, pkt, ip_hdr, pkt_family,
+						     src_port, dst_port)) {
+				continue;
 			}
 
 			if (best_rank < NET_CONN_RANK(conn->flags)) {
@@ -866,6 +1089,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	} /* loop end */
 
+#if defined(CONFIG_NET_CONN_HASH)
+lookup_done:
+#endif
 	if (best_match) {
 		cb = best_match->cb;
 		user_data = best_match->user_data;
@@ -953,6 +1179,15 @@ void net_conn_init(void)
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	for (i = 0; i < CONFIG_NET_CONN_HASH_BUCKETS; i++) {
+		sys_slist_init(&conn_exact[i]);
+		sys_slist_init(&conn_port[i]);
+	}
+
+	sys_slist_init(&conn_wild);
+#endif
+
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
 	}
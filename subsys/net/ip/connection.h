@@ -82,6 +82,14 @@ struct net_conn {
 
 	/** Is v4-mapping-to-v6 enabled for this connection */
 	uint8_t v6only : 1;
+
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Node in the hash index bucket of the connection */
+	sys_snode_t index_node;
+
+	/** Registration order, to break ties between equal ranks */
+	uint32_t seq;
+#endif
 };
 
 /**
@@ -629,7 +629,8 @@ enum net_verdict net_ipv4_prepare_for_send(struct net_pkt *pkt)
 
 		mtu = MAX(NET_IPV4_MTU, mtu);
 
-		if (pkt_len > mtu) {
+		/* GSO packets are split into TCP segments by net_if */
+		if (pkt_len > mtu && net_pkt_gso_size(pkt) == 0U) {
 			ret = net_ipv4_send_fragmented_pkt(net_pkt_iface(pkt), pkt, pkt_len, mtu);
 
 			if (ret < 0) {
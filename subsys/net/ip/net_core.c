@@ -408,6 +408,7 @@ int net_send_data(struct net_pkt *pkt)
 		 */
 		NET_DBG("Loopback pkt %p back to us", pkt);
 		processing_data(pkt, true);
+		net_tcp_gro_flush();
 		return 0;
 	}
 
@@ -30,6 +30,7 @@ LOG_MODULE_REGISTER(net_if, CONFIG_NET_IF_LOG_LEVEL);
 #include "ipv4.h"
 #include "ipv6.h"
 #include "ipv4_autoconf_internal.h"
+#include "tcp_internal.h"
 
 #include "net_stats.h"
 
@@ -205,6 +206,55 @@ static void update_txtime_stats_detail(struct net_pkt *pkt,
 	}
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+static bool net_if_tx_tso(struct net_if *iface)
+{
+	return net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET) &&
+	       (net_eth_get_hw_capabilities(iface) & ETHERNET_HW_TX_TSO);
+}
+
+/* Hand a TCP GSO packet to L2 one segment at a time. Like for a regular
+ * packet, the original one is consumed only if everything was sent.
+ */
+static int net_if_l2_send_gso(struct net_if *iface, struct net_pkt *pkt)
+{
+	const struct net_l2 *l2 = net_if_l2(iface);
+	struct net_pkt *seg;
+	size_t offset = 0;
+	int sent = 0;
+	int ret;
+
+	while ((ret = net_tcp_gso_segment(pkt, &offset, &seg)) == 0) {
+		ret = l2->send(iface, seg);
+		if (ret < 0) {
+			net_pkt_unref(seg);
+			return ret;
+		}
+
+		sent += ret;
+	}
+
+	if (ret != -ENODATA) {
+		return ret;
+	}
+
+	net_pkt_unref(pkt);
+
+	return sent;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
+static int net_if_l2_send(struct net_if *iface, struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_TCP_GSO)
+	if (net_pkt_gso_size(pkt) > 0U && !net_if_tx_tso(iface)) {
+		return net_if_l2_send_gso(iface, pkt);
+	}
+#endif
+
+	return net_if_l2(iface)->send(iface, pkt);
+}
+
 static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	struct net_linkaddr ll_dst = {
@@ -255,7 +305,7 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 		}
 
 		net_if_tx_lock(iface);
-		status = net_if_l2(iface)->send(iface, pkt);
+		status = net_if_l2_send(iface, pkt);
 		net_if_tx_unlock(iface);
 
 		if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS)) {
@@ -857,6 +857,9 @@ void net_pkt_print(void)
 
 #if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE)
 
+/* Max number of fragments taken off the pool in one go */
+#define PKT_ALLOC_BATCH 8
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 					size_t size, k_timeout_t timeout,
@@ -867,41 +870,50 @@ static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 #endif
 {
 	k_timepoint_t end = sys_timepoint_calc(timeout);
+	size_t frag_size = pool->alloc->max_alloc_size;
+	struct net_buf *bufs[PKT_ALLOC_BATCH];
 	struct net_buf *first = NULL;
 	struct net_buf *current = NULL;
+	int count;
 
 	do {
-		struct net_buf *new;
-
-		new = net_buf_alloc_fixed(pool, timeout);
-		if (!new) {
+		/* Take the fragments still needed off the pool together */
+		count = MIN(MAX(DIV_ROUND_UP(size, frag_size), 1),
+			    ARRAY_SIZE(bufs));
+		count = net_buf_alloc_batch(pool, frag_size, bufs, count,
+					    timeout);
+		if (!count) {
 			goto error;
 		}
 
-		if (!first && !current) {
-			first = new;
-		} else {
-			current->frags = new;
-		}
+		for (int i = 0; i < count; i++) {
+			struct net_buf *new = bufs[i];
 
-		current = new;
-		if (current->size > size) {
-			current->size = size;
-		}
+			if (!first && !current) {
+				first = new;
+			} else {
+				current->frags = new;
+			}
 
-		size -= current->size;
+			current = new;
+			if (current->size > size) {
+				current->size = size;
+			}
 
-		timeout = sys_timepoint_timeout(end);
+			size -= current->size;
 
 #if CONFIG_NET_PKT_LOG_LEVEL >= LOG_LEVEL_DBG
-		NET_FRAG_CHECK_IF_NOT_IN_USE(new, new->ref + 1);
+			NET_FRAG_CHECK_IF_NOT_IN_USE(new, new->ref + 1);
 
-		net_pkt_alloc_add(new, false, caller, line);
+			net_pkt_alloc_add(new, false, caller, line);
 
-		NET_DBG("%s (%s) [%d] frag %p ref %d (%s():%d)",
-			pool2str(pool), get_name(pool), get_frees(pool),
-			new, new->ref, caller, line);
+			NET_DBG("%s (%s) [%d] frag %p ref %d (%s():%d)",
+				pool2str(pool), get_name(pool), get_frees(pool),
+				new, new->ref, caller, line);
 #endif
+		}
+
+		timeout = sys_timepoint_timeout(end);
 	} while (size);
 
 	return first;
@@ -1541,6 +1553,82 @@ struct net_pkt *net_pkt_rx_alloc_with_buffer(struct net_if *iface,
 #endif
 }
 
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+struct net_pkt *net_pkt_rx_alloc_from_cache(struct net_if *iface,
+					    struct net_pkt_buf_cache *cache,
+					    size_t size, k_timeout_t timeout)
+{
+	size_t count = MAX(DIV_ROUND_UP(size, CONFIG_NET_BUF_DATA_SIZE), 1);
+	struct net_buf *first = NULL;
+	struct net_buf *last = NULL;
+	struct net_pkt *pkt;
+
+	if (count > ARRAY_SIZE(cache->bufs)) {
+		goto fallback;
+	}
+
+	if (cache->count < count) {
+		cache->count += net_buf_alloc_batch(&rx_bufs,
+						    CONFIG_NET_BUF_DATA_SIZE,
+						    &cache->bufs[cache->count],
+						    ARRAY_SIZE(cache->bufs) -
+						    cache->count,
+						    K_NO_WAIT);
+		if (cache->count < count) {
+			goto fallback;
+		}
+	}
+
+	pkt = net_pkt_rx_alloc_on_iface(iface, timeout);
+	if (!pkt) {
+		return NULL;
+	}
+
+	while (count--) {
+		struct net_buf *buf = cache->bufs[--cache->count];
+
+		/* Cached buffers are used again, reset their size */
+		buf->size = MIN(size, CONFIG_NET_BUF_DATA_SIZE);
+		size -= buf->size;
+
+		if (!first) {
+			first = buf;
+		} else {
+			last->frags = buf;
+		}
+
+		last = buf;
+
+		net_pkt_alloc_add(buf, false, __func__, __LINE__);
+	}
+
+	net_pkt_append_buffer(pkt, first);
+
+	return pkt;
+
+fallback:
+	return net_pkt_rx_alloc_with_buffer(iface, size, AF_UNSPEC, 0,
+					    timeout);
+}
+
+void net_pkt_buf_cache_flush(struct net_pkt_buf_cache *cache)
+{
+	struct net_buf *head = NULL;
+
+	/* Chained, the buffers go back to the pool in one go */
+	while (cache->count) {
+		struct net_buf *buf = cache->bufs[--cache->count];
+
+		buf->frags = head;
+		head = buf;
+	}
+
+	if (head) {
+		net_buf_unref(head);
+	}
+}
+#endif /* CONFIG_NET_PKT_BUF_RX_CACHE */
+
 void net_pkt_append_buffer(struct net_pkt *pkt, struct net_buf *buffer)
 {
 	if (!pkt->buffer) {
@@ -1875,6 +1963,7 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_forwarding(clone_pkt, net_pkt_forwarding(pkt));
 	net_pkt_set_chksum_done(clone_pkt, net_pkt_is_chksum_done(pkt));
 	net_pkt_set_ip_reassembled(pkt, net_pkt_is_ip_reassembled(pkt));
+	net_pkt_set_gso_size(clone_pkt, net_pkt_gso_size(pkt));
 
 	net_pkt_set_l2_bridged(clone_pkt, net_pkt_is_l2_bridged(pkt));
 	net_pkt_set_l2_processed(clone_pkt, net_pkt_is_l2_processed(pkt));
@@ -1980,6 +2069,60 @@ struct net_pkt *net_pkt_rx_clone(struct net_pkt *pkt, k_timeout_t timeout)
 	return net_pkt_clone_internal(pkt, &rx_pkts, timeout);
 }
 
+struct net_pkt *net_pkt_clone_segment(struct net_pkt *pkt, size_t hdr_len,
+				      size_t offset, size_t len,
+				      k_timeout_t timeout)
+{
+	bool overwrite = net_pkt_is_being_overwritten(pkt);
+	struct net_pkt_cursor backup;
+	struct net_pkt *seg_pkt;
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+	seg_pkt = pkt_alloc_with_buffer(pkt->slab, net_pkt_iface(pkt),
+					hdr_len + len, AF_UNSPEC, 0, timeout,
+					__func__, __LINE__);
+#else
+	seg_pkt = pkt_alloc_with_buffer(pkt->slab, net_pkt_iface(pkt),
+					hdr_len + len, AF_UNSPEC, 0, timeout);
+#endif
+	if (!seg_pkt) {
+		return NULL;
+	}
+
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_copy(seg_pkt, pkt, hdr_len)) {
+		goto error;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_skip(pkt, offset) || net_pkt_copy(seg_pkt, pkt, len)) {
+		goto error;
+	}
+
+	clone_pkt_attributes(pkt, seg_pkt);
+	net_pkt_set_gso_size(seg_pkt, 0);
+
+	net_pkt_cursor_init(seg_pkt);
+
+	net_pkt_cursor_restore(pkt, &backup);
+	net_pkt_set_overwrite(pkt, overwrite);
+
+	NET_DBG("Segment %zu+%zu of %p to %p", offset, len, pkt, seg_pkt);
+
+	return seg_pkt;
+
+error:
+	net_pkt_unref(seg_pkt);
+	net_pkt_cursor_restore(pkt, &backup);
+	net_pkt_set_overwrite(pkt, overwrite);
+
+	return NULL;
+}
+
 struct net_pkt *net_pkt_shallow_clone(struct net_pkt *pkt, k_timeout_t timeout)
 {
 	struct net_pkt *clone_pkt;
@@ -172,6 +172,19 @@ struct sock_obj {
 };
 #endif /* CONFIG_NET_SOCKETS_OBJ_CORE */
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+/**
+ * @brief Tell the epoll instances watching a socket that its state may have
+ * changed. It belongs here because TCP calls it when it can send again.
+ */
+extern void net_socket_epoll_notify(struct net_context *ctx);
+#else
+static inline void net_socket_epoll_notify(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+#endif
+
 #if defined(CONFIG_NET_GPTP)
 /**
  * @brief Initialize Precision Time Protocol Layer.
@@ -201,6 +214,26 @@ int net_ipv6_send_fragmented_pkt(struct net_if *iface, struct net_pkt *pkt,
 				 uint16_t pkt_len);
 #endif
 
+/**
+ * @brief Clone the headers of a pkt followed by a part of its payload,
+ *        on the pool of the original one.
+ *
+ * @details Used to split a large packet into segments: each of them gets
+ *          a copy of the first @p hdr_len bytes of @p pkt and of @p len
+ *          bytes starting at @p offset, along with the packet attributes.
+ *
+ * @param pkt Original pkt to be segmented
+ * @param hdr_len Length of the headers at the start of @p pkt
+ * @param offset Offset of the segment data in @p pkt
+ * @param len Length of the segment data
+ * @param timeout Timeout to wait for free buffer
+ *
+ * @return NULL if error, segment packet otherwise.
+ */
+struct net_pkt *net_pkt_clone_segment(struct net_pkt *pkt, size_t hdr_len,
+				      size_t offset, size_t len,
+				      k_timeout_t timeout);
+
 extern const char *net_proto2str(int family, int proto);
 extern char *net_byte_to_hex(char *ptr, uint8_t byte, char base, bool pad);
 extern char *net_sprint_ll_addr_buf(const uint8_t *ll, uint8_t ll_len,
@@ -13,23 +13,34 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_stats.h>
+#include <zephyr/net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
 #include "net_tc_mapping.h"
+#include "ipv4.h"
+#include "tcp_internal.h"
 
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
  * where y indicates the traffic class id. The value of y can be from 0 to 7.
+ * With RX steering, "q[y.zz]" denotes the steering queue zz of the class.
  */
-#define MAX_NAME_LEN sizeof("xx_q[y]")
+#define MAX_NAME_LEN sizeof("xx_q[y.zz]")
+
+/* Each RX traffic class is handled by this many queues and threads */
+#if defined(CONFIG_NET_TC_RX_STEERING)
+#define NET_TC_RX_QUEUES CONFIG_NET_TC_RX_STEERING_QUEUES
+#else
+#define NET_TC_RX_QUEUES 1
+#endif
 
 /* Stacks for TX work queue */
 K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_COUNT,
 			    CONFIG_NET_TX_STACK_SIZE);
 
 /* Stacks for RX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT * NET_TC_RX_QUEUES,
 			    CONFIG_NET_RX_STACK_SIZE);
 
 #if NET_TC_TX_COUNT > 0
@@ -37,7 +48,7 @@ static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
 #endif
 
 #if NET_TC_RX_COUNT > 0
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+static struct net_traffic_class rx_classes[NET_TC_RX_COUNT * NET_TC_RX_QUEUES];
 #endif
 
 #if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
@@ -60,12 +71,149 @@ bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 	return true;
 }
 
+#if defined(CONFIG_NET_TC_RX_STEERING)
+static inline uint32_t rx_hash_mix(uint32_t h)
+{
+	h ^= h >> 16;
+	h *= 0x7feb352dU;
+	h ^= h >> 15;
+
+	return h;
+}
+
+static uint32_t rx_hash_bytes(uint32_t h, const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+		h = rx_hash_mix(h ^ UNALIGNED_GET((const uint32_t *)&data[i]));
+	}
+
+	return h;
+}
+
+/* Reassembled packets are fed back without their L2 header, and loopback
+ * and test interfaces carry bare IP packets.
+ */
+static bool rx_is_bare_ip(struct net_pkt *pkt, const struct net_l2 *l2)
+{
+	if (net_pkt_is_ip_reassembled(pkt)) {
+		return true;
+	}
+
+#if defined(CONFIG_NET_L2_DUMMY)
+	if (l2 == &NET_L2_GET_NAME(DUMMY)) {
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+/* Hash of a received frame, which has not been through L2 yet. All the
+ * packets of a flow, including its fragments and the packet reassembled
+ * from them, hash the same so they are processed in order by one queue.
+ * Ports are only seen in every packet of a flow that cannot be
+ * fragmented, so only IPv4 TCP and UDP packets with the DF bit set hash
+ * them. Other IPv4 packets hash their addresses and protocol. IPv6
+ * packets hash their addresses and flow label, or their addresses and
+ * protocol when the flow label is not set. Frames that are not IP and
+ * frames of L2s that are not known here all hash to 0.
+ */
+static uint32_t rx_flow_hash(struct net_pkt *pkt)
+{
+	uint8_t hdr[sizeof(struct net_eth_vlan_hdr) + NET_IPV4H_LEN +
+		    NET_IPV4_HDR_OPTNS_MAX_LEN + 2 * sizeof(uint16_t)];
+	const struct net_l2 *l2 = net_if_l2(net_pkt_iface(pkt));
+	size_t len, off = 0;
+	uint16_t type = 0;
+	uint32_t h;
+
+	len = net_buf_linearize(hdr, sizeof(hdr), pkt->buffer, 0, sizeof(hdr));
+
+	if (rx_is_bare_ip(pkt, l2)) {
+		if (len > 0 && (hdr[0] & 0xf0) == 0x40) {
+			type = NET_ETH_PTYPE_IP;
+		} else if (len > 0 && (hdr[0] & 0xf0) == 0x60) {
+			type = NET_ETH_PTYPE_IPV6;
+		}
+	}
+#if defined(CONFIG_NET_L2_ETHERNET)
+	else if (l2 == &NET_L2_GET_NAME(ETHERNET)) {
+		off = sizeof(struct net_eth_hdr);
+		if (len < off) {
+			return 0;
+		}
+
+		type = sys_get_be16(&hdr[off - sizeof(uint16_t)]);
+		if (type == NET_ETH_PTYPE_VLAN) {
+			off = sizeof(struct net_eth_vlan_hdr);
+			if (len < off) {
+				return 0;
+			}
+
+			type = sys_get_be16(&hdr[off - sizeof(uint16_t)]);
+		}
+	}
+#endif
+
+	if (type == NET_ETH_PTYPE_IP && len >= off + NET_IPV4H_LEN) {
+		const struct net_ipv4_hdr *ip = (struct net_ipv4_hdr *)&hdr[off];
+		uint16_t flags = sys_get_be16(ip->offset) &
+				 (NET_IPV4_DO_NOT_FRAG_MASK | NET_IPV4_MORE_FRAG_MASK |
+				  NET_IPV4_FRAGH_OFFSET_MASK);
+
+		h = rx_hash_bytes(0, ip->src, 2 * sizeof(struct in_addr));
+		off += (ip->vhl & NET_IPV4_IHL_MASK) * 4U;
+
+		if (flags == NET_IPV4_DO_NOT_FRAG_MASK &&
+		    (ip->proto == IPPROTO_TCP || ip->proto == IPPROTO_UDP) &&
+		    len >= off + 2 * sizeof(uint16_t)) {
+			return rx_hash_mix(h ^ ip->proto ^
+					   UNALIGNED_GET((const uint32_t *)&hdr[off]));
+		}
+
+		return rx_hash_mix(h ^ ip->proto);
+	}
+
+	if (type == NET_ETH_PTYPE_IPV6 && len >= off + NET_IPV6H_LEN) {
+		const struct net_ipv6_hdr *ip = (struct net_ipv6_hdr *)&hdr[off];
+		uint32_t flow = sys_get_be32(&hdr[off]) & 0x000fffffU;
+		uint8_t proto = ip->nexthdr;
+
+		h = rx_hash_bytes(0, ip->src, 2 * sizeof(struct in6_addr));
+		if (flow != 0U) {
+			return rx_hash_mix(h ^ flow);
+		}
+
+		/* Reassembly moves the protocol of the fragment header to
+		 * the IPv6 header.
+		 */
+		off += NET_IPV6H_LEN;
+		if (proto == NET_IPV6_NEXTHDR_FRAG && len >= off + NET_IPV6_FRAGH_LEN) {
+			proto = hdr[off];
+		}
+
+		return rx_hash_mix(h ^ proto);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NET_TC_RX_STEERING */
+
 void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_RX_COUNT > 0
+	uint8_t queue = 0U;
+
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&rx_classes[tc].fifo, pkt);
+#if defined(CONFIG_NET_TC_RX_STEERING)
+	queue = rx_flow_hash(pkt) % NET_TC_RX_QUEUES;
+
+	net_stats_update_rx_queue(net_pkt_iface(pkt), queue,
+				  net_pkt_get_len(pkt));
+#endif
+
+	submit_to_queue(&rx_classes[tc * NET_TC_RX_QUEUES + queue].fifo, pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
@@ -255,6 +403,17 @@ static void tc_rx_handler(void *p1, void *p2, void *p3)
 		}
 
 		net_process_rx_packet(pkt);
+
+		/* The burst is over, hand the coalesced segments to TCP, or
+		 * at least those held for too long while it goes on.
+		 */
+		if (IS_ENABLED(CONFIG_NET_TCP_GRO)) {
+			if (k_fifo_is_empty(fifo)) {
+				net_tcp_gro_flush();
+			} else {
+				net_tcp_gro_flush_expired();
+			}
+		}
 	}
 }
 #endif
@@ -354,12 +513,12 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_TC_RX_COUNT * NET_TC_RX_QUEUES; i++) {
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = rx_tc2thread(i);
+		thread_priority = rx_tc2thread(i / NET_TC_RX_QUEUES);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -389,10 +548,23 @@ void net_tc_rx_init(void)
 		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
 			char name[MAX_NAME_LEN];
 
-			snprintk(name, sizeof(name), "rx_q[%d]", i);
+			if (NET_TC_RX_QUEUES > 1) {
+				snprintk(name, sizeof(name), "rx_q[%d.%d]",
+					 i / NET_TC_RX_QUEUES,
+					 i % NET_TC_RX_QUEUES);
+			} else {
+				snprintk(name, sizeof(name), "rx_q[%d]", i);
+			}
+
 			k_thread_name_set(tid, name);
 		}
 
+#if defined(CONFIG_NET_TC_RX_STEERING) && defined(CONFIG_SCHED_CPU_MASK)
+		/* Steering queues of a class run on different CPUs */
+		(void)k_thread_cpu_pin(tid, (i % NET_TC_RX_QUEUES) %
+					    arch_num_cpus());
+#endif
+
 		k_thread_start(tid);
 	}
 #endif
@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include <limits.h>
 #include <zephyr/types.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/barrier.h>
 
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_core.h>
@@ -247,6 +248,304 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 	return 0;
 }
 
+#if defined(CONFIG_NET_ROUTE_TRIE)
+/* The routes are also kept in a path compressed binary trie keyed by
+ * prefix.  Each trie node stands for a prefix and holds the routes for
+ * exactly that prefix (one per interface).  Child nodes always have a
+ * longer prefix than their parent, so a lookup walks down at most one
+ * node per address bit and remembers the deepest route it passes.
+ *
+ * Changes are made with the neighbor cache lock held.  Lookups don't
+ * take it: they read a sequence count, which is odd while the trie is
+ * being changed, and check it again afterwards.  If it changed they
+ * redo the lookup with the lock held.  The nodes and the routes live in
+ * static pools, so a lookup racing with a change may see stale data,
+ * but never freed memory.
+ */
+struct route_trie_node {
+	struct route_trie_node *child[2];
+	sys_slist_t routes;
+	struct in6_addr prefix;
+	uint8_t len;
+};
+
+#define ROUTE_TRIE_NODES (2 * CONFIG_NET_MAX_ROUTES + 1)
+
+static struct route_trie_node route_trie_nodes[ROUTE_TRIE_NODES];
+static struct route_trie_node *route_trie_free;
+static struct route_trie_node *route_trie_root;
+static atomic_t route_trie_seq;
+static atomic_t route_access_seq;
+
+static inline int prefix_bit(const struct in6_addr *addr, uint8_t bit)
+{
+	return (addr->s6_addr[bit / 8U] >> (7 - (bit % 8U))) & 1;
+}
+
+static uint8_t prefix_common_len(const struct in6_addr *a,
+				 const struct in6_addr *b, uint8_t max)
+{
+	uint8_t len = 0U;
+
+	while (len < max && a->s6_addr[len / 8U] == b->s6_addr[len / 8U] &&
+	       len + 8U <= max) {
+		len += 8U;
+	}
+
+	while (len < max && prefix_bit(a, len) == prefix_bit(b, len)) {
+		len++;
+	}
+
+	return len;
+}
+
+static void prefix_copy(struct in6_addr *dst, const struct in6_addr *src,
+			uint8_t len)
+{
+	uint8_t bytes = len / 8U;
+
+	memset(dst, 0, sizeof(*dst));
+	memcpy(dst->s6_addr, src->s6_addr, bytes);
+
+	if (len % 8U) {
+		dst->s6_addr[bytes] = src->s6_addr[bytes] &
+				      (uint8_t)(0xff << (8 - (len % 8U)));
+	}
+}
+
+static struct route_trie_node *route_trie_node_new(const struct in6_addr *addr,
+						   uint8_t len)
+{
+	struct route_trie_node *node = route_trie_free;
+
+	/* The pool has room for every route and a branch for each */
+	NET_ASSERT(node != NULL);
+
+	route_trie_free = node->child[0];
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	sys_slist_init(&node->routes);
+	prefix_copy(&node->prefix, addr, len);
+	node->len = len;
+
+	return node;
+}
+
+static void route_trie_node_free(struct route_trie_node *node)
+{
+	node->child[0] = route_trie_free;
+	node->child[1] = NULL;
+	route_trie_free = node;
+}
+
+static inline void route_trie_write_begin(void)
+{
+	(void)atomic_inc(&route_trie_seq);
+	barrier_dmem_fence_full();
+}
+
+static inline void route_trie_write_end(void)
+{
+	barrier_dmem_fence_full();
+	(void)atomic_inc(&route_trie_seq);
+}
+
+/* Must be called with the neighbor cache lock held */
+static void route_trie_insert(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie_root;
+	struct route_trie_node *node = route_trie_root;
+	const struct in6_addr *addr = &route->addr;
+	uint8_t len = route->prefix_len;
+
+	route_trie_write_begin();
+
+	while (node->len < len) {
+		struct route_trie_node *child, *leaf, *mid;
+		int bit = prefix_bit(addr, node->len);
+		uint8_t common;
+
+		link = &node->child[bit];
+		child = *link;
+
+		if (child == NULL) {
+			node = route_trie_node_new(addr, len);
+			*link = node;
+			break;
+		}
+
+		common = prefix_common_len(addr, &child->prefix,
+					   MIN(len, child->len));
+		if (common == child->len) {
+			node = child;
+			continue;
+		}
+
+		if (common == len) {
+			/* The new prefix sits between node and child */
+			leaf = route_trie_node_new(addr, len);
+			leaf->child[prefix_bit(&child->prefix, len)] = child;
+			*link = leaf;
+			node = leaf;
+			break;
+		}
+
+		/* Branch where the two prefixes part */
+		mid = route_trie_node_new(addr, common);
+		leaf = route_trie_node_new(addr, len);
+		mid->child[prefix_bit(&child->prefix, common)] = child;
+		mid->child[prefix_bit(addr, common)] = leaf;
+		*link = mid;
+		node = leaf;
+		break;
+	}
+
+	sys_slist_append(&node->routes, &route->trie_node);
+
+	route_trie_write_end();
+}
+
+/* Must be called with the neighbor cache lock held */
+static void route_trie_remove(struct net_route_entry *route)
+{
+	struct route_trie_node **parent_link = NULL;
+	struct route_trie_node **link = &route_trie_root;
+	struct route_trie_node *parent = NULL;
+	struct route_trie_node *node = route_trie_root;
+	uint8_t len = route->prefix_len;
+
+	while (node != NULL && node->len < len) {
+		parent_link = link;
+		parent = node;
+		link = &node->child[prefix_bit(&route->addr, node->len)];
+		node = *link;
+	}
+
+	if (node == NULL || node->len != len ||
+	    !net_ipv6_is_prefix(node->prefix.s6_addr, route->addr.s6_addr, len)) {
+		return;
+	}
+
+	route_trie_write_begin();
+
+	(void)sys_slist_find_and_remove(&node->routes, &route->trie_node);
+
+	/* A node without routes is only needed where the trie branches.
+	 * Dropping a leaf can leave its parent with a single child, in
+	 * which case that goes too if it holds no routes.  The root stays.
+	 */
+	if (node != route_trie_root && sys_slist_is_empty(&node->routes) &&
+	    (node->child[0] == NULL || node->child[1] == NULL)) {
+		*link = node->child[0] != NULL ? node->child[0] : node->child[1];
+		route_trie_node_free(node);
+
+		if (*link == NULL && parent != route_trie_root &&
+		    sys_slist_is_empty(&parent->routes)) {
+			*parent_link = parent->child[0] != NULL ?
+				parent->child[0] : parent->child[1];
+			route_trie_node_free(parent);
+		}
+	}
+
+	route_trie_write_end();
+}
+
+/* Lookup without the lock, returns false if the trie changed meanwhile */
+static bool route_trie_lookup(struct net_if *iface, const struct in6_addr *dst,
+			      struct net_route_entry **found)
+{
+	atomic_val_t seq = atomic_get(&route_trie_seq);
+	struct route_trie_node *node = route_trie_root;
+	struct net_route_entry *best = NULL;
+
+	if (seq & 1) {
+		return false;
+	}
+
+	while (node != NULL) {
+		struct net_route_entry *route;
+		struct route_trie_node *next;
+		int count = 0;
+
+		if (!net_ipv6_is_prefix(dst->s6_addr, node->prefix.s6_addr,
+					node->len)) {
+			break;
+		}
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, trie_node) {
+			/* Bail out of lists changing under our feet */
+			if (++count > CONFIG_NET_MAX_ROUTES) {
+				return false;
+			}
+
+			if (iface == NULL || route->iface == iface) {
+				best = route;
+				break;
+			}
+		}
+
+		if (node->len >= 128U) {
+			break;
+		}
+
+		next = node->child[prefix_bit(dst, node->len)];
+		if (next != NULL && next->len <= node->len) {
+			return false;
+		}
+
+		node = next;
+	}
+
+	barrier_dmem_fence_full();
+
+	if (atomic_get(&route_trie_seq) != seq) {
+		return false;
+	}
+
+	*found = best;
+
+	return true;
+}
+
+static void route_trie_init(void)
+{
+	for (int i = 0; i < ROUTE_TRIE_NODES; i++) {
+		route_trie_node_free(&route_trie_nodes[i]);
+	}
+
+	route_trie_root = route_trie_node_new(net_ipv6_unspecified_address(), 0);
+}
+
+/* The route used least recently, the one to drop if the table is full */
+static sys_snode_t *route_lru(void)
+{
+	uint32_t now = (uint32_t)atomic_get(&route_access_seq);
+	struct net_route_entry *route, *lru = NULL;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&routes, route, node) {
+		if (lru == NULL ||
+		    now - route->last_access >= now - lru->last_access) {
+			lru = route;
+		}
+	}
+
+	return lru != NULL ? &lru->node : NULL;
+}
+
+static inline void update_route_access(struct net_route_entry *route)
+{
+	route->last_access = (uint32_t)atomic_inc(&route_access_seq);
+}
+#else
+/* Route was accessed, so place it in front of the routes list */
+static inline void update_route_access(struct net_route_entry *route)
+{
+	sys_slist_find_and_remove(&routes, &route->node);
+	sys_slist_prepend(&routes, &route->node);
+}
+#endif /* CONFIG_NET_ROUTE_TRIE */
+
 #define net_route_info(str, route, dst)					\
 	do {								\
 	if (CONFIG_NET_ROUTE_LOG_LEVEL >= LOG_LEVEL_DBG) {		\
@@ -260,16 +559,27 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 			route->iface);					\
 	} } while (0)
 
-/* Route was accessed, so place it in front of the routes list */
-static inline void update_route_access(struct net_route_entry *route)
-{
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
-}
-
 struct net_route_entry *net_route_lookup(struct net_if *iface,
 					 struct in6_addr *dst)
 {
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	struct net_route_entry *found = NULL;
+
+	if (!route_trie_lookup(iface, dst, &found)) {
+		/* The trie was being changed, look again once that is done */
+		net_ipv6_nbr_lock();
+		(void)route_trie_lookup(iface, dst, &found);
+		net_ipv6_nbr_unlock();
+	}
+
+	if (found) {
+		net_route_info("Found", found, dst);
+
+		update_route_access(found);
+	}
+
+	return found;
+#else
 	struct net_route_entry *route, *found = NULL;
 	uint8_t longest_match = 0U;
 	int i;
@@ -306,6 +616,7 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 
 	net_ipv6_nbr_unlock();
 	return found;
+#endif /* CONFIG_NET_ROUTE_TRIE */
 }
 
 static inline bool route_preference_is_lower(uint8_t old, uint8_t new)
@@ -393,7 +704,11 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
+#if defined(CONFIG_NET_ROUTE_TRIE)
+		sys_snode_t *last = route_lru();
+#else
 		sys_snode_t *last = sys_slist_peek_tail(&routes);
+#endif
 
 		sys_slist_find_and_remove(&routes, last);
 
@@ -446,6 +761,11 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 
 	sys_slist_prepend(&routes, &route->node);
 
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	update_route_access(route);
+	route_trie_insert(route);
+#endif
+
 	tmp = nbr_nexthop_get(iface, nexthop);
 
 	NET_ASSERT(tmp == nbr_nexthop);
@@ -596,6 +916,10 @@ int net_route_del(struct net_route_entry *route)
 
 	net_route_info("Deleted", route, &route->addr);
 
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	route_trie_remove(route);
+#endif
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
 		if (!nexthop_route->nbr) {
 			continue;
@@ -1028,4 +1352,8 @@ void net_route_init(void)
 		CONFIG_NET_MAX_NEXTHOPS, sizeof(net_route_nexthop_pool));
 
 	k_work_init_delayable(&route_lifetime_timer, route_lifetime_timeout);
+
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	route_trie_init();
+#endif
 }
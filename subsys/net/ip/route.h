@@ -68,6 +68,16 @@ struct net_route_entry {
 
 	/** Is the route valid forever */
 	uint8_t is_infinite : 1;
+
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	/** Node in the list of routes of a trie node */
+	sys_snode_t trie_node;
+
+	/** When the route was last used, to find the least recently
+	 * used one.
+	 */
+	uint32_t last_access;
+#endif
 };
 
 /* Route preference values, as defined in RFC 4191 */
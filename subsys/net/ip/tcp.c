@@ -64,6 +64,14 @@ static int tcp_tx_window =
 #define TCP_RTO_MS (tcp_rto)
 #endif
 
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+/* RFC 7323, the largest shift and the window it can describe */
+#define TCP_WSCALE_MAX 14
+#define TCP_MAX_WIN ((uint32_t)UINT16_MAX << TCP_WSCALE_MAX)
+#else
+#define TCP_MAX_WIN UINT16_MAX
+#endif
+
 /* Define the number of MSS sections the congestion window is initialized at */
 #define TCP_CONGESTION_INITIAL_WIN 1
 #define TCP_CONGESTION_INITIAL_SSTHRESH 3
@@ -402,7 +410,7 @@ static void tcp_derive_rto(struct tcp *conn)
 
 static void tcp_new_reno_log(struct tcp *conn, char *step)
 {
-	NET_DBG("conn: %p, ca %s, cwnd=%d, ssthres=%d, fast_pend=%i",
+	NET_DBG("conn: %p, ca %s, cwnd=%u, ssthres=%u, fast_pend=%u",
 		conn, step, conn->ca.cwnd, conn->ca.ssthresh,
 		conn->ca.pending_fast_retransmit_bytes);
 }
@@ -436,17 +444,17 @@ static void tcp_new_reno_timeout(struct tcp *conn)
 /* For every duplicate ack increment the cwnd by mss */
 static void tcp_new_reno_dup_ack(struct tcp *conn)
 {
-	int32_t new_win = conn->ca.cwnd;
+	uint32_t new_win = conn->ca.cwnd;
 
 	new_win += conn_mss(conn);
-	conn->ca.cwnd = MIN(new_win, UINT16_MAX);
+	conn->ca.cwnd = MIN(new_win, TCP_MAX_WIN);
 	tcp_new_reno_log(conn, "dup_ack");
 }
 
 static void tcp_new_reno_pkts_acked(struct tcp *conn, uint32_t acked_len)
 {
-	int32_t new_win = conn->ca.cwnd;
-	int32_t win_inc = MIN(acked_len, conn_mss(conn));
+	uint32_t new_win = conn->ca.cwnd;
+	uint32_t win_inc = MIN(acked_len, conn_mss(conn));
 
 	if (conn->ca.pending_fast_retransmit_bytes == 0) {
 		if (conn->ca.cwnd < conn->ca.ssthresh) {
@@ -455,7 +463,7 @@ static void tcp_new_reno_pkts_acked(struct tcp *conn, uint32_t acked_len)
 			/* Implement a div_ceil	to avoid rounding to 0 */
 			new_win += ((win_inc * win_inc) + conn->ca.cwnd - 1) / conn->ca.cwnd;
 		}
-		conn->ca.cwnd = MIN(new_win, UINT16_MAX);
+		conn->ca.cwnd = MIN(new_win, TCP_MAX_WIN);
 	} else {
 		/* Check if it is still in fast recovery mode */
 		if (conn->ca.pending_fast_retransmit_bytes <= acked_len) {
@@ -809,6 +817,20 @@ static int tcp_conn_unref(struct tcp *conn)
 	return ref_count;
 }
 
+/* Wake up the senders waiting for the window to open. The epoll waiters
+ * are only told when the window was full, that is the edge they wait for.
+ */
+static void tcp_tx_sem_give(struct tcp *conn)
+{
+	bool was_full = k_sem_count_get(&conn->tx_sem) == 0U;
+
+	k_sem_give(&conn->tx_sem);
+
+	if (was_full) {
+		net_socket_epoll_notify(conn->context);
+	}
+}
+
 #if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
 #define tcp_conn_close(conn, status)				\
 	tcp_conn_close_debug(conn, status, __func__, __LINE__)
@@ -839,7 +861,7 @@ static int tcp_conn_close(struct tcp *conn, int status)
 				       status, conn->recv_user_data);
 	}
 
-	k_sem_give(&conn->tx_sem);
+	tcp_tx_sem_give(conn);
 
 	return tcp_conn_unref(conn);
 }
@@ -1048,9 +1070,6 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
-
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
 
@@ -1095,9 +1114,48 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = options[2];
 			recv_options->wnd_found = true;
 			break;
+		case NET_TCP_SACK_PERM_OPT:
+			if (opt_len != NET_TCP_SACK_PERM_SIZE) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+		case NET_TCP_TIMESTAMPS_OPT:
+			if (opt_len != NET_TCP_TIMESTAMPS_SIZE) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->tsval = sys_get_be32(options + 2);
+			recv_options->tsecr = sys_get_be32(options + 6);
+			recv_options->ts_found = true;
+			break;
+#endif
+#if defined(CONFIG_NET_TCP_SACK)
+		case NET_TCP_SACK_OPT:
+			if (opt_len < 2 + NET_TCP_SACK_BLOCK_SIZE ||
+			    ((opt_len - 2) % NET_TCP_SACK_BLOCK_SIZE) != 0) {
+				result = false;
+				goto end;
+			}
+
+			for (int i = 2; i < opt_len &&
+			     recv_options->sack_cnt < NET_TCP_SACK_MAX_BLOCKS;
+			     i += NET_TCP_SACK_BLOCK_SIZE) {
+				struct tcp_sack_block *blk =
+					&recv_options->sack[recv_options->sack_cnt++];
+
+				blk->start = sys_get_be32(options + i);
+				blk->end = sys_get_be32(options + i + 4);
+			}
+			break;
+#endif
 		default:
 			continue;
 		}
@@ -1271,8 +1329,24 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+/* The window field of a segment, scaled down unless it is a SYN */
+static uint16_t tcp_win_field(struct tcp *conn, uint8_t flags)
+{
+	uint32_t win = conn->recv_win;
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	if (!(flags & SYN)) {
+		win >>= conn->rcv_wscale;
+	}
+#else
+	ARG_UNUSED(flags);
+#endif
+
+	return MIN(win, UINT16_MAX);
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, size_t opts_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
@@ -1286,14 +1360,10 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
-
-	if (conn->send_options.mss_found) {
-		th->th_off++;
-	}
+	th->th_off = 5 + opts_len / 4;
 
 	UNALIGNED_PUT(flags, &th->th_flags);
-	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
+	UNALIGNED_PUT(htons(tcp_win_field(conn, flags)), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
 
 	if (ACK & flags) {
@@ -1351,23 +1421,104 @@ static int get_tcp_nodelay(struct tcp *conn, void *value, size_t *len)
 	return 0;
 }
 
-static int net_tcp_set_mss_opt(struct tcp *conn, struct net_pkt *pkt)
+#if defined(CONFIG_NET_TCP_SACK)
+/* Report the out of order data held in the receive queue. The queue
+ * only ever holds one contiguous range, so there is one block at most.
+ */
+static size_t tcp_sack_blocks_build(struct tcp *conn, uint8_t *opts)
 {
-	NET_PKT_DATA_ACCESS_DEFINE(mss_opt_access, struct tcp_mss_option);
-	struct tcp_mss_option *mss;
-	uint32_t recv_mss;
+	uint32_t start;
 
-	mss = net_pkt_get_data(pkt, &mss_opt_access);
-	if (!mss) {
-		return -ENOBUFS;
+	if (!CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT ||
+	    net_pkt_is_empty(conn->queue_recv_data)) {
+		return 0;
+	}
+
+	start = tcp_get_seq(conn->queue_recv_data->buffer);
+
+	opts[0] = NET_TCP_NOP_OPT;
+	opts[1] = NET_TCP_NOP_OPT;
+	opts[2] = NET_TCP_SACK_OPT;
+	opts[3] = 2 + NET_TCP_SACK_BLOCK_SIZE;
+	sys_put_be32(start, &opts[4]);
+	sys_put_be32(start + net_pkt_get_len(conn->queue_recv_data), &opts[8]);
+
+	return 4 + NET_TCP_SACK_BLOCK_SIZE;
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+/* Build the options of a segment: the MSS, SACK permitted and window
+ * scale in SYNs, the timestamps in every segment once agreed on, and
+ * SACK blocks in ACKs without data, which is what duplicate ACKs are.
+ * The result is padded to a multiple of 4 bytes.
+ */
+static size_t tcp_options_build(struct tcp *conn, uint8_t flags, bool has_data,
+				uint8_t *opts)
+{
+	uint8_t *p = opts;
+
+	if (conn->send_options.mss_found) {
+		*p++ = NET_TCP_MSS_OPT;
+		*p++ = NET_TCP_MSS_SIZE;
+		sys_put_be16(net_tcp_get_supported_mss(conn), p);
+		p += sizeof(uint16_t);
+	}
+
+	if ((flags & SYN) && conn->sack_ok) {
+		if (!conn->ts_ok) {
+			*p++ = NET_TCP_NOP_OPT;
+			*p++ = NET_TCP_NOP_OPT;
+		}
+
+		*p++ = NET_TCP_SACK_PERM_OPT;
+		*p++ = NET_TCP_SACK_PERM_SIZE;
+	} else if (conn->ts_ok) {
+		*p++ = NET_TCP_NOP_OPT;
+		*p++ = NET_TCP_NOP_OPT;
 	}
 
-	recv_mss = net_tcp_get_supported_mss(conn);
-	recv_mss |= (NET_TCP_MSS_OPT << 24) | (NET_TCP_MSS_SIZE << 16);
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	if (conn->ts_ok) {
+		*p++ = NET_TCP_TIMESTAMPS_OPT;
+		*p++ = NET_TCP_TIMESTAMPS_SIZE;
+		sys_put_be32(k_uptime_get_32(), p);
+		sys_put_be32((flags & ACK) ? conn->ts_recent : 0U, p + 4);
+		p += 2 * sizeof(uint32_t);
+	}
+#endif
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	if ((flags & SYN) && conn->wscale_ok) {
+		*p++ = NET_TCP_NOP_OPT;
+		*p++ = NET_TCP_WINDOW_SCALE_OPT;
+		*p++ = NET_TCP_WINDOW_SCALE_SIZE;
+		*p++ = conn->rcv_wscale;
+	}
+#endif
+
+#if defined(CONFIG_NET_TCP_SACK)
+	if (!(flags & SYN) && (flags & ACK) && !has_data && conn->sack_ok) {
+		p += tcp_sack_blocks_build(conn, p);
+	}
+#else
+	ARG_UNUSED(has_data);
+#endif
+
+	return p - opts;
+}
+
+/* Payload of a full sized data segment, the timestamps every segment
+ * carries come out of the MSS.
+ */
+static int tcp_seg_len(struct tcp *conn)
+{
+	int len = conn_mss(conn);
 
-	UNALIGNED_PUT(htonl(recv_mss), (uint32_t *)mss);
+	if (conn->ts_ok) {
+		len -= 2 * NET_TCP_NOP_SIZE + NET_TCP_TIMESTAMPS_SIZE;
+	}
 
-	return net_pkt_set_data(pkt, &mss_opt_access);
+	return len;
 }
 
 static bool is_destination_local(struct net_pkt *pkt)
@@ -1474,20 +1625,23 @@ err:
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
-	size_t alloc_len = sizeof(struct tcphdr);
+	uint8_t opts[NET_TCP_OPTIONS_MAX_SIZE];
+	size_t opts_len = tcp_options_build(conn, flags, data != NULL, opts);
+	size_t alloc_len = sizeof(struct tcphdr) + opts_len;
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	if (conn->send_options.mss_found) {
-		alloc_len += sizeof(uint32_t);
-	}
-
 	pkt = tcp_pkt_alloc(conn, alloc_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
 	}
 
+	if (IS_ENABLED(CONFIG_NET_TCP_GSO) && data &&
+	    net_pkt_get_len(data) > tcp_seg_len(conn)) {
+		net_pkt_set_gso_size(pkt, tcp_seg_len(conn));
+	}
+
 	if (data) {
 		/* Append the data buffer to the pkt */
 		net_pkt_append_buffer(pkt, data->buffer);
@@ -1500,14 +1654,14 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, opts_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
 	}
 
-	if (conn->send_options.mss_found) {
-		ret = net_tcp_set_mss_opt(conn, pkt);
+	if (opts_len > 0) {
+		ret = net_pkt_write(pkt, opts, opts_len);
 		if (ret < 0) {
 			tcp_pkt_unref(pkt);
 			goto out;
@@ -1651,13 +1805,13 @@ static int tcp_unsent_len(struct tcp *conn)
 	if (conn->unacked_len >= conn->send_win) {
 		unsent_len = 0;
 	} else {
-		unsent_len = MIN(unsent_len, conn->send_win - conn->unacked_len);
+		unsent_len = MIN(unsent_len, (int)(conn->send_win - conn->unacked_len));
 
 #ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
 		if (conn->unacked_len >= conn->ca.cwnd) {
 			unsent_len = 0;
 		} else {
-			unsent_len = MIN(unsent_len, conn->ca.cwnd - conn->unacked_len);
+			unsent_len = MIN(unsent_len, (int)(conn->ca.cwnd - conn->unacked_len));
 		}
 #endif
 	}
@@ -1665,13 +1819,73 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+/* Data sent over Ethernet goes out in packets of several segments, which
+ * are split right before being given to L2. Packets to a local address
+ * never reach L2 and are kept to one segment, as is a retransmission
+ * after a timeout, which must not put more than a segment on the path.
+ */
+static int tcp_gso_segs(struct tcp *conn)
+{
+	if (conn->data_mode == TCP_DATA_MODE_RESEND) {
+		return 1;
+	}
+
+	if (net_if_l2(conn->iface) != &NET_L2_GET_NAME(ETHERNET)) {
+		return 1;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && conn->dst.sa.sa_family == AF_INET &&
+	    (net_ipv4_is_addr_loopback(&conn->dst.sin.sin_addr) ||
+	     net_ipv4_is_my_addr(&conn->dst.sin.sin_addr))) {
+		return 1;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && conn->dst.sa.sa_family == AF_INET6 &&
+	    (net_ipv6_is_addr_loopback(&conn->dst.sin6.sin6_addr) ||
+	     net_ipv6_is_my_addr(&conn->dst.sin6.sin6_addr))) {
+		return 1;
+	}
+
+	return CONFIG_NET_TCP_GSO_MAX_SEGS;
+}
+
+static struct net_pkt *tcp_data_pkt_alloc(struct tcp *conn, int *len)
+{
+	struct net_pkt *pkt;
+
+	if (*len <= tcp_seg_len(conn)) {
+		return tcp_pkt_alloc(conn, *len);
+	}
+
+	/* tcp_pkt_alloc() would limit the buffer to the MTU */
+	pkt = tcp_pkt_alloc(conn, 0);
+	if (pkt && net_pkt_alloc_buffer_raw(pkt, *len,
+					    TCP_PKT_ALLOC_TIMEOUT) == 0) {
+		return pkt;
+	}
+
+	if (pkt) {
+		tcp_pkt_unref(pkt);
+	}
+
+	/* Short of buffers, fall back to a single segment */
+	*len = tcp_seg_len(conn);
+
+	return tcp_pkt_alloc(conn, *len);
+}
+#else
+#define tcp_gso_segs(_conn) 1
+#define tcp_data_pkt_alloc(_conn, _len) tcp_pkt_alloc(_conn, *(_len))
+#endif /* CONFIG_NET_TCP_GSO */
+
 static int tcp_send_data(struct tcp *conn)
 {
 	int ret = 0;
 	int len;
 	struct net_pkt *pkt;
 
-	len = MIN(tcp_unsent_len(conn), conn_mss(conn));
+	len = MIN(tcp_unsent_len(conn), tcp_seg_len(conn) * tcp_gso_segs(conn));
 	if (len < 0) {
 		ret = len;
 		goto out;
@@ -1682,7 +1896,7 @@ static int tcp_send_data(struct tcp *conn)
 		goto out;
 	}
 
-	pkt = tcp_pkt_alloc(conn, len);
+	pkt = tcp_data_pkt_alloc(conn, &len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
 		ret = -ENOBUFS;
@@ -1736,7 +1950,7 @@ static int tcp_send_queued_data(struct tcp *conn)
 		/* Implement Nagle's algorithm */
 		if ((conn->tcp_nodelay == false) && (conn->unacked_len > 0)) {
 			/* If there is already pending data */
-			if (tcp_unsent_len(conn) < conn_mss(conn)) {
+			if (tcp_unsent_len(conn) < tcp_seg_len(conn)) {
 				/* The number of bytes to be transmitted is less than an MSS,
 				 * skip transmission for now.
 				 * Wait for more data to be transmitted or all pending data
@@ -1769,6 +1983,175 @@ static int tcp_send_queued_data(struct tcp *conn)
 	return ret;
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+static void tcp_sack_reset(struct tcp *conn)
+{
+	conn->sacked_cnt = 0U;
+	conn->sack_rexmit_next = conn->seq;
+}
+
+/* Merge a SACKed range into the scoreboard, which is kept sorted and
+ * without overlaps. When it is full, the highest range is forgotten.
+ */
+static void tcp_sack_add(struct tcp *conn, uint32_t start, uint32_t end)
+{
+	struct tcp_sack_block *sb = conn->sacked;
+	int i, j;
+
+	for (i = 0; i < conn->sacked_cnt; i++) {
+		if (net_tcp_seq_cmp(sb[i].end, start) >= 0) {
+			break;
+		}
+	}
+
+	for (j = i; j < conn->sacked_cnt; j++) {
+		if (net_tcp_seq_cmp(sb[j].start, end) > 0) {
+			break;
+		}
+
+		if (net_tcp_seq_cmp(sb[j].start, start) < 0) {
+			start = sb[j].start;
+		}
+
+		if (net_tcp_seq_cmp(sb[j].end, end) > 0) {
+			end = sb[j].end;
+		}
+	}
+
+	if (i == j) {
+		if (conn->sacked_cnt == ARRAY_SIZE(conn->sacked)) {
+			if (i == conn->sacked_cnt) {
+				return;
+			}
+
+			conn->sacked_cnt--;
+		}
+
+		memmove(&sb[i + 1], &sb[i], (conn->sacked_cnt - i) * sizeof(*sb));
+		conn->sacked_cnt++;
+	} else if (j > i + 1) {
+		memmove(&sb[i + 1], &sb[j], (conn->sacked_cnt - j) * sizeof(*sb));
+		conn->sacked_cnt -= j - i - 1;
+	}
+
+	sb[i].start = start;
+	sb[i].end = end;
+}
+
+/* Take the SACK blocks of a received segment into the scoreboard.
+ * Blocks which do not describe data sent and not yet acknowledged,
+ * like D-SACK ones, are ignored.
+ */
+static void tcp_sack_update(struct tcp *conn)
+{
+	uint32_t snd_nxt = conn->seq + conn->unacked_len;
+
+	if (!conn->sack_ok) {
+		return;
+	}
+
+	for (int i = 0; i < conn->recv_options.sack_cnt; i++) {
+		struct tcp_sack_block *blk = &conn->recv_options.sack[i];
+
+		if (net_tcp_seq_cmp(blk->start, conn->seq) <= 0 ||
+		    net_tcp_seq_cmp(blk->end, blk->start) <= 0 ||
+		    net_tcp_seq_cmp(blk->end, snd_nxt) > 0) {
+			continue;
+		}
+
+		tcp_sack_add(conn, blk->start, blk->end);
+	}
+}
+
+/* Forget the ranges the cumulative acknowledgement has reached */
+static void tcp_sack_ack(struct tcp *conn)
+{
+	int i;
+
+	for (i = 0; i < conn->sacked_cnt; i++) {
+		if (net_tcp_seq_cmp(conn->sacked[i].end, conn->seq) > 0) {
+			break;
+		}
+	}
+
+	if (i > 0) {
+		memmove(&conn->sacked[0], &conn->sacked[i],
+			(conn->sacked_cnt - i) * sizeof(conn->sacked[0]));
+		conn->sacked_cnt -= i;
+	}
+
+	if (conn->sacked_cnt > 0 &&
+	    net_tcp_seq_cmp(conn->sacked[0].start, conn->seq) < 0) {
+		conn->sacked[0].start = conn->seq;
+	}
+}
+
+/* Retransmit the next hole below the highest SACKed range which was not
+ * retransmitted yet, at most one segment of it.
+ */
+static int tcp_sack_retransmit(struct tcp *conn)
+{
+	uint32_t pos = conn->seq;
+	struct net_pkt *pkt;
+	int len = 0;
+	int ret;
+
+	if (!conn->sack_ok) {
+		return -ENODATA;
+	}
+
+	if (net_tcp_seq_cmp(conn->sack_rexmit_next, pos) > 0) {
+		pos = conn->sack_rexmit_next;
+	}
+
+	for (int i = 0; i < conn->sacked_cnt; i++) {
+		if (net_tcp_seq_cmp(pos, conn->sacked[i].start) < 0) {
+			len = conn->sacked[i].start - pos;
+			break;
+		}
+
+		if (net_tcp_seq_cmp(pos, conn->sacked[i].end) < 0) {
+			pos = conn->sacked[i].end;
+		}
+	}
+
+	if (len == 0 || (int)(pos - conn->seq) >= conn->unacked_len) {
+		return -ENODATA;
+	}
+
+	len = MIN(len, tcp_seg_len(conn));
+
+	pkt = tcp_pkt_alloc(conn, len);
+	if (!pkt) {
+		return -ENOBUFS;
+	}
+
+	ret = tcp_pkt_peek(pkt, conn->send_data, pos - conn->seq, len);
+	if (ret < 0) {
+		tcp_pkt_unref(pkt);
+		return -ENOBUFS;
+	}
+
+	NET_DBG("conn: %p SACK retransmit seq %u len %d", conn, pos, len);
+
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, pos);
+	if (ret == 0) {
+		conn->sack_rexmit_next = pos + len;
+		net_stats_update_tcp_resent(conn->iface, len);
+		net_stats_update_tcp_seg_rexmit(conn->iface);
+	}
+
+	tcp_pkt_unref(pkt);
+
+	return ret;
+}
+#else
+#define tcp_sack_reset(_conn)
+#define tcp_sack_update(_conn)
+#define tcp_sack_ack(_conn)
+#define tcp_sack_retransmit(_conn) (-ENODATA)
+#endif /* CONFIG_NET_TCP_SACK */
+
 static void tcp_cleanup_recv_queue(struct k_work *work)
 {
 	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
@@ -1815,6 +2198,9 @@ static void tcp_resend_data(struct k_work *work)
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
+	/* RFC 2018, the receiver may have discarded SACKed data */
+	tcp_sack_reset(conn);
+
 	ret = tcp_send_data(conn);
 	conn->send_data_retries++;
 	if (ret == 0) {
@@ -2066,7 +2452,7 @@ static struct tcp *tcp_conn_alloc(void)
 	/* Initially set the congestion window at its max size, since only the MSS
 	 * is available as soon as the connection is established
 	 */
-	conn->ca.cwnd = UINT16_MAX;
+	conn->ca.cwnd = TCP_MAX_WIN;
 #endif
 
 	/* The ISN value will be set when we get the connection attempt or
@@ -2162,6 +2548,212 @@ static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 	return found ? conn : NULL;
 }
 
+#if defined(CONFIG_NET_TCP_GRO)
+/* Connections with data segments held for coalescing. The RX path merges
+ * in-order segments of a connection into the held packet, which is given
+ * to tcp_in() once it is full, when a segment that cannot be merged shows
+ * up, when the RX thread that held it has nothing more to process, or once
+ * it has been held for CONFIG_NET_TCP_GRO_MAX_HOLD_US even if the thread
+ * still has packets of other connections to process. Only that thread
+ * flushes it, another RX thread could be processing a newer segment of the
+ * connection.
+ */
+static sys_slist_t tcp_gro_list = SYS_SLIST_STATIC_INIT(&tcp_gro_list);
+static K_MUTEX_DEFINE(tcp_gro_lock);
+
+static bool tcp_gro_can_hold(struct tcp *conn, struct net_pkt *pkt)
+{
+	struct tcphdr *th = th_get(pkt);
+	uint8_t fl;
+
+	if (!th || conn->state != TCP_ESTABLISHED) {
+		return false;
+	}
+
+	fl = th_flags(th);
+	if (fl != ACK && fl != (ACK | PSH)) {
+		return false;
+	}
+
+	return tcp_data_len(pkt) > 0;
+}
+
+/* Append the payload of pkt to the held one if it directly follows it
+ * and carries the same options, which tcp_in() only sees once.
+ */
+static bool tcp_gro_merge(struct net_pkt *held, struct net_pkt *pkt)
+{
+	uint8_t held_opts[40]; /* TCP header max options size is 40 */
+	uint8_t opts[40];
+	struct tcphdr *th = th_get(held);
+	uint32_t ack = th_ack(th);
+	uint8_t off = th_off(th);
+	uint32_t seq = th_seq(th) + tcp_data_len(held);
+	size_t opts_len;
+	uint16_t win;
+	uint8_t fl;
+
+	th = th_get(pkt);
+	if (!th || th_seq(th) != seq || th_ack(th) != ack || th_off(th) != off) {
+		return false;
+	}
+
+	if (off * 4U < sizeof(struct tcphdr)) {
+		return false;
+	}
+
+	opts_len = off * 4U - sizeof(struct tcphdr);
+	if (opts_len > 0 &&
+	    (!tcp_options_get(held, opts_len, held_opts, sizeof(held_opts)) ||
+	     !tcp_options_get(pkt, opts_len, opts, sizeof(opts)) ||
+	     memcmp(held_opts, opts, opts_len) != 0)) {
+		return false;
+	}
+
+	win = th_win(th);
+	fl = th_flags(th);
+
+	if (tcp_pkt_pull(pkt, net_pkt_ip_hdr_len(pkt) +
+			 net_pkt_ip_opts_len(pkt) + off * 4U) < 0) {
+		return false;
+	}
+
+	net_pkt_append_buffer(held, pkt->buffer);
+	pkt->buffer = NULL;
+	tcp_pkt_unref(pkt);
+
+	th = th_get(held);
+	UNALIGNED_PUT(win, &th->th_win);
+	UNALIGNED_PUT(th_flags(th) | (fl & PSH), &th->th_flags);
+
+	return true;
+}
+
+static struct net_pkt *tcp_gro_detach(struct tcp *conn)
+{
+	struct net_pkt *pkt = conn->gro_pkt;
+
+	if (pkt) {
+		sys_slist_find_and_remove(&tcp_gro_list, &conn->gro_node);
+		conn->gro_pkt = NULL;
+		conn->gro_segs = 0U;
+	}
+
+	return pkt;
+}
+
+/* The connection stays referenced while a packet is held for it, so that
+ * it is not released under the packet. Dropping that reference must not
+ * go through tcp_conn_unref(), which would also cancel a pending connect.
+ */
+static void tcp_gro_deliver(struct tcp *conn, struct net_pkt *pkt)
+{
+	if (tcp_in(conn, pkt) == NET_DROP) {
+		tcp_pkt_unref(pkt);
+	}
+
+	if (atomic_dec(&conn->ref_count) == 1) {
+		k_work_submit_to_queue(&tcp_work_q, &conn->conn_release);
+	}
+}
+
+/* Returns true if pkt was held or merged, false if the caller has to give
+ * it to tcp_in() itself.
+ */
+static bool tcp_gro_receive(struct tcp *conn, struct net_pkt *pkt)
+{
+	struct net_pkt *flush = NULL;
+	bool held = false;
+
+	k_mutex_lock(&tcp_gro_lock, K_FOREVER);
+
+	if (conn->gro_pkt) {
+		if (tcp_gro_can_hold(conn, pkt) &&
+		    tcp_gro_merge(conn->gro_pkt, pkt)) {
+			held = true;
+
+			if (++conn->gro_segs < CONFIG_NET_TCP_GRO_MAX_SEGS) {
+				goto out;
+			}
+		}
+
+		flush = tcp_gro_detach(conn);
+	}
+
+	/* A packet is not held right after a flush, so that it cannot be
+	 * flushed by another RX thread before the previous one is processed.
+	 */
+	if (!held && !flush && tcp_gro_can_hold(conn, pkt)) {
+		tcp_conn_ref(conn);
+		conn->gro_pkt = pkt;
+		conn->gro_segs = 1U;
+		conn->gro_owner = k_current_get();
+		conn->gro_start = k_cycle_get_32();
+		sys_slist_append(&tcp_gro_list, &conn->gro_node);
+		held = true;
+	}
+out:
+	k_mutex_unlock(&tcp_gro_lock);
+
+	if (flush) {
+		tcp_gro_deliver(conn, flush);
+	}
+
+	return held;
+}
+
+static void tcp_gro_flush(bool expired_only)
+{
+	uint32_t max_hold = k_us_to_cyc_ceil32(CONFIG_NET_TCP_GRO_MAX_HOLD_US);
+	k_tid_t self = k_current_get();
+	struct net_pkt *pkt;
+	struct tcp *conn;
+
+	while (true) {
+		pkt = NULL;
+
+		k_mutex_lock(&tcp_gro_lock, K_FOREVER);
+
+		/* The list is in holding order, so once a packet of this
+		 * thread is recent enough, its following ones are as well.
+		 */
+		SYS_SLIST_FOR_EACH_CONTAINER(&tcp_gro_list, conn, gro_node) {
+			if (conn->gro_owner != self) {
+				continue;
+			}
+
+			if (!expired_only ||
+			    k_cycle_get_32() - conn->gro_start >= max_hold) {
+				pkt = tcp_gro_detach(conn);
+			}
+			break;
+		}
+
+		k_mutex_unlock(&tcp_gro_lock);
+
+		if (!pkt) {
+			break;
+		}
+
+		tcp_gro_deliver(conn, pkt);
+	}
+}
+
+void net_tcp_gro_flush(void)
+{
+	tcp_gro_flush(false);
+}
+
+void net_tcp_gro_flush_expired(void)
+{
+	if (sys_slist_is_empty(&tcp_gro_list)) {
+		return;
+	}
+
+	tcp_gro_flush(true);
+}
+#endif /* CONFIG_NET_TCP_GRO */
+
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
 
 static enum net_verdict tcp_recv(struct net_conn *net_conn,
@@ -2197,6 +2789,11 @@ static enum net_verdict tcp_recv(struct net_conn *net_conn,
 	}
 in:
 	if (conn) {
+#if defined(CONFIG_NET_TCP_GRO)
+		if (tcp_gro_receive(conn, pkt)) {
+			return NET_OK;
+		}
+#endif
 		verdict = tcp_in(conn, pkt);
 	} else {
 		net_tcp_reply_rst(pkt);
@@ -2669,6 +3266,70 @@ static void tcp_out_of_order_data(struct tcp *conn, struct net_pkt *pkt,
 	tcp_queue_recv_data(conn, pkt, data_len, seq);
 }
 
+/* Select the options a SYN offers, or once the SYN of the peer was
+ * parsed, the ones both ends offered.
+ */
+static void tcp_syn_options_set(struct tcp *conn, bool peer_syn)
+{
+	struct tcp_options *peer = &conn->recv_options;
+
+	conn->wscale_ok = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) &&
+			  (!peer_syn || peer->wnd_found);
+	conn->ts_ok = IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS) &&
+		      (!peer_syn || peer->ts_found);
+	conn->sack_ok = IS_ENABLED(CONFIG_NET_TCP_SACK) &&
+			(!peer_syn || peer->sack_perm_found);
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	conn->rcv_wscale = 0U;
+	conn->snd_wscale = 0U;
+
+	if (conn->wscale_ok) {
+		while (conn->rcv_wscale < TCP_WSCALE_MAX &&
+		       (conn->recv_win_max >> conn->rcv_wscale) > UINT16_MAX) {
+			conn->rcv_wscale++;
+		}
+
+		if (peer_syn) {
+			conn->snd_wscale = MIN(peer->window, TCP_WSCALE_MAX);
+		}
+	}
+#endif
+
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	if (conn->ts_ok && peer_syn) {
+		conn->ts_recent = peer->tsval;
+	}
+#endif
+
+	tcp_sack_reset(conn);
+}
+
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+/* RFC 7323 PAWS, tell whether a segment is an old duplicate and else
+ * remember its timestamp if it is the next one in sequence.
+ */
+static bool tcp_paws_reject(struct tcp *conn, struct tcphdr *th)
+{
+	if (!conn->ts_ok || !conn->recv_options.ts_found ||
+	    (th_flags(th) & SYN)) {
+		return false;
+	}
+
+	if ((int32_t)(conn->recv_options.tsval - conn->ts_recent) < 0) {
+		return true;
+	}
+
+	if (net_tcp_seq_cmp(th_seq(th), conn->ack) <= 0) {
+		conn->ts_recent = conn->recv_options.tsval;
+	}
+
+	return false;
+}
+#else
+#define tcp_paws_reject(_conn, _th) false
+#endif /* CONFIG_NET_TCP_TIMESTAMPS */
+
 static void tcp_check_sock_options(struct tcp *conn)
 {
 	int sndbuf_opt = 0;
@@ -2779,6 +3440,12 @@ static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto out;
 	}
 
+	/* Timestamps and SACK blocks only describe the current segment */
+	conn->recv_options.ts_found = false;
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->recv_options.sack_cnt = 0U;
+#endif
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -2803,8 +3470,21 @@ static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto out;
 	}
 
+	if (th && tcp_paws_reject(conn, th)) {
+		NET_DBG("DROP: old timestamp (PAWS)");
+		net_stats_update_tcp_seg_drop(conn->iface);
+		tcp_out(conn, ACK);
+		k_mutex_unlock(&conn->lock);
+		return NET_DROP;
+	}
+
 	if (th) {
 		conn->send_win = ntohs(th_win(th));
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+		if (!(th_flags(th) & SYN)) {
+			conn->send_win <<= conn->snd_wscale;
+		}
+#endif
 		if (conn->send_win > conn->send_win_max) {
 			NET_DBG("Lowering send window from %u to %u",
 				conn->send_win, conn->send_win_max);
@@ -2826,7 +3506,7 @@ static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		if (tcp_window_full(conn)) {
 			(void)k_sem_take(&conn->tx_sem, K_NO_WAIT);
 		} else {
-			k_sem_give(&conn->tx_sem);
+			tcp_tx_sem_give(conn);
 		}
 	}
 
@@ -2836,6 +3516,8 @@ next_state:
 	switch (conn->state) {
 	case TCP_LISTEN:
 		if (FL(&fl, ==, SYN)) {
+			tcp_syn_options_set(conn, true);
+
 			/* Make sure our MSS is also sent in the ACK */
 			conn->send_options.mss_found = true;
 			conn_ack(conn, th_seq(th) + 1); /* capture peer's isn */
@@ -2851,6 +3533,7 @@ next_state:
 						    ACK_TIMEOUT);
 			verdict = NET_OK;
 		} else {
+			tcp_syn_options_set(conn, false);
 			conn->send_options.mss_found = true;
 			tcp_out(conn, SYN);
 			conn->send_options.mss_found = false;
@@ -2958,6 +3641,7 @@ next_state:
 		 */
 		if (FL(&fl, &, SYN | ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
+			tcp_syn_options_set(conn, true);
 			conn_ack(conn, th_seq(th) + 1);
 			if (len) {
 				verdict = tcp_data_get(conn, pkt, &len);
@@ -3043,6 +3727,10 @@ next_state:
 		 */
 		keep_alive_timer_restart(conn);
 
+		if (th) {
+			tcp_sack_update(conn);
+		}
+
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
 		if (th && (net_tcp_seq_cmp(th_ack(th), conn->seq) == 0)) {
 			/* Only if there is pending data, increment the duplicate ack count */
@@ -3063,20 +3751,30 @@ next_state:
 			/* Only do fast retransmit when not already in a resend state */
 			if ((conn->data_mode == TCP_DATA_MODE_SEND) &&
 			    (conn->dup_ack_cnt == DUPLICATE_ACK_RETRANSMIT_TRHESHOLD)) {
-				/* Apply a fast retransmit */
-				int temp_unacked_len = conn->unacked_len;
+				/* Apply a fast retransmit, of the first hole if
+				 * the peer reported what it holds.
+				 */
+				if (tcp_sack_retransmit(conn) == -ENODATA) {
+					int temp_unacked_len = conn->unacked_len;
 
-				conn->unacked_len = 0;
+					conn->unacked_len = 0;
 
-				(void)tcp_send_data(conn);
+					(void)tcp_send_data(conn);
 
-				/* Restore the current transmission */
-				conn->unacked_len = temp_unacked_len;
+					/* Restore the current transmission */
+					conn->unacked_len = temp_unacked_len;
+				}
 
 				tcp_ca_fast_retransmit(conn);
 				if (tcp_window_full(conn)) {
 					(void)k_sem_take(&conn->tx_sem, K_NO_WAIT);
 				}
+			} else if ((conn->data_mode == TCP_DATA_MODE_SEND) &&
+				   (conn->dup_ack_cnt > DUPLICATE_ACK_RETRANSMIT_TRHESHOLD)) {
+				/* Every further duplicate ACK means another
+				 * segment left the network, fill the next hole.
+				 */
+				(void)tcp_sack_retransmit(conn);
 			}
 		}
 #endif
@@ -3117,12 +3815,21 @@ next_state:
 			}
 
 			if (!tcp_window_full(conn)) {
-				k_sem_give(&conn->tx_sem);
+				tcp_tx_sem_give(conn);
 			}
 
 			conn_seq(conn, + len_acked);
 			net_stats_update_tcp_seg_recv(conn->iface);
 
+			/* A partial acknowledgement with data SACKed above it
+			 * means the next hole was lost too, do not wait for
+			 * the retransmission timer.
+			 */
+			tcp_sack_ack(conn);
+			if (conn->data_mode == TCP_DATA_MODE_SEND) {
+				(void)tcp_sack_retransmit(conn);
+			}
+
 			/* Receipt of an acknowledgment that covers a sequence number
 			 * not previously acknowledged indicates that the connection
 			 * makes a "forward progress".
@@ -3218,7 +3925,7 @@ next_state:
 		if (tcp_window_full(conn)) {
 			(void)k_sem_take(&conn->tx_sem, K_NO_WAIT);
 		} else {
-			k_sem_give(&conn->tx_sem);
+			tcp_tx_sem_give(conn);
 		}
 
 		break;
@@ -3976,7 +4683,9 @@ int net_tcp_finalize(struct net_pkt *pkt, bool force_chksum)
 
 	tcp_hdr->chksum = 0U;
 
-	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt)) || force_chksum) {
+	/* The checksum of a GSO packet is computed for each of its segments */
+	if ((net_if_need_calc_tx_checksum(net_pkt_iface(pkt)) || force_chksum) &&
+	    net_pkt_gso_size(pkt) == 0U) {
 		tcp_hdr->chksum = net_calc_chksum_tcp(pkt);
 		net_pkt_set_chksum_done(pkt, true);
 	}
@@ -3984,6 +4693,63 @@ int net_tcp_finalize(struct net_pkt *pkt, bool force_chksum)
 	return net_pkt_set_data(pkt, &tcp_access);
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+int net_tcp_gso_segment(struct net_pkt *pkt, size_t *offset,
+			struct net_pkt **seg)
+{
+	size_t hdr_len, data_len, len;
+	struct tcphdr *th;
+	uint32_t seq;
+	uint8_t flags;
+	int ret;
+
+	th = th_get(pkt);
+	if (!th) {
+		return -ENOBUFS;
+	}
+
+	hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+		  th_off(th) * 4U;
+	seq = th_seq(th);
+	flags = th_flags(th);
+
+	data_len = net_pkt_get_len(pkt) - hdr_len;
+	if (*offset >= data_len) {
+		return -ENODATA;
+	}
+
+	len = MIN(net_pkt_gso_size(pkt), data_len - *offset);
+
+	*seg = net_pkt_clone_segment(pkt, hdr_len, hdr_len + *offset, len,
+				     TCP_PKT_ALLOC_TIMEOUT);
+	if (!*seg) {
+		return -ENOBUFS;
+	}
+
+	th = th_get(*seg);
+	UNALIGNED_PUT(htonl(seq + *offset), &th->th_seq);
+
+	*offset += len;
+
+	/* PSH and FIN belong to the last segment only */
+	if (*offset < data_len) {
+		UNALIGNED_PUT(flags & ~(PSH | FIN), &th->th_flags);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(*seg) == AF_INET) {
+		NET_IPV4_HDR(*seg)->chksum = 0U;
+	}
+
+	ret = tcp_finalize_pkt(*seg);
+	if (ret < 0) {
+		tcp_pkt_unref(*seg);
+		return ret;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 				  struct net_pkt_data_access *tcp_access)
 {
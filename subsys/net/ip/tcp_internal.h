@@ -448,6 +448,61 @@ static inline void net_tcp_reply_rst(struct net_pkt *pkt)
 }
 #endif
 
+/**
+ * @brief Build the next segment of a TCP GSO packet.
+ *
+ * @details The segment gets the headers of @p pkt with the sequence
+ *          number and the flags adjusted, and net_pkt_gso_size() bytes
+ *          of its payload starting at @p offset, which is then advanced.
+ *
+ * @param pkt TCP packet of several segments
+ * @param offset Offset in the TCP payload of @p pkt, 0 for the first one
+ * @param seg Set to the segment on success
+ *
+ * @return 0 on success, -ENODATA if all the payload was segmented,
+ *         other negative errno code on error.
+ */
+#if defined(CONFIG_NET_TCP_GSO)
+int net_tcp_gso_segment(struct net_pkt *pkt, size_t *offset,
+			struct net_pkt **seg);
+#else
+static inline int net_tcp_gso_segment(struct net_pkt *pkt, size_t *offset,
+				      struct net_pkt **seg)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(offset);
+	ARG_UNUSED(seg);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Give the data segments held for coalescing by the calling thread
+ * to TCP.
+ *
+ * @details Called by the RX traffic class threads once their queue is
+ *          empty, and after packets looped back to us were processed.
+ */
+#if defined(CONFIG_NET_TCP_GRO)
+void net_tcp_gro_flush(void);
+#else
+#define net_tcp_gro_flush(...)
+#endif
+
+/**
+ * @brief Give to TCP the data segments the calling thread has held for
+ * coalescing for longer than CONFIG_NET_TCP_GRO_MAX_HOLD_US.
+ *
+ * @details Called by the RX traffic class threads after each packet, so
+ *          that a busy queue does not delay the held segments indefinitely.
+ */
+#if defined(CONFIG_NET_TCP_GRO)
+void net_tcp_gro_flush_expired(void);
+#else
+#define net_tcp_gro_flush_expired(...)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
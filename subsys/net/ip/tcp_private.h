@@ -146,7 +146,7 @@
 #define conn_send_data_dump(_conn)                                             \
 	({                                                                     \
 		NET_DBG("conn: %p total=%zd, unacked_len=%d, "                 \
-			"send_win=%hu, mss=%hu",                               \
+			"send_win=%u, mss=%hu",                                \
 			(_conn), net_pkt_get_len((_conn)->send_data),          \
 			_conn->unacked_len, _conn->send_win,                   \
 			(uint16_t)conn_mss((_conn)));                          \
@@ -227,26 +227,55 @@ union tcp_endpoint {
 #define NET_TCP_NOP_OPT          1
 #define NET_TCP_MSS_OPT          2
 #define NET_TCP_WINDOW_SCALE_OPT 3
+#define NET_TCP_SACK_PERM_OPT    4
+#define NET_TCP_SACK_OPT         5
+#define NET_TCP_TIMESTAMPS_OPT   8
 
 /* TCP Option sizes */
 #define NET_TCP_END_SIZE          1
 #define NET_TCP_NOP_SIZE          1
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
+#define NET_TCP_SACK_PERM_SIZE    2
+#define NET_TCP_SACK_BLOCK_SIZE   8
+#define NET_TCP_TIMESTAMPS_SIZE   10
+
+/* Room for options in the header, th_off is at most 15 words */
+#define NET_TCP_OPTIONS_MAX_SIZE  40
+
+/* At most 4 SACK blocks fit in the 40 bytes of options, 3 next to the
+ * timestamps.
+ */
+#define NET_TCP_SACK_MAX_BLOCKS   4
+
+struct tcp_sack_block {
+	uint32_t start;
+	uint32_t end;
+};
 
 struct tcp_options {
 	uint16_t mss;
 	uint16_t window;
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	uint32_t tsval;
+	uint32_t tsecr;
+#endif
+#if defined(CONFIG_NET_TCP_SACK)
+	struct tcp_sack_block sack[NET_TCP_SACK_MAX_BLOCKS];
+	uint8_t sack_cnt;
+#endif
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool sack_perm_found : 1;
+	bool ts_found : 1;
 };
 
 #ifdef CONFIG_NET_TCP_CONGESTION_AVOIDANCE
 
 struct tcp_collision_avoidance_reno {
-	uint16_t cwnd;
-	uint16_t ssthresh;
-	uint16_t pending_fast_retransmit_bytes;
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t pending_fast_retransmit_bytes;
 };
 #endif
 
@@ -274,6 +303,13 @@ struct tcp { /* TCP connection */
 	struct k_sem connect_sem; /* semaphore for blocking connect */
 	struct k_sem tx_sem; /* Semaphore indicating if transfers are blocked . */
 	struct k_fifo recv_data;  /* temp queue before passing data to app */
+#if defined(CONFIG_NET_TCP_GRO)
+	sys_snode_t gro_node;
+	struct net_pkt *gro_pkt; /* data segments held for coalescing */
+	k_tid_t gro_owner; /* RX thread that flushes gro_pkt */
+	uint32_t gro_start; /* cycle count when gro_pkt was held */
+	uint8_t gro_segs;
+#endif
 	struct tcp_options recv_options;
 	struct tcp_options send_options;
 	struct k_work_delayable send_timer;
@@ -314,10 +350,19 @@ struct tcp { /* TCP connection */
 	uint32_t keep_cnt;
 	uint32_t keep_cur;
 #endif /* CONFIG_NET_TCP_KEEPALIVE */
-	uint16_t recv_win_max;
-	uint16_t recv_win;
-	uint16_t send_win_max;
-	uint16_t send_win;
+	uint32_t recv_win_max;
+	uint32_t recv_win;
+	uint32_t send_win_max;
+	uint32_t send_win;
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	uint32_t ts_recent; /* last timestamp received in sequence */
+#endif
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Ranges of sent data the peer has SACKed, sorted by sequence */
+	struct tcp_sack_block sacked[CONFIG_NET_TCP_SACK_SCOREBOARD_SIZE];
+	uint32_t sack_rexmit_next; /* holes below this were retransmitted */
+	uint8_t sacked_cnt;
+#endif
 #ifdef CONFIG_NET_TCP_RANDOMIZED_RTO
 	uint16_t rto;
 #endif
@@ -329,6 +374,13 @@ struct tcp { /* TCP connection */
 	uint8_t dup_ack_cnt;
 #endif
 	uint8_t zwp_retries;
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	uint8_t rcv_wscale; /* shift applied to the window we send */
+	uint8_t snd_wscale; /* shift applied to the window of the peer */
+#endif
+	bool wscale_ok : 1; /* window scaling in use */
+	bool ts_ok : 1; /* timestamps in use */
+	bool sack_ok : 1; /* selective acknowledgements in use */
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
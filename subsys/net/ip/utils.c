@@ -26,6 +26,16 @@ LOG_MODULE_REGISTER(net_utils, CONFIG_NET_UTILS_LOG_LEVEL);
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/socketcan.h>
 
+#if defined(CONFIG_NET_IP_CHKSUM_SIMD)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#endif
+
 char *net_sprint_addr(sa_family_t af, const void *addr)
 {
 #define NBUFS 3
@@ -520,6 +530,71 @@ static uint16_t offset_based_swap8(const uint8_t *data)
 	}
 }
 
+/* Sum of the 32-bit words in n blocks of 16 bytes. The vector units are
+ * only used when the compiler already generates vector code for the
+ * whole build, so their registers are part of the thread context.
+ */
+#if defined(CONFIG_NET_IP_CHKSUM_SIMD) && defined(__SSE2__)
+static uint64_t chksum_blocks(const uint32_t *p, size_t n)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i acc = zero;
+	uint64_t lanes[2];
+
+	while (n--) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+
+		acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, zero));
+		acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, zero));
+		p += 4;
+	}
+
+	_mm_storeu_si128((__m128i *)lanes, acc);
+
+	return lanes[0] + lanes[1];
+}
+#elif defined(CONFIG_NET_IP_CHKSUM_SIMD) && defined(__ARM_FEATURE_MVE)
+static uint64_t chksum_blocks(const uint32_t *p, size_t n)
+{
+	uint64_t acc = 0U;
+
+	while (n--) {
+		acc = vaddlvaq_u32(acc, vld1q_u32(p));
+		p += 4;
+	}
+
+	return acc;
+}
+#elif defined(CONFIG_NET_IP_CHKSUM_SIMD) && defined(__ARM_NEON)
+static uint64_t chksum_blocks(const uint32_t *p, size_t n)
+{
+	uint64x2_t acc = vdupq_n_u64(0);
+
+	while (n--) {
+		acc = vpadalq_u32(acc, vld1q_u32(p));
+		p += 4;
+	}
+
+	return vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+}
+#else
+static uint64_t chksum_blocks(const uint32_t *p, size_t n)
+{
+	uint64_t sum_a = 0U;
+	uint64_t sum_b = 0U;
+
+	while (n--) {
+		sum_a += p[0];
+		sum_b += p[1];
+		sum_a += p[2];
+		sum_b += p[3];
+		p += 4;
+	}
+
+	return sum_a + sum_b;
+}
+#endif
+
 /* Word based checksum calculation based on:
  * https://blogs.igalia.com/dpino/2018/06/14/fast-checksum-computation/
  * It’s not necessary to add octets as 16-bit words. Due to the associative property of addition,
@@ -557,17 +632,11 @@ uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len)
 	}
 	p = (uint32_t *)data;
 
-	/* Do loop unrolling for the very large data sets */
-	while (pending >= sizeof(uint32_t) * 4) {
-		uint64_t sum_a = p[i];
-		uint64_t sum_b = p[i + 1];
+	/* Bulk of the data in blocks of 4 words */
+	sum += chksum_blocks(p, pending / (sizeof(uint32_t) * 4));
+	i = (pending / (sizeof(uint32_t) * 4)) * 4;
+	pending %= sizeof(uint32_t) * 4;
 
-		pending -= sizeof(uint32_t) * 4;
-		sum_a += p[i + 2];
-		sum_b += p[i + 3];
-		i += 4;
-		sum += sum_a + sum_b;
-	}
 	while (pending >= sizeof(uint32_t)) {
 		pending -= sizeof(uint32_t);
 		sum = sum + p[i++];
@@ -420,6 +420,23 @@ static void print_tc_rx_stats(const struct shell *sh, struct net_if *iface)
 #endif /* NET_TC_RX_COUNT > 1 */
 }
 
+static void print_rx_queue_stats(const struct shell *sh, struct net_if *iface)
+{
+#if defined(CONFIG_NET_TC_RX_STEERING)
+	PR("RX steering queue statistics:\n");
+	PR("Queue\tRecv pkts\tbytes\n");
+
+	for (int i = 0; i < CONFIG_NET_TC_RX_STEERING_QUEUES; i++) {
+		PR("[%d]\t%d\t\t%d\n", i,
+		   GET_STAT(iface, rx_queue[i].pkts),
+		   GET_STAT(iface, rx_queue[i].bytes));
+	}
+#else
+	ARG_UNUSED(sh);
+	ARG_UNUSED(iface);
+#endif /* CONFIG_NET_TC_RX_STEERING */
+}
+
 static void print_net_pm_stats(const struct shell *sh, struct net_if *iface)
 {
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
@@ -544,6 +561,7 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 
 	print_tc_tx_stats(sh, iface);
 	print_tc_rx_stats(sh, iface);
+	print_rx_queue_stats(sh, iface);
 
 #if defined(CONFIG_NET_STATISTICS_ETHERNET) && \
 					defined(CONFIG_NET_STATISTICS_USER_API)
@@ -194,6 +194,10 @@ static int zsock_socket_internal(int family, int type, int proto)
 	/* recv_q and accept_q are in union */
 	k_fifo_init(&ctx->recv_q);
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	sys_slist_init(&ctx->epoll_items);
+#endif
+
 	/* Condition variable is used to avoid keeping lock for a long time
 	 * when waiting data to be received
 	 */
@@ -263,6 +267,8 @@ int zsock_close_ctx(struct net_context *ctx)
 	 * as these are fail-free operations and we're closing
 	 * socket anyway.
 	 */
+	net_socket_epoll_close(ctx);
+
 	if (net_context_get_state(ctx) == NET_CONTEXT_LISTENING) {
 		(void)net_context_accept(ctx, NULL, K_NO_WAIT, NULL);
 	} else {
@@ -365,6 +371,9 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 				       NULL);
 		k_fifo_init(&new_ctx->recv_q);
 		k_condvar_init(&new_ctx->cond.recv);
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+		sys_slist_init(&new_ctx->epoll_items);
+#endif
 
 		k_fifo_put(&parent->accept_q, new_ctx);
 
@@ -378,6 +387,8 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		net_context_ref(new_ctx);
 
 		(void)k_condvar_signal(&parent->cond.recv);
+
+		net_socket_epoll_notify(parent);
 	}
 
 }
@@ -432,6 +443,8 @@ unlock:
 	/* Wake reader if it was sleeping */
 	(void)k_condvar_signal(&ctx->cond.recv);
 
+	net_socket_epoll_notify(ctx);
+
 	if (ctx->cond.lock) {
 		(void)k_mutex_unlock(ctx->cond.lock);
 	}
@@ -449,6 +462,8 @@ int zsock_shutdown_ctx(struct net_context *ctx, int how)
 		sock_set_eof(ctx);
 
 		zsock_flush_queue(ctx);
+
+		net_socket_epoll_notify(ctx);
 	} else if (how == ZSOCK_SHUT_WR || how == ZSOCK_SHUT_RDWR) {
 		SET_ERRNO(-ENOTSUP);
 	} else {
@@ -500,6 +515,8 @@ static void zsock_connected_cb(struct net_context *ctx, int status, void *user_d
 		ctx->user_data = INT_TO_POINTER(-status);
 		sock_set_error(ctx);
 	}
+
+	net_socket_epoll_notify(ctx);
 }
 
 int zsock_connect_ctx(struct net_context *ctx, const struct sockaddr *addr,
@@ -1351,6 +1368,42 @@ out:
 	return ret;
 }
 
+static int zsock_dgram_src_addr(struct net_context *ctx, struct net_pkt *pkt,
+				struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	int ret;
+
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		ret  = sock_get_offload_pkt_src_addr(pkt, ctx, src_addr,
+						     *addrlen);
+		if (ret < 0) {
+			NET_DBG("sock_get_offload_pkt_src_addr %d", ret);
+			return ret;
+		}
+	} else {
+		ret = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
+					    src_addr, *addrlen);
+		if (ret < 0) {
+			NET_DBG("sock_get_pkt_src_addr %d", ret);
+			return ret;
+		}
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 				       struct msghdr *msg,
 				       void *buf,
@@ -1402,38 +1455,11 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	net_pkt_cursor_backup(pkt, &backup);
 
 	if (src_addr && addrlen) {
-		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
-		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
-			int ret;
-
-			ret  = sock_get_offload_pkt_src_addr(pkt, ctx, src_addr,
-								*addrlen);
-			if (ret < 0) {
-				errno = -ret;
-				NET_DBG("sock_get_offload_pkt_src_addr %d", ret);
-				goto fail;
-			}
-		} else {
-			int ret;
-
-			ret = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
-						   src_addr, *addrlen);
-			if (ret < 0) {
-				errno = -ret;
-				NET_DBG("sock_get_pkt_src_addr %d", ret);
-				goto fail;
-			}
-		}
+		int ret;
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
+		ret = zsock_dgram_src_addr(ctx, pkt, src_addr, addrlen);
+		if (ret < 0) {
+			errno = -ret;
 			goto fail;
 		}
 	}
@@ -2024,6 +2050,401 @@ fail:
 #include <syscalls/zsock_recvmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+/* Batched variants of sendmsg/recvmsg.  The socket is looked up and locked
+ * once for the whole batch.  As on Linux, an error ends the batch but is
+ * only reported if it hit the first message, otherwise the number of
+ * messages already transferred is returned.
+ */
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec, unsigned int vlen,
+			  int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	unsigned int i;
+	ssize_t ret;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		ret = vtable->sendmsg(obj, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+		sock_obj_core_update_send_stats(sock, ret);
+	}
+
+	k_mutex_unlock(lock);
+
+	return (i == 0 && vlen > 0) ? -1 : i;
+}
+
+#ifdef CONFIG_USERSPACE
+/* The messages are copied in and out one by one with the same helpers
+ * as the single message calls, so only the syscall entry is amortized.
+ */
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	unsigned int i, len;
+	ssize_t ret;
+
+	K_OOPS(K_SYSCALL_MEMORY_ARRAY_WRITE(msgvec, vlen,
+					    sizeof(struct mmsghdr)));
+
+	for (i = 0; i < vlen; i++) {
+		ret = z_vrfy_zsock_sendmsg(sock, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		len = ret;
+		K_OOPS(k_usermode_to_copy(&msgvec[i].msg_len, &len,
+					  sizeof(len)));
+	}
+
+	return (i == 0 && vlen > 0) ? -1 : i;
+}
+#include <syscalls/zsock_sendmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec, unsigned int vlen,
+			  int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	unsigned int i;
+	ssize_t ret;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (vtable->recvmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		ret = vtable->recvmsg(obj, &msgvec[i].msg_hdr,
+				      flags & ~ZSOCK_MSG_WAITFORONE);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+		sock_obj_core_update_recv_stats(sock, ret);
+
+		if (flags & ZSOCK_MSG_WAITFORONE) {
+			flags |= ZSOCK_MSG_DONTWAIT;
+		}
+	}
+
+	k_mutex_unlock(lock);
+
+	return (i == 0 && vlen > 0) ? -1 : i;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	unsigned int i, len;
+	ssize_t ret;
+
+	K_OOPS(K_SYSCALL_MEMORY_ARRAY_WRITE(msgvec, vlen,
+					    sizeof(struct mmsghdr)));
+
+	for (i = 0; i < vlen; i++) {
+		ret = z_vrfy_zsock_recvmsg(sock, &msgvec[i].msg_hdr,
+					   flags & ~ZSOCK_MSG_WAITFORONE);
+		if (ret < 0) {
+			break;
+		}
+
+		len = ret;
+		K_OOPS(k_usermode_to_copy(&msgvec[i].msg_len, &len,
+					  sizeof(len)));
+
+		if (flags & ZSOCK_MSG_WAITFORONE) {
+			flags |= ZSOCK_MSG_DONTWAIT;
+		}
+	}
+
+	return (i == 0 && vlen > 0) ? -1 : i;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+#if defined(CONFIG_NET_SOCKETS_RECV_ZEROCOPY)
+/* Point the iovecs of msg to the data of pkt from its cursor on, without
+ * moving the cursor.
+ */
+static size_t zsock_zc_fill(struct net_pkt *pkt, struct msghdr *msg)
+{
+	struct net_buf *frag = pkt->cursor.buf;
+	uint8_t *pos = pkt->cursor.pos;
+	size_t iovec = 0, recv_len = 0;
+
+	while (frag != NULL && iovec < msg->msg_iovlen) {
+		size_t len = frag->len - (pos - frag->data);
+
+		if (len > 0) {
+			msg->msg_iov[iovec].iov_base = pos;
+			msg->msg_iov[iovec].iov_len = len;
+			recv_len += len;
+			iovec++;
+		}
+
+		frag = frag->frags;
+		pos = (frag != NULL) ? frag->data : NULL;
+	}
+
+	msg->msg_iovlen = iovec;
+
+	return recv_len;
+}
+
+static ssize_t zsock_recv_dgram_zc(struct net_context *ctx, struct msghdr *msg,
+				   struct zsock_zc_ref *ref, int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	size_t recv_len;
+	int ret;
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+
+		ret = zsock_wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	pkt = k_fifo_get(&ctx->recv_q, timeout);
+	if (pkt == NULL) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (msg->msg_name != NULL && msg->msg_namelen > 0) {
+		ret = zsock_dgram_src_addr(ctx, pkt, msg->msg_name,
+					   &msg->msg_namelen);
+		if (ret < 0) {
+			net_pkt_unref(pkt);
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	recv_len = zsock_zc_fill(pkt, msg);
+	if (recv_len < net_pkt_remaining_data(pkt)) {
+		msg->msg_flags |= ZSOCK_MSG_TRUNC;
+	}
+
+	msg->msg_controllen = 0U;
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	/* The reference of the receive queue goes to the caller */
+	ref->pkt = pkt;
+	ref->len = recv_len;
+
+	return recv_len;
+}
+
+static ssize_t zsock_recv_stream_zc(struct net_context *ctx, struct msghdr *msg,
+				    struct zsock_zc_ref *ref, int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	k_timepoint_t end;
+	size_t recv_len;
+	int ret;
+
+	if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+		errno = ENOTCONN;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else if (!sock_is_eof(ctx) && !sock_is_error(ctx)) {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+	}
+
+	for (end = sys_timepoint_calc(timeout); ; timeout = sys_timepoint_timeout(end)) {
+		if (sock_is_error(ctx)) {
+			errno = POINTER_TO_INT(ctx->user_data);
+			return -1;
+		}
+
+		pkt = k_fifo_peek_head(&ctx->recv_q);
+		if (pkt != NULL && net_pkt_remaining_data(pkt) == 0) {
+			/* Drop empty packets, they may only carry the EOF */
+			pkt = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+			if (net_pkt_eof(pkt)) {
+				sock_set_eof(ctx);
+			}
+
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		if (pkt != NULL) {
+			break;
+		}
+
+		if (sock_is_eof(ctx)) {
+			return 0;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			errno = EAGAIN;
+			return -1;
+		}
+
+		ret = zsock_wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	recv_len = zsock_zc_fill(pkt, msg);
+	if (recv_len == net_pkt_remaining_data(pkt)) {
+		/* All of it is lent out, the reference of the receive queue
+		 * goes to the caller.
+		 */
+		pkt = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+		if (net_pkt_eof(pkt)) {
+			sock_set_eof(ctx);
+		}
+
+		if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+			net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+		}
+	} else {
+		/* The rest stays queued behind the lent out part */
+		net_pkt_ref(pkt);
+		(void)net_pkt_skip(pkt, recv_len);
+	}
+
+	msg->msg_controllen = 0U;
+
+	ref->pkt = pkt;
+	ref->len = recv_len;
+
+	return recv_len;
+}
+
+ssize_t zsock_recvmsg_zc(int sock, struct msghdr *msg,
+			 struct zsock_zc_ref *ref, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	if (msg == NULL || ref == NULL || msg->msg_iov == NULL ||
+	    msg->msg_iovlen < 1 || (flags & ZSOCK_MSG_PEEK)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ctx = get_sock_vtable(sock, &vtable, &lock);
+	if (ctx == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	/* Nothing to release unless a packet is lent out below, which may
+	 * also be for an empty datagram.
+	 */
+	ref->pkt = NULL;
+	ref->len = 0U;
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	switch (net_context_get_type(ctx)) {
+	case SOCK_DGRAM:
+		ret = zsock_recv_dgram_zc(ctx, msg, ref, flags);
+		break;
+	case SOCK_STREAM:
+		ret = zsock_recv_stream_zc(ctx, msg, ref, flags);
+		break;
+	default:
+		errno = EOPNOTSUPP;
+		ret = -1;
+		break;
+	}
+
+	k_mutex_unlock(lock);
+
+	sock_obj_core_update_recv_stats(sock, ret);
+
+	return ret;
+}
+
+int zsock_recv_zc_release(int sock, struct zsock_zc_ref *ref)
+{
+	const struct socket_op_vtable *vtable;
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	int ret = 0;
+
+	if (ref == NULL || ref->pkt == NULL) {
+		return 0;
+	}
+
+	ctx = get_sock_vtable(sock, &vtable, &lock);
+	if (ctx == NULL || vtable != &sock_fd_op_vtable) {
+		errno = EBADF;
+		ret = -1;
+	} else if (net_context_get_type(ctx) == SOCK_STREAM) {
+		/* The lent out data counted against the window until now */
+		(void)k_mutex_lock(lock, K_FOREVER);
+		net_context_update_recv_wnd(ctx, ref->len);
+		k_mutex_unlock(lock);
+	}
+
+	net_pkt_unref(ref->pkt);
+	ref->pkt = NULL;
+	ref->len = 0U;
+
+	return ret;
+}
+#endif /* CONFIG_NET_SOCKETS_RECV_ZEROCOPY */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -0,0 +1,609 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/net_context.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/fdtable.h>
+
+#include "sockets_internal.h"
+#include "../../ip/tcp_internal.h"
+#include "../../ip/net_private.h"
+
+/* A registration of a native socket is on the list of its net_context.
+ * net_socket_epoll_notify() is called whenever something happens to the
+ * socket: a packet or a connection was queued, the connection was
+ * established, shut down or failed, or TCP can send again. It queues the
+ * registration on the ready list of its instance and raises the signal
+ * of the instance. A wait only checks the queued registrations: the
+ * level-triggered ones are queued again once returned, so that the next
+ * wait checks them once more, the edge-triggered ones are only queued
+ * again by the next notification.
+ *
+ * Registrations of other descriptors, which cannot notify us, are on the
+ * fallback list of their instance and are polled on every wait, along
+ * with the signal of the instance.
+ */
+
+#define EPOLL_ALWAYS (ZSOCK_EPOLLERR | ZSOCK_EPOLLHUP)
+#define EPOLL_POLL_EVENTS (ZSOCK_EPOLLIN | ZSOCK_EPOLLPRI | ZSOCK_EPOLLOUT)
+
+struct epoll_instance;
+
+struct epoll_item {
+	/* On the list of the net_context, or on the fallback list */
+	sys_snode_t node;
+	sys_dnode_t ready_node;
+	struct epoll_instance *ep; /* NULL when free */
+	struct net_context *ctx;   /* NULL for other descriptors */
+	struct zsock_epoll_event event;
+	int fd;
+	bool disabled;             /* one-shot registration was returned */
+};
+
+struct epoll_instance {
+	struct k_poll_signal signal;
+	sys_dlist_t ready;
+	sys_slist_t fallback;
+	int fallback_count;
+	bool in_use;
+};
+
+static struct epoll_instance instances[CONFIG_NET_SOCKETS_EPOLL_MAX];
+static struct epoll_item items[CONFIG_NET_SOCKETS_EPOLL_MAX_ITEMS];
+
+/* Protects the instances, the registrations and the lists they are on */
+static struct k_spinlock epoll_lock;
+
+static const struct fd_op_vtable epoll_fd_op_vtable;
+
+static void epoll_queue(struct epoll_item *item)
+{
+	if (!sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_append(&item->ep->ready, &item->ready_node);
+	}
+
+	k_poll_signal_raise(&item->ep->signal, 0);
+}
+
+static void epoll_item_free(struct epoll_item *item)
+{
+	if (sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_remove(&item->ready_node);
+	}
+
+	if (item->ctx != NULL) {
+		(void)sys_slist_find_and_remove(&item->ctx->epoll_items,
+						&item->node);
+	} else {
+		(void)sys_slist_find_and_remove(&item->ep->fallback,
+						&item->node);
+		item->ep->fallback_count--;
+	}
+
+	item->ep = NULL;
+}
+
+static struct epoll_item *epoll_item_find(struct epoll_instance *ep,
+					  struct net_context *ctx, int fd)
+{
+	struct epoll_item *item;
+
+	if (ctx != NULL) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, node) {
+			if (item->ep == ep) {
+				return item;
+			}
+		}
+	} else {
+		SYS_SLIST_FOR_EACH_CONTAINER(&ep->fallback, item, node) {
+			if (item->fd == fd) {
+				return item;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/* Same conditions as zsock_poll_update_ctx(), but read without waiting */
+static uint32_t epoll_ctx_events(struct net_context *ctx)
+{
+	uint32_t events = 0U;
+
+	if (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLIN;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_NATIVE_TCP) &&
+	    net_context_get_type(ctx) == SOCK_STREAM &&
+	    !net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		if (net_context_get_state(ctx) == NET_CONTEXT_CONNECTED &&
+		    !sock_is_eof(ctx) &&
+		    k_sem_count_get(net_tcp_tx_sem_get(ctx)) > 0) {
+			events |= ZSOCK_EPOLLOUT;
+		}
+	} else {
+		events |= ZSOCK_EPOLLOUT;
+	}
+
+	if (sock_is_error(ctx)) {
+		events |= ZSOCK_EPOLLERR;
+	}
+
+	if (sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLHUP;
+	}
+
+	return events;
+}
+
+void net_socket_epoll_notify(struct net_context *ctx)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+
+	if (sys_slist_is_empty(&ctx->epoll_items)) {
+		return;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, node) {
+		epoll_queue(item);
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+}
+
+void net_socket_epoll_close(struct net_context *ctx)
+{
+	sys_snode_t *node;
+
+	K_SPINLOCK(&epoll_lock) {
+		while ((node = sys_slist_peek_head(&ctx->epoll_items)) != NULL) {
+			epoll_item_free(CONTAINER_OF(node, struct epoll_item,
+						     node));
+		}
+	}
+}
+
+/* Returns the ready native sockets. The checks only read the state of
+ * the sockets, so they are done with the lock held, which keeps the
+ * registrations from being freed under us.
+ */
+static int epoll_collect(struct epoll_instance *ep,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+	sys_dnode_t *node;
+	uint32_t revents;
+	int pending = 0;
+	int n = 0;
+
+	key = k_spin_lock(&epoll_lock);
+
+	/* Level-triggered registrations are queued again as they are
+	 * returned, only look at the ones queued at the start.
+	 */
+	SYS_DLIST_FOR_EACH_NODE(&ep->ready, node) {
+		pending++;
+	}
+
+	while (n < maxevents && pending-- > 0) {
+		node = sys_dlist_get(&ep->ready);
+		item = CONTAINER_OF(node, struct epoll_item, ready_node);
+
+		if (item->disabled) {
+			continue;
+		}
+
+		revents = epoll_ctx_events(item->ctx) &
+			  (item->event.events | EPOLL_ALWAYS);
+		if (revents == 0U) {
+			continue;
+		}
+
+		events[n].events = revents;
+		events[n].data = item->event.data;
+		n++;
+
+		if (item->event.events & ZSOCK_EPOLLONESHOT) {
+			item->disabled = true;
+		} else if (!(item->event.events & ZSOCK_EPOLLET)) {
+			sys_dlist_append(&ep->ready, &item->ready_node);
+		}
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	return n;
+}
+
+/* Polls the other descriptors together with the instance itself, so
+ * that a notification of a native socket ends the wait too.
+ */
+static int epoll_poll_fallback(int epfd, struct epoll_instance *ep,
+			       struct zsock_epoll_event *events, int maxevents,
+			       k_timeout_t timeout)
+{
+	struct zsock_pollfd fds[CONFIG_NET_SOCKETS_POLL_MAX];
+	union zsock_epoll_data data[CONFIG_NET_SOCKETS_POLL_MAX];
+	uint32_t flags[CONFIG_NET_SOCKETS_POLL_MAX];
+	struct epoll_item *item;
+	int nfds = 1;
+	int n = 0;
+
+	fds[0].fd = epfd;
+	fds[0].events = ZSOCK_POLLIN;
+
+	K_SPINLOCK(&epoll_lock) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&ep->fallback, item, node) {
+			if (item->disabled) {
+				continue;
+			}
+
+			fds[nfds].fd = item->fd;
+			fds[nfds].events = item->event.events &
+					   EPOLL_POLL_EVENTS;
+			data[nfds] = item->event.data;
+			flags[nfds] = item->event.events;
+			nfds++;
+		}
+	}
+
+	if (zsock_poll_internal(fds, nfds, timeout) < 0) {
+		return -1;
+	}
+
+	for (int i = 1; i < nfds && n < maxevents; i++) {
+		if (fds[i].revents == 0) {
+			continue;
+		}
+
+		/* A descriptor closed without being removed first */
+		if (fds[i].revents & ZSOCK_POLLNVAL) {
+			fds[i].revents = EPOLL_ALWAYS;
+		}
+
+		events[n].events = fds[i].revents;
+		events[n].data = data[i];
+		n++;
+
+		if (flags[i] & ZSOCK_EPOLLONESHOT) {
+			K_SPINLOCK(&epoll_lock) {
+				item = epoll_item_find(ep, NULL, fds[i].fd);
+				if (item != NULL) {
+					item->disabled = true;
+				}
+			}
+		}
+	}
+
+	return n;
+}
+
+int zsock_epoll_create(int size)
+{
+	struct epoll_instance *ep = NULL;
+	int fd;
+
+	if (size <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	K_SPINLOCK(&epoll_lock) {
+		for (int i = 0; i < ARRAY_SIZE(instances); i++) {
+			if (!instances[i].in_use) {
+				ep = &instances[i];
+				ep->in_use = true;
+				break;
+			}
+		}
+	}
+
+	if (ep == NULL) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	k_poll_signal_init(&ep->signal);
+	sys_dlist_init(&ep->ready);
+	sys_slist_init(&ep->fallback);
+	ep->fallback_count = 0;
+
+	z_finalize_fd(fd, ep, &epoll_fd_op_vtable);
+
+	return fd;
+}
+
+int zsock_epoll_ctl(int epfd, int op, int fd, struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct net_context *ctx = NULL;
+	struct epoll_instance *ep;
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+	void *obj;
+	int ret = 0;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, NULL);
+	if (obj == NULL) {
+		return -1;
+	}
+
+	if (fd == epfd) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	if (vtable == (const struct fd_op_vtable *)&sock_fd_op_vtable) {
+		ctx = obj;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+
+	item = epoll_item_find(ep, ctx, fd);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		if (item != NULL) {
+			ret = -EEXIST;
+			break;
+		}
+
+		/* One poll entry is taken by the instance itself */
+		if (ctx == NULL &&
+		    ep->fallback_count >= CONFIG_NET_SOCKETS_POLL_MAX - 1) {
+			ret = -ENOSPC;
+			break;
+		}
+
+		for (int i = 0; i < ARRAY_SIZE(items); i++) {
+			if (items[i].ep == NULL) {
+				item = &items[i];
+				break;
+			}
+		}
+
+		if (item == NULL) {
+			ret = -ENOMEM;
+			break;
+		}
+
+		item->ep = ep;
+		item->ctx = ctx;
+		item->fd = fd;
+		item->event = *event;
+		item->disabled = false;
+		sys_dnode_init(&item->ready_node);
+
+		if (ctx != NULL) {
+			sys_slist_append(&ctx->epoll_items, &item->node);
+			epoll_queue(item);
+		} else {
+			sys_slist_append(&ep->fallback, &item->node);
+			ep->fallback_count++;
+			k_poll_signal_raise(&ep->signal, 0);
+		}
+
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		item->event = *event;
+		item->disabled = false;
+
+		if (ctx != NULL) {
+			epoll_queue(item);
+		} else {
+			k_poll_signal_raise(&ep->signal, 0);
+		}
+
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_item_free(item);
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout)
+{
+	struct epoll_instance *ep;
+	k_timepoint_t end;
+	int ret;
+	int n;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (events == NULL || maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	end = sys_timepoint_calc(timeout < 0 ? K_FOREVER : K_MSEC(timeout));
+
+	while (true) {
+		/* Reset before looking, so that a notification coming
+		 * after we looked ends the wait.
+		 */
+		k_poll_signal_reset(&ep->signal);
+
+		n = epoll_collect(ep, events, maxevents);
+
+		if (ep->fallback_count > 0 && n < maxevents) {
+			ret = epoll_poll_fallback(epfd, ep, events + n,
+						  maxevents - n,
+						  n > 0 ? K_NO_WAIT :
+						  sys_timepoint_timeout(end));
+			if (ret < 0) {
+				return -1;
+			}
+
+			n += ret;
+		} else if (n == 0) {
+			struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+				K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY,
+				&ep->signal);
+
+			(void)k_poll(&event, 1, sys_timepoint_timeout(end));
+		}
+
+		if (n > 0 || sys_timepoint_expired(end)) {
+			return n;
+		}
+	}
+}
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_close_vmeth(void *obj)
+{
+	struct epoll_instance *ep = obj;
+
+	K_SPINLOCK(&epoll_lock) {
+		for (int i = 0; i < ARRAY_SIZE(items); i++) {
+			if (items[i].ep == ep) {
+				epoll_item_free(&items[i]);
+			}
+		}
+
+		ep->in_use = false;
+	}
+
+	return 0;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	struct epoll_instance *ep = obj;
+
+	switch (request) {
+	case ZFD_IOCTL_POLL_PREPARE: {
+		struct zsock_pollfd *pfd;
+		struct k_poll_event **pev;
+		struct k_poll_event *pev_end;
+
+		pfd = va_arg(args, struct zsock_pollfd *);
+		pev = va_arg(args, struct k_poll_event **);
+		pev_end = va_arg(args, struct k_poll_event *);
+
+		if (!(pfd->events & ZSOCK_POLLIN)) {
+			return 0;
+		}
+
+		if (*pev == pev_end) {
+			return -ENOMEM;
+		}
+
+		(*pev)->obj = &ep->signal;
+		(*pev)->type = K_POLL_TYPE_SIGNAL;
+		(*pev)->mode = K_POLL_MODE_NOTIFY_ONLY;
+		(*pev)->state = K_POLL_STATE_NOT_READY;
+		(*pev)++;
+
+		return sys_dlist_is_empty(&ep->ready) ? 0 : -EALREADY;
+	}
+
+	case ZFD_IOCTL_POLL_UPDATE: {
+		struct zsock_pollfd *pfd;
+		struct k_poll_event **pev;
+
+		pfd = va_arg(args, struct zsock_pollfd *);
+		pev = va_arg(args, struct k_poll_event **);
+
+		if (pfd->events & ZSOCK_POLLIN) {
+			if ((*pev)->state != K_POLL_STATE_NOT_READY ||
+			    !sys_dlist_is_empty(&ep->ready)) {
+				pfd->revents |= ZSOCK_POLLIN;
+			}
+			(*pev)++;
+		}
+
+		return 0;
+	}
+
+	case ZFD_IOCTL_SET_LOCK:
+		return 0;
+
+	default:
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+}
+
+static const struct fd_op_vtable epoll_fd_op_vtable = {
+	.read = epoll_read_vmeth,
+	.write = epoll_write_vmeth,
+	.close = epoll_close_vmeth,
+	.ioctl = epoll_ioctl_vmeth,
+};
@@ -20,12 +20,36 @@ static K_CONDVAR_DEFINE(wait_start);
 STRUCT_SECTION_START_EXTERN(net_socket_service_desc);
 STRUCT_SECTION_END_EXTERN(net_socket_service_desc);
 
+#if defined(CONFIG_NET_SOCKETS_SERVICE_EPOLL)
+/* The sockets of all services are registered one-shot with this epoll
+ * instance, and re-armed once their callback has run.
+ */
+static int epoll_fd = -1;
+
+static void svc_epoll_ctl(struct net_socket_service_event *pev, int op)
+{
+	struct zsock_epoll_event ev = {
+		.events = pev->event.events | ZSOCK_EPOLLONESHOT,
+		.data.ptr = pev,
+	};
+
+	if (pev->event.fd < 0) {
+		return;
+	}
+
+	if (zsock_epoll_ctl(epoll_fd, op, pev->event.fd, &ev) < 0) {
+		NET_DBG("epoll op %d for fd %d failed (%d)", op,
+			pev->event.fd, -errno);
+	}
+}
+#else
 static struct service {
 	struct zsock_pollfd events[CONFIG_NET_SOCKETS_POLL_MAX];
 	int count;
 } ctx;
 
 #define get_idx(svc) (*(svc->idx))
+#endif /* CONFIG_NET_SOCKETS_SERVICE_EPOLL */
 
 void net_socket_service_foreach(net_socket_service_cb_t cb, void *user_data)
 {
@@ -37,7 +61,11 @@ void net_socket_service_foreach(net_socket_service_cb_t cb, void *user_data)
 static void cleanup_svc_events(const struct net_socket_service_desc *svc)
 {
 	for (int i = 0; i < svc->pev_len; i++) {
+#if defined(CONFIG_NET_SOCKETS_SERVICE_EPOLL)
+		svc_epoll_ctl(&svc->pev[i], ZSOCK_EPOLL_CTL_DEL);
+#else
 		ctx.events[get_idx(svc) + i].fd = -1;
+#endif
 		svc->pev[i].event.fd = -1;
 		svc->pev[i].event.events = 0;
 	}
@@ -71,6 +99,17 @@ int z_impl_net_socket_service_register(const struct net_socket_service_desc *svc
 			goto out;
 		}
 
+#if defined(CONFIG_NET_SOCKETS_SERVICE_EPOLL)
+		for (i = 0; i < len; i++) {
+			svc_epoll_ctl(&svc->pev[i], ZSOCK_EPOLL_CTL_DEL);
+
+			svc->pev[i].event = fds[i];
+			svc->pev[i].user_data = user_data;
+			svc->pev[i].svc = (struct net_socket_service_desc *)svc;
+
+			svc_epoll_ctl(&svc->pev[i], ZSOCK_EPOLL_CTL_ADD);
+		}
+#else
 		for (i = 0; i < len; i++) {
 			svc->pev[i].event = fds[i];
 			svc->pev[i].user_data = user_data;
@@ -79,10 +118,13 @@ int z_impl_net_socket_service_register(const struct net_socket_service_desc *svc
 		for (i = 0; i < svc->pev_len; i++) {
 			ctx.events[get_idx(svc) + i] = svc->pev[i].event;
 		}
+#endif
 	}
 
+#if !defined(CONFIG_NET_SOCKETS_SERVICE_EPOLL)
 	/* Tell the thread to re-read the variables */
 	eventfd_write(ctx.events[0].fd, 1);
+#endif
 	ret = 0;
 
 out:
@@ -91,6 +133,7 @@ out:
 	return ret;
 }
 
+#if !defined(CONFIG_NET_SOCKETS_SERVICE_EPOLL)
 static struct net_socket_service_desc *find_svc_and_event(
 	struct zsock_pollfd *pev,
 	struct net_socket_service_event **event)
@@ -106,6 +149,7 @@ static struct net_socket_service_desc *find_svc_and_event(
 
 	return NULL;
 }
+#endif
 
 /* We do not set the user callback to our work struct because we need to
  * hook into the flow and restore the global poll array so that the next poll
@@ -121,24 +165,25 @@ void net_socket_service_callback(struct k_work *work)
 
 	ev.callback(&ev.work);
 
+#if defined(CONFIG_NET_SOCKETS_SERVICE_EPOLL)
+	ARG_UNUSED(svc);
+
+	/* The socket was disabled when it was returned by the wait */
+	svc_epoll_ctl(pev, ZSOCK_EPOLL_CTL_MOD);
+#else
 	/* Copy back the socket fd to the global array because we marked
 	 * it as -1 when triggering the work.
 	 */
 	for (int i = 0; i < svc->pev_len; i++) {
 		ctx.events[get_idx(svc) + i] = svc->pev[i].event;
 	}
+#endif
 }
 
-static int call_work(struct zsock_pollfd *pev, struct k_work_q *work_q,
-		     struct k_work *work)
+static int call_work(struct k_work_q *work_q, struct k_work *work)
 {
 	int ret = 0;
 
-	/* Mark the global fd non pollable so that we do not
-	 * call the callback second time.
-	 */
-	pev->fd = -1;
-
 	if (work->handler == NULL) {
 		/* Synchronous call */
 		net_socket_service_callback(work);
@@ -156,6 +201,7 @@ static int call_work(struct zsock_pollfd *pev, struct k_work_q *work_q,
 
 }
 
+#if !defined(CONFIG_NET_SOCKETS_SERVICE_EPOLL)
 static int trigger_work(struct zsock_pollfd *pev)
 {
 	struct net_socket_service_event *event;
@@ -173,9 +219,64 @@ static int trigger_work(struct zsock_pollfd *pev)
 	 */
 	event->event = *pev;
 
-	return call_work(pev, svc->work_q, &event->work);
+	/* Mark the global fd non pollable so that we do not
+	 * call the callback second time.
+	 */
+	pev->fd = -1;
+
+	return call_work(svc->work_q, &event->work);
 }
+#endif
 
+#if defined(CONFIG_NET_SOCKETS_SERVICE_EPOLL)
+static void socket_service_thread(void)
+{
+	struct zsock_epoll_event events[CONFIG_NET_SOCKETS_POLL_MAX];
+	struct net_socket_service_event *pev;
+	int ret, i;
+
+	STRUCT_SECTION_COUNT(net_socket_service_desc, &ret);
+	if (ret == 0) {
+		NET_INFO("No socket services found, service disabled.");
+		goto fail;
+	}
+
+	epoll_fd = zsock_epoll_create(1);
+	if (epoll_fd < 0) {
+		NET_ERR("epoll_create failed (%d)", -errno);
+		goto fail;
+	}
+
+	init_done = true;
+	k_condvar_broadcast(&wait_start);
+
+	while (true) {
+		ret = zsock_epoll_wait(epoll_fd, events, ARRAY_SIZE(events), -1);
+		if (ret < 0) {
+			ret = -errno;
+			NET_ERR("epoll_wait failed (%d)", ret);
+			break;
+		}
+
+		for (i = 0; i < ret; i++) {
+			pev = events[i].data.ptr;
+			pev->event.revents = events[i].events;
+
+			if (call_work(pev->svc->work_q, &pev->work) < 0) {
+				NET_DBG("Triggering work failed");
+			}
+		}
+	}
+
+	NET_DBG("Socket service thread stopped");
+	init_done = false;
+
+	return;
+
+fail:
+	k_condvar_broadcast(&wait_start);
+}
+#else
 static void socket_service_thread(void)
 {
 	int ret, i, fd, count = 0;
@@ -280,6 +381,7 @@ out:
 fail:
 	k_condvar_broadcast(&wait_start);
 }
+#endif /* CONFIG_NET_SOCKETS_SERVICE_EPOLL */
 
 static int init_socket_service(void)
 {
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SETTINGS_NVS_HASH_H_
+#define __SETTINGS_NVS_HASH_H_
+
+#include <zephyr/fs/nvs.h>
+#include <zephyr/settings/settings.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* In the NVS hash backend, each setting is stored in a single NVS entry:
+ *	1. length of the setting's name, one byte
+ *	2. setting's name, without the trailing '\0'
+ *	3. setting's value
+ *
+ * The NVS entry ID is SETTINGS_NVS_HASH_ID_BASE plus the hash of the name,
+ * modulo the number of IDs in use. The IDs below SETTINGS_NVS_HASH_ID_BASE
+ * are left to other users of the NVS file system. On collision the next
+ * IDs are probed, up to the first ID which was never written. Deleting a
+ * setting which is followed by more of its probe sequence writes a
+ * tombstone, an entry with a name length of 0, so that the lookup of the
+ * settings after it does not stop there.
+ */
+#define SETTINGS_NVS_HASH_ID_BASE 0x8000
+#define SETTINGS_NVS_HASH_IDS BIT(CONFIG_SETTINGS_NVS_HASH_ID_BITS)
+#define SETTINGS_NVS_HASH_TOMBSTONE 0
+
+struct settings_nvs_hash {
+	struct settings_store cf_store;
+	struct nvs_fs cf_nvs;
+	const struct device *flash_dev;
+	/* IDs found in use while loading */
+	uint32_t seen[SETTINGS_NVS_HASH_IDS / 32];
+};
+
+/* register nvs hash to be a source of settings */
+int settings_nvs_hash_src(struct settings_nvs_hash *cf);
+
+/* register nvs hash to be the destination of settings */
+int settings_nvs_hash_dst(struct settings_nvs_hash *cf);
+
+/* Initialize a nvs hash backend. */
+int settings_nvs_hash_backend_init(struct settings_nvs_hash *cf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SETTINGS_NVS_HASH_H_ */
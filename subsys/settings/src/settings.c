@@ -24,6 +24,127 @@ sys_slist_t settings_handlers;
 
 K_MUTEX_DEFINE(settings_lock);
 
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+/* The static and dynamic handlers sorted by name. A lookup is a binary
+ * search for each prefix of the name instead of a name compare with every
+ * handler. Once the index overflows, lookups go back to the scan.
+ */
+static struct settings_handler_static *settings_index[CONFIG_SETTINGS_HANDLER_INDEX_SIZE];
+static size_t settings_index_cnt;
+static bool settings_index_valid;
+
+/* Compare a handler name with the first len characters of a name */
+static int settings_index_cmp(const char *hname, const char *name, size_t len)
+{
+	int rc = strncmp(hname, name, len);
+
+	if ((rc == 0) && (hname[len] != '\0')) {
+		rc = 1;
+	}
+
+	return rc;
+}
+
+/* Position of the first handler whose name is not before name[0..len) */
+static size_t settings_index_find(const char *name, size_t len)
+{
+	size_t lo = 0;
+	size_t hi = settings_index_cnt;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (settings_index_cmp(settings_index[mid]->name, name, len) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static void settings_index_add(struct settings_handler_static *handler)
+{
+	size_t pos;
+
+	if (!settings_index_valid) {
+		return;
+	}
+
+	if (settings_index_cnt == ARRAY_SIZE(settings_index)) {
+		LOG_WRN("Handler index full, using a scan for lookups");
+		settings_index_valid = false;
+		return;
+	}
+
+	pos = settings_index_find(handler->name, strlen(handler->name));
+	memmove(&settings_index[pos + 1], &settings_index[pos],
+		(settings_index_cnt - pos) * sizeof(settings_index[0]));
+	settings_index[pos] = handler;
+	settings_index_cnt++;
+}
+
+static void settings_index_remove(struct settings_handler_static *handler)
+{
+	size_t pos;
+
+	if (!settings_index_valid) {
+		return;
+	}
+
+	for (pos = settings_index_find(handler->name, strlen(handler->name));
+	     pos < settings_index_cnt; pos++) {
+		if (settings_index[pos] == handler) {
+			settings_index_cnt--;
+			memmove(&settings_index[pos], &settings_index[pos + 1],
+				(settings_index_cnt - pos) * sizeof(settings_index[0]));
+			return;
+		}
+	}
+}
+
+static void settings_index_init(void)
+{
+	settings_index_cnt = 0;
+	settings_index_valid = true;
+
+	STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
+		settings_index_add(ch);
+	}
+}
+
+/* The handler whose name is the longest prefix of name, ending where name
+ * has a separator or ends, as settings_name_steq() matches them.
+ */
+static struct settings_handler_static *settings_index_lookup(const char *name,
+							     const char **next)
+{
+	struct settings_handler_static *bestmatch = NULL;
+	size_t len = 0;
+	size_t pos;
+	char c;
+
+	do {
+		c = name[len];
+		if ((c == SETTINGS_NAME_SEPARATOR) || (c == SETTINGS_NAME_END) ||
+		    (c == '\0')) {
+			pos = settings_index_find(name, len);
+			if ((pos < settings_index_cnt) &&
+			    (settings_index_cmp(settings_index[pos]->name, name, len) == 0)) {
+				bestmatch = settings_index[pos];
+				if (next) {
+					*next = (c == SETTINGS_NAME_SEPARATOR) ?
+						&name[len + 1] : NULL;
+				}
+			}
+		}
+		len++;
+	} while ((c != SETTINGS_NAME_END) && (c != '\0'));
+
+	return bestmatch;
+}
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
 
 void settings_store_init(void);
 
@@ -32,6 +153,9 @@ void settings_init(void)
 #if defined(CONFIG_SETTINGS_DYNAMIC_HANDLERS)
 	sys_slist_init(&settings_handlers);
 #endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	settings_index_init();
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
 	settings_store_init();
 }
 
@@ -56,11 +180,31 @@ int settings_register(struct settings_handler *handler)
 		}
 	}
 	sys_slist_append(&settings_handlers, &handler->node);
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	settings_index_add((struct settings_handler_static *)handler);
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
 
 end:
 	k_mutex_unlock(&settings_lock);
 	return rc;
 }
+
+bool settings_deregister(struct settings_handler *handler)
+{
+	bool found;
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	found = sys_slist_find_and_remove(&settings_handlers, &handler->node);
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	if (found) {
+		settings_index_remove((struct settings_handler_static *)handler);
+	}
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
+
+	k_mutex_unlock(&settings_lock);
+	return found;
+}
 #endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
 
 int settings_name_steq(const char *name, const char *key, const char **next)
@@ -145,6 +289,12 @@ struct settings_handler_static *settings_parse_and_lookup(const char *name,
 		*next = NULL;
 	}
 
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	if (settings_index_valid && name) {
+		return settings_index_lookup(name, next);
+	}
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
+
 	STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
 		if (!settings_name_steq(name, ch->name, &tmpnext)) {
 			continue;
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/settings/settings.h>
+#include "settings/settings_nvs_hash.h"
+#include <zephyr/sys/crc.h>
+#include "settings_priv.h"
+#include <zephyr/storage/flash_map.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
+
+#if DT_HAS_CHOSEN(zephyr_settings_partition)
+#define SETTINGS_PARTITION DT_FIXED_PARTITION_ID(DT_CHOSEN(zephyr_settings_partition))
+#else
+#define SETTINGS_PARTITION FIXED_PARTITION_ID(storage_partition)
+#endif
+
+#define SETTINGS_NVS_HASH_NAME_MAX (SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN)
+
+BUILD_ASSERT(SETTINGS_NVS_HASH_NAME_MAX <= UINT8_MAX,
+	     "name length must fit in the entry header");
+
+struct settings_nvs_hash_read_fn_arg {
+	struct nvs_fs *fs;
+	const struct nvs_entry *entry;
+	size_t offset;
+};
+
+struct settings_nvs_hash_load_cb_arg {
+	struct settings_nvs_hash *cf;
+	const struct settings_load_arg *arg;
+};
+
+static int settings_nvs_hash_load(struct settings_store *cs,
+				  const struct settings_load_arg *arg);
+static int settings_nvs_hash_save(struct settings_store *cs, const char *name,
+				  const char *value, size_t val_len);
+static void *settings_nvs_hash_storage_get(struct settings_store *cs);
+
+static struct settings_store_itf settings_nvs_hash_itf = {
+	.csi_load = settings_nvs_hash_load,
+	.csi_save = settings_nvs_hash_save,
+	.csi_storage_get = settings_nvs_hash_storage_get
+};
+
+static inline uint16_t settings_nvs_hash_next(uint16_t id)
+{
+	return (id + 1U) % SETTINGS_NVS_HASH_IDS;
+}
+
+static inline uint16_t settings_nvs_hash_prev(uint16_t id)
+{
+	return (id + SETTINGS_NVS_HASH_IDS - 1U) % SETTINGS_NVS_HASH_IDS;
+}
+
+static ssize_t settings_nvs_hash_read_fn(void *back_end, void *data, size_t len)
+{
+	struct settings_nvs_hash_read_fn_arg *rd_fn_arg = back_end;
+
+	return nvs_entry_read(rd_fn_arg->fs, rd_fn_arg->entry,
+			      rd_fn_arg->offset, data, len);
+}
+
+int settings_nvs_hash_src(struct settings_nvs_hash *cf)
+{
+	cf->cf_store.cs_itf = &settings_nvs_hash_itf;
+	settings_src_register(&cf->cf_store);
+
+	return 0;
+}
+
+int settings_nvs_hash_dst(struct settings_nvs_hash *cf)
+{
+	cf->cf_store.cs_itf = &settings_nvs_hash_itf;
+	settings_dst_register(&cf->cf_store);
+
+	return 0;
+}
+
+static int settings_nvs_hash_load_cb(struct nvs_fs *fs,
+				     const struct nvs_entry *entry, void *arg)
+{
+	struct settings_nvs_hash_load_cb_arg *load_arg = arg;
+	struct settings_nvs_hash_read_fn_arg read_fn_arg;
+	uint32_t *seen = load_arg->cf->seen;
+	uint8_t buf[1 + SETTINGS_NVS_HASH_NAME_MAX + 1];
+	uint8_t name_len;
+	uint16_t id;
+	ssize_t rc;
+
+	if ((entry->id < SETTINGS_NVS_HASH_ID_BASE) ||
+	    (entry->id >= SETTINGS_NVS_HASH_ID_BASE + SETTINGS_NVS_HASH_IDS)) {
+		return 0;
+	}
+
+	id = entry->id - SETTINGS_NVS_HASH_ID_BASE;
+
+	/* Entries come newest first, any later one for an ID is stale. The
+	 * walk starts over after a write, so entries can also come again.
+	 */
+	if (seen[id / 32] & BIT(id % 32)) {
+		return 0;
+	}
+
+	if (entry->len == 0U) {
+		/* Deleted */
+		seen[id / 32] |= BIT(id % 32);
+		return 0;
+	}
+
+	rc = nvs_entry_read(fs, entry, 0, buf, 1 + SETTINGS_NVS_HASH_NAME_MAX);
+	if (rc == -EAGAIN) {
+		/* Written meanwhile, the walk starts over and comes back */
+		return 0;
+	}
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	seen[id / 32] |= BIT(id % 32);
+
+	name_len = buf[0];
+	if ((name_len == SETTINGS_NVS_HASH_TOMBSTONE) ||
+	    (name_len > SETTINGS_NVS_HASH_NAME_MAX) || (rc < 1 + name_len)) {
+		/* A tombstone, or not an entry of ours */
+		return 0;
+	}
+
+	buf[1 + name_len] = '\0';
+
+	read_fn_arg.fs = fs;
+	read_fn_arg.entry = entry;
+	read_fn_arg.offset = 1 + name_len;
+
+	return settings_call_set_handler((const char *)&buf[1],
+					 entry->len - 1 - name_len,
+					 settings_nvs_hash_read_fn, &read_fn_arg,
+					 (void *)load_arg->arg);
+}
+
+static int settings_nvs_hash_load(struct settings_store *cs,
+				  const struct settings_load_arg *arg)
+{
+	struct settings_nvs_hash *cf =
+		CONTAINER_OF(cs, struct settings_nvs_hash, cf_store);
+	struct settings_nvs_hash_load_cb_arg load_arg = {
+		.cf = cf,
+		.arg = arg,
+	};
+
+	memset(cf->seen, 0, sizeof(cf->seen));
+
+	return nvs_walk(&cf->cf_nvs, settings_nvs_hash_load_cb, &load_arg);
+}
+
+/* Look up the ID holding a name by walking its probe sequence. IDs are
+ * counted from SETTINGS_NVS_HASH_ID_BASE. When the name is not found,
+ * free_id is set to the first ID of the sequence which can be written, or
+ * to -1 if there is none.
+ */
+static int settings_nvs_hash_find(struct settings_nvs_hash *cf,
+				  const char *name, size_t name_len,
+				  int *free_id)
+{
+	uint8_t rdname[1 + SETTINGS_NVS_HASH_NAME_MAX];
+	uint16_t id;
+	ssize_t rc;
+
+	*free_id = -1;
+	id = crc32_ieee(name, name_len) % SETTINGS_NVS_HASH_IDS;
+
+	for (int i = 0; i < SETTINGS_NVS_HASH_IDS; i++) {
+		rc = nvs_read(&cf->cf_nvs, SETTINGS_NVS_HASH_ID_BASE + id, rdname,
+			      1 + name_len);
+		if (rc == -ENOENT) {
+			/* End of the probe sequence */
+			if (*free_id < 0) {
+				*free_id = id;
+			}
+
+			return -ENOENT;
+		}
+
+		if (rc < 0) {
+			return rc;
+		}
+
+		if (rdname[0] == SETTINGS_NVS_HASH_TOMBSTONE) {
+			if (*free_id < 0) {
+				*free_id = id;
+			}
+		} else if ((rdname[0] == name_len) && (rc >= 1 + name_len) &&
+			   !memcmp(&rdname[1], name, name_len)) {
+			return id;
+		}
+
+		id = settings_nvs_hash_next(id);
+	}
+
+	return -ENOENT;
+}
+
+static int settings_nvs_hash_delete(struct settings_nvs_hash *cf, uint16_t id)
+{
+	uint8_t hdr;
+	ssize_t rc;
+
+	rc = nvs_read(&cf->cf_nvs,
+		      SETTINGS_NVS_HASH_ID_BASE + settings_nvs_hash_next(id),
+		      &hdr, sizeof(hdr));
+	if (rc >= 0) {
+		/* Other names may probe past this ID, leave a tombstone */
+		hdr = SETTINGS_NVS_HASH_TOMBSTONE;
+		rc = nvs_write(&cf->cf_nvs, SETTINGS_NVS_HASH_ID_BASE + id, &hdr,
+			       sizeof(hdr));
+
+		return rc < 0 ? rc : 0;
+	}
+
+	if (rc != -ENOENT) {
+		return rc;
+	}
+
+	/* Last ID of the probe sequence, it and the tombstones right before
+	 * it are not needed anymore.
+	 */
+	do {
+		rc = nvs_delete(&cf->cf_nvs, SETTINGS_NVS_HASH_ID_BASE + id);
+		if (rc < 0) {
+			return rc;
+		}
+
+		id = settings_nvs_hash_prev(id);
+		rc = nvs_read(&cf->cf_nvs, SETTINGS_NVS_HASH_ID_BASE + id, &hdr,
+			      sizeof(hdr));
+	} while ((rc > 0) && (hdr == SETTINGS_NVS_HASH_TOMBSTONE));
+
+	return (rc < 0 && rc != -ENOENT) ? rc : 0;
+}
+
+static int settings_nvs_hash_save(struct settings_store *cs, const char *name,
+				  const char *value, size_t val_len)
+{
+	struct settings_nvs_hash *cf =
+		CONTAINER_OF(cs, struct settings_nvs_hash, cf_store);
+	uint8_t buf[1 + SETTINGS_NVS_HASH_NAME_MAX + SETTINGS_MAX_VAL_LEN];
+	size_t name_len;
+	int id, free_id;
+	ssize_t rc;
+
+	if (!name) {
+		return -EINVAL;
+	}
+
+	name_len = strlen(name);
+	if ((name_len == 0) || (name_len > SETTINGS_NVS_HASH_NAME_MAX)) {
+		return -EINVAL;
+	}
+
+	id = settings_nvs_hash_find(cf, name, name_len, &free_id);
+	if ((id < 0) && (id != -ENOENT)) {
+		return id;
+	}
+
+	/* Find out if we are doing a delete */
+	if ((value == NULL) || (val_len == 0)) {
+		if (id == -ENOENT) {
+			return 0;
+		}
+
+		return settings_nvs_hash_delete(cf, id);
+	}
+
+	if (val_len > SETTINGS_MAX_VAL_LEN) {
+		return -EINVAL;
+	}
+
+	if (id == -ENOENT) {
+		/* No free IDs left. */
+		if (free_id < 0) {
+			return -ENOMEM;
+		}
+
+		id = free_id;
+	}
+
+	buf[0] = name_len;
+	memcpy(&buf[1], name, name_len);
+	memcpy(&buf[1 + name_len], value, val_len);
+
+	rc = nvs_write(&cf->cf_nvs, SETTINGS_NVS_HASH_ID_BASE + id, buf,
+		       1 + name_len + val_len);
+
+	return rc < 0 ? rc : 0;
+}
+
+/* Initialize the nvs hash backend. */
+int settings_nvs_hash_backend_init(struct settings_nvs_hash *cf)
+{
+	int rc;
+
+	cf->cf_nvs.flash_device = cf->flash_dev;
+	if (cf->cf_nvs.flash_device == NULL) {
+		return -ENODEV;
+	}
+
+	rc = nvs_mount(&cf->cf_nvs);
+	if (rc) {
+		return rc;
+	}
+
+	LOG_DBG("Initialized");
+	return 0;
+}
+
+int settings_backend_init(void)
+{
+	static struct settings_nvs_hash default_settings_nvs_hash;
+	int rc;
+	uint16_t cnt = 0;
+	size_t nvs_sector_size, nvs_size = 0;
+	const struct flash_area *fa;
+	struct flash_sector hw_flash_sector;
+	uint32_t sector_cnt = 1;
+
+	rc = flash_area_open(SETTINGS_PARTITION, &fa);
+	if (rc) {
+		return rc;
+	}
+
+	rc = flash_area_get_sectors(SETTINGS_PARTITION, &sector_cnt,
+				    &hw_flash_sector);
+	if (rc != 0 && rc != -ENOMEM) {
+		return rc;
+	}
+
+	nvs_sector_size = CONFIG_SETTINGS_NVS_SECTOR_SIZE_MULT *
+			  hw_flash_sector.fs_size;
+
+	if (nvs_sector_size > UINT16_MAX) {
+		return -EDOM;
+	}
+
+	while (cnt < CONFIG_SETTINGS_NVS_SECTOR_COUNT) {
+		nvs_size += nvs_sector_size;
+		if (nvs_size > fa->fa_size) {
+			break;
+		}
+		cnt++;
+	}
+
+	/* define the nvs file system using the page_info */
+	default_settings_nvs_hash.cf_nvs.sector_size = nvs_sector_size;
+	default_settings_nvs_hash.cf_nvs.sector_count = cnt;
+	default_settings_nvs_hash.cf_nvs.offset = fa->fa_off;
+	default_settings_nvs_hash.flash_dev = fa->fa_dev;
+
+	rc = settings_nvs_hash_backend_init(&default_settings_nvs_hash);
+	if (rc) {
+		return rc;
+	}
+
+	rc = settings_nvs_hash_src(&default_settings_nvs_hash);
+	if (rc) {
+		return rc;
+	}
+
+	return settings_nvs_hash_dst(&default_settings_nvs_hash);
+}
+
+static void *settings_nvs_hash_storage_get(struct settings_store *cs)
+{
+	struct settings_nvs_hash *cf =
+		CONTAINER_OF(cs, struct settings_nvs_hash, cf_store);
+
+	return &cf->cf_nvs;
+}
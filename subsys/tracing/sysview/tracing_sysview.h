@@ -385,6 +385,8 @@ void sys_trace_thread_info(struct k_thread *thread);
 
 #define sys_port_trace_k_queue_merge_slist_enter(queue)
 #define sys_port_trace_k_queue_merge_slist_exit(queue, ret)
+#define sys_port_trace_k_queue_prepend_list_enter(queue)
+#define sys_port_trace_k_queue_prepend_list_exit(queue, ret)
 
 #define sys_port_trace_k_queue_get_enter(queue, timeout)                                           \
 	SEGGER_SYSVIEW_RecordU32x2(TID_QUEUE_GET, (uint32_t)(uintptr_t)queue,                      \
@@ -472,6 +474,9 @@ void sys_trace_thread_info(struct k_thread *thread);
 
 #define sys_port_trace_k_lifo_put_exit(lifo, data) SEGGER_SYSVIEW_RecordEndCall(TID_LIFO_PUT)
 
+#define sys_port_trace_k_lifo_put_slist_enter(lifo, list)
+#define sys_port_trace_k_lifo_put_slist_exit(lifo, list)
+
 #define sys_port_trace_k_lifo_alloc_put_enter(lifo, data)                                          \
 	SEGGER_SYSVIEW_RecordU32x2(TID_LIFO_ALLOC_PUT, (uint32_t)(uintptr_t)lifo,                  \
 				   (uint32_t)(uintptr_t)data)
@@ -185,6 +185,9 @@
 	sys_trace_k_queue_merge_slist_enter(queue, list)
 #define sys_port_trace_k_queue_merge_slist_exit(queue, ret)                                        \
 	sys_trace_k_queue_merge_slist_exit(queue, list, ret)
+#define sys_port_trace_k_queue_prepend_list_enter(queue)
+#define sys_port_trace_k_queue_prepend_list_exit(queue, ret)                                       \
+	sys_trace_k_queue_prepend_list_exit(queue, head, tail, ret)
 #define sys_port_trace_k_queue_get_enter(queue, timeout)
 #define sys_port_trace_k_queue_get_blocking(queue, timeout)                                        \
 	sys_trace_k_queue_get_blocking(queue, timeout)
@@ -253,6 +256,11 @@
 
 #define sys_port_trace_k_lifo_put_exit(lifo, data) sys_trace_k_lifo_put_exit(lifo, data)
 
+#define sys_port_trace_k_lifo_put_slist_enter(lifo, list)                                          \
+	sys_trace_k_lifo_put_slist_enter(lifo, list)
+
+#define sys_port_trace_k_lifo_put_slist_exit(lifo, list) sys_trace_k_lifo_put_slist_exit(lifo, list)
+
 #define sys_port_trace_k_lifo_alloc_put_enter(lifo, data)                                          \
 	sys_trace_k_lifo_alloc_put_enter(lifo, data)
 
@@ -539,6 +547,7 @@ void sys_trace_k_queue_insert_exit(struct k_queue *queue, void *prev, void *data
 void sys_trace_k_queue_append_list_exit(struct k_queue *queue, void *head, void *tail, int ret);
 void sys_trace_k_queue_merge_slist_enter(struct k_queue *queue, sys_slist_t *list);
 void sys_trace_k_queue_merge_slist_exit(struct k_queue *queue, sys_slist_t *list, int ret);
+void sys_trace_k_queue_prepend_list_exit(struct k_queue *queue, void *head, void *tail, int ret);
 void sys_trace_k_queue_get_blocking(struct k_queue *queue, k_timeout_t timeout);
 void sys_trace_k_queue_get_exit(struct k_queue *queue, k_timeout_t timeout, void *ret);
 void sys_trace_k_queue_remove_enter(struct k_queue *queue, void *data);
@@ -571,6 +580,8 @@ void sys_trace_k_lifo_init_enter(struct k_lifo *lifo);
 void sys_trace_k_lifo_init_exit(struct k_lifo *lifo);
 void sys_trace_k_lifo_put_enter(struct k_lifo *lifo, void *data);
 void sys_trace_k_lifo_put_exit(struct k_lifo *lifo, void *data);
+void sys_trace_k_lifo_put_slist_enter(struct k_lifo *lifo, sys_slist_t *list);
+void sys_trace_k_lifo_put_slist_exit(struct k_lifo *lifo, sys_slist_t *list);
 void sys_trace_k_lifo_alloc_put_enter(struct k_lifo *lifo, void *data);
 void sys_trace_k_lifo_alloc_put_exit(struct k_lifo *lifo, void *data, int ret);
 void sys_trace_k_lifo_get_enter(struct k_lifo *lifo, k_timeout_t timeout);
@@ -189,6 +189,8 @@ void sys_trace_idle(void);
 #define sys_port_trace_k_queue_append_list_exit(queue, ret)
 #define sys_port_trace_k_queue_merge_slist_enter(queue)
 #define sys_port_trace_k_queue_merge_slist_exit(queue, ret)
+#define sys_port_trace_k_queue_prepend_list_enter(queue)
+#define sys_port_trace_k_queue_prepend_list_exit(queue, ret)
 #define sys_port_trace_k_queue_get_enter(queue, timeout)
 #define sys_port_trace_k_queue_get_blocking(queue, timeout)
 #define sys_port_trace_k_queue_get_exit(queue, timeout, ret)
@@ -222,6 +224,8 @@ void sys_trace_idle(void);
 #define sys_port_trace_k_lifo_init_exit(lifo)
 #define sys_port_trace_k_lifo_put_enter(lifo, data)
 #define sys_port_trace_k_lifo_put_exit(lifo, data)
+#define sys_port_trace_k_lifo_put_slist_enter(lifo, list)
+#define sys_port_trace_k_lifo_put_slist_exit(lifo, list)
 #define sys_port_trace_k_lifo_alloc_put_enter(lifo, data)
 #define sys_port_trace_k_lifo_alloc_put_exit(lifo, data, ret)
 #define sys_port_trace_k_lifo_get_enter(lifo, timeout)
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_TESTS_BENCHMARKS_COMMON_BENCH_UTIL_H_
+#define ZEPHYR_TESTS_BENCHMARKS_COMMON_BENCH_UTIL_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+
+/* Helpers shared by the throughput benchmarks.  Time is measured with
+ * the timing API, as latency_measure does, so the benchmarks need
+ * CONFIG_TIMING_FUNCTIONS=y and must call bench_timing_init() first.
+ */
+
+static inline void bench_timing_init(void)
+{
+	timing_init();
+	timing_start();
+}
+
+static inline timing_t bench_stamp(void)
+{
+	return timing_counter_get();
+}
+
+/* Nanoseconds between two stamps */
+static inline uint64_t bench_ns(timing_t start, timing_t end)
+{
+	return timing_cycles_to_ns(timing_cycles_get(&start, &end));
+}
+
+/* Nanoseconds since a stamp */
+static inline uint64_t bench_ns_since(timing_t start)
+{
+	return bench_ns(start, bench_stamp());
+}
+
+/* Rate per second of count events taking ns nanoseconds */
+static inline uint32_t bench_rate(uint64_t count, uint64_t ns)
+{
+	return (uint32_t)((count * NSEC_PER_SEC) / MAX(ns, 1U));
+}
+
+/* Let the benchmark threads run for ms milliseconds and return how
+ * long they actually ran, in nanoseconds.  The caller must run at a
+ * higher priority than the threads it measures, so it gets the CPU
+ * back as soon as the window is over.
+ */
+static inline uint64_t bench_window(int32_t ms)
+{
+	timing_t start = bench_stamp();
+
+	k_msleep(ms);
+
+	return bench_ns_since(start);
+}
+
+/* Busy loop standing for the work a benchmark thread does */
+static inline void bench_spin(uint32_t iters)
+{
+	volatile uint32_t acc = 0U;
+
+	for (uint32_t i = 0; i < iters; i++) {
+		acc += i;
+	}
+}
+
+/* Start a benchmark thread, pinned to the given CPU (modulo the number
+ * of CPUs) when CONFIG_SCHED_CPU_MASK is enabled.
+ */
+static inline void bench_thread_start(struct k_thread *thread,
+				      k_thread_stack_t *stack, size_t stack_size,
+				      k_thread_entry_t entry, void *arg,
+				      int prio, unsigned int cpu)
+{
+	k_thread_create(thread, stack, stack_size, entry, arg, NULL, NULL,
+			prio, 0, K_FOREVER);
+#ifdef CONFIG_SCHED_CPU_MASK
+	k_thread_cpu_pin(thread, cpu % arch_num_cpus());
+#else
+	ARG_UNUSED(cpu);
+#endif
+	k_thread_start(thread);
+}
+
+#endif /* ZEPHYR_TESTS_BENCHMARKS_COMMON_BENCH_UTIL_H_ */
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/fs/fs.h>
+
+/* Ext2 file operations benchmark.  For each count of files of the sweep,
+ * formats the RAM disk, creates that many files of FILE_SIZE bytes in one
+ * directory, then looks each of them up with fs_stat() and reads each of
+ * them back.  Reports the average time of a file creation, a lookup and a
+ * read.  Lookups scan the directory blocks and creations scan the bitmaps
+ * too, so their time follows how often these blocks are read again from
+ * the disk.
+ */
+
+#define DISK_NAME  "RAM"
+#define MNT_POINT  "/ext"
+#define DIR_PATH   MNT_POINT "/dir"
+#define FILE_SIZE  512
+#define N_LOOKUPS  256
+
+static const uint32_t sweep[] = { 32, 64, 128 };
+
+static struct fs_mount_t mp = {
+	.type = FS_EXT2,
+	.mnt_point = MNT_POINT,
+	.storage_dev = (void *)DISK_NAME,
+};
+
+static uint8_t wbuf[FILE_SIZE];
+static uint8_t rbuf[FILE_SIZE];
+static uint32_t bad;
+
+static void file_path(char *path, size_t size, uint32_t i)
+{
+	snprintk(path, size, DIR_PATH "/file%u", i);
+}
+
+static void fill(uint8_t *buf, uint32_t i)
+{
+	memset(buf, (uint8_t)i, FILE_SIZE);
+	memcpy(buf, &i, sizeof(i));
+}
+
+static uint64_t create_all(uint32_t n)
+{
+	struct fs_file_t file;
+	char path[32];
+	uint64_t start;
+	int ret;
+
+	start = k_cycle_get_64();
+	for (uint32_t i = 0; i < n; i++) {
+		file_path(path, sizeof(path), i);
+		fill(wbuf, i);
+
+		fs_file_t_init(&file);
+		ret = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE);
+		if (ret < 0) {
+			printk("cannot create %s (%d)\n", path, ret);
+			k_oops();
+		}
+
+		if (fs_write(&file, wbuf, sizeof(wbuf)) != sizeof(wbuf)) {
+			bad++;
+		}
+
+		(void)fs_close(&file);
+	}
+
+	return k_cycle_get_64() - start;
+}
+
+static uint64_t lookup_all(uint32_t n)
+{
+	struct fs_dirent entry;
+	char path[32];
+	uint64_t start;
+
+	start = k_cycle_get_64();
+	for (uint32_t i = 0; i < N_LOOKUPS; i++) {
+		/* step through the files in an order unrelated to the creation */
+		file_path(path, sizeof(path), (i * 7U) % n);
+
+		if (fs_stat(path, &entry) < 0 || entry.size != FILE_SIZE) {
+			bad++;
+		}
+	}
+
+	return k_cycle_get_64() - start;
+}
+
+static uint64_t read_all(uint32_t n)
+{
+	struct fs_file_t file;
+	char path[32];
+	uint64_t start;
+
+	start = k_cycle_get_64();
+	for (uint32_t i = 0; i < n; i++) {
+		file_path(path, sizeof(path), i);
+
+		fs_file_t_init(&file);
+		if (fs_open(&file, path, FS_O_READ) < 0) {
+			bad++;
+			continue;
+		}
+
+		if (fs_read(&file, rbuf, sizeof(rbuf)) != sizeof(rbuf)) {
+			bad++;
+		}
+
+		(void)fs_close(&file);
+
+		fill(wbuf, i);
+		if (memcmp(rbuf, wbuf, sizeof(rbuf))) {
+			bad++;
+		}
+	}
+
+	return k_cycle_get_64() - start;
+}
+
+static void run(uint32_t n)
+{
+	uint64_t create_cyc, lookup_cyc, read_cyc;
+	int ret;
+
+	/* start from an empty file system */
+	ret = fs_mkfs(FS_EXT2, (uintptr_t)DISK_NAME, NULL, 0);
+	if (ret < 0) {
+		printk("cannot format the disk (%d)\n", ret);
+		k_oops();
+	}
+
+	ret = fs_mount(&mp);
+	if (ret < 0) {
+		printk("cannot mount ext2 (%d)\n", ret);
+		k_oops();
+	}
+
+	ret = fs_mkdir(DIR_PATH);
+	if (ret < 0) {
+		printk("cannot create the directory (%d)\n", ret);
+		k_oops();
+	}
+
+	bad = 0U;
+	create_cyc = create_all(n);
+	lookup_cyc = lookup_all(n);
+	read_cyc = read_all(n);
+
+	if (bad != 0U) {
+		printk("files %u: %u bad operations\n", n, bad);
+	}
+
+	printk("files %4u: create %5u us lookup %5u us read %5u us\n", n,
+	       (uint32_t)k_cyc_to_us_floor64(create_cyc / n),
+	       (uint32_t)k_cyc_to_us_floor64(lookup_cyc / N_LOOKUPS),
+	       (uint32_t)k_cyc_to_us_floor64(read_cyc / n));
+
+	ret = fs_unmount(&mp);
+	if (ret < 0) {
+		printk("cannot unmount ext2 (%d)\n", ret);
+		k_oops();
+	}
+}
+
+int main(void)
+{
+	printk("Ext2 file operations benchmark, block cache %s\n",
+	       IS_ENABLED(CONFIG_EXT2_BLOCK_CACHE) ? "on" : "off");
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		run(sweep[s]);
+	}
+
+	printk("fin\n");
+	return 0;
+}
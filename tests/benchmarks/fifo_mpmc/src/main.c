@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "bench_util.h"
+
+/* FIFO throughput benchmark.  Producers take a free item from a shared
+ * LIFO and put it into a shared FIFO, consumers get items from the
+ * FIFO and put them back into the LIFO.  The benchmark runs with 1,
+ * 2, ... producer/consumer pairs and reports the aggregate rate of
+ * items going through the FIFO for each step.
+ */
+
+#define MAX_PAIRS      MAX(CONFIG_MP_MAX_NUM_CPUS, 2)
+#define ITEMS_PER_PAIR 16
+#define STACK_SIZE     (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define PAIR_PRIO      K_PRIO_PREEMPT(5)
+#define RUN_MS         1000
+
+struct item {
+	void *fifo_reserved;
+	uint32_t seq;
+};
+
+static struct item items[MAX_PAIRS * ITEMS_PER_PAIR];
+
+static K_FIFO_DEFINE(fifo);
+static K_LIFO_DEFINE(free_items);
+
+static uint32_t consumed[MAX_PAIRS];
+static struct k_thread threads[MAX_PAIRS * 2];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_PAIRS * 2, STACK_SIZE);
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	uint32_t seq = 0U;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		struct item *item = k_lifo_get(&free_items, K_FOREVER);
+
+		item->seq = seq++;
+		k_fifo_put(&fifo, item);
+	}
+}
+
+static void consumer(void *p1, void *p2, void *p3)
+{
+	uint32_t *count = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		struct item *item = k_fifo_get(&fifo, K_FOREVER);
+
+		k_lifo_put(&free_items, item);
+		(*count)++;
+	}
+}
+
+static void start_pair(int i)
+{
+	k_thread_entry_t entry[2] = { producer, consumer };
+
+	consumed[i] = 0U;
+
+	for (int j = 0; j < 2; j++) {
+		bench_thread_start(&threads[i * 2 + j], stacks[i * 2 + j],
+				   STACK_SIZE, entry[j], &consumed[i], PAIR_PRIO, i);
+	}
+}
+
+static void stop_pair(int i)
+{
+	for (int j = 0; j < 2; j++) {
+		k_thread_abort(&threads[i * 2 + j]);
+	}
+}
+
+/* Put every item back into the free list, aborted threads may have
+ * been holding some of them.
+ */
+static void reset_items(unsigned int n)
+{
+	while (k_fifo_get(&fifo, K_NO_WAIT) != NULL) {
+	}
+	while (k_lifo_get(&free_items, K_NO_WAIT) != NULL) {
+	}
+
+	for (unsigned int i = 0; i < n * ITEMS_PER_PAIR; i++) {
+		k_lifo_put(&free_items, &items[i]);
+	}
+}
+
+int main(void)
+{
+	unsigned int max_pairs = MAX(arch_num_cpus(), 2U);
+
+	printk("FIFO MPMC benchmark, %u CPUs\n", arch_num_cpus());
+
+	bench_timing_init();
+
+	for (unsigned int n = 1; n <= max_pairs; n++) {
+		uint64_t total = 0U;
+		uint64_t ns;
+
+		reset_items(n);
+
+		for (unsigned int i = 0; i < n; i++) {
+			start_pair(i);
+		}
+
+		ns = bench_window(RUN_MS);
+
+		for (unsigned int i = 0; i < n; i++) {
+			stop_pair(i);
+			total += consumed[i];
+		}
+
+		uint32_t rate = bench_rate(total, ns);
+
+		printk("pairs %u: items/s %u per pair %u\n",
+		       n, rate, rate / n);
+	}
+
+	printk("fin\n");
+	return 0;
+}
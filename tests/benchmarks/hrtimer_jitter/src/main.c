@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+/* Timer jitter benchmark.  Runs a periodic k_timer and a periodic
+ * k_hrtimer for N_SAMPLES expiries at each period of the sweep,
+ * timestamping every expiry from the expiry function.  Reports the
+ * average and worst error of the interval between expiries against the
+ * requested period, and how late the first expiry was.
+ */
+
+#define N_SAMPLES 200
+
+enum kind {
+	KIND_TIMER,
+	KIND_HRTIMER,
+	NUM_KINDS
+};
+
+static const char *const kind_names[NUM_KINDS] = {
+	"timer", "hrtimer",
+};
+
+static const uint32_t sweep_us[] = { 50, 250, 1000, 3300 };
+
+static struct k_timer timer;
+static struct k_hrtimer hrtimer;
+static K_SEM_DEFINE(done, 0, 1);
+
+static uint64_t stamps[N_SAMPLES];
+static int n_stamps;
+
+static void record(void)
+{
+	stamps[n_stamps++] = k_cycle_get_64();
+	if (n_stamps == N_SAMPLES) {
+		k_timer_stop(&timer);
+		(void)k_hrtimer_stop(&hrtimer);
+		k_sem_give(&done);
+	}
+}
+
+static void timer_fn(struct k_timer *t)
+{
+	ARG_UNUSED(t);
+
+	if (n_stamps < N_SAMPLES) {
+		record();
+	}
+}
+
+static void hrtimer_fn(struct k_hrtimer *t)
+{
+	ARG_UNUSED(t);
+
+	if (n_stamps < N_SAMPLES) {
+		record();
+	}
+}
+
+static void run(enum kind k, uint32_t period_us)
+{
+	uint64_t period = k_us_to_cyc_ceil64(period_us);
+	uint64_t err_tot = 0U, err_max = 0U;
+	uint64_t start;
+
+	n_stamps = 0;
+	k_sem_reset(&done);
+
+	start = k_cycle_get_64() + period;
+	if (k == KIND_TIMER) {
+		k_timer_start(&timer, K_USEC(period_us), K_USEC(period_us));
+	} else {
+		k_hrtimer_start(&hrtimer, start, period);
+	}
+
+	k_sem_take(&done, K_FOREVER);
+
+	for (int i = 1; i < N_SAMPLES; i++) {
+		uint64_t interval = stamps[i] - stamps[i - 1];
+		uint64_t err = (interval > period) ? (interval - period)
+						   : (period - interval);
+
+		err_tot += err;
+		err_max = MAX(err_max, err);
+	}
+
+	printk("%-7s period %5u us: err avg %7u max %7u ns late %7u ns\n",
+	       kind_names[k], period_us,
+	       (uint32_t)k_cyc_to_ns_floor64(err_tot / (N_SAMPLES - 1)),
+	       (uint32_t)k_cyc_to_ns_floor64(err_max),
+	       (uint32_t)k_cyc_to_ns_floor64(stamps[0] > start ?
+					      stamps[0] - start : 0U));
+}
+
+int main(void)
+{
+	k_timer_init(&timer, timer_fn, NULL);
+	k_hrtimer_init(&hrtimer, hrtimer_fn);
+
+	printk("Timer jitter benchmark, %u ticks/s, %u cycles/s\n",
+	       CONFIG_SYS_CLOCK_TICKS_PER_SEC, sys_clock_hw_cycles_per_sec());
+
+	for (int k = 0; k < NUM_KINDS; k++) {
+		for (int s = 0; s < ARRAY_SIZE(sweep_us); s++) {
+			run(k, sweep_us[s]);
+		}
+	}
+
+	printk("fin\n");
+	return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "bench_util.h"
+
+/* Lock contention benchmark.  One worker per CPU loops taking a shared
+ * lock, running a short critical section, releasing it and running a
+ * bit of work outside of it.  The lock is a k_mutex or a binary k_sem.
+ * For each lock and critical section length it reports the aggregate
+ * rate of lock/unlock pairs across all workers.
+ */
+
+#define MAX_WORKERS CONFIG_MP_MAX_NUM_CPUS
+#define STACK_SIZE  (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define WORKER_PRIO K_PRIO_PREEMPT(5)
+#define RUN_MS      1000
+#define OUTSIDE_ITERS 100
+
+enum lock_kind {
+	LOCK_MUTEX,
+	LOCK_SEM,
+	NUM_LOCKS
+};
+
+static const char *const lock_names[NUM_LOCKS] = {
+	"mutex", "sem",
+};
+
+/* Critical section lengths, in loop iterations */
+static const uint32_t sweep[] = { 0, 50, 200, 1000, 5000 };
+
+static K_MUTEX_DEFINE(mutex);
+static K_SEM_DEFINE(sem, 1, 1);
+
+static uint32_t ops[MAX_WORKERS];
+static struct k_thread threads[MAX_WORKERS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_WORKERS, STACK_SIZE);
+
+static volatile bool stop;
+static enum lock_kind kind;
+static uint32_t cs_iters;
+static volatile uint32_t shared;
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	uint32_t *count = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!stop) {
+		if (kind == LOCK_MUTEX) {
+			k_mutex_lock(&mutex, K_FOREVER);
+		} else {
+			k_sem_take(&sem, K_FOREVER);
+		}
+
+		shared++;
+		bench_spin(cs_iters);
+
+		if (kind == LOCK_MUTEX) {
+			k_mutex_unlock(&mutex);
+		} else {
+			k_sem_give(&sem);
+		}
+
+		(*count)++;
+		bench_spin(OUTSIDE_ITERS);
+	}
+}
+
+static void start_worker(int i)
+{
+	ops[i] = 0U;
+
+	bench_thread_start(&threads[i], stacks[i], STACK_SIZE, worker,
+			   &ops[i], WORKER_PRIO, i);
+}
+
+static void run(enum lock_kind k, uint32_t iters)
+{
+	unsigned int num_cpus = arch_num_cpus();
+	uint64_t total = 0U;
+	uint64_t ns;
+
+	kind = k;
+	cs_iters = iters;
+	stop = false;
+
+	for (unsigned int i = 0; i < num_cpus; i++) {
+		start_worker(i);
+	}
+
+	ns = bench_window(RUN_MS);
+
+	for (unsigned int i = 0; i < num_cpus; i++) {
+		total += ops[i];
+	}
+
+	/* Stopped rather than aborted, so none of them dies holding the lock */
+	stop = true;
+	for (unsigned int i = 0; i < num_cpus; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+
+	uint32_t rate = bench_rate(total, ns);
+
+	printk("%-5s cs %5u: ops/s %u per thread %u\n", lock_names[k],
+	       iters, rate, rate / num_cpus);
+}
+
+int main(void)
+{
+	printk("Lock contention benchmark, %u CPUs, adaptive spin %s\n",
+	       arch_num_cpus(), IS_ENABLED(CONFIG_ADAPTIVE_SPIN) ? "on" : "off");
+
+	bench_timing_init();
+
+	for (int k = 0; k < NUM_LOCKS; k++) {
+		for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+			run(k, sweep[s]);
+		}
+	}
+
+	printk("fin\n");
+	return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "bench_util.h"
+
+/* SMP memory slab throughput benchmark.  Each worker thread loops
+ * allocating a small batch of blocks from one shared slab and freeing
+ * them again.  The benchmark runs with 1, 2, ... up to arch_num_cpus()
+ * workers and reports the aggregate rate of alloc/free pairs for each
+ * step, which shows how the slab scales as more cores contend on it.
+ */
+
+#define MAX_WORKERS CONFIG_MP_MAX_NUM_CPUS
+#define STACK_SIZE  (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define WORKER_PRIO K_PRIO_PREEMPT(5)
+#define RUN_MS      1000
+#define BATCH       4
+#define BLOCK_SIZE  64
+
+/* Workers aborted at the end of a step leak whatever they were
+ * holding, leave room for that on top of what the workers use.
+ */
+#define NUM_BLOCKS  (MAX_WORKERS * (MAX_WORKERS + 1) * BATCH)
+
+K_MEM_SLAB_DEFINE_STATIC(slab, BLOCK_SIZE, NUM_BLOCKS, sizeof(void *));
+
+static uint32_t pairs[MAX_WORKERS];
+static struct k_thread threads[MAX_WORKERS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_WORKERS, STACK_SIZE);
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	uint32_t *count = p1;
+	void *blocks[BATCH];
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		for (int i = 0; i < BATCH; i++) {
+			if (k_mem_slab_alloc(&slab, &blocks[i], K_FOREVER) != 0) {
+				printk("allocation failed\n");
+				return;
+			}
+		}
+
+		for (int i = 0; i < BATCH; i++) {
+			k_mem_slab_free(&slab, blocks[i]);
+		}
+
+		*count += BATCH;
+	}
+}
+
+static void start_worker(int i)
+{
+	pairs[i] = 0U;
+
+	bench_thread_start(&threads[i], stacks[i], STACK_SIZE, worker,
+			   &pairs[i], WORKER_PRIO, i);
+}
+
+int main(void)
+{
+	unsigned int num_cpus = arch_num_cpus();
+
+	printk("SMP memory slab benchmark, %u CPUs\n", num_cpus);
+
+	bench_timing_init();
+
+	for (unsigned int n = 1; n <= num_cpus; n++) {
+		uint64_t total = 0U;
+		uint64_t ns;
+
+		for (unsigned int i = 0; i < n; i++) {
+			start_worker(i);
+		}
+
+		ns = bench_window(RUN_MS);
+
+		for (unsigned int i = 0; i < n; i++) {
+			k_thread_abort(&threads[i]);
+			total += pairs[i];
+		}
+
+		uint32_t rate = bench_rate(total, ns);
+
+		printk("threads %u: pairs/s %u per thread %u\n",
+		       n, rate, rate / n);
+	}
+
+	printk("fin\n");
+	return 0;
+}
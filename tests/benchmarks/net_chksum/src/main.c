@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "net_private.h"
+
+#include "bench_util.h"
+
+/* Internet checksum benchmark.  Times calc_chksum() over buffers of
+ * each length of the sweep, starting on an aligned and on an odd
+ * address, and reports the throughput in megabytes per second.
+ */
+
+#define N_BYTES (4U * 1024U * 1024U)
+#define MAX_LEN 9000U
+
+static const uint32_t sweep[] = { 20, 64, 256, 576, 1500, MAX_LEN };
+
+static uint8_t buf[MAX_LEN + 1] __aligned(16);
+
+/* Keeps the sums alive so the calls cannot be optimized away */
+static volatile uint16_t sink;
+
+static uint32_t run(uint32_t len, uint32_t offset)
+{
+	uint32_t iters = MAX(N_BYTES / len, 1U);
+	uint16_t sum = 0U;
+	timing_t start;
+	uint64_t ns;
+
+	start = bench_stamp();
+	for (uint32_t i = 0; i < iters; i++) {
+		sum = calc_chksum(sum, &buf[offset], len);
+	}
+	ns = bench_ns_since(start);
+
+	sink = sum;
+
+	/* Bytes per microsecond, that is megabytes per second */
+	return (uint32_t)(((uint64_t)iters * len * 1000U) / MAX(ns, 1U));
+}
+
+int main(void)
+{
+	printk("Internet checksum benchmark, SIMD %s\n",
+	       IS_ENABLED(CONFIG_NET_IP_CHKSUM_SIMD) ? "on" : "off");
+
+	bench_timing_init();
+
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		for (uint32_t offset = 0; offset < 2; offset++) {
+			printk("len %4u offset %u: MB/s %u\n", sweep[s],
+			       offset, run(sweep[s], offset));
+		}
+	}
+
+	printk("fin\n");
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/udp.h>
+
+#include "ipv4.h"
+#include "udp_internal.h"
+#include "connection.h"
+
+#include "bench_util.h"
+
+/* Connection demultiplexing benchmark.  Registers a listener on a local
+ * port plus a number of connected handlers on the same port, each with
+ * its own remote port, then feeds one pre-built IPv4 UDP packet to
+ * net_conn_input() in a loop.  Reports the rate of matched packets for
+ * a packet from a connected client (the first one registered) and for
+ * one only the listener takes, for each connection count of the sweep.
+ */
+
+#define LOCAL_PORT   4242
+#define REMOTE_PORT  10000
+#define STRAY_PORT   9999
+#define N_PKTS       20000
+
+static const uint32_t sweep[] = { 1, 16, 64, 128, 256 };
+
+static struct net_conn_handle *handles[CONFIG_NET_MAX_CONN];
+static int n_handles;
+static uint32_t delivered;
+
+static struct in_addr local_addr = { { { 127, 0, 0, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 9 } } };
+
+static enum net_verdict conn_cb(struct net_conn *conn, struct net_pkt *pkt,
+				union net_ip_header *ip_hdr,
+				union net_proto_header *proto_hdr,
+				void *user_data)
+{
+	ARG_UNUSED(conn);
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(ip_hdr);
+	ARG_UNUSED(proto_hdr);
+	ARG_UNUSED(user_data);
+
+	/* The packet is fed again, keep it */
+	delivered++;
+
+	return NET_OK;
+}
+
+static void conn_add(const struct sockaddr_in *remote, uint16_t remote_port)
+{
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LOCAL_PORT),
+	};
+	int ret;
+
+	ret = net_conn_register(IPPROTO_UDP, AF_INET,
+				(const struct sockaddr *)remote,
+				(const struct sockaddr *)&local,
+				remote_port, LOCAL_PORT, NULL, conn_cb, NULL,
+				&handles[n_handles]);
+	if (ret < 0) {
+		printk("cannot register connection %d (%d)\n", n_handles, ret);
+		k_oops();
+	}
+
+	n_handles++;
+}
+
+static void conns_setup(uint32_t n)
+{
+	struct sockaddr_in remote = {
+		.sin_family = AF_INET,
+		.sin_addr = peer_addr,
+	};
+
+	while (n_handles > 0) {
+		(void)net_conn_unregister(handles[--n_handles]);
+	}
+
+	/* The client the packet comes from is the oldest connection */
+	for (uint32_t i = 0; i < n - 1; i++) {
+		remote.sin_port = htons(REMOTE_PORT + i);
+		conn_add(&remote, REMOTE_PORT + i);
+	}
+
+	conn_add(NULL, 0);
+}
+
+static void run(struct net_if *iface, const char *name, uint32_t n,
+		uint16_t src_port)
+{
+	union net_ip_header ip_hdr;
+	union net_proto_header proto_hdr;
+	struct net_pkt *pkt;
+	timing_t start;
+	uint64_t ns;
+
+	pkt = net_pkt_alloc_with_buffer(iface, 0, AF_INET, IPPROTO_UDP,
+					K_SECONDS(1));
+	if (pkt == NULL ||
+	    net_ipv4_create(pkt, &peer_addr, &local_addr) < 0 ||
+	    net_udp_create(pkt, htons(src_port), htons(LOCAL_PORT)) < 0) {
+		printk("cannot create packet\n");
+		k_oops();
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	ip_hdr.ipv4 = (struct net_ipv4_hdr *)pkt->buffer->data;
+	proto_hdr.udp = (struct net_udp_hdr *)(pkt->buffer->data +
+					       sizeof(struct net_ipv4_hdr));
+
+	delivered = 0U;
+	start = bench_stamp();
+	for (int i = 0; i < N_PKTS; i++) {
+		(void)net_conn_input(pkt, &ip_hdr, IPPROTO_UDP, &proto_hdr);
+	}
+	ns = bench_ns_since(start);
+
+	net_pkt_unref(pkt);
+
+	if (delivered != N_PKTS) {
+		printk("%s: only %u of %u packets matched\n", name, delivered,
+		       N_PKTS);
+	}
+
+	printk("%-8s conns %4u: pkts/s %u\n", name, n, bench_rate(N_PKTS, ns));
+}
+
+int main(void)
+{
+	struct net_if *iface = net_if_get_default();
+
+	printk("Connection demux benchmark, hash index %s\n",
+	       IS_ENABLED(CONFIG_NET_CONN_HASH) ? "on" : "off");
+
+	bench_timing_init();
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		uint32_t n = MIN(sweep[s], CONFIG_NET_MAX_CONN);
+
+		conns_setup(n);
+		if (n > 1) {
+			run(iface, "client", n, REMOTE_PORT);
+		}
+		run(iface, "listener", n, STRAY_PORT);
+	}
+
+	printk("fin\n");
+	return 0;
+}
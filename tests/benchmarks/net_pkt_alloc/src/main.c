@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+
+#include "bench_util.h"
+
+/* Packet allocation benchmark.  For each frame size of the sweep,
+ * allocates N_PKTS RX packets with buffers for the frame, writes the
+ * frame into them and releases them, the way a driver receiving frames
+ * and the stack dropping them would.  Reports the rate of packets per
+ * second with the regular allocator and, when enabled, with a driver
+ * owned RX buffer cache.
+ */
+
+#define N_PKTS 20000
+
+static const uint32_t sweep[] = { 64, 590, 1514 };
+
+static uint8_t frame[1514];
+
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+static struct net_pkt_buf_cache cache;
+#endif
+
+static struct net_pkt *alloc(struct net_if *iface, size_t size, bool cached)
+{
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+	if (cached) {
+		return net_pkt_rx_alloc_from_cache(iface, &cache, size,
+						   K_NO_WAIT);
+	}
+#else
+	ARG_UNUSED(cached);
+#endif
+
+	return net_pkt_rx_alloc_with_buffer(iface, size, AF_UNSPEC, 0,
+					    K_NO_WAIT);
+}
+
+static void run(struct net_if *iface, uint32_t size, bool cached)
+{
+	timing_t start;
+	uint64_t ns;
+	int failed = 0;
+
+	start = bench_stamp();
+	for (int i = 0; i < N_PKTS; i++) {
+		struct net_pkt *pkt = alloc(iface, size, cached);
+
+		if (pkt == NULL) {
+			failed++;
+			continue;
+		}
+
+		if (net_pkt_write(pkt, frame, size) < 0) {
+			failed++;
+		}
+
+		net_pkt_unref(pkt);
+	}
+	ns = bench_ns_since(start);
+
+	if (failed) {
+		printk("size %4u: %d of %d packets failed\n", size, failed,
+		       N_PKTS);
+	}
+
+	printk("size %4u %-6s: pkts/s %u\n", size, cached ? "cached" : "plain",
+	       bench_rate(N_PKTS, ns));
+}
+
+int main(void)
+{
+	struct net_if *iface = net_if_get_default();
+
+	printk("Packet allocation benchmark, %u byte buffers, RX cache %s\n",
+	       CONFIG_NET_BUF_DATA_SIZE,
+	       IS_ENABLED(CONFIG_NET_PKT_BUF_RX_CACHE) ? "on" : "off");
+
+	bench_timing_init();
+
+	for (int i = 0; i < sizeof(frame); i++) {
+		frame[i] = (uint8_t)i;
+	}
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		run(iface, sweep[s], false);
+
+		if (IS_ENABLED(CONFIG_NET_PKT_BUF_RX_CACHE)) {
+			run(iface, sweep[s], true);
+		}
+	}
+
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+	net_pkt_buf_cache_flush(&cache);
+#endif
+
+	printk("fin\n");
+	return 0;
+}
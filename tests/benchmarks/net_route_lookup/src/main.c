@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/random/random.h>
+#include <zephyr/net/net_if.h>
+
+#include "ipv6.h"
+#include "route.h"
+
+#include "bench_util.h"
+
+/* Route lookup benchmark.  Fills the routing table with random prefixes
+ * of 48 to 64 bits under 2001:db8::/32 through a single next hop, then
+ * times net_route_lookup() for addresses inside the added prefixes and
+ * for addresses outside all of them, for each table size of the sweep.
+ */
+
+#define N_LOOKUPS 10000
+
+static const uint32_t sweep[] = { 4, 16, 64, 256, 1024 };
+
+static struct net_route_entry *routes[CONFIG_NET_MAX_ROUTES];
+static struct in6_addr prefixes[CONFIG_NET_MAX_ROUTES];
+static int n_routes;
+
+static struct in6_addr nexthop = { { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static uint8_t nexthop_lladdr[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static void routes_fill(struct net_if *iface, uint32_t n)
+{
+	while (n_routes < n) {
+		struct in6_addr *prefix = &prefixes[n_routes];
+		uint8_t len = 48U + sys_rand32_get() % 17U;
+
+		/* The index in the third group keeps prefixes disjoint, so
+		 * none of them is taken for an update of another.
+		 */
+		prefix->s6_addr32[0] = htonl(0x20010db8);
+		prefix->s6_addr16[2] = htons(n_routes);
+		sys_rand_get(&prefix->s6_addr[6], 10);
+
+		routes[n_routes] = net_route_add(iface, prefix, len, &nexthop,
+						 NET_IPV6_ND_INFINITE_LIFETIME,
+						 NET_ROUTE_PREFERENCE_MEDIUM);
+		if (routes[n_routes] == NULL) {
+			printk("cannot add route %d\n", n_routes);
+			k_oops();
+		}
+
+		n_routes++;
+	}
+}
+
+static uint32_t run(struct net_if *iface, bool hit)
+{
+	struct in6_addr dst;
+	timing_t start;
+	uint64_t ns;
+	int found = 0;
+
+	start = bench_stamp();
+	for (int i = 0; i < N_LOOKUPS; i++) {
+		if (hit) {
+			/* An address in the prefix, the host bits differ */
+			dst = prefixes[i % n_routes];
+			dst.s6_addr[15] ^= (uint8_t)i;
+		} else {
+			dst.s6_addr32[0] = htonl(0x20010db9);
+			dst.s6_addr32[3] = i;
+		}
+
+		if (net_route_lookup(iface, &dst) != NULL) {
+			found++;
+		}
+	}
+	ns = bench_ns_since(start);
+
+	if (hit ? (found != N_LOOKUPS) : (found != 0)) {
+		printk("%s: %d of %d lookups found a route\n",
+		       hit ? "hit" : "miss", found, N_LOOKUPS);
+	}
+
+	return bench_rate(N_LOOKUPS, ns);
+}
+
+int main(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct net_linkaddr lladdr = {
+		.addr = nexthop_lladdr,
+		.len = sizeof(nexthop_lladdr),
+		.type = NET_LINK_ETHERNET,
+	};
+
+	printk("Route lookup benchmark, trie %s\n",
+	       IS_ENABLED(CONFIG_NET_ROUTE_TRIE) ? "on" : "off");
+
+	bench_timing_init();
+
+	if (net_ipv6_nbr_add(iface, &nexthop, &lladdr, true,
+			     NET_IPV6_NBR_STATE_REACHABLE) == NULL) {
+		printk("cannot add next hop neighbor\n");
+		return 0;
+	}
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		uint32_t n = MIN(sweep[s], CONFIG_NET_MAX_ROUTES);
+		uint32_t hits, misses;
+
+		routes_fill(iface, n);
+
+		hits = run(iface, true);
+		misses = run(iface, false);
+
+		printk("routes %4u: lookups/s %u misses/s %u\n", n, hits, misses);
+	}
+
+	printk("fin\n");
+	return 0;
+}
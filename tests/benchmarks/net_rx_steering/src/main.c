@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/net_stats.h>
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/udp.h>
+
+#include "ipv4.h"
+#include "udp_internal.h"
+#include "connection.h"
+
+#include "bench_util.h"
+
+/* RX steering benchmark.  Registers one UDP connection handler per flow
+ * on a dummy interface, each flow with its own remote port, then feeds
+ * N_PKTS IPv4 UDP packets of all the flows in turn to net_recv_data().
+ * Each handler spins for WORK_ITERS loop iterations per packet and
+ * checks the sequence number the packet carries.  Reports the rate of
+ * processed packets and the number of packets seen out of order for
+ * each flow count of the sweep.
+ */
+
+#define LOCAL_PORT  4242
+#define REMOTE_PORT 10000
+#define N_PKTS      20000
+#define WORK_ITERS  2000
+#define MAX_FLOWS   8
+#define MAX_WAIT_MS (10 * MSEC_PER_SEC)
+
+static const uint32_t sweep[] = { 1, 2, 4, 8 };
+
+static struct net_conn_handle *handles[MAX_FLOWS];
+static uint32_t next_seq[MAX_FLOWS];
+static atomic_t delivered;
+static atomic_t reordered;
+
+static struct in_addr local_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 9 } } };
+
+static uint8_t mac_addr[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static int dummy_dev_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static void dummy_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int dummy_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static struct dummy_api dummy_if_api = {
+	.iface_api.init = dummy_iface_init,
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(rx_steering_test, "rx_steering_test",
+		dummy_dev_init, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&dummy_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), NET_IPV4_MTU);
+
+static enum net_verdict conn_cb(struct net_conn *conn, struct net_pkt *pkt,
+				union net_ip_header *ip_hdr,
+				union net_proto_header *proto_hdr,
+				void *user_data)
+{
+	int flow = POINTER_TO_INT(user_data);
+	uint32_t seq = 0U;
+
+	ARG_UNUSED(conn);
+	ARG_UNUSED(ip_hdr);
+	ARG_UNUSED(proto_hdr);
+
+	net_pkt_cursor_init(pkt);
+	if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+			 sizeof(struct net_udp_hdr)) < 0 ||
+	    net_pkt_read_be32(pkt, &seq) < 0) {
+		return NET_DROP;
+	}
+
+	/* All the packets of a flow are handled by the same RX thread */
+	if (seq != next_seq[flow]) {
+		atomic_inc(&reordered);
+	}
+	next_seq[flow] = seq + 1U;
+
+	bench_spin(WORK_ITERS);
+
+	net_pkt_unref(pkt);
+	atomic_inc(&delivered);
+
+	return NET_OK;
+}
+
+static void flows_setup(uint32_t n)
+{
+	struct sockaddr_in remote = {
+		.sin_family = AF_INET,
+		.sin_addr = peer_addr,
+	};
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LOCAL_PORT),
+	};
+	int ret;
+
+	for (uint32_t i = 0; i < n; i++) {
+		remote.sin_port = htons(REMOTE_PORT + i);
+		next_seq[i] = 0U;
+
+		ret = net_conn_register(IPPROTO_UDP, AF_INET,
+					(const struct sockaddr *)&remote,
+					(const struct sockaddr *)&local,
+					REMOTE_PORT + i, LOCAL_PORT, NULL,
+					conn_cb, INT_TO_POINTER(i), &handles[i]);
+		if (ret < 0) {
+			printk("cannot register flow %u (%d)\n", i, ret);
+			k_oops();
+		}
+	}
+}
+
+static void flows_teardown(uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i++) {
+		(void)net_conn_unregister(handles[i]);
+	}
+}
+
+static void inject(struct net_if *iface, uint32_t flow, uint32_t seq)
+{
+	struct net_pkt *pkt;
+
+	/* Waiting for a packet paces us to the RX threads */
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(seq), AF_INET,
+					   IPPROTO_UDP, K_FOREVER);
+	if (pkt == NULL ||
+	    net_ipv4_create(pkt, &peer_addr, &local_addr) < 0 ||
+	    net_udp_create(pkt, htons(REMOTE_PORT + flow),
+			   htons(LOCAL_PORT)) < 0 ||
+	    net_pkt_write_be32(pkt, seq) < 0) {
+		printk("cannot create packet\n");
+		k_oops();
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	if (net_recv_data(iface, pkt) < 0) {
+		net_pkt_unref(pkt);
+	}
+}
+
+static void run(struct net_if *iface, uint32_t n)
+{
+	timing_t start;
+	uint64_t ns;
+
+	flows_setup(n);
+
+	atomic_set(&delivered, 0);
+	atomic_set(&reordered, 0);
+
+	start = bench_stamp();
+	for (uint32_t i = 0; i < N_PKTS; i++) {
+		inject(iface, i % n, i / n);
+	}
+
+	while (atomic_get(&delivered) < N_PKTS &&
+	       bench_ns_since(start) < (uint64_t)MAX_WAIT_MS * NSEC_PER_MSEC) {
+		k_msleep(1);
+	}
+	ns = bench_ns_since(start);
+
+	flows_teardown(n);
+
+	if (atomic_get(&delivered) != N_PKTS) {
+		printk("flows %u: only %ld of %u packets processed\n", n,
+		       atomic_get(&delivered), N_PKTS);
+	}
+
+	printk("flows %u: pkts/s %u reordered %ld\n", n,
+	       bench_rate(atomic_get(&delivered), ns),
+	       atomic_get(&reordered));
+}
+
+static void print_queue_stats(struct net_if *iface)
+{
+#if defined(CONFIG_NET_TC_RX_STEERING) && defined(CONFIG_NET_STATISTICS_USER_API)
+	static struct net_stats stats;
+
+	if (net_mgmt(NET_REQUEST_STATS_GET_ALL, iface, &stats,
+		     sizeof(stats)) < 0) {
+		return;
+	}
+
+	for (int i = 0; i < CONFIG_NET_TC_RX_STEERING_QUEUES; i++) {
+		printk("queue %d: pkts %u bytes %u\n", i,
+		       stats.rx_queue[i].pkts, stats.rx_queue[i].bytes);
+	}
+#else
+	ARG_UNUSED(iface);
+#endif
+}
+
+int main(void)
+{
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+
+	printk("RX steering benchmark, %u CPUs, steering %s\n",
+	       arch_num_cpus(),
+	       IS_ENABLED(CONFIG_NET_TC_RX_STEERING) ? "on" : "off");
+
+	bench_timing_init();
+
+	if (net_if_ipv4_addr_add(iface, &local_addr, NET_ADDR_MANUAL,
+				 0) == NULL) {
+		printk("cannot add address\n");
+		return 0;
+	}
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		run(iface, MIN(sweep[s], MAX_FLOWS));
+	}
+
+	print_queue_stats(iface);
+
+	printk("fin\n");
+	return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/socket.h>
+
+#include "bench_util.h"
+
+/* Batched socket I/O benchmark.  Sends batches of small datagrams from
+ * a client to a server socket over the loopback interface and receives
+ * them again, either one per zsock_sendmsg()/zsock_recvmsg() call or
+ * a batch per zsock_sendmmsg()/zsock_recvmmsg() call.  Reports the rate
+ * of datagrams moved for each batch size of the sweep.
+ */
+
+#define SERVER_PORT  4242
+#define PAYLOAD_LEN  64
+#define MAX_BATCH    32
+#define RUN_MS       1000
+
+enum mode {
+	MODE_MSG,
+	MODE_MMSG,
+	NUM_MODES
+};
+
+static const char *const mode_names[NUM_MODES] = {
+	"msg", "mmsg",
+};
+
+static const unsigned int sweep[] = { 1, 4, 8, 16, MAX_BATCH };
+
+static uint8_t tx_payload[PAYLOAD_LEN];
+static uint8_t rx_bufs[MAX_BATCH][PAYLOAD_LEN];
+static struct iovec tx_iov;
+static struct iovec rx_iov[MAX_BATCH];
+static struct mmsghdr tx_msgs[MAX_BATCH];
+static struct mmsghdr rx_msgs[MAX_BATCH];
+
+static struct sockaddr_in server_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(SERVER_PORT),
+	.sin_addr = { { { 127, 0, 0, 1 } } },
+};
+
+static void msgs_init(void)
+{
+	tx_iov.iov_base = tx_payload;
+	tx_iov.iov_len = sizeof(tx_payload);
+
+	for (int i = 0; i < MAX_BATCH; i++) {
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov;
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+		tx_msgs[i].msg_hdr.msg_name = &server_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+
+		rx_iov[i].iov_base = rx_bufs[i];
+		rx_iov[i].iov_len = sizeof(rx_bufs[i]);
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+static int send_batch(int sock, enum mode m, unsigned int n)
+{
+	if (m == MODE_MMSG) {
+		return zsock_sendmmsg(sock, tx_msgs, n, 0);
+	}
+
+	for (unsigned int i = 0; i < n; i++) {
+		if (zsock_sendmsg(sock, &tx_msgs[i].msg_hdr, 0) < 0) {
+			return i == 0 ? -1 : i;
+		}
+	}
+
+	return n;
+}
+
+static int recv_batch(int sock, enum mode m, unsigned int n)
+{
+	if (m == MODE_MMSG) {
+		return zsock_recvmmsg(sock, rx_msgs, n, ZSOCK_MSG_WAITFORONE);
+	}
+
+	if (zsock_recvmsg(sock, &rx_msgs[0].msg_hdr, 0) < 0) {
+		return -1;
+	}
+
+	return 1;
+}
+
+static void run(int client, int server, enum mode m, unsigned int batch)
+{
+	uint64_t pkts = 0U;
+	timing_t start;
+	uint64_t ns;
+	int ret;
+
+	start = bench_stamp();
+	do {
+		ret = send_batch(client, m, batch);
+		if (ret < 0) {
+			printk("send failed (%d)\n", errno);
+			k_oops();
+		}
+
+		/* Datagrams the loopback path dropped are not waited for */
+		for (int left = ret; left > 0; left -= ret) {
+			ret = recv_batch(server, m, left);
+			if (ret < 0) {
+				break;
+			}
+
+			pkts += ret;
+		}
+
+		ns = bench_ns_since(start);
+	} while (ns < RUN_MS * NSEC_PER_MSEC);
+
+	printk("%-4s batch %2u: pkts/s %u\n", mode_names[m], batch,
+	       bench_rate(pkts, ns));
+}
+
+int main(void)
+{
+	struct zsock_timeval rcvtimeo = { .tv_usec = 100 * USEC_PER_MSEC };
+	int client, server;
+
+	printk("UDP batched socket I/O benchmark, %u byte datagrams\n",
+	       PAYLOAD_LEN);
+
+	client = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	server = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (client < 0 || server < 0) {
+		printk("cannot create sockets (%d)\n", errno);
+		return 0;
+	}
+
+	if (zsock_bind(server, (struct sockaddr *)&server_addr,
+		       sizeof(server_addr)) < 0) {
+		printk("cannot bind server socket (%d)\n", errno);
+		return 0;
+	}
+
+	(void)zsock_setsockopt(server, SOL_SOCKET, SO_RCVTIMEO, &rcvtimeo,
+			       sizeof(rcvtimeo));
+
+	msgs_init();
+	bench_timing_init();
+
+	for (int m = 0; m < NUM_MODES; m++) {
+		for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+			run(client, server, m, sweep[s]);
+		}
+	}
+
+	printk("fin\n");
+	return 0;
+}
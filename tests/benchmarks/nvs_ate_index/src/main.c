@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/fs/nvs.h>
+#include <zephyr/stats/stats.h>
+#include <zephyr/storage/flash_map.h>
+
+/* NVS ATE index benchmark.  For each count of IDs of the sweep, writes all
+ * of them on an empty file system and updates each UPDATES times, then
+ * mounts the file system again and reads them back.  Reports the mount
+ * time, the average time of a read of the most recent data and of the data
+ * before, the average time of an update and the bytes garbage collection
+ * wrote during the updates.  Run on the flash simulator with timing
+ * simulation, the times follow the flash operations done by NVS.
+ */
+
+#define NVS_PARTITION FIXED_PARTITION_ID(slot1_partition)
+#define SECTOR_COUNT  16
+#define DATA_LEN      16
+#define UPDATES       4
+#define N_READS       256
+
+/* Size of an NVS allocation table entry, with the write block size of 1 of
+ * the native_sim flash.
+ */
+#define ATE_SIZE 8
+
+static const uint32_t sweep[] = { 32, 64, 128, 256 };
+
+static struct nvs_fs fs;
+static uint32_t *bytes_written;
+static uint32_t bad;
+
+static int stat_find(struct stats_hdr *hdr, void *arg, const char *name,
+		     uint16_t off)
+{
+	if (!strcmp(name, "bytes_written")) {
+		bytes_written = (uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static void fill(uint8_t *data, uint16_t id, uint32_t round)
+{
+	memset(data, (uint8_t)round, DATA_LEN);
+	memcpy(data, &id, sizeof(id));
+}
+
+static void nvs_init(void)
+{
+	const struct flash_area *fa;
+	struct flash_pages_info info;
+	int ret;
+
+	ret = flash_area_open(NVS_PARTITION, &fa);
+	if (ret < 0) {
+		printk("cannot open the flash area (%d)\n", ret);
+		k_oops();
+	}
+
+	fs.flash_device = flash_area_get_device(fa);
+	fs.offset = fa->fa_off;
+
+	ret = flash_get_page_info_by_offs(fs.flash_device, fs.offset, &info);
+	if ((ret < 0) || (info.size * SECTOR_COUNT > fa->fa_size)) {
+		printk("cannot fit %u sectors in the flash area\n", SECTOR_COUNT);
+		k_oops();
+	}
+
+	fs.sector_size = info.size;
+	fs.sector_count = SECTOR_COUNT;
+
+	flash_area_close(fa);
+}
+
+static void nvs_fill(uint32_t n)
+{
+	uint8_t data[DATA_LEN];
+	ssize_t ret;
+
+	for (uint32_t r = 0; r <= UPDATES; r++) {
+		for (uint16_t id = 0; id < n; id++) {
+			fill(data, id, r);
+
+			ret = nvs_write(&fs, id, data, sizeof(data));
+			if (ret != sizeof(data)) {
+				printk("cannot write id %u (%d)\n", id, (int)ret);
+				k_oops();
+			}
+		}
+	}
+}
+
+static uint64_t nvs_read_all(uint32_t n, uint16_t cnt)
+{
+	uint8_t data[DATA_LEN], expected[DATA_LEN];
+	uint64_t start;
+	uint16_t id;
+
+	start = k_cycle_get_64();
+	for (uint32_t i = 0; i < N_READS; i++) {
+		/* step through the ids in an order unrelated to the writes */
+		id = (i * 7U) % n;
+
+		if (nvs_read_hist(&fs, id, data, sizeof(data), cnt) != sizeof(data)) {
+			bad++;
+			continue;
+		}
+
+		fill(expected, id, UPDATES - cnt);
+		if (memcmp(data, expected, sizeof(data))) {
+			bad++;
+		}
+	}
+
+	return k_cycle_get_64() - start;
+}
+
+static void run(uint32_t n)
+{
+	uint64_t mount_cyc, read_cyc, hist_cyc, update_cyc;
+	uint32_t written, gc_bytes;
+	uint64_t start;
+	int ret;
+
+	/* start from an empty file system */
+	if (fs.ready) {
+		(void)nvs_clear(&fs);
+	}
+
+	ret = nvs_mount(&fs);
+	if (ret < 0) {
+		printk("cannot mount nvs (%d)\n", ret);
+		k_oops();
+	}
+
+	written = *bytes_written;
+	start = k_cycle_get_64();
+	nvs_fill(n);
+	update_cyc = k_cycle_get_64() - start;
+
+	/* beyond the entries themselves, gc wrote the data it moved and the
+	 * ATEs closing the sectors.
+	 */
+	gc_bytes = *bytes_written - written - n * (UPDATES + 1) * (DATA_LEN + ATE_SIZE);
+
+	start = k_cycle_get_64();
+	ret = nvs_mount(&fs);
+	mount_cyc = k_cycle_get_64() - start;
+	if (ret < 0) {
+		printk("cannot mount nvs again (%d)\n", ret);
+		k_oops();
+	}
+
+	bad = 0U;
+	read_cyc = nvs_read_all(n, 0);
+	hist_cyc = nvs_read_all(n, 1);
+
+	if (bad != 0U) {
+		printk("ids %u: %u bad reads\n", n, bad);
+	}
+
+	printk("ids %4u: mount %6u us read %4u us hist %5u us update %5u us gc %6u B\n",
+	       n, (uint32_t)k_cyc_to_us_floor64(mount_cyc),
+	       (uint32_t)k_cyc_to_us_floor64(read_cyc / N_READS),
+	       (uint32_t)k_cyc_to_us_floor64(hist_cyc / N_READS),
+	       (uint32_t)k_cyc_to_us_floor64(update_cyc / (n * (UPDATES + 1))),
+	       gc_bytes);
+}
+
+int main(void)
+{
+	struct stats_hdr *sim_stats;
+
+	printk("NVS ATE index benchmark, %s\n",
+	       IS_ENABLED(CONFIG_NVS_ATE_INDEX) ? "ate index" :
+	       IS_ENABLED(CONFIG_NVS_LOOKUP_CACHE) ? "lookup cache" : "ate walk");
+
+	sim_stats = stats_group_find("flash_sim_stats");
+	if (sim_stats != NULL) {
+		stats_walk(sim_stats, stat_find, NULL);
+	}
+
+	if (bytes_written == NULL) {
+		printk("no flash simulator statistics\n");
+		return 0;
+	}
+
+	nvs_init();
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		run(sweep[s]);
+	}
+
+	printk("fin\n");
+	return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "bench_util.h"
+
+/* Ready queue backend microbenchmark.  The main thread creates a
+ * number of threads at one lower priority, so they all sit in the
+ * ready queue without ever running, each with its own deadline when
+ * CONFIG_SCHED_DEADLINE is enabled.  It then repeatedly suspends one
+ * of them (a ready queue removal plus a best-thread pick) and resumes
+ * it with a new deadline (an insertion plus a best-thread pick),
+ * reporting the average time of each step, in nanoseconds, as the
+ * number of queued threads grows.  Build it with each of SCHED_DUMB,
+ * SCHED_SCALABLE and SCHED_MULTIQ to compare them.
+ */
+
+#define MAX_THREADS 64
+#define STACK_SIZE  (512 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define N_RUNS      1000
+#define N_SETTLE    10
+
+static const int sweep[] = { 1, 4, 16, 32, MAX_THREADS };
+
+static struct k_thread threads[MAX_THREADS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+
+static uint32_t seed = 1U;
+
+static uint32_t next_rand(void)
+{
+	seed = seed * 1664525U + 1013904223U;
+	return seed;
+}
+
+static void set_deadline(k_tid_t thread)
+{
+#ifdef CONFIG_SCHED_DEADLINE
+	/* Positive and well below 2^31, as the API requires */
+	k_thread_deadline_set(thread, 1 + (next_rand() >> 8));
+#else
+	ARG_UNUSED(thread);
+#endif
+}
+
+static void never_runs(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	printk("queued thread ran unexpectedly\n");
+}
+
+int main(void)
+{
+	/* Must be able to outrank the queued threads */
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+
+	bench_timing_init();
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		int n = sweep[s];
+		uint64_t suspend_tot = 0U, resume_tot = 0U;
+
+		for (int i = 0; i < n; i++) {
+			k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+					never_runs, NULL, NULL, NULL,
+					prio, 0, K_NO_WAIT);
+			set_deadline(&threads[i]);
+		}
+
+		for (int i = 0; i < N_RUNS + N_SETTLE; i++) {
+			k_tid_t thread = &threads[next_rand() % n];
+			timing_t t0, t1, t2, t3;
+
+			t0 = bench_stamp();
+			k_thread_suspend(thread);
+			t1 = bench_stamp();
+
+			/* Not queued while suspended, so this is cheap */
+			set_deadline(thread);
+
+			t2 = bench_stamp();
+			k_thread_resume(thread);
+			t3 = bench_stamp();
+
+			if (i >= N_SETTLE) {
+				suspend_tot += timing_cycles_get(&t0, &t1);
+				resume_tot += timing_cycles_get(&t2, &t3);
+			}
+		}
+
+		for (int i = 0; i < n; i++) {
+			k_thread_abort(&threads[i]);
+		}
+
+		printk("threads %3d: suspend %6u ns resume %6u ns\n", n,
+		       (uint32_t)timing_cycles_to_ns_avg(suspend_tot, N_RUNS),
+		       (uint32_t)timing_cycles_to_ns_avg(resume_tot, N_RUNS));
+	}
+
+	printk("fin\n");
+	return 0;
+}
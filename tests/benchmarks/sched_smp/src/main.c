@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "bench_util.h"
+
+/* SMP context switch throughput benchmark.  Each "pair" is two
+ * threads ping-ponging through two semaphores, so every round trip
+ * forces two context switches.  The benchmark runs with 1, 2, ... up
+ * to arch_num_cpus() pairs switching concurrently and reports the
+ * aggregate switch rate for each step, which shows how the scheduler
+ * scales as more cores contend on the ready queue(s).
+ */
+
+#define MAX_PAIRS   CONFIG_MP_MAX_NUM_CPUS
+#define STACK_SIZE  (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define PAIR_PRIO   K_PRIO_PREEMPT(5)
+#define RUN_MS      1000
+
+struct pair {
+	struct k_sem ping;
+	struct k_sem pong;
+	uint32_t round_trips;
+};
+
+static struct pair pairs[MAX_PAIRS];
+static struct k_thread threads[MAX_PAIRS * 2];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_PAIRS * 2, STACK_SIZE);
+
+static void pinger(void *p1, void *p2, void *p3)
+{
+	struct pair *pair = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_give(&pair->ping);
+		k_sem_take(&pair->pong, K_FOREVER);
+		pair->round_trips++;
+	}
+}
+
+static void ponger(void *p1, void *p2, void *p3)
+{
+	struct pair *pair = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&pair->ping, K_FOREVER);
+		k_sem_give(&pair->pong);
+	}
+}
+
+static void start_pair(int i)
+{
+	k_thread_entry_t entry[2] = { pinger, ponger };
+
+	k_sem_init(&pairs[i].ping, 0, 1);
+	k_sem_init(&pairs[i].pong, 0, 1);
+	pairs[i].round_trips = 0U;
+
+	for (int j = 0; j < 2; j++) {
+		bench_thread_start(&threads[i * 2 + j], stacks[i * 2 + j],
+				   STACK_SIZE, entry[j], &pairs[i], PAIR_PRIO, i);
+	}
+}
+
+static void stop_pair(int i)
+{
+	for (int j = 0; j < 2; j++) {
+		k_thread_abort(&threads[i * 2 + j]);
+	}
+}
+
+int main(void)
+{
+	unsigned int num_cpus = arch_num_cpus();
+
+	printk("SMP scheduler benchmark, %u CPUs\n", num_cpus);
+
+	bench_timing_init();
+
+	for (unsigned int n = 1; n <= num_cpus; n++) {
+		uint64_t total = 0U;
+		uint64_t ns;
+
+		for (unsigned int i = 0; i < n; i++) {
+			start_pair(i);
+		}
+
+		ns = bench_window(RUN_MS);
+
+		for (unsigned int i = 0; i < n; i++) {
+			stop_pair(i);
+			total += pairs[i].round_trips;
+		}
+
+		/* Two context switches per round trip */
+		uint32_t rate = bench_rate(total * 2U, ns);
+
+		printk("pairs %u: switches/s %u per pair %u\n",
+		       n, rate, rate / n);
+	}
+
+	printk("fin\n");
+	return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/settings/settings.h>
+
+/* Settings dispatch benchmark.  Defines N_STATIC static handlers and
+ * registers more dynamic handlers for each count of the sweep, then hands
+ * one setting per handler to settings_call_set_handler(), as a storage
+ * back-end does for each setting it loads.  Reports the time of such a
+ * load of all the settings and the rate of handler lookups.
+ */
+
+#define N_STATIC    256
+#define MAX_DYNAMIC 256
+#define N_ROUNDS    10
+
+static const uint32_t sweep[] = { 0, 64, 128, 256 };
+
+static uint32_t set_calls;
+
+static int bench_set(const char *key, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	ARG_UNUSED(key);
+	ARG_UNUSED(len);
+	ARG_UNUSED(read_cb);
+	ARG_UNUSED(cb_arg);
+
+	set_calls++;
+
+	return 0;
+}
+
+#define STATIC_HANDLER(i, _) \
+	SETTINGS_STATIC_HANDLER_DEFINE(s##i, "s" #i, NULL, bench_set, NULL, NULL)
+
+LISTIFY(N_STATIC, STATIC_HANDLER, (;));
+
+static struct settings_handler handlers[MAX_DYNAMIC];
+static char names[MAX_DYNAMIC][8];
+static char keys[N_STATIC + MAX_DYNAMIC][16];
+static uint32_t n_dynamic;
+
+static ssize_t read_fn(void *cb_arg, void *data, size_t len)
+{
+	ARG_UNUSED(cb_arg);
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+
+	return 0;
+}
+
+static void handlers_add(uint32_t n)
+{
+	int ret;
+
+	for (; n_dynamic < n; n_dynamic++) {
+		snprintk(names[n_dynamic], sizeof(names[n_dynamic]), "d%u",
+			 n_dynamic);
+		snprintk(keys[N_STATIC + n_dynamic], sizeof(keys[0]), "d%u/val",
+			 n_dynamic);
+
+		handlers[n_dynamic].name = names[n_dynamic];
+		handlers[n_dynamic].h_set = bench_set;
+
+		ret = settings_register(&handlers[n_dynamic]);
+		if (ret < 0) {
+			printk("cannot register handler %u (%d)\n", n_dynamic, ret);
+			k_oops();
+		}
+	}
+}
+
+static void run(uint32_t n)
+{
+	uint32_t n_keys, start, cyc;
+
+	handlers_add(n);
+	n_keys = N_STATIC + n_dynamic;
+
+	set_calls = 0U;
+
+	start = k_cycle_get_32();
+	for (int r = 0; r < N_ROUNDS; r++) {
+		for (uint32_t i = 0; i < N_STATIC; i++) {
+			(void)settings_call_set_handler(keys[i], 0, read_fn,
+							NULL, NULL);
+		}
+
+		for (uint32_t i = 0; i < n_dynamic; i++) {
+			(void)settings_call_set_handler(keys[N_STATIC + i], 0,
+							read_fn, NULL, NULL);
+		}
+	}
+	cyc = k_cycle_get_32() - start;
+
+	if (set_calls != n_keys * N_ROUNDS) {
+		printk("handlers %u: %u of %u settings dispatched\n", n_keys,
+		       set_calls, n_keys * N_ROUNDS);
+	}
+
+	printk("handlers %4u: load %u us lookups/s %u\n", n_keys,
+	       (uint32_t)k_cyc_to_us_floor64(cyc / N_ROUNDS),
+	       (uint32_t)(((uint64_t)n_keys * N_ROUNDS *
+			   sys_clock_hw_cycles_per_sec()) / MAX(cyc, 1U)));
+}
+
+int main(void)
+{
+	int ret;
+
+	printk("Settings dispatch benchmark, handler index %s\n",
+	       IS_ENABLED(CONFIG_SETTINGS_HANDLER_INDEX) ? "on" : "off");
+
+	ret = settings_subsys_init();
+	if (ret < 0) {
+		printk("cannot initialize settings (%d)\n", ret);
+		return 0;
+	}
+
+	for (uint32_t i = 0; i < N_STATIC; i++) {
+		snprintk(keys[i], sizeof(keys[0]), "s%u/val", i);
+	}
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		run(MIN(sweep[s], MAX_DYNAMIC));
+	}
+
+	printk("fin\n");
+	return 0;
+}
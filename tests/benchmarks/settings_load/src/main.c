@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/storage/flash_map.h>
+
+/* Settings load benchmark.  Stores settings of 4 bytes under "bench/"
+ * until there are as many as the count of the sweep, then times a
+ * settings_load() of all of them, like the one done at boot.  Reports the
+ * load time and the average time of a save for each count.  Run on the
+ * flash simulator with timing simulation, the times follow the flash
+ * operations of the storage back-end.
+ */
+
+#if DT_HAS_CHOSEN(zephyr_settings_partition)
+#define SETTINGS_PARTITION DT_FIXED_PARTITION_ID(DT_CHOSEN(zephyr_settings_partition))
+#else
+#define SETTINGS_PARTITION FIXED_PARTITION_ID(storage_partition)
+#endif
+
+#define VALUE_MAGIC 0x5a5a0000U
+
+static const uint32_t sweep[] = { 250, 500, 1000, 2000 };
+
+static uint32_t n_items;
+static uint32_t loaded;
+static uint32_t bad;
+
+static int bench_set(const char *name, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	uint32_t value;
+
+	if ((len != sizeof(value)) ||
+	    (read_cb(cb_arg, &value, sizeof(value)) != sizeof(value)) ||
+	    (value != (VALUE_MAGIC | strtoul(name, NULL, 10)))) {
+		bad++;
+		return 0;
+	}
+
+	loaded++;
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bench, "bench", NULL, bench_set, NULL, NULL);
+
+static const char *backend_name(void)
+{
+	if (IS_ENABLED(CONFIG_SETTINGS_NVS_HASH)) {
+		return "nvs hash";
+	}
+
+	if (IS_ENABLED(CONFIG_SETTINGS_NVS)) {
+		return "nvs";
+	}
+
+	return "fcb";
+}
+
+static void storage_erase(void)
+{
+	const struct flash_area *fa;
+
+	if (flash_area_open(SETTINGS_PARTITION, &fa) < 0 ||
+	    flash_area_erase(fa, 0, fa->fa_size) < 0) {
+		printk("cannot erase the settings partition\n");
+		k_oops();
+	}
+
+	flash_area_close(fa);
+}
+
+static uint64_t fill(uint32_t n)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t value;
+	uint64_t start;
+	int ret;
+
+	start = k_cycle_get_64();
+	for (; n_items < n; n_items++) {
+		snprintk(name, sizeof(name), "bench/%u", n_items);
+		value = VALUE_MAGIC | n_items;
+
+		ret = settings_save_one(name, &value, sizeof(value));
+		if (ret < 0) {
+			printk("cannot save %s (%d)\n", name, ret);
+			k_oops();
+		}
+	}
+
+	return k_cycle_get_64() - start;
+}
+
+static void run(uint32_t n)
+{
+	uint32_t added = n - n_items;
+	uint64_t save_cyc, load_cyc;
+	uint64_t start;
+
+	save_cyc = fill(n);
+
+	loaded = 0U;
+	bad = 0U;
+
+	start = k_cycle_get_64();
+	(void)settings_load();
+	load_cyc = k_cycle_get_64() - start;
+
+	if (loaded != n || bad != 0U) {
+		printk("settings %u: loaded %u, %u bad\n", n, loaded, bad);
+	}
+
+	printk("settings %4u: load %u us save %u us/item\n", n,
+	       (uint32_t)k_cyc_to_us_floor64(load_cyc),
+	       (uint32_t)k_cyc_to_us_floor64(save_cyc / MAX(added, 1U)));
+}
+
+int main(void)
+{
+	int ret;
+
+	printk("Settings load benchmark, %s back-end\n", backend_name());
+
+	storage_erase();
+
+	ret = settings_subsys_init();
+	if (ret < 0) {
+		printk("cannot initialize settings (%d)\n", ret);
+		return 0;
+	}
+
+	/* The first load of an empty storage, lets the back-ends which
+	 * cache names know they have seen all of them.
+	 */
+	(void)settings_load();
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		run(sweep[s]);
+	}
+
+	printk("fin\n");
+	return 0;
+}
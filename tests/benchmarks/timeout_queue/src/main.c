@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <timeout_q.h>
+
+#include "bench_util.h"
+
+/* Timeout queue microbenchmark.  Fills the kernel timeout queue with
+ * an increasing number of pending timeouts, spread pseudo-randomly far
+ * enough in the future that none of them expires during the run, and
+ * then measures the average time, in nanoseconds, of adding and
+ * aborting one more timeout with an expiry drawn from the same
+ * distribution.  With the sorted delta
+ * list the cost grows linearly with the number of pending timeouts,
+ * with the timing wheel it should stay flat.
+ */
+
+#define MAX_PENDING 2048
+#define N_RUNS      1000
+#define N_SETTLE    10
+
+/* Expiries land between FAR_TICKS and FAR_TICKS + SPREAD_TICKS */
+#define FAR_TICKS    1000000
+#define SPREAD_TICKS 1000000
+
+static const int sweep[] = { 0, 16, 64, 256, 1024, MAX_PENDING };
+
+static struct _timeout pending[MAX_PENDING];
+static struct _timeout probe;
+
+static uint32_t seed = 1U;
+
+static uint32_t next_rand(void)
+{
+	/* Numerical Recipes LCG, good enough to spread expiries */
+	seed = seed * 1664525U + 1013904223U;
+	return seed;
+}
+
+static k_timeout_t far_timeout(void)
+{
+	return K_TICKS(FAR_TICKS + (next_rand() % SPREAD_TICKS));
+}
+
+static void expired(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+
+	printk("unexpected timeout expiry\n");
+}
+
+int main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(pending); i++) {
+		z_init_timeout(&pending[i]);
+	}
+	z_init_timeout(&probe);
+
+	bench_timing_init();
+
+	for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+		uint64_t add_tot = 0U, abort_tot = 0U;
+
+		for (int i = 0; i < sweep[s]; i++) {
+			z_add_timeout(&pending[i], expired, far_timeout());
+		}
+
+		for (int i = 0; i < N_RUNS + N_SETTLE; i++) {
+			k_timeout_t timeout = far_timeout();
+			timing_t t0, t1, t2;
+
+			t0 = bench_stamp();
+			z_add_timeout(&probe, expired, timeout);
+			t1 = bench_stamp();
+			z_abort_timeout(&probe);
+			t2 = bench_stamp();
+
+			/* Let caches settle before averaging */
+			if (i >= N_SETTLE) {
+				add_tot += timing_cycles_get(&t0, &t1);
+				abort_tot += timing_cycles_get(&t1, &t2);
+			}
+		}
+
+		for (int i = 0; i < sweep[s]; i++) {
+			z_abort_timeout(&pending[i]);
+		}
+
+		printk("pending %5d: add %6u ns abort %6u ns\n", sweep[s],
+		       (uint32_t)timing_cycles_to_ns_avg(add_tot, N_RUNS),
+		       (uint32_t)timing_cycles_to_ns_avg(abort_tot, N_RUNS));
+	}
+
+	printk("fin\n");
+	return 0;
+}
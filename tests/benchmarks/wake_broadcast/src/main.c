@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+/* Broadcast wakeup benchmark.  A number of waiter threads block on one
+ * object and the main thread releases all of them with a single call,
+ * for a condition variable, an event object and a poll signal.  For
+ * each step of the sweep it reports the average cycle count of the
+ * broadcast call and of the time until the last waiter runs again.
+ */
+
+#define MAX_WAITERS 64
+#define STACK_SIZE  (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define N_RUNS      100
+#define N_SETTLE    5
+
+enum mode {
+	MODE_CONDVAR,
+	MODE_EVENT,
+	MODE_POLL,
+	NUM_MODES
+};
+
+static const char *const mode_names[NUM_MODES] = {
+	"condvar", "event", "poll",
+};
+
+static const int sweep[] = { 1, 4, 16, 32, MAX_WAITERS };
+
+static struct k_thread threads[MAX_WAITERS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_WAITERS, STACK_SIZE);
+
+static K_MUTEX_DEFINE(mutex);
+static K_CONDVAR_DEFINE(condvar);
+static K_EVENT_DEFINE(event);
+static struct k_poll_signal poll_signal;
+
+static K_SEM_DEFINE(done, 0, 1);
+static K_SEM_DEFINE(rearm, 0, MAX_WAITERS);
+
+static enum mode mode;
+static int num_waiters;
+static uint32_t generation;
+static atomic_t waiting;
+static atomic_t woken;
+static uint32_t last_stamp;
+
+static inline uint32_t stamp(void)
+{
+	uint32_t t;
+
+	/* The TSC runs in lockstep on all the emulated CPUs, so stamps
+	 * taken on different CPUs can be compared.
+	 */
+#ifdef CONFIG_X86
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+#else
+	t = k_cycle_get_32();
+#endif
+	return t;
+}
+
+static void wait_broadcast(void)
+{
+	struct k_poll_event poll_event;
+	uint32_t gen;
+
+	switch (mode) {
+	case MODE_CONDVAR:
+		k_mutex_lock(&mutex, K_FOREVER);
+		gen = generation;
+		atomic_inc(&waiting);
+		while (gen == generation) {
+			k_condvar_wait(&condvar, &mutex, K_FOREVER);
+		}
+		k_mutex_unlock(&mutex);
+		break;
+	case MODE_EVENT:
+		atomic_inc(&waiting);
+		(void)k_event_wait(&event, BIT(0), false, K_FOREVER);
+		break;
+	case MODE_POLL:
+		k_poll_event_init(&poll_event, K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, &poll_signal);
+		atomic_inc(&waiting);
+		(void)k_poll(&poll_event, 1, K_FOREVER);
+		break;
+	default:
+		break;
+	}
+}
+
+static void broadcast(void)
+{
+	switch (mode) {
+	case MODE_CONDVAR:
+		k_mutex_lock(&mutex, K_FOREVER);
+		generation++;
+		k_condvar_broadcast(&condvar);
+		k_mutex_unlock(&mutex);
+		break;
+	case MODE_EVENT:
+		k_event_post(&event, BIT(0));
+		break;
+	case MODE_POLL:
+		k_poll_signal_raise(&poll_signal, 0);
+		break;
+	default:
+		break;
+	}
+}
+
+static void rearm_broadcast(void)
+{
+	k_event_clear(&event, BIT(0));
+	k_poll_signal_reset(&poll_signal);
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		wait_broadcast();
+
+		if (atomic_inc(&woken) == num_waiters - 1) {
+			last_stamp = stamp();
+			k_sem_give(&done);
+		}
+
+		k_sem_take(&rearm, K_FOREVER);
+	}
+}
+
+static void run(enum mode m, int n)
+{
+	/* Lower than main(), so a broadcast returns before the waiters
+	 * get to run on this CPU
+	 */
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+	uint64_t wake_tot = 0U, last_tot = 0U;
+
+	mode = m;
+	num_waiters = n;
+	atomic_set(&waiting, 0);
+	atomic_set(&woken, 0);
+	k_sem_reset(&done);
+	k_sem_reset(&rearm);
+	rearm_broadcast();
+
+	for (int i = 0; i < n; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				waiter, NULL, NULL, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < N_RUNS + N_SETTLE; i++) {
+		uint32_t t0, t1;
+
+		/* Wait for every waiter to be blocked again */
+		while (atomic_get(&waiting) < n) {
+			k_msleep(1);
+		}
+		k_msleep(1);
+
+		t0 = stamp();
+		broadcast();
+		t1 = stamp();
+
+		k_sem_take(&done, K_FOREVER);
+
+		if (i >= N_SETTLE) {
+			wake_tot += t1 - t0;
+			last_tot += last_stamp - t0;
+		}
+
+		rearm_broadcast();
+		atomic_set(&waiting, 0);
+		atomic_set(&woken, 0);
+		for (int j = 0; j < n; j++) {
+			k_sem_give(&rearm);
+		}
+	}
+
+	for (int i = 0; i < n; i++) {
+		k_thread_abort(&threads[i]);
+	}
+
+	printk("%-7s waiters %3d wake %7u last %7u\n", mode_names[m], n,
+	       (uint32_t)(wake_tot / N_RUNS), (uint32_t)(last_tot / N_RUNS));
+}
+
+int main(void)
+{
+	k_poll_signal_init(&poll_signal);
+
+	printk("Broadcast wakeup benchmark, %u CPUs\n", arch_num_cpus());
+
+	for (int m = 0; m < NUM_MODES; m++) {
+		for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+			run(m, sweep[s]);
+		}
+	}
+
+	printk("fin\n");
+	return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/p4wq.h>
+#include <zephyr/sys/printk.h>
+
+#include "bench_util.h"
+
+/* Work queue throughput benchmark.  The main thread submits batches of
+ * independent work items to the system work queue, to a work queue pool
+ * and to a P4 work queue, and waits for each batch to complete.  Every
+ * item runs a compute loop of a given length.  For each backend and
+ * loop length it reports the number of items completed per second.
+ */
+
+#define MAX_WORKERS CONFIG_MP_MAX_NUM_CPUS
+#define STACK_SIZE  (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define WORKER_PRIO K_PRIO_PREEMPT(5)
+#define BATCH       64
+#define RUN_MS      1000
+
+enum backend {
+	BACKEND_SYSWQ,
+	BACKEND_POOL,
+	BACKEND_P4WQ,
+	NUM_BACKENDS
+};
+
+static const char *const backend_names[NUM_BACKENDS] = {
+	"syswq", "pool", "p4wq",
+};
+
+static const uint32_t sweep[] = { 0, 100, 1000, 10000 };
+
+struct item {
+	struct k_work work;
+	struct k_p4wq_work p4work;
+};
+
+static struct item items[BATCH];
+
+K_WORK_POOL_DEFINE(pool, MAX_WORKERS, STACK_SIZE);
+K_P4WQ_DEFINE(p4wq, MAX_WORKERS, STACK_SIZE);
+
+static K_SEM_DEFINE(batch_done, 0, 1);
+static atomic_t pending;
+static uint32_t work_iters;
+
+static void work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	bench_spin(work_iters);
+	if (atomic_dec(&pending) == 1) {
+		k_sem_give(&batch_done);
+	}
+}
+
+static void p4_handler(struct k_p4wq_work *work)
+{
+	ARG_UNUSED(work);
+
+	bench_spin(work_iters);
+}
+
+static void run_batch(enum backend b)
+{
+	if (b == BACKEND_P4WQ) {
+		for (int i = 0; i < BATCH; i++) {
+			items[i].p4work.deadline = 0;
+			k_p4wq_submit(&p4wq, &items[i].p4work);
+		}
+		for (int i = 0; i < BATCH; i++) {
+			(void)k_p4wq_wait(&items[i].p4work, K_FOREVER);
+		}
+		return;
+	}
+
+	atomic_set(&pending, BATCH);
+	for (int i = 0; i < BATCH; i++) {
+		if (b == BACKEND_SYSWQ) {
+			(void)k_work_submit(&items[i].work);
+		} else {
+			(void)k_work_submit_to_pool(&pool, &items[i].work);
+		}
+	}
+	k_sem_take(&batch_done, K_FOREVER);
+}
+
+static void run(enum backend b, uint32_t iters)
+{
+	uint32_t workers = (b == BACKEND_SYSWQ) ? 1U : MAX_WORKERS;
+	uint64_t total = 0U;
+	timing_t start;
+	uint64_t ns;
+
+	work_iters = iters;
+
+	/* Warm up */
+	run_batch(b);
+
+	start = bench_stamp();
+	do {
+		run_batch(b);
+		total += BATCH;
+		ns = bench_ns_since(start);
+	} while (ns < RUN_MS * NSEC_PER_MSEC);
+
+	printk("%-5s workers %u work %5u: items/s %u\n", backend_names[b],
+	       workers, iters, bench_rate(total, ns));
+}
+
+int main(void)
+{
+	for (int i = 0; i < BATCH; i++) {
+		k_work_init(&items[i].work, work_handler);
+		items[i].p4work.priority = WORKER_PRIO;
+		items[i].p4work.handler = p4_handler;
+		items[i].p4work.sync = true;
+	}
+
+	k_work_pool_start(&pool, WORKER_PRIO, NULL);
+
+	printk("Work queue pool benchmark, %u CPUs\n", arch_num_cpus());
+
+	bench_timing_init();
+
+	for (int b = 0; b < NUM_BACKENDS; b++) {
+		for (int s = 0; s < ARRAY_SIZE(sweep); s++) {
+			run(b, sweep[s]);
+		}
+	}
+
+	printk("fin\n");
+	return 0;
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/storage/disk_access.h>
+
+#if DT_HAS_COMPAT_STATUS_OKAY(zephyr_flash_disk)
+#define DISK_NAME "NAND"
+#else
+#define DISK_NAME "RAM"
+#endif
+
+#define SECTOR_SIZE 512
+#define BURST       CONFIG_DISK_CACHE_BURST
+#define BLOCKS      CONFIG_DISK_CACHE_BLOCKS
+
+/* Each test uses its own sectors, so that what an earlier test left in the
+ * cache does not change the statistics.
+ */
+#define LARGE_START  0
+#define WB_START     24
+#define EVICT_START  32
+#define RA_START     80
+#define HIT_START    120
+
+static const char *disk_pdrv = DISK_NAME;
+static uint8_t wbuf[2 * BLOCKS * SECTOR_SIZE];
+static uint8_t rbuf[2 * BLOCKS * SECTOR_SIZE];
+
+static void fill(uint8_t *buf, uint32_t sector, uint32_t num, uint8_t seed)
+{
+	for (uint32_t i = 0; i < num * SECTOR_SIZE; i++) {
+		buf[i] = (uint8_t)(sector + i / SECTOR_SIZE) ^ seed ^ (uint8_t)i;
+	}
+}
+
+static struct disk_cache_stats stats_get(void)
+{
+	struct disk_cache_stats stats;
+	int rc;
+
+	rc = disk_access_cache_stats_get(disk_pdrv, &stats);
+	zassert_equal(rc, 0, "Failed to get cache statistics");
+
+	return stats;
+}
+
+static void *disk_cache_setup(void)
+{
+	uint32_t sector_size;
+	int rc;
+
+	rc = disk_access_init(disk_pdrv);
+	zassert_equal(rc, 0, "Disk access initialization failed");
+
+	rc = disk_access_ioctl(disk_pdrv, DISK_IOCTL_GET_SECTOR_SIZE, &sector_size);
+	zassert_equal(rc, 0, "Disk ioctl get sector size failed");
+	zassert_equal(sector_size, SECTOR_SIZE, "Unexpected sector size");
+
+	return NULL;
+}
+
+static void disk_cache_before(void *fixture)
+{
+	int rc;
+
+	ARG_UNUSED(fixture);
+
+	rc = disk_access_ioctl(disk_pdrv, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(rc, 0, "Disk sync failed");
+
+	rc = disk_access_cache_stats_reset(disk_pdrv);
+	zassert_equal(rc, 0, "Failed to reset cache statistics");
+}
+
+ZTEST_SUITE(disk_cache, NULL, disk_cache_setup, disk_cache_before, NULL, NULL);
+
+/* Reading a sector again is served by the cache */
+ZTEST(disk_cache, test_read_hit)
+{
+	struct disk_cache_stats stats;
+	int rc;
+
+	rc = disk_access_read(disk_pdrv, rbuf, HIT_START, 1);
+	zassert_equal(rc, 0, "Failed to read");
+
+	rc = disk_access_cache_stats_reset(disk_pdrv);
+	zassert_equal(rc, 0, "Failed to reset cache statistics");
+
+	rc = disk_access_read(disk_pdrv, wbuf, HIT_START, 1);
+	zassert_equal(rc, 0, "Failed to read");
+	zassert_mem_equal(rbuf, wbuf, SECTOR_SIZE, "Cached sector differs");
+
+	stats = stats_get();
+	zassert_equal(stats.hits, 1, "Sector not read from the cache");
+	zassert_equal(stats.misses, 0, "Sector read from the disk");
+}
+
+/* Sequential reads of single sectors read the following ones ahead */
+ZTEST(disk_cache, test_read_ahead)
+{
+	struct disk_cache_stats stats;
+	const uint32_t num = 4 * BURST;
+	int rc;
+
+	/* Not sequential to anything read before, makes the next read so */
+	rc = disk_access_read(disk_pdrv, rbuf, RA_START - 1, 1);
+	zassert_equal(rc, 0, "Failed to read");
+
+	rc = disk_access_cache_stats_reset(disk_pdrv);
+	zassert_equal(rc, 0, "Failed to reset cache statistics");
+
+	for (uint32_t i = 0; i < num; i++) {
+		rc = disk_access_read(disk_pdrv, rbuf, RA_START + i, 1);
+		zassert_equal(rc, 0, "Failed to read");
+	}
+
+	stats = stats_get();
+	if (IS_ENABLED(CONFIG_DISK_CACHE_READ_AHEAD)) {
+		zassert_equal(stats.misses, num / BURST, "Unexpected misses");
+		zassert_equal(stats.read_ahead, (num / BURST) * (BURST - 1),
+			      "Unexpected sectors read ahead");
+		zassert_equal(stats.hits, num - num / BURST, "Unexpected hits");
+	} else {
+		zassert_equal(stats.misses, num, "Unexpected misses");
+	}
+
+	TC_PRINT("%u sequential reads: %u hits, %u misses\n", num, stats.hits,
+		 stats.misses);
+}
+
+/* Writes are kept in the cache and written back on sync, as one command */
+ZTEST(disk_cache, test_write_back)
+{
+	struct disk_cache_stats stats;
+	int rc;
+
+	fill(wbuf, WB_START, BURST, 0x5a);
+	for (uint32_t i = 0; i < BURST; i++) {
+		rc = disk_access_write(disk_pdrv, &wbuf[i * SECTOR_SIZE], WB_START + i, 1);
+		zassert_equal(rc, 0, "Failed to write");
+	}
+
+	stats = stats_get();
+	if (IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK)) {
+		zassert_equal(stats.written, 0, "Sectors written before sync");
+	} else {
+		zassert_equal(stats.written, BURST, "Sectors not written through");
+		zassert_equal(stats.write_cmds, BURST, "Unexpected write commands");
+	}
+
+	rc = disk_access_read(disk_pdrv, rbuf, WB_START, BURST);
+	zassert_equal(rc, 0, "Failed to read");
+	zassert_mem_equal(rbuf, wbuf, BURST * SECTOR_SIZE, "Read data differs");
+
+	rc = disk_access_ioctl(disk_pdrv, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(rc, 0, "Disk sync failed");
+
+	stats = stats_get();
+	zassert_equal(stats.written, BURST, "Sectors not written on sync");
+	if (IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK)) {
+		zassert_equal(stats.write_cmds, 1, "Sectors not written at once");
+	}
+}
+
+/* Sectors evicted from the cache reach the disk */
+ZTEST(disk_cache, test_eviction)
+{
+	const uint32_t num = 2 * BLOCKS;
+	int rc;
+
+	fill(wbuf, EVICT_START, num, 0xa5);
+	for (uint32_t i = 0; i < num; i++) {
+		rc = disk_access_write(disk_pdrv, &wbuf[i * SECTOR_SIZE], EVICT_START + i, 1);
+		zassert_equal(rc, 0, "Failed to write");
+	}
+
+	/* Too large for the cache, read from the disk */
+	memset(rbuf, 0, sizeof(rbuf));
+	rc = disk_access_read(disk_pdrv, rbuf, EVICT_START, num);
+	zassert_equal(rc, 0, "Failed to read");
+	zassert_mem_equal(rbuf, wbuf, num * SECTOR_SIZE, "Read data differs");
+
+	rc = disk_access_ioctl(disk_pdrv, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(rc, 0, "Disk sync failed");
+
+	memset(rbuf, 0, sizeof(rbuf));
+	rc = disk_access_read(disk_pdrv, rbuf, EVICT_START, num);
+	zassert_equal(rc, 0, "Failed to read");
+	zassert_mem_equal(rbuf, wbuf, num * SECTOR_SIZE, "Read data differs after sync");
+}
+
+/* Requests too large for the cache see, and update, the cached sectors */
+ZTEST(disk_cache, test_large_requests)
+{
+	const uint32_t num = BLOCKS;
+	int rc;
+
+	fill(wbuf, LARGE_START, num, 0x11);
+	rc = disk_access_write(disk_pdrv, wbuf, LARGE_START, num);
+	zassert_equal(rc, 0, "Failed to write");
+
+	/* Cached and, with write-back, not on the disk yet */
+	fill(&wbuf[2 * SECTOR_SIZE], LARGE_START + 2, 1, 0x22);
+	rc = disk_access_write(disk_pdrv, &wbuf[2 * SECTOR_SIZE], LARGE_START + 2, 1);
+	zassert_equal(rc, 0, "Failed to write");
+
+	rc = disk_access_read(disk_pdrv, rbuf, LARGE_START, num);
+	zassert_equal(rc, 0, "Failed to read");
+	zassert_mem_equal(rbuf, wbuf, num * SECTOR_SIZE, "Cached sector not read");
+
+	/* Overwrites the cached sector */
+	fill(wbuf, LARGE_START, num, 0x33);
+	rc = disk_access_write(disk_pdrv, wbuf, LARGE_START, num);
+	zassert_equal(rc, 0, "Failed to write");
+
+	rc = disk_access_read(disk_pdrv, rbuf, LARGE_START + 2, 1);
+	zassert_equal(rc, 0, "Failed to read");
+	zassert_mem_equal(rbuf, &wbuf[2 * SECTOR_SIZE], SECTOR_SIZE,
+			  "Cached sector not updated");
+}
+
+ZTEST(disk_cache, test_stats_unknown_disk)
+{
+	struct disk_cache_stats stats;
+
+	zassert_equal(disk_access_cache_stats_get("none", &stats), -EINVAL,
+		      "Statistics of an unknown disk");
+	zassert_equal(disk_access_cache_stats_reset("none"), -EINVAL,
+		      "Statistics of an unknown disk reset");
+}
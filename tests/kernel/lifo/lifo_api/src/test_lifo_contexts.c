@@ -130,6 +130,39 @@ ZTEST(lifo_contexts, test_lifo_isr2thread)
 	tlifo_isr_thread(&klifo);
 }
 
+/**
+ * @brief test adding a list of data items to a lifo
+ * @see k_lifo_put(), k_lifo_put_slist(), k_lifo_get()
+ */
+ZTEST(lifo_contexts, test_lifo_put_slist)
+{
+	static ldata_t first, list_data[LIST_LEN];
+	sys_slist_t list;
+	void *rx_data;
+
+	k_lifo_init(&lifo);
+	k_lifo_put(&lifo, (void *)&first);
+
+	sys_slist_init(&list);
+	for (int i = 0; i < LIST_LEN; i++) {
+		sys_slist_append(&list, &list_data[i].snode);
+	}
+
+	/**TESTPOINT: lifo put slist*/
+	k_lifo_put_slist(&lifo, &list);
+	zassert_true(sys_slist_is_empty(&list));
+
+	/* The list comes out in its order, before the items already there */
+	for (int i = 0; i < LIST_LEN; i++) {
+		rx_data = k_lifo_get(&lifo, K_NO_WAIT);
+		zassert_equal(rx_data, (void *)&list_data[i]);
+	}
+
+	rx_data = k_lifo_get(&lifo, K_NO_WAIT);
+	zassert_equal(rx_data, (void *)&first);
+	zassert_is_null(k_lifo_get(&lifo, K_NO_WAIT));
+}
+
 /**
  * @}
  */
@@ -1172,6 +1172,158 @@ ZTEST(smp, test_smp_switch_torture)
 	}
 }
 
+#define SPIN_HOLD_US 20000
+
+#ifdef CONFIG_ADAPTIVE_SPIN
+/* Well within the spin budget */
+#define SPIN_SHORT_US (CONFIG_ADAPTIVE_SPIN_MAX_US / 4)
+#else
+#define SPIN_SHORT_US 0
+#endif
+
+static K_MUTEX_DEFINE(spin_mutex);
+static K_SEM_DEFINE(spin_held, 0, 1);
+static K_SEM_DEFINE(spin_sem, 0, 1);
+static volatile int spin_holder_prio;
+static volatile bool spin_contending;
+static volatile bool spin_waiter_pended;
+
+/* Busy until the contender is about to wait, so it sees us running */
+static void spin_wait_contender(void)
+{
+	while (!spin_contending) {
+		k_busy_wait(1);
+	}
+}
+
+static void spin_holder(void *p1, void *p2, void *p3)
+{
+	uint32_t hold_us = POINTER_TO_UINT(p1);
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_mutex_lock(&spin_mutex, K_FOREVER);
+	k_sem_give(&spin_held);
+
+	/* Keep running, so a contender sees us active on this CPU */
+	spin_wait_contender();
+	k_busy_wait(hold_us);
+
+	spin_waiter_pended = (z_waitq_head(&spin_mutex.wait_q) != NULL);
+	spin_holder_prio = k_thread_priority_get(k_current_get());
+	k_mutex_unlock(&spin_mutex);
+}
+
+static void spin_giver(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	spin_wait_contender();
+	k_busy_wait(SPIN_SHORT_US);
+
+	spin_waiter_pended = (z_waitq_head(&spin_sem.wait_q) != NULL);
+	k_sem_give(&spin_sem);
+}
+
+static void spin_test_start(k_thread_entry_t entry, uint32_t hold_us)
+{
+	spin_holder_prio = 0;
+	spin_contending = false;
+	spin_waiter_pended = false;
+
+	k_thread_create(&t2, t2_stack, T2_STACK_SIZE, entry,
+			UINT_TO_POINTER(hold_us), NULL, NULL,
+			K_PRIO_PREEMPT(10), 0, K_NO_WAIT);
+}
+
+/**
+ * @brief Test contending on a mutex held by a thread running on another CPU
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details A low priority thread holds a mutex for much longer than
+ * CONFIG_ADAPTIVE_SPIN_MAX_US while running.  A contender with a
+ * timeout shorter than the hold time must time out with -EAGAIN, and a
+ * contender waiting forever must end up boosting the holder to its own
+ * priority, whether or not it spun first.
+ */
+ZTEST(smp, test_mutex_spin_then_block)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	uint32_t start;
+
+	spin_test_start(spin_holder, SPIN_HOLD_US);
+	zassert_ok(k_sem_take(&spin_held, K_MSEC(TIMEOUT)));
+
+	spin_contending = true;
+	start = k_cycle_get_32();
+	zassert_equal(k_mutex_lock(&spin_mutex, K_USEC(SPIN_HOLD_US / 4)),
+		      -EAGAIN, "lock did not time out");
+	zassert_true(k_cyc_to_us_ceil32(k_cycle_get_32() - start) >=
+		     SPIN_HOLD_US / 4, "timed out early");
+
+	zassert_ok(k_mutex_lock(&spin_mutex, K_FOREVER));
+	zassert_true(spin_waiter_pended, "waiter did not pend");
+	zassert_equal(spin_holder_prio, prio, "holder ran at %d, not %d",
+		      spin_holder_prio, prio);
+	k_mutex_unlock(&spin_mutex);
+
+	k_thread_join(&t2, K_FOREVER);
+}
+
+/**
+ * @brief Test spinning on a mutex released shortly by its running owner
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details The holder keeps a mutex for a fraction of
+ * CONFIG_ADAPTIVE_SPIN_MAX_US while running on another CPU.  The
+ * contender must get it by spinning: it must never pend on the mutex,
+ * so the holder must not be boosted.
+ */
+ZTEST(smp, test_mutex_spin_acquire)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_ADAPTIVE_SPIN);
+
+	spin_test_start(spin_holder, SPIN_SHORT_US);
+	zassert_ok(k_sem_take(&spin_held, K_MSEC(TIMEOUT)));
+
+	spin_contending = true;
+	zassert_ok(k_mutex_lock(&spin_mutex, K_FOREVER));
+	zassert_false(spin_waiter_pended, "waiter pended instead of spinning");
+	zassert_equal(spin_holder_prio, K_PRIO_PREEMPT(10),
+		      "holder was boosted to %d", spin_holder_prio);
+	k_mutex_unlock(&spin_mutex);
+
+	k_thread_join(&t2, K_FOREVER);
+}
+
+/**
+ * @brief Test spinning on a semaphore given shortly from another CPU
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details A thread running on another CPU gives an empty semaphore
+ * after a fraction of CONFIG_ADAPTIVE_SPIN_MAX_US.  The taker must get
+ * it by spinning, without ever pending on the semaphore.
+ */
+ZTEST(smp, test_sem_spin_acquire)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_ADAPTIVE_SPIN);
+
+	k_sem_reset(&spin_sem);
+	spin_test_start(spin_giver, 0);
+
+	spin_contending = true;
+	zassert_ok(k_sem_take(&spin_sem, K_FOREVER));
+	zassert_false(spin_waiter_pended, "taker pended instead of spinning");
+
+	k_thread_join(&t2, K_FOREVER);
+}
+
 static void *smp_tests_setup(void)
 {
 	/* Sleep a bit to guarantee that both CPUs enter an idle
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#define NUM_PERIODS 10
+#define NUM_ORDERED 3
+
+static struct k_hrtimer timers[NUM_ORDERED];
+static K_SEM_DEFINE(fired_sem, 0, NUM_PERIODS);
+
+static uint64_t fired_at[NUM_PERIODS];
+static int fired_count;
+static int fired_order[NUM_ORDERED];
+
+static uint64_t tick_cyc(void)
+{
+	return k_ticks_to_cyc_floor64(1);
+}
+
+/* Worst acceptable lateness: sub-tick with cycle deadlines, otherwise
+ * the expiry is rounded up to the next tick.
+ */
+static uint64_t max_late(void)
+{
+	if (IS_ENABLED(CONFIG_SYSTEM_TIMER_HAS_CYCLE_DEADLINE)) {
+		return tick_cyc() / 2U;
+	}
+
+	return 3U * tick_cyc();
+}
+
+static void record_fn(struct k_hrtimer *timer)
+{
+	if (fired_count < NUM_PERIODS) {
+		fired_at[fired_count] = k_cycle_get_64();
+		if (timer->user_data != NULL) {
+			fired_order[fired_count] = POINTER_TO_INT(timer->user_data);
+		}
+		fired_count++;
+	}
+
+	if (fired_count == NUM_PERIODS) {
+		(void)k_hrtimer_stop(timer);
+	}
+
+	k_sem_give(&fired_sem);
+}
+
+ZTEST(hrtimer, test_oneshot)
+{
+	struct k_hrtimer *t = &timers[0];
+	uint64_t expiry = k_cycle_get_64() + tick_cyc() / 4U;
+
+	k_hrtimer_start(t, expiry, 0);
+	zassert_equal(k_hrtimer_expires_get(t), expiry);
+
+	zassert_ok(k_sem_take(&fired_sem, K_MSEC(1000)));
+	zassert_equal(fired_count, 1);
+	zassert_true(fired_at[0] >= expiry, "fired early");
+	zassert_true(fired_at[0] - expiry <= max_late(),
+		     "fired %" PRIu64 " cycles late", fired_at[0] - expiry);
+
+	/* One-shot: not running anymore and doesn't fire again */
+	zassert_equal(k_hrtimer_expires_get(t), 0);
+	zassert_false(k_hrtimer_stop(t));
+	zassert_equal(k_sem_take(&fired_sem, K_MSEC(50)), -EAGAIN);
+}
+
+ZTEST(hrtimer, test_periodic)
+{
+	struct k_hrtimer *t = &timers[0];
+	uint64_t period = tick_cyc() / 3U;
+	uint64_t start = k_cycle_get_64() + period;
+
+	k_hrtimer_start(t, start, period);
+
+	for (int i = 0; i < NUM_PERIODS; i++) {
+		zassert_ok(k_sem_take(&fired_sem, K_MSEC(1000)));
+	}
+
+	/* The last expiry stopped it */
+	zassert_false(k_hrtimer_stop(t));
+
+	for (int i = 0; i < NUM_PERIODS; i++) {
+		zassert_true(fired_at[i] >= start + i * period,
+			     "expiry %d early", i);
+	}
+}
+
+ZTEST(hrtimer, test_stop)
+{
+	struct k_hrtimer *t = &timers[0];
+
+	k_hrtimer_start(t, k_cycle_get_64() + tick_cyc() * 10U, 0);
+	zassert_not_equal(k_hrtimer_expires_get(t), 0);
+
+	zassert_true(k_hrtimer_stop(t));
+	zassert_false(k_hrtimer_stop(t));
+	zassert_equal(k_hrtimer_expires_get(t), 0);
+
+	zassert_equal(k_sem_take(&fired_sem, K_TICKS(20)), -EAGAIN);
+	zassert_equal(fired_count, 0);
+}
+
+ZTEST(hrtimer, test_restart)
+{
+	struct k_hrtimer *t = &timers[0];
+	uint64_t expiry;
+
+	k_hrtimer_start(t, k_cycle_get_64() + tick_cyc() * 100U, 0);
+
+	expiry = k_cycle_get_64() + tick_cyc() / 2U;
+	k_hrtimer_start(t, expiry, 0);
+	zassert_equal(k_hrtimer_expires_get(t), expiry);
+
+	zassert_ok(k_sem_take(&fired_sem, K_MSEC(500)));
+	zassert_true(fired_at[0] >= expiry, "fired early");
+	zassert_equal(k_sem_take(&fired_sem, K_MSEC(50)), -EAGAIN);
+	zassert_equal(fired_count, 1);
+}
+
+ZTEST(hrtimer, test_past_expiry)
+{
+	struct k_hrtimer *t = &timers[0];
+	uint64_t now = k_cycle_get_64();
+
+	k_hrtimer_start(t, now - 1U, 0);
+
+	zassert_ok(k_sem_take(&fired_sem, K_MSEC(100)));
+	zassert_true(fired_at[0] - now <= max_late(),
+		     "fired %" PRIu64 " cycles late", fired_at[0] - now);
+}
+
+ZTEST(hrtimer, test_same_expiry_order)
+{
+	uint64_t expiry = k_cycle_get_64() + tick_cyc() / 2U;
+
+	for (int i = 0; i < NUM_ORDERED; i++) {
+		timers[i].user_data = INT_TO_POINTER(i + 1);
+		k_hrtimer_start(&timers[i], expiry, 0);
+	}
+
+	for (int i = 0; i < NUM_ORDERED; i++) {
+		zassert_ok(k_sem_take(&fired_sem, K_MSEC(500)));
+	}
+
+	for (int i = 0; i < NUM_ORDERED; i++) {
+		zassert_equal(fired_order[i], i + 1, "timer %d out of order", i);
+		zassert_true(fired_at[i] >= expiry, "timer %d fired early", i);
+	}
+}
+
+static void hrtimer_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (int i = 0; i < NUM_ORDERED; i++) {
+		k_hrtimer_init(&timers[i], record_fn);
+		fired_order[i] = 0;
+	}
+
+	fired_count = 0;
+	k_sem_reset(&fired_sem);
+}
+
+static void hrtimer_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (int i = 0; i < NUM_ORDERED; i++) {
+		(void)k_hrtimer_stop(&timers[i]);
+	}
+}
+
+ZTEST_SUITE(hrtimer, NULL, NULL, hrtimer_before, hrtimer_after, NULL);
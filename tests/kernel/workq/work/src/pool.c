@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define POOL_PRIORITY K_PRIO_PREEMPT(1)
+#define NUM_WORKERS 2
+#define NUM_ITEMS 16
+#define NUM_RESUBMITS 32
+#define WAIT_TIMEOUT K_MSEC(1000)
+
+K_WORK_POOL_DEFINE(test_pool, NUM_WORKERS, STACK_SIZE);
+
+/* Work items are static, to avoid dead references to stack objects
+ * if a test fails.
+ */
+static struct k_work items[NUM_ITEMS];
+static struct k_work block_work;
+static struct k_work gated_work;
+static struct k_work flushed_work;
+static struct k_work resubmit_work;
+
+/* Work synchronization objects must be in cache-coherent memory,
+ * which excludes stacks on some architectures.
+ */
+static struct k_work_sync flush_sync;
+static struct k_work_sync thread_flush_sync;
+
+static atomic_t run_count;
+static atomic_t active;
+static atomic_t overlaps;
+static atomic_t resubmits_left;
+
+static k_tid_t block_thread;
+static k_tid_t gated_thread;
+
+static K_SEM_DEFINE(block_sem, 0, 1);
+static K_SEM_DEFINE(block_started, 0, 1);
+static K_SEM_DEFINE(gate_sem, 0, 1);
+static K_SEM_DEFINE(gate_started, 0, 1);
+static K_SEM_DEFINE(flush_done, 0, 1);
+
+static K_THREAD_STACK_DEFINE(flusher_stack, STACK_SIZE);
+static struct k_thread flusher_thread;
+
+static void count_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	atomic_inc(&run_count);
+}
+
+/* Keeps the worker running it busy until block_sem is given */
+static void block_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	block_thread = k_current_get();
+	k_sem_give(&block_started);
+	k_sem_take(&block_sem, K_FOREVER);
+}
+
+static void gated_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	gated_thread = k_current_get();
+	k_sem_give(&gate_started);
+	k_sem_take(&gate_sem, K_FOREVER);
+}
+
+static void resubmit_handler(struct k_work *work)
+{
+	if (atomic_inc(&active) != 0) {
+		atomic_inc(&overlaps);
+	}
+
+	k_busy_wait(100);
+	atomic_inc(&run_count);
+
+	if (atomic_dec(&resubmits_left) > 1) {
+		(void)k_work_submit_to_pool(&test_pool, work);
+	}
+
+	atomic_dec(&active);
+}
+
+static void flusher_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	(void)k_work_flush(&flushed_work, &thread_flush_sync);
+	k_sem_give(&flush_done);
+}
+
+/* Block one worker, so everything else has to be picked up by its
+ * sibling.
+ */
+static void block_one_worker(void)
+{
+	k_work_init(&block_work, block_handler);
+	zassert_equal(k_work_submit_to_pool(&test_pool, &block_work), 1);
+	zassert_equal(k_sem_take(&block_started, WAIT_TIMEOUT), 0);
+}
+
+static void release_worker(void)
+{
+	k_sem_give(&block_sem);
+	zassert_equal(k_work_pool_drain(&test_pool, false) >= 0, true);
+}
+
+ZTEST(work_pool, test_pool_run_all)
+{
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		k_work_init(&items[i], count_handler);
+		zassert_equal(k_work_submit_to_pool(&test_pool, &items[i]), 1);
+	}
+
+	zassert_equal(k_work_pool_drain(&test_pool, false) >= 0, true);
+	zassert_equal(atomic_get(&run_count), NUM_ITEMS);
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		zassert_equal(k_work_busy_get(&items[i]), 0);
+	}
+}
+
+ZTEST(work_pool, test_pool_steal)
+{
+	block_one_worker();
+
+	/* However these land, the blocked worker can't run them */
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		k_work_init(&items[i], count_handler);
+		zassert_equal(k_work_submit_to_pool(&test_pool, &items[i]), 1);
+	}
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		(void)k_work_flush(&items[i], &flush_sync);
+	}
+	zassert_equal(atomic_get(&run_count), NUM_ITEMS);
+	zassert_equal(k_sem_count_get(&block_sem), 0);
+
+	release_worker();
+}
+
+ZTEST(work_pool, test_pool_flush_stolen)
+{
+	block_one_worker();
+
+	/* Occupy the other worker too, so the next item stays queued */
+	k_work_init(&gated_work, gated_handler);
+	zassert_equal(k_work_submit_to_pool(&test_pool, &gated_work), 1);
+	zassert_equal(k_sem_take(&gate_started, WAIT_TIMEOUT), 0);
+	zassert_not_equal(gated_thread, block_thread);
+
+	k_work_init(&flushed_work, count_handler);
+	zassert_equal(k_work_submit_to_pool(&test_pool, &flushed_work), 1);
+
+	k_thread_create(&flusher_thread, flusher_stack, STACK_SIZE,
+			flusher_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	/* The flush waits until a worker frees up */
+	zassert_equal(k_sem_take(&flush_done, K_MSEC(50)), -EAGAIN);
+	zassert_equal(atomic_get(&run_count), 0);
+
+	k_sem_give(&gate_sem);
+	zassert_equal(k_sem_take(&flush_done, WAIT_TIMEOUT), 0);
+	zassert_equal(atomic_get(&run_count), 1);
+	zassert_equal(k_sem_count_get(&block_sem), 0);
+
+	k_thread_join(&flusher_thread, K_FOREVER);
+	release_worker();
+}
+
+ZTEST(work_pool, test_pool_no_reentrancy)
+{
+	k_work_init(&resubmit_work, resubmit_handler);
+	atomic_set(&resubmits_left, NUM_RESUBMITS);
+
+	zassert_equal(k_work_submit_to_pool(&test_pool, &resubmit_work), 1);
+	while (atomic_get(&resubmits_left) > 1) {
+		k_msleep(1);
+	}
+	(void)k_work_flush(&resubmit_work, &flush_sync);
+	zassert_equal(k_work_pool_drain(&test_pool, false) >= 0, true);
+
+	zassert_equal(atomic_get(&run_count), NUM_RESUBMITS);
+	zassert_equal(atomic_get(&overlaps), 0);
+}
+
+ZTEST(work_pool, test_pool_plugged)
+{
+	k_work_init(&items[0], count_handler);
+
+	zassert_equal(k_work_pool_drain(&test_pool, true) >= 0, true);
+	zassert_equal(k_work_submit_to_pool(&test_pool, &items[0]), -EBUSY);
+
+	zassert_equal(k_work_pool_unplug(&test_pool), 0);
+	zassert_equal(k_work_pool_unplug(&test_pool), -EALREADY);
+
+	zassert_equal(k_work_submit_to_pool(&test_pool, &items[0]), 1);
+	zassert_equal(k_work_pool_drain(&test_pool, false) >= 0, true);
+	zassert_equal(atomic_get(&run_count), 1);
+}
+
+static void *pool_setup(void)
+{
+	k_work_pool_start(&test_pool, POOL_PRIORITY, NULL);
+
+	return NULL;
+}
+
+static void pool_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	atomic_set(&run_count, 0);
+	atomic_set(&active, 0);
+	atomic_set(&overlaps, 0);
+	k_sem_reset(&block_sem);
+	k_sem_reset(&gate_sem);
+	k_sem_reset(&flush_done);
+}
+
+ZTEST_SUITE(work_pool, NULL, pool_setup, pool_before, NULL, NULL);
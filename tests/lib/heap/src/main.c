@@ -158,6 +158,12 @@ static void log_result(size_t sz, struct z_heap_stress_result *r)
 		 "  avg usage: %d/%d (%d%%)\n",
 		 r->successful_allocs, r->total_allocs, succ_pct,
 		 r->total_frees, avg, (int) sz, avg_pct);
+	TC_PRINT("alloc cycles p50/p90/p99/max: %u/%u/%u/%u,"
+		 "  free cycles p50/p90/p99/max: %u/%u/%u/%u\n",
+		 r->alloc_latency.p50, r->alloc_latency.p90,
+		 r->alloc_latency.p99, r->alloc_latency.max,
+		 r->free_latency.p50, r->free_latency.p90,
+		 r->free_latency.p99, r->free_latency.max);
 }
 
 /* Do a heavy test over a small heap, with many iterations that need
@@ -71,6 +71,7 @@ static void var_destroy(struct net_buf *buf);
 NET_BUF_POOL_HEAP_DEFINE(bufs_pool, 10, USER_DATA_HEAP, buf_destroy);
 NET_BUF_POOL_FIXED_DEFINE(fixed_pool, 10, FIXED_BUFFER_SIZE, USER_DATA_FIXED, fixed_destroy);
 NET_BUF_POOL_VAR_DEFINE(var_pool, 10, 1024, USER_DATA_VAR, var_destroy);
+NET_BUF_POOL_FIXED_DEFINE(batch_pool, 8, FIXED_BUFFER_SIZE, USER_DATA_FIXED, NULL);
 
 static void buf_destroy(struct net_buf *buf)
 {
@@ -849,4 +850,74 @@ ZTEST(net_buf_tests, test_net_buf_fixed_append)
 }
 
 
+ZTEST(net_buf_tests, test_net_buf_alloc_batch)
+{
+	struct net_buf *bufs[8];
+	struct net_buf *chain;
+	int count;
+
+	count = net_buf_alloc_batch(&batch_pool, FIXED_BUFFER_SIZE, bufs, 5,
+				    K_NO_WAIT);
+	zassert_equal(count, 5, "Wrong number of buffers %d", count);
+
+	for (int i = 0; i < count; i++) {
+		zassert_equal(bufs[i]->ref, 1, "Invalid refcount");
+		zassert_equal(bufs[i]->size, FIXED_BUFFER_SIZE, "Invalid size");
+		zassert_equal(bufs[i]->len, 0, "Invalid length");
+		zassert_is_null(bufs[i]->frags, "Unexpected fragment");
+
+		for (int j = 0; j < i; j++) {
+			zassert_not_equal(bufs[i], bufs[j], "Buffer given twice");
+		}
+	}
+
+	/* Only what is left in the pool is returned */
+	count = net_buf_alloc_batch(&batch_pool, FIXED_BUFFER_SIZE, &bufs[5], 5,
+				    K_NO_WAIT);
+	zassert_equal(count, 3, "Wrong number of buffers %d", count);
+
+	count = net_buf_alloc_batch(&batch_pool, FIXED_BUFFER_SIZE, bufs, 1,
+				    K_NO_WAIT);
+	zassert_equal(count, 0, "Allocated from an empty pool");
+
+	/* Free all of them as one fragment chain */
+	for (int i = 0; i < ARRAY_SIZE(bufs) - 1; i++) {
+		bufs[i]->frags = bufs[i + 1];
+	}
+
+	net_buf_unref(bufs[0]);
+
+	count = net_buf_alloc_batch(&batch_pool, FIXED_BUFFER_SIZE, bufs,
+				    ARRAY_SIZE(bufs), K_NO_WAIT);
+	zassert_equal(count, ARRAY_SIZE(bufs), "Wrong number of buffers %d",
+		      count);
+
+	/* A fragment still referenced ends the chain being freed */
+	bufs[0]->frags = bufs[1];
+	bufs[1]->frags = bufs[2];
+	chain = net_buf_ref(bufs[1]);
+
+	net_buf_unref(bufs[0]);
+
+	count = net_buf_alloc_batch(&batch_pool, FIXED_BUFFER_SIZE, bufs, 2,
+				    K_NO_WAIT);
+	zassert_equal(count, 1, "Wrong number of buffers %d", count);
+	zassert_equal(chain->ref, 1, "Invalid refcount");
+
+	net_buf_unref(bufs[0]);
+	net_buf_unref(chain);
+
+	for (int i = 3; i < ARRAY_SIZE(bufs); i++) {
+		net_buf_unref(bufs[i]);
+	}
+
+	count = net_buf_alloc_batch(&batch_pool, FIXED_BUFFER_SIZE, bufs,
+				    ARRAY_SIZE(bufs), K_NO_WAIT);
+	zassert_equal(count, ARRAY_SIZE(bufs), "Buffers were lost");
+
+	for (int i = 0; i < count; i++) {
+		net_buf_unref(bufs[i]);
+	}
+}
+
 ZTEST_SUITE(net_buf_tests, NULL, NULL, NULL, NULL, NULL);
@@ -1273,4 +1273,39 @@ ZTEST(net_pkt_test_suite, test_net_pkt_shallow_clone_append_buf_2)
 	test_net_pkt_shallow_clone_append_buf(2);
 }
 
+ZTEST(net_pkt_test_suite, test_net_pkt_rx_cache_flush)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_NET_PKT_BUF_RX_CACHE);
+
+#if defined(CONFIG_NET_PKT_BUF_RX_CACHE)
+	static struct net_pkt_buf_cache cache;
+	struct net_buf_pool *rx_data;
+	struct net_pkt *pkt;
+	atomic_val_t avail;
+
+	net_pkt_get_info(NULL, NULL, &rx_data, NULL);
+	avail = atomic_get(&rx_data->avail_count);
+
+	pkt = net_pkt_rx_alloc_from_cache(eth_if, &cache,
+					  CONFIG_NET_BUF_DATA_SIZE, K_NO_WAIT);
+	zassert_true(pkt != NULL, "Pkt not allocated");
+
+	/* The cache was refilled with more buffers than the packet needs */
+	zassert_true(cache.count > 0, "Cache not refilled");
+	zassert_equal(atomic_get(&rx_data->avail_count),
+		      avail - 1 - cache.count,
+		      "Incorrect net buf allocation");
+
+	net_pkt_unref(pkt);
+	zassert_equal(atomic_get(&rx_data->avail_count),
+		      avail - cache.count,
+		      "Incorrect available net buf count");
+
+	net_pkt_buf_cache_flush(&cache);
+	zassert_equal(cache.count, 0, "Cache not emptied");
+	zassert_equal(atomic_get(&rx_data->avail_count), avail,
+		      "Leak detected");
+#endif
+}
+
 ZTEST_SUITE(net_pkt_test_suite, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_stats.h>
+
+#include "net_private.h"
+
+#define LOCAL_PORT 4242
+#define PEERS      32
+
+/* Fragments carry data, not the ports, after their IP header */
+#define FRAG_DATA  0xa5
+
+struct eth_context {
+	uint8_t mac_addr[6];
+};
+
+static struct eth_context eth_ctx = {
+	.mac_addr = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 },
+};
+
+static const uint8_t peer_mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x09 };
+
+static struct net_if *eth_iface;
+
+static void eth_iface_init(struct net_if *iface)
+{
+	const struct device *dev = net_if_get_device(iface);
+	struct eth_context *context = dev->data;
+
+	net_if_set_link_addr(iface, context->mac_addr,
+			     sizeof(context->mac_addr), NET_LINK_ETHERNET);
+
+	ethernet_init(iface);
+}
+
+static int eth_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static struct ethernet_api eth_api = {
+	.iface_api.init = eth_iface_init,
+	.send = eth_send,
+};
+
+ETH_NET_DEVICE_INIT(eth_rx_steering_test, "eth_rx_steering_test",
+		    NULL, NULL, &eth_ctx, NULL,
+		    CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		    &eth_api, NET_ETH_MTU);
+
+/* Build a UDP packet from peer, with an Ethernet header unless it is fed
+ * back by reassembly.
+ */
+static struct net_pkt *ipv4_pkt(uint8_t peer, uint16_t flags, uint16_t port,
+				bool reassembled)
+{
+	uint8_t buf[sizeof(struct net_eth_hdr) + NET_IPV4H_LEN + NET_UDPH_LEN];
+	struct net_eth_hdr *eth = (struct net_eth_hdr *)buf;
+	struct net_ipv4_hdr *ip;
+	struct net_udp_hdr *udp;
+	struct net_pkt *pkt;
+	size_t off = 0;
+
+	memset(buf, 0, sizeof(buf));
+
+	if (!reassembled) {
+		memcpy(eth->dst.addr, eth_ctx.mac_addr, sizeof(eth->dst.addr));
+		memcpy(eth->src.addr, peer_mac, sizeof(eth->src.addr));
+		eth->type = htons(NET_ETH_PTYPE_IP);
+		off = sizeof(struct net_eth_hdr);
+	}
+
+	ip = (struct net_ipv4_hdr *)&buf[off];
+	ip->vhl = 0x45;
+	ip->len = htons(NET_IPV4H_LEN + NET_UDPH_LEN);
+	sys_put_be16(flags, ip->offset);
+	ip->ttl = 64;
+	ip->proto = IPPROTO_UDP;
+	ip->src[0] = 198;
+	ip->src[1] = 51;
+	ip->src[2] = 100;
+	ip->src[3] = peer;
+	ip->dst[0] = 192;
+	ip->dst[1] = 0;
+	ip->dst[2] = 2;
+	ip->dst[3] = 1;
+
+	udp = (struct net_udp_hdr *)&buf[off + NET_IPV4H_LEN];
+	if ((flags & NET_IPV4_FRAGH_OFFSET_MASK) != 0U) {
+		memset(udp, FRAG_DATA, NET_UDPH_LEN);
+	} else {
+		udp->src_port = htons(port);
+		udp->dst_port = htons(LOCAL_PORT);
+		udp->len = htons(NET_UDPH_LEN);
+	}
+
+	pkt = net_pkt_rx_alloc_with_buffer(eth_iface, sizeof(buf) - off,
+					   AF_UNSPEC, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "Cannot allocate packet");
+	zassert_ok(net_pkt_write(pkt, &buf[off], sizeof(buf) - off),
+		   "Cannot write packet");
+
+	net_pkt_set_ip_reassembled(pkt, reassembled);
+
+	return pkt;
+}
+
+static struct net_pkt *ipv6_pkt(uint8_t peer, uint32_t flow, bool frag,
+				uint16_t port, bool reassembled)
+{
+	uint8_t buf[sizeof(struct net_eth_hdr) + NET_IPV6H_LEN +
+		    NET_IPV6_FRAGH_LEN + NET_UDPH_LEN];
+	struct net_eth_hdr *eth = (struct net_eth_hdr *)buf;
+	struct net_ipv6_hdr *ip;
+	struct net_udp_hdr *udp;
+	struct net_pkt *pkt;
+	size_t off = 0, len;
+
+	memset(buf, 0, sizeof(buf));
+
+	if (!reassembled) {
+		memcpy(eth->dst.addr, eth_ctx.mac_addr, sizeof(eth->dst.addr));
+		memcpy(eth->src.addr, peer_mac, sizeof(eth->src.addr));
+		eth->type = htons(NET_ETH_PTYPE_IPV6);
+		off = sizeof(struct net_eth_hdr);
+	}
+
+	ip = (struct net_ipv6_hdr *)&buf[off];
+	sys_put_be32(0x60000000U | flow, &buf[off]);
+	ip->nexthdr = IPPROTO_UDP;
+	ip->hop_limit = 64;
+	ip->src[0] = 0x20;
+	ip->src[1] = 0x01;
+	ip->src[2] = 0x0d;
+	ip->src[3] = 0xb8;
+	ip->src[15] = peer;
+	memcpy(ip->dst, ip->src, sizeof(ip->dst));
+	ip->dst[15] = 1;
+	len = off + NET_IPV6H_LEN;
+
+	if (frag) {
+		/* A later fragment, without the UDP header */
+		struct net_ipv6_frag_hdr *frag_hdr =
+			(struct net_ipv6_frag_hdr *)&buf[len];
+
+		ip->nexthdr = NET_IPV6_NEXTHDR_FRAG;
+		frag_hdr->nexthdr = IPPROTO_UDP;
+		frag_hdr->offset = htons(8);
+		len += NET_IPV6_FRAGH_LEN;
+		memset(&buf[len], FRAG_DATA, NET_UDPH_LEN);
+	} else {
+		udp = (struct net_udp_hdr *)&buf[len];
+		udp->src_port = htons(port);
+		udp->dst_port = htons(LOCAL_PORT);
+		udp->len = htons(NET_UDPH_LEN);
+	}
+
+	len += NET_UDPH_LEN;
+	ip->len = htons(len - off - NET_IPV6H_LEN);
+
+	pkt = net_pkt_rx_alloc_with_buffer(eth_iface, len - off, AF_UNSPEC, 0,
+					   K_SECONDS(1));
+	zassert_not_null(pkt, "Cannot allocate packet");
+	zassert_ok(net_pkt_write(pkt, &buf[off], len - off),
+		   "Cannot write packet");
+
+	net_pkt_set_ip_reassembled(pkt, reassembled);
+
+	return pkt;
+}
+
+/* Submit the packet and return the RX queue it was put in */
+static int rx_queue_of(struct net_pkt *pkt)
+{
+	static struct net_stats before, after;
+	int ret;
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_ALL, eth_iface, &before,
+		       sizeof(before));
+	zassert_ok(ret, "Cannot get stats (%d)", ret);
+
+	net_tc_submit_to_rx_queue(0, pkt);
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_ALL, eth_iface, &after,
+		       sizeof(after));
+	zassert_ok(ret, "Cannot get stats (%d)", ret);
+
+	for (int i = 0; i < CONFIG_NET_TC_RX_STEERING_QUEUES; i++) {
+		if (after.rx_queue[i].pkts != before.rx_queue[i].pkts) {
+			return i;
+		}
+	}
+
+	zassert_unreachable("Packet not put in any queue");
+	return -1;
+}
+
+/* The fragments of a flow and the packet reassembled from them go to the
+ * queue of its other packets.
+ */
+ZTEST(net_rx_steering, test_ipv4_fragments)
+{
+	for (uint8_t peer = 1; peer <= PEERS; peer++) {
+		uint16_t port = 10000U + peer;
+		int queue = rx_queue_of(ipv4_pkt(peer, 0, port, false));
+
+		zassert_equal(rx_queue_of(ipv4_pkt(peer, NET_IPV4_MORE_FRAG_MASK,
+						   port, false)),
+			      queue, "First fragment of peer %u in another queue", peer);
+		zassert_equal(rx_queue_of(ipv4_pkt(peer, 1, port, false)), queue,
+			      "Last fragment of peer %u in another queue", peer);
+		zassert_equal(rx_queue_of(ipv4_pkt(peer, 0, port, true)), queue,
+			      "Reassembled packet of peer %u in another queue", peer);
+	}
+}
+
+/* Flows that cannot be fragmented are spread by their ports */
+ZTEST(net_rx_steering, test_ipv4_ports)
+{
+	uint32_t used = 0U;
+
+	for (uint16_t port = 10000U; port < 10000U + PEERS; port++) {
+		int queue = rx_queue_of(ipv4_pkt(1, NET_IPV4_DO_NOT_FRAG_MASK,
+						  port, false));
+
+		zassert_equal(rx_queue_of(ipv4_pkt(1, NET_IPV4_DO_NOT_FRAG_MASK,
+						   port, true)),
+			      queue, "Reassembled packet of port %u in another queue",
+			      port);
+		used |= BIT(queue);
+	}
+
+	zassert_true(POPCOUNT(used) > 1, "Flows of one peer all in one queue");
+}
+
+ZTEST(net_rx_steering, test_ipv6_fragments)
+{
+	for (uint8_t peer = 1; peer <= PEERS; peer++) {
+		uint16_t port = 10000U + peer;
+
+		/* With and without a flow label */
+		for (uint32_t flow = 0U; flow <= 0x12345U; flow += 0x12345U) {
+			int queue = rx_queue_of(ipv6_pkt(peer, flow, false, port, false));
+
+			zassert_equal(rx_queue_of(ipv6_pkt(peer, flow, true, port, false)),
+				      queue, "Fragment of peer %u in another queue", peer);
+			zassert_equal(rx_queue_of(ipv6_pkt(peer, flow, false, port, true)),
+				      queue, "Reassembled packet of peer %u in another queue",
+				      peer);
+		}
+	}
+}
+
+static void *rx_steering_setup(void)
+{
+	eth_iface = net_if_get_first_by_type(&NET_L2_GET_NAME(ETHERNET));
+	zassert_not_null(eth_iface, "No Ethernet interface");
+
+	return NULL;
+}
+
+ZTEST_SUITE(net_rx_steering, NULL, rx_steering_setup, NULL, NULL, NULL);
@@ -252,4 +252,219 @@ ZTEST(net_socket_poll, test_pollout_tcp)
 	zassert_equal(res, 0, "close failed");
 }
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+static void epoll_expect(int epfd, int maxevents, int timeout, int expected,
+			 uint32_t events, int fd)
+{
+	struct zsock_epoll_event evs[2];
+	int res;
+
+	memset(evs, 0, sizeof(evs));
+
+	res = zsock_epoll_wait(epfd, evs, maxevents, timeout);
+	zassert_equal(res, expected, "wait returned %d, expected %d", res,
+		      expected);
+
+	if (expected == 1 && events != 0U) {
+		zassert_equal(evs[0].events, events, "wrong events 0x%x",
+			      evs[0].events);
+		zassert_equal(evs[0].data.fd, fd, "wrong data");
+	}
+}
+
+ZTEST(net_socket_poll, test_epoll)
+{
+	struct zsock_epoll_event ev;
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	uint32_t tstamp;
+	int c_sock;
+	int s_sock;
+	int epfd;
+	ssize_t len;
+	char buf[10];
+	int res;
+
+	prepare_sock_udp_v6(MY_IPV6_ADDR, CLIENT_PORT, &c_sock, &c_addr);
+	prepare_sock_udp_v6(MY_IPV6_ADDR, SERVER_PORT, &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	epfd = zsock_epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed (%d)", errno);
+
+	ev.events = ZSOCK_EPOLLIN;
+	ev.data.fd = s_sock;
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, 0, "add failed");
+
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, -1, "second add succeeded");
+	zassert_equal(errno, EEXIST, "wrong errno %d", errno);
+
+	/* Wait on a non-ready socket with timeout of 30 */
+	tstamp = k_uptime_get_32();
+	epoll_expect(epfd, 2, 30, 0, 0U, 0);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+
+	/* Level-triggered: reported until the data is read */
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	epoll_expect(epfd, 2, 30, 1, ZSOCK_EPOLLIN, s_sock);
+	epoll_expect(epfd, 2, 0, 1, ZSOCK_EPOLLIN, s_sock);
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	epoll_expect(epfd, 2, 0, 0, 0U, 0);
+
+	/* Edge-triggered: reported once per arriving datagram */
+	ev.events = ZSOCK_EPOLLIN | ZSOCK_EPOLLET;
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "mod failed");
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	epoll_expect(epfd, 2, 30, 1, ZSOCK_EPOLLIN, s_sock);
+	epoll_expect(epfd, 2, 0, 0, 0U, 0);
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	epoll_expect(epfd, 2, 30, 1, ZSOCK_EPOLLIN, s_sock);
+
+	for (int i = 0; i < 2; i++) {
+		len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+		zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+	}
+
+	/* One-shot: not reported again until re-armed */
+	ev.events = ZSOCK_EPOLLIN | ZSOCK_EPOLLONESHOT;
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "mod failed");
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	epoll_expect(epfd, 2, 30, 1, ZSOCK_EPOLLIN, s_sock);
+	epoll_expect(epfd, 2, 0, 0, 0U, 0);
+
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "mod failed");
+
+	epoll_expect(epfd, 2, 0, 1, ZSOCK_EPOLLIN, s_sock);
+
+	/* No more events than asked for are returned */
+	ev.events = ZSOCK_EPOLLIN;
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "mod failed");
+
+	ev.events = ZSOCK_EPOLLOUT;
+	ev.data.fd = c_sock;
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_ADD, c_sock, &ev);
+	zassert_equal(res, 0, "add failed");
+
+	epoll_expect(epfd, 1, 0, 1, 0U, 0);
+	epoll_expect(epfd, 2, 0, 2, 0U, 0);
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	/* Removed sockets are not reported */
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_DEL, c_sock, NULL);
+	zassert_equal(res, 0, "del failed");
+
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_DEL, c_sock, NULL);
+	zassert_equal(res, -1, "second del succeeded");
+	zassert_equal(errno, ENOENT, "wrong errno %d", errno);
+
+	epoll_expect(epfd, 2, 0, 0, 0U, 0);
+
+	/* A closed socket is removed from the instance */
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	epoll_expect(epfd, 2, 0, 0, 0U, 0);
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+}
+
+ZTEST(net_socket_poll, test_epollout_tcp)
+{
+	struct zsock_epoll_event ev;
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	char buf[TEST_SNDBUF_SIZE] = { };
+	int new_sock;
+	int c_sock;
+	int s_sock;
+	int epfd;
+	int res;
+
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, CLIENT_PORT, &c_sock, &c_addr);
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, SERVER_PORT, &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "");
+	res = listen(s_sock, 0);
+	zassert_equal(res, 0, "");
+	res = connect(c_sock, (const struct sockaddr *)&s_addr,
+		      sizeof(s_addr));
+	zassert_equal(res, 0, "");
+	new_sock = accept(s_sock, NULL, NULL);
+	zassert_true(new_sock >= 0, "");
+
+	k_msleep(10);
+
+	epfd = zsock_epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed (%d)", errno);
+
+	ev.events = ZSOCK_EPOLLOUT | ZSOCK_EPOLLET;
+	ev.data.fd = c_sock;
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_ADD, c_sock, &ev);
+	zassert_equal(res, 0, "add failed");
+
+	/* EPOLLOUT is reported once after connecting */
+	epoll_expect(epfd, 1, 10, 1, ZSOCK_EPOLLOUT, c_sock);
+	epoll_expect(epfd, 1, 0, 0, 0U, 0);
+
+	/* Fill the window, then consume the data server side: the window
+	 * opening again is a new edge.
+	 */
+	res = send(c_sock, buf, sizeof(buf), 0);
+	zassert_equal(res, sizeof(buf), "");
+
+	epoll_expect(epfd, 1, 10, 0, 0U, 0);
+
+	res = recv(new_sock, buf, sizeof(buf), 0);
+	zassert_equal(res, sizeof(buf), "");
+
+	/* Wait longer this time to give TCP stack a chance to send ZWP. */
+	epoll_expect(epfd, 1, 500, 1, ZSOCK_EPOLLOUT, c_sock);
+
+	k_msleep(10);
+
+	/* Finalize the test */
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+	res = close(new_sock);
+	zassert_equal(res, 0, "close failed");
+}
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 ZTEST_SUITE(net_socket_poll, NULL, NULL, NULL, NULL, NULL);
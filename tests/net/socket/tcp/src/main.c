@@ -1411,6 +1411,85 @@ ZTEST(net_socket_tcp, test_so_rcvbuf_win_size)
 	test_context_cleanup();
 }
 
+#if defined(CONFIG_NET_SOCKETS_RECV_ZEROCOPY)
+ZTEST(net_socket_tcp, test_recv_zerocopy_win_size)
+{
+	int rv;
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	char tx_buf[] = TEST_STR_SMALL;
+	int buf_optval = sizeof(TEST_STR_SMALL);
+	struct zsock_zc_ref ref;
+	struct iovec io_vector[4];
+	struct msghdr msg;
+	size_t off = 0;
+	char rx_buf[sizeof(tx_buf)];
+
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, ANY_PORT, &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, SERVER_PORT, &s_sock, &s_saddr);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+	zassert_equal(addrlen, sizeof(struct sockaddr_in), "wrong addrlen");
+
+	/* Lower server-side RX window size. */
+	rv = setsockopt(new_sock, SOL_SOCKET, SO_RCVBUF, &buf_optval,
+			sizeof(buf_optval));
+	zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+
+	rv = send(c_sock, tx_buf, sizeof(tx_buf), MSG_DONTWAIT);
+	zassert_equal(rv, sizeof(tx_buf), "Unexpected return code %d", rv);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+
+	rv = zsock_recvmsg_zc(new_sock, &msg, &ref, 0);
+	zassert_equal(rv, sizeof(tx_buf), "Unexpected return code %d", rv);
+
+	for (size_t i = 0; i < msg.msg_iovlen; i++) {
+		zassert_true(off + io_vector[i].iov_len <= sizeof(rx_buf),
+			     "iovecs longer than the data");
+		memcpy(rx_buf + off, io_vector[i].iov_base, io_vector[i].iov_len);
+		off += io_vector[i].iov_len;
+	}
+
+	zassert_equal(off, sizeof(tx_buf), "wrong iovec length");
+	zassert_mem_equal(rx_buf, tx_buf, sizeof(tx_buf), "unexpected data");
+
+	/* The data is still lent out, the window stays closed. */
+	k_msleep(150);
+
+	rv = send(c_sock, tx_buf, 1, MSG_DONTWAIT);
+	zassert_equal(rv, -1, "Unexpected return code %d", rv);
+	zassert_equal(errno, EAGAIN, "Unexpected errno value: %d", errno);
+
+	/* Releasing it reopens the window. */
+	rv = zsock_recv_zc_release(new_sock, &ref);
+	zassert_equal(rv, 0, "release failed (%d)", errno);
+
+	k_msleep(150);
+
+	rv = send(c_sock, tx_buf, 1, MSG_DONTWAIT);
+	zassert_equal(rv, 1, "Unexpected return code %d", rv);
+
+	test_close(c_sock);
+	test_close(new_sock);
+	test_close(s_sock);
+
+	test_context_cleanup();
+}
+#endif /* CONFIG_NET_SOCKETS_RECV_ZEROCOPY */
+
 ZTEST(net_socket_tcp, test_so_sndbuf)
 {
 	struct sockaddr_in bind_addr4;
@@ -2408,6 +2408,197 @@ ZTEST_USER(net_socket_udp, test_35_recvmsg_msg_controllen_update)
 	zassert_equal(rv, 0, "close failed");
 }
 
+#define MMSG_COUNT 4
+
+static ZTEST_BMEM char mmsg_rx_buf[MMSG_COUNT][sizeof(TEST_STR_SMALL) + 1];
+
+ZTEST_USER(net_socket_udp, test_36_v4_sendmmsg_recvmmsg)
+{
+	static const char *const payloads[MMSG_COUNT] = {
+		"a", "bb", "ccc", TEST_STR_SMALL,
+	};
+	struct mmsghdr msgvec[MMSG_COUNT];
+	struct iovec io_vector[MMSG_COUNT];
+	struct sockaddr_in src_addr[MMSG_COUNT];
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	int client_sock;
+	int server_sock;
+	int received;
+	int rv;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, CLIENT_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = bind(client_sock, (struct sockaddr *)&client_addr,
+		  sizeof(client_addr));
+	zassert_equal(rv, 0, "client bind failed");
+
+	/* Nothing queued yet */
+	memset(msgvec, 0, sizeof(msgvec));
+	io_vector[0].iov_base = mmsg_rx_buf[0];
+	io_vector[0].iov_len = sizeof(mmsg_rx_buf[0]);
+	msgvec[0].msg_hdr.msg_iov = &io_vector[0];
+	msgvec[0].msg_hdr.msg_iovlen = 1;
+	rv = recvmmsg(server_sock, msgvec, 1, MSG_DONTWAIT, NULL);
+	zassert_equal(rv, -1, "recvmmsg() succeeded");
+	zassert_equal(errno, EAGAIN, "Wrong errno (%d)", errno);
+
+	memset(msgvec, 0, sizeof(msgvec));
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		io_vector[i].iov_base = (void *)payloads[i];
+		io_vector[i].iov_len = strlen(payloads[i]);
+		msgvec[i].msg_hdr.msg_iov = &io_vector[i];
+		msgvec[i].msg_hdr.msg_iovlen = 1;
+		msgvec[i].msg_hdr.msg_name = &server_addr;
+		msgvec[i].msg_hdr.msg_namelen = sizeof(server_addr);
+	}
+
+	rv = sendmmsg(client_sock, msgvec, MMSG_COUNT, 0);
+	zassert_equal(rv, MMSG_COUNT, "sendmmsg() sent %d messages", rv);
+
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(msgvec[i].msg_len, strlen(payloads[i]),
+			      "message %d: wrong length %u", i, msgvec[i].msg_len);
+	}
+
+	/* The datagrams may not all be queued yet when the first one is
+	 * received, collect them until all have arrived.
+	 */
+	received = 0;
+	while (received < MMSG_COUNT) {
+		memset(msgvec, 0, sizeof(msgvec));
+		for (int i = 0; i < MMSG_COUNT - received; i++) {
+			io_vector[i].iov_base = mmsg_rx_buf[received + i];
+			io_vector[i].iov_len = sizeof(mmsg_rx_buf[0]);
+			msgvec[i].msg_hdr.msg_iov = &io_vector[i];
+			msgvec[i].msg_hdr.msg_iovlen = 1;
+			msgvec[i].msg_hdr.msg_name = &src_addr[received + i];
+			msgvec[i].msg_hdr.msg_namelen = sizeof(src_addr[0]);
+		}
+
+		rv = recvmmsg(server_sock, msgvec, MMSG_COUNT - received,
+			      MSG_WAITFORONE, NULL);
+		zassert_true(rv > 0, "recvmmsg() failed (%d)", errno);
+
+		for (int i = 0; i < rv; i++) {
+			int n = received + i;
+
+			zassert_equal(msgvec[i].msg_len, strlen(payloads[n]),
+				      "message %d: wrong length %u", n,
+				      msgvec[i].msg_len);
+			zassert_mem_equal(mmsg_rx_buf[n], payloads[n],
+					  strlen(payloads[n]),
+					  "message %d: wrong data", n);
+			zassert_equal(src_addr[n].sin_port, client_addr.sin_port,
+				      "message %d: wrong source port", n);
+		}
+
+		received += rv;
+	}
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+#if defined(CONFIG_NET_SOCKETS_RECV_ZEROCOPY)
+ZTEST(net_socket_udp, test_37_v4_recv_zerocopy)
+{
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in src_addr;
+	struct zsock_zc_ref ref;
+	struct iovec io_vector[1];
+	struct msghdr msg;
+	int client_sock;
+	int server_sock;
+	int rv;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, CLIENT_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = bind(client_sock, (struct sockaddr *)&client_addr,
+		  sizeof(client_addr));
+	zassert_equal(rv, 0, "client bind failed");
+
+	rv = sendto(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	msg.msg_name = &src_addr;
+	msg.msg_namelen = sizeof(src_addr);
+
+	rv = zsock_recvmsg_zc(server_sock, &msg, &ref, 0);
+	zassert_equal(rv, STRLEN(TEST_STR_SMALL), "recvmsg_zc failed");
+	zassert_equal(msg.msg_iovlen, 1, "wrong iovlen %zu", msg.msg_iovlen);
+	zassert_equal(io_vector[0].iov_len, STRLEN(TEST_STR_SMALL),
+		      "wrong iovec length");
+	zassert_mem_equal(io_vector[0].iov_base, TEST_STR_SMALL,
+			  STRLEN(TEST_STR_SMALL), "wrong data");
+	zassert_equal(msg.msg_namelen, sizeof(struct sockaddr_in),
+		      "wrong address length");
+	zassert_equal(src_addr.sin_port, client_addr.sin_port,
+		      "wrong source port");
+	zassert_false(msg.msg_flags & MSG_TRUNC, "truncated");
+
+	rv = zsock_recv_zc_release(server_sock, &ref);
+	zassert_equal(rv, 0, "release failed");
+
+	/* A datagram over more buffers than iovecs is truncated */
+	rv = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR2), "sendto failed");
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+
+	rv = zsock_recvmsg_zc(server_sock, &msg, &ref, 0);
+	zassert_true(rv > 0 && rv < STRLEN(TEST_STR2), "unexpected length %d", rv);
+	zassert_true(msg.msg_flags & MSG_TRUNC, "not truncated");
+	zassert_mem_equal(io_vector[0].iov_base, TEST_STR2, rv, "wrong data");
+
+	rv = zsock_recv_zc_release(server_sock, &ref);
+	zassert_equal(rv, 0, "release failed");
+
+	/* An empty datagram is still lent out and must be released */
+	rv = sendto(client_sock, "", 0, 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, 0, "sendto failed");
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+
+	rv = zsock_recvmsg_zc(server_sock, &msg, &ref, 0);
+	zassert_equal(rv, 0, "unexpected length %d", rv);
+	zassert_equal(msg.msg_iovlen, 0, "wrong iovlen %zu", msg.msg_iovlen);
+	zassert_not_null(ref.pkt, "empty datagram not lent out");
+
+	rv = zsock_recv_zc_release(server_sock, &ref);
+	zassert_equal(rv, 0, "release failed");
+	zassert_is_null(ref.pkt, "reference not cleared");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+#endif /* CONFIG_NET_SOCKETS_RECV_ZEROCOPY */
+
 static void after(void *arg)
 {
 	ARG_UNUSED(arg);
@@ -136,6 +136,7 @@ static void handle_server_recv_out_of_order(struct net_pkt *pkt);
 static void handle_server_rst_on_closed_port(sa_family_t af, struct tcphdr *th);
 static void handle_server_rst_on_listening_port(sa_family_t af, struct tcphdr *th);
 static void handle_syn_invalid_ack(sa_family_t af, struct tcphdr *th);
+static void handle_link_emulation(struct net_pkt *pkt);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -485,6 +486,9 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 17:
 		handle_client_fin_wait_2_failure_test(net_pkt_family(pkt), &th);
 		break;
+	case 18:
+		handle_link_emulation(pkt);
+		break;
 
 	default:
 		zassert_true(false, "Undefined test case");
@@ -2005,7 +2009,7 @@ ZTEST(net_tcp, test_client_invalid_rst)
 {
 	struct net_context *ctx;
 	struct tcp *conn;
-	uint16_t wnd;
+	uint32_t wnd;
 
 	ctx = create_server_socket(0, 0);
 
@@ -2408,4 +2412,531 @@ ZTEST(net_tcp, test_client_rst_on_unexpected_ack_on_syn)
 	test_sem_take(K_MSEC(100), __LINE__);
 }
 
+/* Link emulation between two connections of the stack itself. A client
+ * bound to my_addr connects to the server port at peer_addr, and every
+ * packet sent to peer_addr comes back LINK_DELAY_MS later with the
+ * addresses swapped, so the client and a server bound to my_addr talk
+ * to each other. The data segments of the client whose index is set in
+ * link_drop_mask are lost on their first transmission.
+ */
+#define LINK_PORT 4243
+#define LINK_CLIENT_PORT 4244
+#define LINK_DELAY_MS 20
+#define LINK_QUEUE_LEN 32
+#define LINK_DATA_LEN (sizeof(lorem_ipsum) - 1)
+
+static struct {
+	struct net_pkt *pkt;
+	int64_t due;
+} link_queue[LINK_QUEUE_LEN];
+static int link_head;
+static int link_count;
+static struct k_spinlock link_lock;
+static struct k_work_delayable link_work;
+
+static uint32_t link_drop_mask;
+static uint32_t link_next_seq;
+static int link_data_segs;
+static int link_rexmit_segs;
+static bool link_sack_seen;
+static uint8_t link_wscale;
+static uint32_t link_max_win;
+static uint16_t link_max_retries;
+
+/* The next data segment of the client is preceded by a copy of it with
+ * an old timestamp and other data, which PAWS must drop.
+ */
+#define LINK_PAWS_AGE 100000U
+static bool link_paws_armed;
+static bool link_paws_sent;
+static bool link_paws_acked;
+static uint32_t link_paws_seq;
+
+/* Room for a byte sent after lorem_ipsum */
+static uint8_t link_rx_buf[LINK_DATA_LEN + 1];
+static size_t link_rx_len;
+static size_t link_rx_expected;
+static struct net_context *link_server;
+static struct net_context *link_client;
+static struct net_context *link_accepted_ctx;
+
+static void link_deliver(struct k_work *work)
+{
+	int64_t now = k_uptime_get();
+	struct net_pkt *pkt;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(work);
+
+	while (true) {
+		key = k_spin_lock(&link_lock);
+
+		if (link_count == 0) {
+			k_spin_unlock(&link_lock, key);
+			break;
+		}
+
+		if (link_queue[link_head].due > now) {
+			k_work_reschedule(&link_work,
+					  K_MSEC(link_queue[link_head].due - now));
+			k_spin_unlock(&link_lock, key);
+			break;
+		}
+
+		pkt = link_queue[link_head].pkt;
+		link_head = (link_head + 1) % LINK_QUEUE_LEN;
+		link_count--;
+
+		k_spin_unlock(&link_lock, key);
+
+		if (net_recv_data(net_iface, pkt) < 0) {
+			net_pkt_unref(pkt);
+		}
+	}
+}
+
+static void link_flush(void)
+{
+	k_spinlock_key_t key;
+
+	(void)k_work_cancel_delayable(&link_work);
+
+	key = k_spin_lock(&link_lock);
+
+	while (link_count > 0) {
+		net_pkt_unref(link_queue[link_head].pkt);
+		link_head = (link_head + 1) % LINK_QUEUE_LEN;
+		link_count--;
+	}
+
+	k_spin_unlock(&link_lock, key);
+}
+
+/* Look at the options of a segment the link carries */
+static void link_parse_options(struct net_pkt *pkt, struct tcphdr *th,
+			       bool from_server)
+{
+	uint8_t opts[40];
+	size_t len = (th->th_off - 5) * 4;
+	size_t i = 0;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (len == 0 ||
+	    net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+			 sizeof(struct tcphdr)) < 0 ||
+	    net_pkt_read(pkt, opts, len) < 0) {
+		return;
+	}
+
+	while (i < len && opts[i] != NET_TCP_END_OPT) {
+		if (opts[i] == NET_TCP_NOP_OPT) {
+			i++;
+			continue;
+		}
+
+		if (i + 1 >= len || opts[i + 1] < 2) {
+			break;
+		}
+
+		if (from_server && opts[i] == NET_TCP_SACK_OPT) {
+			link_sack_seen = true;
+		}
+
+		if (from_server && (th->th_flags & SYN) &&
+		    opts[i] == NET_TCP_WINDOW_SCALE_OPT) {
+			link_wscale = opts[i + 2];
+		}
+
+		i += opts[i + 1];
+	}
+}
+
+/* Make a copy of a data segment of the client look like an old
+ * duplicate: older timestamp, different data.
+ */
+static void link_make_stale(struct net_pkt *pkt, struct tcphdr *th,
+			    size_t data_len)
+{
+	size_t hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+			 sizeof(struct tcphdr);
+	size_t len = (th->th_off - 5) * 4;
+	uint8_t opts[40];
+	size_t i = 0;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	zassert_ok(net_pkt_skip(pkt, hdr_len), "Cannot skip header");
+	zassert_ok(net_pkt_read(pkt, opts, len), "Cannot read options");
+
+	while (i + 1 < len && opts[i] != NET_TCP_END_OPT) {
+		if (opts[i] == NET_TCP_NOP_OPT) {
+			i++;
+			continue;
+		}
+
+		if (opts[i] == NET_TCP_TIMESTAMPS_OPT) {
+			sys_put_be32(sys_get_be32(&opts[i + 2]) - LINK_PAWS_AGE,
+				     &opts[i + 2]);
+			break;
+		}
+
+		i += MAX(opts[i + 1], 2);
+	}
+
+	zassert_true(i + 1 < len && opts[i] == NET_TCP_TIMESTAMPS_OPT,
+		     "No timestamps in data segment");
+
+	net_pkt_cursor_init(pkt);
+	zassert_ok(net_pkt_skip(pkt, hdr_len), "Cannot skip header");
+	zassert_ok(net_pkt_write(pkt, opts, len), "Cannot write options");
+	zassert_ok(net_pkt_memset(pkt, '#', data_len), "Cannot write data");
+
+	net_pkt_cursor_init(pkt);
+}
+
+/* Hand a copy of pkt back to the stack with the addresses swapped */
+static void link_enqueue(struct net_pkt *pkt)
+{
+	struct net_ipv4_hdr *hdr;
+	struct in_addr addr;
+	k_spinlock_key_t key;
+
+	hdr = NET_IPV4_HDR(pkt);
+	net_ipv4_addr_copy_raw((uint8_t *)&addr, hdr->src);
+	net_ipv4_addr_copy_raw(hdr->src, hdr->dst);
+	net_ipv4_addr_copy_raw(hdr->dst, (uint8_t *)&addr);
+
+	key = k_spin_lock(&link_lock);
+
+	if (link_count == LINK_QUEUE_LEN) {
+		k_spin_unlock(&link_lock, key);
+		net_pkt_unref(pkt);
+		return;
+	}
+
+	link_queue[(link_head + link_count) % LINK_QUEUE_LEN].pkt = pkt;
+	link_queue[(link_head + link_count) % LINK_QUEUE_LEN].due =
+		k_uptime_get() + LINK_DELAY_MS;
+	if (link_count++ == 0) {
+		k_work_reschedule(&link_work, K_MSEC(LINK_DELAY_MS));
+	}
+
+	k_spin_unlock(&link_lock, key);
+}
+
+static void handle_link_emulation(struct net_pkt *pkt)
+{
+	struct net_pkt *clone;
+	struct tcphdr th;
+	size_t data_len;
+	bool from_server;
+
+	if (read_tcp_header(pkt, &th) < 0) {
+		zassert_true(false, "%s failed", __func__);
+		return;
+	}
+
+	/* Anything the link carries after a retransmission timeout, at
+	 * least the reply to the retransmission, sees the count raised.
+	 */
+	if (link_client != NULL && link_client->tcp != NULL) {
+		link_max_retries = MAX(link_max_retries,
+				       ((struct tcp *)link_client->tcp)->send_data_retries);
+	}
+
+	from_server = (th.th_sport == htons(LINK_PORT));
+	data_len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt) -
+		   net_pkt_ip_opts_len(pkt) - th.th_off * 4;
+
+	link_parse_options(pkt, &th, from_server);
+
+	if (from_server) {
+		if (!(th.th_flags & SYN)) {
+			link_max_win = MAX(link_max_win,
+					   (uint32_t)ntohs(th.th_win) << link_wscale);
+		}
+
+		/* The link is idle around the stale copy, so an ACK of its
+		 * sequence number without data is the reply to it.
+		 */
+		if (link_paws_sent && data_len == 0 && (th.th_flags & ACK) &&
+		    ntohl(th.th_ack) == link_paws_seq) {
+			link_paws_acked = true;
+		}
+	} else if (th.th_flags & SYN) {
+		link_next_seq = ntohl(th.th_seq) + 1U;
+	} else if (data_len > 0) {
+		uint32_t seg_seq = ntohl(th.th_seq);
+
+		if (net_tcp_seq_cmp(seg_seq, link_next_seq) >= 0) {
+			int idx = link_data_segs++;
+
+			link_next_seq = seg_seq + data_len;
+
+			if (idx < 32 && (link_drop_mask & BIT(idx))) {
+				NET_DBG("Link drops segment %d seq %u", idx, seg_seq);
+				return;
+			}
+		} else {
+			link_rexmit_segs++;
+		}
+
+		if (link_paws_armed) {
+			link_paws_armed = false;
+
+			clone = net_pkt_rx_clone(pkt, K_NO_WAIT);
+			zassert_not_null(clone, "Cannot clone packet");
+
+			link_make_stale(clone, &th, data_len);
+			link_paws_seq = seg_seq;
+			link_paws_sent = true;
+			link_enqueue(clone);
+		}
+	}
+
+	clone = net_pkt_rx_clone(pkt, K_NO_WAIT);
+	zassert_not_null(clone, "Cannot clone packet");
+
+	link_enqueue(clone);
+}
+
+static void link_recv_cb(struct net_context *context,
+			 struct net_pkt *pkt,
+			 union net_ip_header *ip_hdr,
+			 union net_proto_header *proto_hdr,
+			 int status,
+			 void *user_data)
+{
+	size_t len;
+
+	if (!pkt) {
+		return;
+	}
+
+	len = net_pkt_remaining_data(pkt);
+	if (link_rx_len + len <= sizeof(link_rx_buf)) {
+		(void)net_pkt_read(pkt, &link_rx_buf[link_rx_len], len);
+	}
+
+	link_rx_len += len;
+	net_pkt_unref(pkt);
+
+	/* The data is consumed, open the window again */
+	(void)net_context_update_recv_wnd(context, len);
+
+	if (link_rx_len >= link_rx_expected) {
+		test_sem_give();
+	}
+}
+
+static void link_accept_cb(struct net_context *ctx,
+			   struct sockaddr *addr,
+			   socklen_t addrlen,
+			   int status,
+			   void *user_data)
+{
+	zassert_equal(status, 0, "failed to accept the conn");
+
+	ctx->recv_cb = link_recv_cb;
+	link_accepted_ctx = ctx;
+
+	net_context_ref(ctx);
+
+	test_sem_give();
+}
+
+/* Connect a client to a server over the emulated link, which loses the
+ * data segments of the client in drop_mask once.
+ */
+static void link_open(uint32_t drop_mask)
+{
+	struct sockaddr_in server_addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LINK_PORT),
+		.sin_addr = { { { 192, 0, 2, 1 } } },
+	};
+	struct sockaddr_in client_addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LINK_CLIENT_PORT),
+		.sin_addr = { { { 192, 0, 2, 1 } } },
+	};
+	struct sockaddr_in remote_addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LINK_PORT),
+		.sin_addr = { { { 192, 0, 2, 2 } } },
+	};
+	int ret;
+
+	k_work_init_delayable(&link_work, link_deliver);
+	k_sem_reset(&test_sem);
+
+	link_drop_mask = drop_mask;
+	link_data_segs = 0;
+	link_rexmit_segs = 0;
+	link_sack_seen = false;
+	link_wscale = 0U;
+	link_max_win = 0U;
+	link_max_retries = 0U;
+	link_paws_armed = false;
+	link_paws_sent = false;
+	link_paws_acked = false;
+	link_rx_len = 0;
+	link_rx_expected = 0;
+	test_case_no = 18;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &link_server);
+	zassert_equal(ret, 0, "Failed to get net_context");
+
+	ret = net_context_bind(link_server, (struct sockaddr *)&server_addr,
+			       sizeof(server_addr));
+	zassert_equal(ret, 0, "Failed to bind net_context");
+
+	ret = net_context_listen(link_server, 1);
+	zassert_equal(ret, 0, "Failed to listen on net_context");
+
+	ret = net_context_accept(link_server, link_accept_cb, K_FOREVER, NULL);
+	zassert_equal(ret, 0, "Failed to set accept on net_context");
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &link_client);
+	zassert_equal(ret, 0, "Failed to get net_context");
+
+	ret = net_context_bind(link_client, (struct sockaddr *)&client_addr,
+			       sizeof(client_addr));
+	zassert_equal(ret, 0, "Failed to bind net_context");
+
+	ret = net_context_connect(link_client, (struct sockaddr *)&remote_addr,
+				  sizeof(remote_addr), NULL, K_MSEC(1000), NULL);
+	zassert_equal(ret, 0, "Connect failed (%d)", ret);
+
+	test_sem_take(K_MSEC(1000), __LINE__);
+}
+
+/* Send data from the client and wait until the server got all of it */
+static void link_send(const char *data, size_t len)
+{
+	int64_t deadline;
+	size_t sent = 0;
+	int ret;
+
+	link_rx_expected += len;
+
+	deadline = k_uptime_get() + 5 * MSEC_PER_SEC;
+	while (sent < len && k_uptime_get() < deadline) {
+		ret = net_context_send(link_client, &data[sent], len - sent,
+				       NULL, K_NO_WAIT, NULL);
+		if (ret == -EAGAIN) {
+			k_msleep(5);
+			continue;
+		}
+
+		zassert_true(ret > 0, "Send failed (%d)", ret);
+		sent += ret;
+	}
+
+	zassert_equal(sent, len, "Not all data was sent");
+
+	/* Leave time for a couple of retransmission timeouts */
+	test_sem_take(K_MSEC(3000), __LINE__);
+
+	zassert_equal(link_rx_len, link_rx_expected, "Received %zu bytes",
+		      link_rx_len);
+}
+
+static void link_close(void)
+{
+	struct net_context *client = link_client;
+
+	link_client = NULL;
+
+	net_context_put(client);
+	net_context_put(link_accepted_ctx);
+	net_context_put(link_server);
+
+	/* Let the connections close over the link before it goes away */
+	k_msleep(500);
+	link_flush();
+}
+
+/* Send lorem_ipsum from a client to a server over the emulated link,
+ * losing the data segments in drop_mask once.
+ */
+static void link_transfer(uint32_t drop_mask)
+{
+	link_open(drop_mask);
+	link_send(lorem_ipsum, LINK_DATA_LEN);
+
+	zassert_mem_equal(link_rx_buf, lorem_ipsum, LINK_DATA_LEN,
+			  "Received data does not match");
+
+	link_close();
+}
+
+ZTEST(net_tcp, test_link_delay)
+{
+	link_transfer(0U);
+
+	zassert_equal(link_rexmit_segs, 0, "%d segments retransmitted",
+		      link_rexmit_segs);
+}
+
+/* Two segments of one window are lost and the data still arrives in
+ * order. With SACK the receiver reports the data it queued after the
+ * first hole, and the sender fills the holes from the duplicate ACKs
+ * without waiting for the retransmission timer.
+ */
+ZTEST(net_tcp, test_link_loss)
+{
+	link_transfer(BIT(3) | BIT(5));
+
+	zassert_true(link_rexmit_segs >= 2, "Lost segments not retransmitted");
+
+#if defined(CONFIG_NET_TCP_SACK)
+	zassert_true(link_sack_seen, "No SACK option sent by the receiver");
+	zassert_equal(link_max_retries, 0U,
+		      "Holes were only resent after the retransmission timeout");
+#endif
+}
+
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+/* A segment carrying the next expected data but an older timestamp than
+ * the last one seen is an old duplicate: it is dropped and ACKed, and
+ * the data of the real segment is received.
+ */
+ZTEST(net_tcp, test_link_paws)
+{
+	link_open(0U);
+	link_send(lorem_ipsum, LINK_DATA_LEN);
+
+	/* Let the last ACKs cross the link first */
+	k_msleep(4 * LINK_DELAY_MS);
+
+	link_paws_armed = true;
+	link_send("!", 1);
+
+	zassert_true(link_paws_sent, "No stale segment sent");
+	zassert_true(link_paws_acked, "Stale segment not ACKed");
+	zassert_mem_equal(link_rx_buf, lorem_ipsum, LINK_DATA_LEN,
+			  "Received data does not match");
+	zassert_equal(link_rx_buf[LINK_DATA_LEN], '!',
+		      "Data of the stale segment received");
+
+	link_close();
+}
+#endif
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+/* The receive window is larger than the window field can hold */
+ZTEST(net_tcp, test_link_window_scale)
+{
+	link_transfer(0U);
+
+	zassert_true(link_wscale > 0U, "No window scale offered");
+	zassert_true(link_max_win > UINT16_MAX, "Window of %u not scaled",
+		     link_max_win);
+}
+#endif
+
 ZTEST_SUITE(net_tcp, NULL, presetup, NULL, NULL, NULL);
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_L2_ETHERNET_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <string.h>
+#include <errno.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/random/random.h>
+
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_if.h>
+
+#include "ipv4.h"
+#include "tcp.h"
+#include "tcp_private.h"
+#include "net_private.h"
+
+/* Segment size and payload of the GSO packets sent by the tests, which
+ * ends with a segment shorter than the others.
+ */
+#define TEST_MSS	500
+#define TEST_LEN	(3 * TEST_MSS + 123)
+#define TEST_SEGS	DIV_ROUND_UP(TEST_LEN, TEST_MSS)
+
+/* Sequence number of the first byte, the segments wrap around 0 */
+#define TEST_SEQ	0xfffffe00U
+
+#define WAIT_TIME K_MSEC(500)
+
+static struct in_addr in4addr_gso = { { { 192, 0, 2, 1 } } };
+static struct in_addr in4addr_tso = { { { 192, 0, 42, 1 } } };
+static struct in_addr in4addr_dst = { { { 192, 0, 2, 2 } } };
+static struct in_addr in4addr_dst2 = { { { 192, 0, 42, 2 } } };
+
+struct eth_context {
+	struct net_if *iface;
+	uint8_t mac_addr[6];
+};
+
+static struct eth_context eth_context_gso;
+static struct eth_context eth_context_tso;
+
+/* What the driver saw of each packet it was given */
+struct sent_pkt {
+	uint32_t seq;
+	uint8_t flags;
+	size_t len;
+	uint16_t gso_size;
+	bool ip_chksum_ok;
+	bool tcp_chksum_ok;
+	bool data_ok;
+};
+
+static struct sent_pkt sent[TEST_SEGS];
+static int sent_count;
+static K_SEM_DEFINE(wait_sent, 0, UINT_MAX);
+
+static uint8_t payload[TEST_LEN];
+static uint8_t frame[sizeof(struct net_eth_hdr) + NET_IPV4H_LEN +
+		     NET_TCPH_LEN + TEST_LEN];
+
+static uint16_t chksum_add(uint32_t sum, const uint8_t *data, size_t len)
+{
+	for ( ; len > 1; data += 2, len -= 2) {
+		sum += sys_get_be16(data);
+	}
+
+	if (len > 0) {
+		sum += (uint32_t)data[0] << 8;
+	}
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return sum;
+}
+
+static void check_sent(struct net_pkt *pkt, struct sent_pkt *s)
+{
+	size_t len = net_pkt_get_len(pkt);
+	size_t ip_hdr_len, ip_len, tcp_len, tcp_hdr_len;
+	uint32_t offset;
+	uint8_t *ip, *th;
+
+	zassert_true(len <= sizeof(frame), "Packet too long (%zu)", len);
+
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+	zassert_ok(net_pkt_read(pkt, frame, len), "Cannot read packet");
+
+	ip = frame + sizeof(struct net_eth_hdr);
+	ip_hdr_len = (ip[0] & 0x0f) * 4U;
+	ip_len = sys_get_be16(&ip[2]);
+	zassert_equal(ip_len, len - sizeof(struct net_eth_hdr),
+		      "Wrong IPv4 length %zu", ip_len);
+
+	th = ip + ip_hdr_len;
+	tcp_len = ip_len - ip_hdr_len;
+	tcp_hdr_len = (th[12] >> 4) * 4U;
+
+	s->seq = sys_get_be32(&th[4]);
+	s->flags = th[13];
+	s->len = tcp_len - tcp_hdr_len;
+	s->gso_size = net_pkt_gso_size(pkt);
+	s->ip_chksum_ok = chksum_add(0, ip, ip_hdr_len) == 0xffff;
+
+	/* Pseudo header: addresses, protocol and TCP length */
+	s->tcp_chksum_ok = chksum_add(chksum_add(IPPROTO_TCP + tcp_len, &ip[12], 8),
+				      th, tcp_len) == 0xffff;
+
+	offset = s->seq - TEST_SEQ;
+	s->data_ok = offset + s->len <= TEST_LEN &&
+		     memcmp(th + tcp_hdr_len, &payload[offset], s->len) == 0;
+}
+
+static int eth_tx(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+
+	if (sent_count < ARRAY_SIZE(sent)) {
+		check_sent(pkt, &sent[sent_count]);
+	}
+
+	sent_count++;
+	k_sem_give(&wait_sent);
+
+	return 0;
+}
+
+static enum ethernet_hw_caps eth_gso_caps(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static enum ethernet_hw_caps eth_tso_caps(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return ETHERNET_HW_TX_TSO;
+}
+
+static void eth_iface_init(struct net_if *iface)
+{
+	const struct device *dev = net_if_get_device(iface);
+	struct eth_context *context = dev->data;
+
+	context->iface = iface;
+
+	net_if_set_link_addr(iface, context->mac_addr,
+			     sizeof(context->mac_addr),
+			     NET_LINK_ETHERNET);
+
+	ethernet_init(iface);
+}
+
+static int eth_init(const struct device *dev)
+{
+	struct eth_context *context = dev->data;
+
+	/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+	context->mac_addr[0] = 0x00;
+	context->mac_addr[1] = 0x00;
+	context->mac_addr[2] = 0x5E;
+	context->mac_addr[3] = 0x00;
+	context->mac_addr[4] = 0x53;
+	context->mac_addr[5] = sys_rand32_get();
+
+	return 0;
+}
+
+static struct ethernet_api api_funcs_gso = {
+	.iface_api.init = eth_iface_init,
+
+	.get_capabilities = eth_gso_caps,
+	.send = eth_tx,
+};
+
+static struct ethernet_api api_funcs_tso = {
+	.iface_api.init = eth_iface_init,
+
+	.get_capabilities = eth_tso_caps,
+	.send = eth_tx,
+};
+
+ETH_NET_DEVICE_INIT(eth_gso_test, "eth_gso_test",
+		    eth_init, NULL, &eth_context_gso, NULL,
+		    CONFIG_ETH_INIT_PRIORITY, &api_funcs_gso,
+		    NET_ETH_MTU);
+
+ETH_NET_DEVICE_INIT(eth_tso_test, "eth_tso_test",
+		    eth_init, NULL, &eth_context_tso, NULL,
+		    CONFIG_ETH_INIT_PRIORITY, &api_funcs_tso,
+		    NET_ETH_MTU);
+
+static void iface_setup(struct net_if *iface, struct in_addr *addr)
+{
+	struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+	struct net_if_addr *ifaddr;
+
+	ifaddr = net_if_ipv4_addr_add(iface, addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	net_if_ipv4_set_netmask_by_addr(iface, addr, &netmask);
+	net_if_up(iface);
+}
+
+static void *tcp_gso_setup(void)
+{
+	for (int i = 0; i < TEST_LEN; i++) {
+		payload[i] = i * 7;
+	}
+
+	iface_setup(eth_context_gso.iface, &in4addr_gso);
+	iface_setup(eth_context_tso.iface, &in4addr_tso);
+
+	return NULL;
+}
+
+static void tcp_gso_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(sent, 0, sizeof(sent));
+	sent_count = 0;
+	k_sem_reset(&wait_sent);
+}
+
+/* Send a TCP packet of TEST_LEN bytes of payload in segments of TEST_MSS
+ * bytes, as tcp_send_data() builds them.
+ */
+static void send_gso_pkt(struct net_if *iface, struct in_addr *src,
+			 struct in_addr *dst, uint8_t flags)
+{
+	struct net_tcp_hdr tcp_hdr = { 0 };
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_on_iface(iface, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	net_pkt_set_family(pkt, AF_INET);
+	zassert_ok(net_pkt_alloc_buffer_raw(pkt, NET_IPV4H_LEN + NET_TCPH_LEN +
+					    TEST_LEN, K_NO_WAIT),
+		   "Cannot allocate buffer");
+
+	zassert_ok(net_ipv4_create(pkt, src, dst), "Cannot create IPv4 header");
+
+	tcp_hdr.src_port = htons(4242);
+	tcp_hdr.dst_port = htons(4243);
+	sys_put_be32(TEST_SEQ, tcp_hdr.seq);
+	sys_put_be32(1, tcp_hdr.ack);
+	tcp_hdr.offset = (NET_TCPH_LEN / 4U) << 4;
+	tcp_hdr.flags = flags;
+	sys_put_be16(1024, tcp_hdr.wnd);
+
+	zassert_ok(net_pkt_write(pkt, &tcp_hdr, sizeof(tcp_hdr)));
+	zassert_ok(net_pkt_write(pkt, payload, TEST_LEN));
+
+	net_pkt_set_gso_size(pkt, TEST_MSS);
+	net_pkt_cursor_init(pkt);
+	zassert_ok(net_ipv4_finalize(pkt, IPPROTO_TCP), "Cannot finalize");
+
+	zassert_ok(net_send_data(pkt), "Cannot send packet");
+}
+
+static void check_segments(uint8_t flags)
+{
+	for (int i = 0; i < TEST_SEGS; i++) {
+		zassert_ok(k_sem_take(&wait_sent, WAIT_TIME),
+			   "Segment %d not sent", i);
+	}
+
+	zassert_equal(k_sem_take(&wait_sent, WAIT_TIME), -EAGAIN,
+		      "More than %d segments sent", TEST_SEGS);
+
+	for (int i = 0; i < TEST_SEGS; i++) {
+		struct sent_pkt *s = &sent[i];
+		bool last = i == TEST_SEGS - 1;
+
+		zassert_equal(s->seq, TEST_SEQ + i * TEST_MSS,
+			      "Segment %d: wrong seq %u", i, s->seq);
+		zassert_equal(s->len, last ? TEST_LEN - i * TEST_MSS : TEST_MSS,
+			      "Segment %d: wrong length %zu", i, s->len);
+		zassert_equal(s->flags, last ? flags : flags & ~(PSH | FIN),
+			      "Segment %d: wrong flags 0x%02x", i, s->flags);
+		zassert_equal(s->gso_size, 0, "Segment %d: GSO size left", i);
+		zassert_true(s->ip_chksum_ok, "Segment %d: bad IPv4 checksum", i);
+		zassert_true(s->tcp_chksum_ok, "Segment %d: bad TCP checksum", i);
+		zassert_true(s->data_ok, "Segment %d: wrong data", i);
+	}
+}
+
+ZTEST(net_tcp_gso, test_gso_segments)
+{
+	send_gso_pkt(eth_context_gso.iface, &in4addr_gso, &in4addr_dst,
+		     PSH | ACK);
+	check_segments(PSH | ACK);
+}
+
+ZTEST(net_tcp_gso, test_gso_segments_fin)
+{
+	send_gso_pkt(eth_context_gso.iface, &in4addr_gso, &in4addr_dst,
+		     FIN | PSH | ACK);
+	check_segments(FIN | PSH | ACK);
+}
+
+ZTEST(net_tcp_gso, test_tso_passthrough)
+{
+	struct sent_pkt *s = &sent[0];
+
+	send_gso_pkt(eth_context_tso.iface, &in4addr_tso, &in4addr_dst2,
+		     PSH | ACK);
+
+	zassert_ok(k_sem_take(&wait_sent, WAIT_TIME), "Packet not sent");
+	zassert_equal(k_sem_take(&wait_sent, WAIT_TIME), -EAGAIN,
+		      "Packet was segmented");
+
+	/* The driver segments it, filling in the TCP checksums */
+	zassert_equal(s->seq, TEST_SEQ, "Wrong seq %u", s->seq);
+	zassert_equal(s->len, TEST_LEN, "Wrong length %zu", s->len);
+	zassert_equal(s->flags, PSH | ACK, "Wrong flags 0x%02x", s->flags);
+	zassert_equal(s->gso_size, TEST_MSS, "Wrong GSO size %u", s->gso_size);
+	zassert_true(s->data_ok, "Wrong data");
+}
+
+ZTEST_SUITE(net_tcp_gso, NULL, tcp_gso_setup, tcp_gso_before, NULL, NULL);
@@ -923,4 +923,26 @@ ZTEST(test_utils_fn, test_ip_checksum)
 	}
 }
 
+/* All ones maximizes the carries out of the accumulators, every start
+ * alignment up to the size of a vector is covered.
+ */
+ZTEST(test_utils_fn, test_ip_checksum_carries)
+{
+	uint16_t sum_got;
+	uint16_t sum_exp;
+
+	memset(testdata, 0xff, sizeof(testdata));
+
+	for (int offset = 0; offset < 32; offset++) {
+		for (int length = 1; length <= CHECKSUM_TEST_LENGTH - 32;
+		     length += 61) {
+			sum_got = calc_chksum_ref(0xffff, testdata + offset, length);
+			sum_exp = calc_chksum(0xffff, testdata + offset, length);
+
+			zassert_equal(sum_got, sum_exp,
+				      "Mismatch between reference and calculated checksum\n");
+		}
+	}
+}
+
 ZTEST_SUITE(test_utils_fn, NULL, NULL, NULL, NULL, NULL);
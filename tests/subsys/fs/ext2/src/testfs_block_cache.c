@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2024 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/storage/disk_access.h>
+
+#include "ext2_impl.h"
+#include "ext2_diskops.h"
+#include "utils.h"
+
+#ifdef CONFIG_EXT2_BLOCK_CACHE
+#define CACHE_BLOCKS (CONFIG_EXT2_MAX_BLOCK_COUNT + CONFIG_EXT2_BLOCK_CACHE_COUNT)
+#else
+#define CACHE_BLOCKS CONFIG_EXT2_MAX_BLOCK_COUNT
+#endif
+
+/* Without the write back thread, dirty blocks stay in the cache until written back */
+#if defined(CONFIG_EXT2_BLOCK_CACHE) && CONFIG_EXT2_BLOCK_CACHE_FLUSH_INTERVAL > 0
+#define NO_FLUSH_THREAD false
+#else
+#define NO_FLUSH_THREAD true
+#endif
+
+static uint8_t disk_buf[CONFIG_EXT2_MAX_BLOCK_SIZE];
+
+static struct ext2_data *cache_test_mount(void)
+{
+	struct fs_mount_t *mp = &testfs_mnt;
+	int ret;
+
+	ret = fs_mkfs(FS_EXT2, (uintptr_t)mp->storage_dev, NULL, 0);
+	zassert_equal(ret, 0, "Failed to mkfs (ret=%d)", ret);
+
+	mp->flags = FS_MOUNT_FLAG_NO_FORMAT;
+	ret = fs_mount(mp);
+	zassert_equal(ret, 0, "Mount failed (ret=%d)", ret);
+
+	return mp->fs_data;
+}
+
+/* Read a file system block from the disk, not from the block cache */
+static void disk_read_block(uint32_t block_size, uint32_t num)
+{
+	const char *disk = testfs_mnt.storage_dev;
+	uint32_t ss;
+	int ret;
+
+	ret = disk_access_ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE, &ss);
+	zassert_equal(ret, 0, "Disk ioctl get sector size failed (ret=%d)", ret);
+
+	ret = disk_access_read(disk, disk_buf,
+			       CONFIG_EXT2_DISK_STARTING_SECTOR + num * (block_size / ss),
+			       block_size / ss);
+	zassert_equal(ret, 0, "Disk read failed (ret=%d)", ret);
+}
+
+static bool block_on_disk(uint32_t block_size, uint32_t num, uint8_t val)
+{
+	disk_read_block(block_size, num);
+
+	for (uint32_t i = 0; i < block_size; i++) {
+		if (disk_buf[i] != val) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Look for a block of the file system holding data on the disk */
+static bool data_on_disk(struct ext2_data *fs, const uint8_t *data)
+{
+	for (uint32_t num = 0; num < fs->sblock.s_blocks_count; num++) {
+		disk_read_block(fs->block_size, num);
+		if (memcmp(disk_buf, data, fs->block_size) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Take a new block of the file system and fill it with val */
+static struct ext2_block *new_block(struct ext2_data *fs, uint8_t val)
+{
+	struct ext2_block *b;
+	int ret;
+
+	b = ext2_get_empty_block(fs);
+	zassert_not_null(b, "Failed to get an empty block");
+
+	ret = ext2_assign_block_num(fs, b);
+	zassert_equal(ret, 0, "Failed to assign a block number (ret=%d)", ret);
+
+	memset(b->data, val, fs->block_size);
+	ret = ext2_write_block(fs, b);
+	zassert_equal(ret, 0, "Block write failed (ret=%d)", ret);
+
+	return b;
+}
+
+/* A freed block allocated again is not found with its former contents */
+ZTEST(ext2tests, test_block_cache_reuse_freed)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_EXT2_BLOCK_CACHE);
+
+	struct ext2_data *fs = cache_test_mount();
+	struct ext2_block *b;
+	uint32_t num;
+	int ret;
+
+	b = new_block(fs, 0xa1);
+	num = b->num;
+	ext2_drop_block(b);
+
+	/* Its dirty copy is still in the cache */
+	ret = ext2_free_block(fs, num);
+	zassert_equal(ret, 0, "Block free failed (ret=%d)", ret);
+
+	b = new_block(fs, 0xb2);
+	zassert_equal(b->num, num, "Freed block %d not reused (got %d)", num, b->num);
+	ext2_drop_block(b);
+
+	b = ext2_get_block(fs, num);
+	zassert_not_null(b, "Failed to get block %d", num);
+	zassert_equal(b->data[0], 0xb2, "Former contents of block %d found", num);
+	ext2_drop_block(b);
+
+	ret = ext2_sync_fs(fs);
+	zassert_equal(ret, 0, "Sync failed (ret=%d)", ret);
+	zassert_true(block_on_disk(fs->block_size, num, 0xb2),
+		     "Block %d overwritten with its former contents", num);
+}
+
+/* A write of a block freed and allocated again while in use is dropped */
+ZTEST(ext2tests, test_block_cache_stale_write)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_EXT2_BLOCK_CACHE);
+
+	struct ext2_data *fs = cache_test_mount();
+	struct ext2_block *stale, *b;
+	uint32_t num;
+	int ret;
+
+	stale = new_block(fs, 0xa1);
+	num = stale->num;
+
+	ret = ext2_free_block(fs, num);
+	zassert_equal(ret, 0, "Block free failed (ret=%d)", ret);
+
+	b = new_block(fs, 0xb2);
+	zassert_equal(b->num, num, "Freed block %d not reused (got %d)", num, b->num);
+	ext2_drop_block(b);
+
+	memset(stale->data, 0xc3, fs->block_size);
+	ret = ext2_write_block(fs, stale);
+	zassert_equal(ret, 0, "Block write failed (ret=%d)", ret);
+	ext2_drop_block(stale);
+
+	b = ext2_get_block(fs, num);
+	zassert_not_null(b, "Failed to get block %d", num);
+	zassert_equal(b->data[0], 0xb2, "Stale write of block %d found", num);
+	ext2_drop_block(b);
+
+	ret = ext2_sync_fs(fs);
+	zassert_equal(ret, 0, "Sync failed (ret=%d)", ret);
+	zassert_true(block_on_disk(fs->block_size, num, 0xb2),
+		     "Stale write of block %d reached the disk", num);
+}
+
+/* Dirty blocks evicted from the cache are written back */
+ZTEST(ext2tests, test_block_cache_evict)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_EXT2_BLOCK_CACHE);
+
+	struct ext2_data *fs = cache_test_mount();
+	struct ext2_block *b;
+	uint32_t nums[2 * CACHE_BLOCKS];
+
+	for (int i = 0; i < ARRAY_SIZE(nums); i++) {
+		b = new_block(fs, (uint8_t)(0x40 + i));
+		nums[i] = b->num;
+		ext2_drop_block(b);
+	}
+
+	/* The cache holds at most CACHE_BLOCKS blocks, the first ones were evicted */
+	for (int i = 0; i < CACHE_BLOCKS; i++) {
+		zassert_true(block_on_disk(fs->block_size, nums[i], (uint8_t)(0x40 + i)),
+			     "Evicted block %d not written back", nums[i]);
+	}
+}
+
+/* Data written to a file is on the disk after fs_sync() */
+ZTEST(ext2tests, test_block_cache_sync)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_EXT2_BLOCK_CACHE);
+
+	struct ext2_data *fs = cache_test_mount();
+	static uint8_t data[CONFIG_EXT2_MAX_BLOCK_SIZE];
+	uint32_t bs = fs->block_size;
+	struct fs_file_t file;
+	int ret;
+
+	for (uint32_t i = 0; i < bs; i++) {
+		data[i] = (uint8_t)(i * 7 + 0x5a);
+	}
+
+	fs_file_t_init(&file);
+	ret = fs_open(&file, "/sml/synced", FS_O_RDWR | FS_O_CREATE);
+	zassert_equal(ret, 0, "File open failed (ret=%d)", ret);
+
+	ret = fs_write(&file, data, bs);
+	zassert_equal(ret, bs, "File write failed (ret=%d)", ret);
+
+	if (NO_FLUSH_THREAD) {
+		zassert_false(data_on_disk(fs, data), "File data written before sync");
+	}
+
+	ret = fs_sync(&file);
+	zassert_equal(ret, 0, "File sync failed (ret=%d)", ret);
+	zassert_true(data_on_disk(fs, data), "File data not written on sync");
+
+	ret = fs_close(&file);
+	zassert_equal(ret, 0, "File close failed (ret=%d)", ret);
+}
+
+/* Dirty blocks are on the disk after unmount */
+ZTEST(ext2tests, test_block_cache_unmount)
+{
+	Z_TEST_SKIP_IFNDEF(CONFIG_EXT2_BLOCK_CACHE);
+
+	struct ext2_data *fs = cache_test_mount();
+	uint32_t bs = fs->block_size;
+	struct ext2_block *b;
+	uint32_t num;
+	int ret;
+
+	b = new_block(fs, 0xd4);
+	num = b->num;
+	ext2_drop_block(b);
+
+	if (NO_FLUSH_THREAD) {
+		zassert_false(block_on_disk(bs, num, 0xd4), "Block %d written before unmount",
+			      num);
+	}
+
+	ret = fs_unmount(&testfs_mnt);
+	zassert_equal(ret, 0, "Unmount failed (ret=%d)", ret);
+	zassert_true(block_on_disk(bs, num, 0xd4), "Block %d not written on unmount", num);
+}
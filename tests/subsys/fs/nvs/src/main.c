@@ -626,6 +626,147 @@ ZTEST_F(nvs, test_delete)
 		     " any footprint in the storage");
 }
 
+struct walk_result {
+	uint16_t seen;
+	uint16_t value[10];
+	bool deleted[10];
+	int visits;
+};
+
+static int walk_cb(struct nvs_fs *fs, const struct nvs_entry *entry, void *arg)
+{
+	struct walk_result *res = arg;
+	uint16_t data;
+	ssize_t len;
+
+	res->visits++;
+
+	zassert_true(entry->id < ARRAY_SIZE(res->value), "unexpected id %u", entry->id);
+
+	/* only the most recent entry of an id counts */
+	if (res->seen & BIT(entry->id)) {
+		return 0;
+	}
+	res->seen |= BIT(entry->id);
+
+	if (entry->len == 0U) {
+		res->deleted[entry->id] = true;
+		return 0;
+	}
+
+	len = nvs_entry_read(fs, entry, 0, &data, sizeof(data));
+	zassert_equal(len, sizeof(data), "nvs_entry_read failed: %d", len);
+	res->value[entry->id] = data;
+
+	return 0;
+}
+
+static int walk_stop_cb(struct nvs_fs *fs, const struct nvs_entry *entry, void *arg)
+{
+	int *visits = arg;
+
+	return ++(*visits) == 3 ? 1 : 0;
+}
+
+ZTEST_F(nvs, test_nvs_walk)
+{
+	struct walk_result res = { 0 };
+	uint16_t data;
+	ssize_t len;
+	int err, visits = 0;
+
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0,  "nvs_mount call failure: %d", err);
+
+	for (uint16_t id = 0; id < ARRAY_SIZE(res.value); id++) {
+		data = id;
+		len = nvs_write(&fixture->fs, id, &data, sizeof(data));
+		zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+	}
+
+	data = 100;
+	len = nvs_write(&fixture->fs, 3, &data, sizeof(data));
+	zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+
+	err = nvs_delete(&fixture->fs, 5);
+	zassert_true(err == 0,  "nvs_delete call failure: %d", err);
+
+	err = nvs_walk(&fixture->fs, walk_cb, &res);
+	zassert_true(err == 0,  "nvs_walk call failure: %d", err);
+
+	zassert_equal(res.visits, ARRAY_SIZE(res.value) + 2, "wrong number of entries visited");
+	zassert_equal(res.seen, BIT_MASK(ARRAY_SIZE(res.value)), "not all ids seen");
+
+	for (uint16_t id = 0; id < ARRAY_SIZE(res.value); id++) {
+		if (id == 5) {
+			zassert_true(res.deleted[id], "deletion not seen first");
+		} else {
+			zassert_false(res.deleted[id], "unexpected deletion");
+			zassert_equal(res.value[id], id == 3 ? 100 : id,
+				      "wrong data for id %u", id);
+		}
+	}
+
+	/* a non zero return stops the walk */
+	err = nvs_walk(&fixture->fs, walk_stop_cb, &visits);
+	zassert_equal(err, 1, "nvs_walk didn't return the callback value: %d", err);
+	zassert_equal(visits, 3, "nvs_walk didn't stop");
+}
+
+struct walk_write_result {
+	struct nvs_entry stale;
+	bool written;
+	int visits;
+};
+
+static int walk_write_cb(struct nvs_fs *fs, const struct nvs_entry *entry, void *arg)
+{
+	struct walk_write_result *res = arg;
+	uint16_t data = 200;
+	ssize_t len;
+
+	res->visits++;
+
+	if (res->written) {
+		return 0;
+	}
+
+	/* the file system is not locked while the callback runs */
+	len = nvs_write(fs, 10, &data, sizeof(data));
+	zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+	res->written = true;
+	res->stale = *entry;
+
+	return 0;
+}
+
+ZTEST_F(nvs, test_nvs_walk_write)
+{
+	struct walk_write_result res = { 0 };
+	uint16_t data;
+	ssize_t len;
+	int err;
+
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0,  "nvs_mount call failure: %d", err);
+
+	for (uint16_t id = 0; id < 4; id++) {
+		data = id;
+		len = nvs_write(&fixture->fs, id, &data, sizeof(data));
+		zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+	}
+
+	err = nvs_walk(&fixture->fs, walk_write_cb, &res);
+	zassert_true(err == 0,  "nvs_walk call failure: %d", err);
+
+	/* the walk started over from the new entry after the write */
+	zassert_equal(res.visits, 1 + 5, "wrong number of entries visited: %d", res.visits);
+
+	/* the entry found before the write can't be read anymore */
+	len = nvs_entry_read(&fixture->fs, &res.stale, 0, &data, sizeof(data));
+	zassert_equal(len, -EAGAIN, "stale entry read didn't fail: %d", len);
+}
+
 /*
  * Test that garbage-collection can recover all ate's even when the last ate,
  * ie close_ate, is corrupt. In this test the close_ate is set to point to the
@@ -934,3 +1075,201 @@ ZTEST_F(nvs, test_nvs_cache_hash_quality)
 
 #endif
 }
+
+#ifdef CONFIG_NVS_ATE_INDEX
+static size_t num_index_entries(uint32_t sector, struct nvs_fs *fs)
+{
+	size_t i, num = 0;
+
+	for (i = 0; i < CONFIG_NVS_ATE_INDEX_SIZE; i++) {
+		if ((fs->ate_index[i].ate_addr != NVS_LOOKUP_CACHE_NO_ADDR) &&
+		    ((fs->ate_index[i].ate_addr >> ADDR_SECT_SHIFT) == sector)) {
+			num++;
+		}
+	}
+
+	return num;
+}
+
+static uint16_t live_bytes(struct nvs_fs *fs, size_t len)
+{
+	size_t wbs = fs->flash_parameters->write_block_size;
+
+	return ROUND_UP(len, wbs) + ROUND_UP(sizeof(struct nvs_ate), wbs);
+}
+
+static bool index_has(struct nvs_fs *fs, const struct nvs_ate_index_entry *entry)
+{
+	for (size_t i = 0; i < CONFIG_NVS_ATE_INDEX_SIZE; i++) {
+		if ((fs->ate_index[i].ate_addr == entry->ate_addr) &&
+		    (fs->ate_index[i].id == entry->id) &&
+		    (fs->ate_index[i].offset == entry->offset) &&
+		    (fs->ate_index[i].len == entry->len)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Check that the index built by nvs_mount() is the one kept up to date */
+static void check_index_rebuild(struct nvs_fs *fs)
+{
+	struct nvs_ate_index_entry ate_index[CONFIG_NVS_ATE_INDEX_SIZE];
+	uint16_t sector_live[CONFIG_NVS_ATE_INDEX_MAX_SECTORS];
+	size_t num = 0;
+	int err;
+
+	memcpy(ate_index, fs->ate_index, sizeof(ate_index));
+	memcpy(sector_live, fs->sector_live, sizeof(sector_live));
+
+	memset(fs->ate_index, 0xAA, sizeof(fs->ate_index));
+	memset(fs->sector_live, 0xAA, sizeof(fs->sector_live));
+	err = nvs_mount(fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+	zassert_true(fs->ate_index_complete, "index not complete after mount");
+
+	/* IDs may land in other slots, as they are added in another order */
+	for (size_t i = 0; i < CONFIG_NVS_ATE_INDEX_SIZE; i++) {
+		if (ate_index[i].ate_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+			continue;
+		}
+
+		zassert_true(index_has(fs, &ate_index[i]), "index entry lost after mount");
+		num++;
+	}
+
+	for (size_t i = 0; i < CONFIG_NVS_ATE_INDEX_SIZE; i++) {
+		if (fs->ate_index[i].ate_addr != NVS_LOOKUP_CACHE_NO_ADDR) {
+			num--;
+		}
+	}
+	zassert_equal(num, 0, "index entry added after mount");
+	zassert_mem_equal(sector_live, fs->sector_live, sizeof(sector_live),
+			  "invalid live bytes after mount");
+}
+#endif
+
+/*
+ * Test that NVS ATE index is built on nvs_mount() and kept up to date by
+ * writes and deletes.
+ */
+ZTEST_F(nvs, test_nvs_ate_index_init)
+{
+#ifdef CONFIG_NVS_ATE_INDEX
+	int err;
+	ssize_t len;
+	uint16_t data = 0;
+
+	fixture->fs.sector_count = 3;
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+	zassert_true(fixture->fs.ate_index_complete, "index not complete");
+	zassert_equal(num_index_entries(0, &fixture->fs), 0, "uninitialized index");
+
+	err = nvs_write(&fixture->fs, 1, &data, sizeof(data));
+	zassert_equal(err, sizeof(data), "nvs_write call failure: %d", err);
+	err = nvs_write(&fixture->fs, 2, &data, sizeof(data));
+	zassert_equal(err, sizeof(data), "nvs_write call failure: %d", err);
+	err = nvs_delete(&fixture->fs, 2);
+	zassert_true(err == 0, "nvs_delete call failure: %d", err);
+
+	/* The deletion is indexed but only the data of ID 1 is in use */
+	zassert_equal(num_index_entries(0, &fixture->fs), 2,
+		      "index not updated after write");
+	zassert_equal(fixture->fs.sector_live[0], live_bytes(&fixture->fs, sizeof(data)),
+		      "invalid live bytes after write");
+
+	len = nvs_read(&fixture->fs, 2, &data, sizeof(data));
+	zassert_equal(len, -ENOENT, "deleted entry found: %d", (int)len);
+
+	check_index_rebuild(&fixture->fs);
+#endif
+}
+
+/*
+ * Test that NVS ATE index follows gc, and that history reads walking from
+ * the indexed ATE find the older data.
+ */
+ZTEST_F(nvs, test_nvs_ate_index_gc)
+{
+#ifdef CONFIG_NVS_ATE_INDEX
+	int err;
+	ssize_t len;
+	uint16_t data = 0, rd_data;
+
+	fixture->fs.sector_count = 3;
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	/* Fill the first sector with writes of ID 1 */
+
+	while (fixture->fs.data_wra + sizeof(data) + sizeof(struct nvs_ate)
+	       <= fixture->fs.ate_wra) {
+		++data;
+		err = nvs_write(&fixture->fs, 1, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_write call failure: %d", err);
+	}
+
+	/* Fill the second sector with writes of ID 2, gc-ing the first one */
+
+	while ((fixture->fs.ate_wra >> ADDR_SECT_SHIFT) != 2) {
+		++data;
+		err = nvs_write(&fixture->fs, 2, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_write call failure: %d", err);
+	}
+
+	zassert_true(fixture->fs.ate_index_complete, "index not complete");
+	zassert_equal(num_index_entries(0, &fixture->fs), 0,
+		      "index entries left in gc-ed sector");
+	zassert_equal(fixture->fs.sector_live[0], 0, "live bytes left in gc-ed sector");
+	zassert_equal(num_index_entries(2, &fixture->fs), 2, "invalid index after gc");
+	zassert_equal(fixture->fs.sector_live[2], 2 * live_bytes(&fixture->fs, sizeof(data)),
+		      "invalid live bytes after gc");
+
+	len = nvs_read(&fixture->fs, 2, &rd_data, sizeof(rd_data));
+	zassert_equal(len, sizeof(rd_data), "nvs_read call failure: %d", (int)len);
+	zassert_equal(rd_data, data, "incorrect data read");
+
+	len = nvs_read_hist(&fixture->fs, 2, &rd_data, sizeof(rd_data), 1);
+	zassert_equal(len, sizeof(rd_data), "nvs_read_hist call failure: %d", (int)len);
+	zassert_equal(rd_data, data - 1, "incorrect history data read");
+
+	check_index_rebuild(&fixture->fs);
+#endif
+}
+
+/*
+ * Test that NVS falls back to walking the ATEs when there are more IDs than
+ * the ATE index can hold.
+ */
+ZTEST_F(nvs, test_nvs_ate_index_full)
+{
+#ifdef CONFIG_NVS_ATE_INDEX
+	int err;
+	uint16_t id;
+	uint16_t data;
+
+	fixture->fs.sector_count = 3;
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	for (id = 0; id < CONFIG_NVS_ATE_INDEX_SIZE + 1; id++) {
+		data = id;
+		err = nvs_write(&fixture->fs, id, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_write call failure: %d", err);
+	}
+
+	zassert_false(fixture->fs.ate_index_complete, "index complete when full");
+
+	for (id = 0; id < CONFIG_NVS_ATE_INDEX_SIZE + 1; id++) {
+		err = nvs_read(&fixture->fs, id, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_read call failure: %d", err);
+		zassert_equal(data, id, "incorrect data read");
+	}
+
+	err = nvs_mount(&fixture->fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+	zassert_false(fixture->fs.ate_index_complete, "index complete when full");
+#endif
+}
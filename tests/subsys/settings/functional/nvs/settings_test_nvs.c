@@ -4,6 +4,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/ztest.h>
 #include <errno.h>
+#include <stdlib.h>
 #include <zephyr/settings/settings.h>
 #include <zephyr/fs/nvs.h>
 
@@ -23,4 +24,90 @@ ZTEST(settings_functional, test_setting_storage_get)
 
 	zassert_true(nvs_rc >= 0, "Can't read nvs record (err=%d).", rc);
 }
+
+#if defined(CONFIG_SETTINGS_NVS_HASH)
+#include "settings/settings_nvs_hash.h"
+
+#define COLL_ITEMS 20
+
+static int coll_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			void *cb_arg, void *param)
+{
+	uint16_t *values = param;
+	uint16_t value;
+	int idx = atoi(key);
+
+	zassert_true(idx >= 0 && idx < COLL_ITEMS, "unexpected key %s", key);
+	zassert_equal(len, sizeof(value), "unexpected length %u", len);
+	zassert_equal(read_cb(cb_arg, &value, sizeof(value)), sizeof(value),
+		      "can't read value");
+
+	values[idx] = value;
+
+	return 0;
+}
+
+/* With 20 names in 32 IDs, colliding names take the next IDs of the probe
+ * sequence. Deleting some of them leaves tombstones, the others must still
+ * be found on overwrite and load. The entry written by the application
+ * under a low NVS ID is left alone.
+ */
+ZTEST(settings_functional, test_nvs_hash_collisions)
+{
+	uint16_t values[COLL_ITEMS];
+	uint16_t raw = 0x5a5a;
+	char name[16];
+	uint16_t value;
+	void *storage;
+	ssize_t nvs_rc;
+	int rc;
+
+	BUILD_ASSERT(COLL_ITEMS < SETTINGS_NVS_HASH_IDS);
+
+	rc = settings_storage_get(&storage);
+	zassert_equal(0, rc, "Can't fetch storage reference (err=%d)", rc);
+
+	nvs_rc = nvs_write((struct nvs_fs *)storage, 26, &raw, sizeof(raw));
+	zassert_true(nvs_rc >= 0, "Can't write nvs record (err=%d)", nvs_rc);
+
+	for (int i = 0; i < COLL_ITEMS; i++) {
+		snprintk(name, sizeof(name), "coll/%d", i);
+		value = i;
+		rc = settings_save_one(name, &value, sizeof(value));
+		zassert_equal(rc, 0, "can't save %s (err=%d)", name, rc);
+	}
+
+	for (int i = 0; i < COLL_ITEMS; i++) {
+		snprintk(name, sizeof(name), "coll/%d", i);
+		if (i % 3 == 0) {
+			rc = settings_delete(name);
+		} else {
+			value = i + 100;
+			rc = settings_save_one(name, &value, sizeof(value));
+		}
+		zassert_equal(rc, 0, "can't update %s (err=%d)", name, rc);
+	}
+
+	memset(values, 0xff, sizeof(values));
+	rc = settings_load_subtree_direct("coll", coll_load_cb, values);
+	zassert_equal(rc, 0, "can't load (err=%d)", rc);
+
+	for (int i = 0; i < COLL_ITEMS; i++) {
+		value = (i % 3 == 0) ? UINT16_MAX : i + 100;
+		zassert_equal(values[i], value, "wrong value for coll/%d", i);
+	}
+
+	raw = 0;
+	nvs_rc = nvs_read((struct nvs_fs *)storage, 26, &raw, sizeof(raw));
+	zassert_equal(nvs_rc, sizeof(raw), "Can't read nvs record (err=%d)", nvs_rc);
+	zassert_equal(raw, 0x5a5a, "nvs record overwritten by the settings");
+
+	for (int i = 0; i < COLL_ITEMS; i++) {
+		snprintk(name, sizeof(name), "coll/%d", i);
+		rc = settings_delete(name);
+		zassert_equal(rc, 0, "can't delete %s (err=%d)", name, rc);
+	}
+}
+#endif /* CONFIG_SETTINGS_NVS_HASH */
+
 ZTEST_SUITE(settings_functional, NULL, NULL, NULL, NULL, NULL);